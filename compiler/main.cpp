@@ -21,6 +21,7 @@
 #include <string>
 #include <algorithm>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include <derplanner/compiler/io.h>
@@ -97,6 +98,51 @@ void print_help()
 "   --custom-header, -c <header-name>\n"
 "       Custom header.\n"
 "\n"
+"   --inline-threshold <task-count>\n"
+"       Inline calls to single-branch methods with empty precondition\n"
+"       and at most this many tasks, 0 disables inlining.\n"
+"       (default: 8)\n"
+"\n"
+"   --verbose, -v\n"
+"       Report what optimization passes did.\n"
+"\n"
+"   --out-of-line-effects\n"
+"       Generate one apply function per operator instead of\n"
+"       expanding operator effects at every call site.\n"
+"\n"
+"   --adaptive-joins\n"
+"       Generate alternative loop nests for conjunctions with several\n"
+"       atoms and pick one by current atom list sizes at run time.\n"
+"\n"
+"   --static-indices\n"
+"       Keep atoms which no operator adds or deletes in sorted indices,\n"
+"       looked up by binary search. Call build_static_indices() after\n"
+"       the worldstate is loaded.\n"
+"\n"
+"   --computed-goto\n"
+"       Resume generated coroutines with a jump through a table of label\n"
+"       addresses instead of a switch. Requires GCC or Clang.\n"
+"\n"
+"   --single-dispatch\n"
+"       Generate branch expands as cases of one function, which jumps from\n"
+"       a branch to the next directly, and a step() function to call\n"
+"       instead of find_plan_step(). Can't be used with --computed-goto.\n"
+"\n"
+"   --slot-cursors\n"
+"       Keep 32-bit tuple slots instead of tuple pointers in precondition\n"
+"       states, which makes method frames smaller on 64-bit targets.\n"
+"\n"
+"   --sort-buffer <binding-count>\n"
+"       Number of bindings a ':sort-by' branch collects and sorts at a\n"
+"       time, larger precondition results are sorted batch by batch:\n"
+"       keys ascend within a batch, not across batches.\n"
+"       (default: 16)\n"
+"\n"
+"   --reorder-literals\n"
+"       Reorder precondition literals by selectivity: filters as early\n"
+"       as possible, atoms with more bound arguments or smaller ':size'\n"
+"       hints first. May change which plan is found first.\n"
+"\n"
 "   --help, -h\n"
 "       Print this help message and exit.\n");
 }
@@ -169,6 +215,16 @@ int main(int argc, char** argv)
     std::string output_dir;
     std::string custom_header;
     std::string input_path;
+    unsigned inline_threshold = 8;
+    unsigned sort_buffer_size = 16;
+    bool inline_operator_effects = true;
+    bool reorder = false;
+    bool adaptive_joins = false;
+    bool static_indices = false;
+    bool computed_goto = false;
+    bool single_dispatch = false;
+    bool slot_cursors = false;
+    bool verbose = false;
 
     for (int i = 1; i < argc; ++i)
     {
@@ -193,6 +249,54 @@ int main(int argc, char** argv)
                 return 1;
             }
 
+            if (name == "v" || name == "verbose")
+            {
+                verbose = true;
+                continue;
+            }
+
+            if (name == "out-of-line-effects")
+            {
+                inline_operator_effects = false;
+                continue;
+            }
+
+            if (name == "adaptive-joins")
+            {
+                adaptive_joins = true;
+                continue;
+            }
+
+            if (name == "static-indices")
+            {
+                static_indices = true;
+                continue;
+            }
+
+            if (name == "computed-goto")
+            {
+                computed_goto = true;
+                continue;
+            }
+
+            if (name == "single-dispatch")
+            {
+                single_dispatch = true;
+                continue;
+            }
+
+            if (name == "slot-cursors")
+            {
+                slot_cursors = true;
+                continue;
+            }
+
+            if (name == "reorder-literals")
+            {
+                reorder = true;
+                continue;
+            }
+
             if (i + 1 >= argc || argv[i + 1][0] == '-')
             {
                 fprintf(stderr, "error: missing value for flag: %s\n", name.c_str());
@@ -216,6 +320,37 @@ int main(int argc, char** argv)
                 continue;
             }
 
+            if (name == "inline-threshold")
+            {
+                char* end = 0;
+                long threshold = strtol(value.c_str(), &end, 10);
+
+                if (value.empty() || *end != 0 || threshold < 0)
+                {
+                    fprintf(stderr, "error: invalid value for flag: %s\n", name.c_str());
+                    return 1;
+                }
+
+                inline_threshold = unsigned(threshold);
+                continue;
+            }
+
+            if (name == "sort-buffer")
+            {
+                char* end = 0;
+                long size = strtol(value.c_str(), &end, 10);
+
+                // sorted bindings live in the method frame, which is limited to 64KB.
+                if (value.empty() || *end != 0 || size < 1 || size > 256)
+                {
+                    fprintf(stderr, "error: invalid value for flag: %s\n", name.c_str());
+                    return 1;
+                }
+
+                sort_buffer_size = unsigned(size);
+                continue;
+            }
+
             if (name == "custom-header" || name == "c")
             {
                 if (!custom_header.empty())
@@ -240,6 +375,13 @@ int main(int argc, char** argv)
         }
     }
 
+    if (single_dispatch && computed_goto)
+    {
+        // resume labels of computed goto coroutines are function scoped and would clash.
+        fprintf(stderr, "error: --single-dispatch can't be combined with --computed-goto.\n");
+        return 1;
+    }
+
     if (input_path.empty())
     {
         fprintf(stderr, "error: no source file specified.\n");
@@ -295,6 +437,23 @@ int main(int argc, char** argv)
         return 1;
     }
 
+    if (reorder)
+    {
+        ast::reorder_literals(tree);
+    }
+
+    unsigned num_inlined = ast::inline_methods(tree, inline_threshold);
+
+    if (verbose)
+    {
+        fprintf(stderr, "inlined %u method call(s).\n", num_inlined);
+    }
+
+    if (static_indices)
+    {
+        ast::find_static_atoms(tree);
+    }
+
     std::string header_file_name = output_name + ".h";
     std::string source_file_name = output_name + ".cpp";
     std::string header_file_path = std::string(output_dir) + "/" + header_file_name;
@@ -327,6 +486,12 @@ int main(int argc, char** argv)
     options.runtime_atom_names = true;
     options.runtime_task_names = true;
     options.enable_reflection = true;
+    options.inline_operator_effects = inline_operator_effects;
+    options.adaptive_join_order = adaptive_joins;
+    options.computed_goto = computed_goto;
+    options.single_dispatch = single_dispatch;
+    options.slot_cursors = slot_cursors;
+    options.sort_buffer_size = sort_buffer_size;
 
     generate_header(tree, header_writer, options);
     generate_source(tree, source_writer, options);
@@ -98,12 +98,27 @@ struct term_ann
     int   type_tag;
     int   var_index;
     node* var_def;
+    // calls compared in a precondition: index of the state field their result is hoisted to.
+    int   call_index;
 };
 
 struct atom_ann
 {
     int index;
     bool lazy;
+    // estimated number of tuples from ':size' hint, 0 if unknown.
+    int cardinality;
+    // set on worldstate atoms which appear in operator effects.
+    bool modified;
+    // static atom stored in a sorted index on argument `index_key`.
+    bool indexed;
+    int index_key;
+};
+
+struct func_ann
+{
+    // results depend on arguments only and are memoized per planner (see `memo_tables` in generated code).
+    bool pure;
 };
 
 struct branch_ann
@@ -114,6 +129,8 @@ struct branch_ann
 struct method_ann
 {
     bool processed;
+    // method always expands, computed on demand by codegen: 0 - unknown, 1 - in progress, 2 - no, 3 - yes.
+    int infallible;
 };
 
 #define PLNNRC_AST_NODE_GROUP(GROUP_ID, FIRST_ID, LAST_ID)          \
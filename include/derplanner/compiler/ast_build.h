@@ -30,6 +30,19 @@ namespace ast {
 
 bool build_translation_unit(tree& ast, sexpr::node* s_expr);
 
+// splices task lists of single-branch methods with empty precondition and
+// at most `max_tasks` tasks into their call sites. returns the number of inlined calls.
+unsigned inline_methods(tree& ast, unsigned max_tasks);
+
+// reorders literals of each precondition conjunction: filters are moved to the earliest point
+// where their variables are bound, atoms are picked by most bound arguments, then by ':size' hint.
+// returns the number of reordered conjunctions.
+unsigned reorder_literals(tree& ast);
+
+// finds worldstate atoms which no operator adds or deletes and picks for each the argument
+// most often bound in preconditions as the key of its sorted index. returns the number of indexed atoms.
+unsigned find_static_atoms(tree& ast);
+
 }
 }
 
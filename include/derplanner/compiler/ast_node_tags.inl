@@ -38,6 +38,8 @@ PLNNRC_AST_NODE(method)
 PLNNRC_AST_NODE(branch)
 PLNNRC_AST_NODE(operator)
 PLNNRC_AST_NODE(task_list)
+PLNNRC_AST_NODE(cost)
+PLNNRC_AST_NODE(sort_by)
 
 PLNNRC_AST_NODE(add_list)
 PLNNRC_AST_NODE(delete_list)
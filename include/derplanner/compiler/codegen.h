@@ -36,6 +36,15 @@ struct codegen_options
     bool runtime_atom_names;
     bool runtime_task_names;
     bool enable_reflection;
+    bool inline_operator_effects;
+    bool adaptive_join_order;
+    bool computed_goto;
+    // all branch expands are cases of one function with direct jumps between branches, plus a `step` function.
+    bool single_dispatch;
+    // precondition states store tuple slots (32-bit) and `next` keeps tuple pointers in locals between yields.
+    bool slot_cursors;
+    // number of bindings sorted at a time by ':sort-by' branches, key order holds within a batch only.
+    unsigned sort_buffer_size;
 };
 
 bool generate_header(ast::tree& ast, writer& output, codegen_options options);
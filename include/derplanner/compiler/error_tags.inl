@@ -23,11 +23,14 @@ PLNNRC_ERROR(error_unexpected, "unexpected expression.")
 PLNNRC_ERROR(error_expected_type, "expected $0{<none>|list|symbol|int|float} expression.")
 PLNNRC_ERROR(error_expected_token, "expected '$0'.")
 PLNNRC_ERROR(error_expected_parameter, "expected parameter identifier.")
-PLNNRC_ERROR(error_multiple_definitions, "multiple definitions of $0{worldstate|domain|delete effects|add effects}.")
+PLNNRC_ERROR(error_multiple_definitions, "multiple definitions of $0{worldstate|domain|delete effects|add effects|cost}.")
 PLNNRC_ERROR(error_redefinition, "redefinition of '$0', originally defined at $1.")
 PLNNRC_ERROR(error_invalid_id, "invalid identifier '$0'.")
-PLNNRC_ERROR(error_unbound_var, "unbound variable '$0' in $1{task list|call term|operation}.")
+PLNNRC_ERROR(error_unbound_var, "unbound variable '$0' in $1{task list|call term|operation|cost|sort key}.")
 PLNNRC_ERROR(error_undefined, "'$0' is undefined.")
 PLNNRC_ERROR(error_wrong_number_of_arguments, "wrong number of arguments for '$0'.")
 PLNNRC_ERROR(error_type_mismatch, "expected argument of type '$0', got '$1'.")
 PLNNRC_ERROR(error_unable_to_infer_type, "unable to infer type of '$0'.")
+PLNNRC_ERROR(error_limit_exceeded, "too many $0{tasks|method branches} in domain, at most 65535 are supported.")
+PLNNRC_ERROR(error_negative_cost, "operator cost can't be negative.")
+PLNNRC_ERROR(error_expected_sort_key, "expected sort key after ':sort-by'.")
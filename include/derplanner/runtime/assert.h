@@ -32,4 +32,11 @@
     #endif
 #endif
 
+#ifndef plnnr_static_assert
+    #define plnnr_static_assert_join2(a, b) a##b
+    #define plnnr_static_assert_join(a, b) plnnr_static_assert_join2(a, b)
+    // array of negative size if `e` is false, at most one per line.
+    #define plnnr_static_assert(e) typedef char plnnr_static_assert_join(plnnr_static_assert_, __LINE__)[(e) ? 1 : -1]
+#endif
+
 #endif
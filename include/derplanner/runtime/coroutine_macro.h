@@ -21,8 +21,15 @@
 #ifndef DERPLANNER_RUNTIME_COROUTINE_MACRO_H_
 #define DERPLANNER_RUNTIME_COROUTINE_MACRO_H_
 
+// `label` is a resume stage assigned by the code generator: stages are numbered 1, 2, ... within a function.
 #define PLNNR_COROUTINE_BEGIN(state) switch ((state).stage) { case 0:
-#define PLNNR_COROUTINE_YIELD(state) do { (state).stage = __LINE__; return true; case __LINE__:; } while (0)
+#define PLNNR_COROUTINE_YIELD(state, label) do { (state).stage = label; return true; case label:; } while (0)
 #define PLNNR_COROUTINE_END() } return false
 
+// computed goto variant (GCC/Clang), resuming jumps through a table of stage label addresses.
+#define PLNNR_COROUTINE_GOTO_BEGIN(state) if ((state).stage != 0) goto plnnr_resume
+#define PLNNR_COROUTINE_GOTO_YIELD(state, label) do { (state).stage = label; return true; plnnr_stage_##label:; } while (0)
+#define PLNNR_COROUTINE_GOTO_LABEL(label) &&plnnr_stage_##label
+#define PLNNR_COROUTINE_GOTO_END(state, table) return false; plnnr_resume: goto *(table)[(state).stage]
+
 #endif
@@ -75,7 +75,7 @@ void dispatch(I* task_instance, V& visitor)
 template <typename T, typename I, typename V>
 void walk_stack_down(I* top_task, V& visitor)
 {
-    for (I* task = top_task; task != 0; task = task->prev)
+    for (I* task = top_task; task != 0; task = prev_task(task))
     {
         dispatch<T>(task, visitor);
     }
@@ -84,7 +84,7 @@ void walk_stack_down(I* top_task, V& visitor)
 template <typename T, typename I, typename V>
 void walk_stack_up(I* top_task, V& visitor)
 {
-    for (I* task = top_task; task != 0; task = task->next)
+    for (I* task = top_task; task != 0; task = next_task(task))
     {
         dispatch<T>(task, visitor);
     }
@@ -37,9 +37,11 @@ void worldstate::append(const T& tuple)
     T* new_tuple_ptr = tuple_list::append<T>(list);
     T* next = new_tuple_ptr->next;
     T* prev = new_tuple_ptr->prev;
+    uint32_t slot = new_tuple_ptr->slot;
     *new_tuple_ptr = tuple;
     new_tuple_ptr->next = next;
     new_tuple_ptr->prev = prev;
+    new_tuple_ptr->slot = slot;
 }
 
 template <typename T,
@@ -24,6 +24,7 @@
 #include <stdint.h>
 #include <stddef.h> // size_t
 
+#include "derplanner/runtime/assert.h"
 #include "derplanner/runtime/worldstate.h"
 #include "derplanner/runtime/memory.h" // alignof
 #include "derplanner/runtime/coroutine_macro.h"
@@ -46,10 +47,17 @@ public:
 
     void reset();
 
+    // reallocates the buffer keeping its contents, pointers into the stack become invalid.
+    bool grow(size_t capacity);
+    // replaces contents with a copy of `source`, false if it doesn't fit.
+    bool assign(const stack& source);
+    bool assign(const void* data, size_t size);
+
     void* top() const { return _top; }
     size_t top_offset() const { return _top - _buffer; }
     void* buffer() const { return _buffer; }
     bool empty() const { return _top == _buffer; }
+    size_t capacity() const { return _capacity; }
 
 private:
     stack(const stack&);
@@ -85,6 +93,81 @@ T* top(stack* s)
     return memory::align<T>(s->top()) - 1;
 }
 
+const uint32_t memo_hash_seed = 2166136261u;
+
+// FNV-1a over the bytes of `value`, used to index memo tables of ':pure' world functions.
+template <typename T>
+inline uint32_t memo_hash(uint32_t hash, const T& value)
+{
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&value);
+
+    for (size_t i = 0; i < sizeof(T); ++i)
+    {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    }
+
+    return hash;
+}
+
+// bottom-up merge sort, keeps the relative order of equal items. returns false if out of memory.
+template <typename T, typename Less>
+bool stable_sort(T* items, size_t count, Less less)
+{
+    if (count < 2)
+    {
+        return true;
+    }
+
+    T* buffer = static_cast<T*>(memory::allocate(sizeof(T) * count));
+
+    if (!buffer)
+    {
+        return false;
+    }
+
+    T* source = items;
+    T* target = buffer;
+
+    for (size_t width = 1; width < count; width *= 2)
+    {
+        for (size_t first = 0; first < count; first += 2 * width)
+        {
+            size_t middle = first + width < count ? first + width : count;
+            size_t last = first + 2 * width < count ? first + 2 * width : count;
+            size_t i = first;
+            size_t j = middle;
+
+            for (size_t k = first; k < last; ++k)
+            {
+                if (i < middle && (j >= last || !less(source[j], source[i])))
+                {
+                    target[k] = source[i++];
+                }
+                else
+                {
+                    target[k] = source[j++];
+                }
+            }
+        }
+
+        T* swap = source;
+        source = target;
+        target = swap;
+    }
+
+    if (source != items)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            items[i] = source[i];
+        }
+    }
+
+    memory::deallocate(buffer);
+
+    return true;
+}
+
 struct planner_state;
 struct method_instance;
 
@@ -95,24 +178,38 @@ enum method_flags
     method_flags_none       = 0x0,
     method_flags_expanded   = 0x1,
     method_flags_failed     = 0x2,
+    // on a branch where a failed subtask fails the method itself (set by generated expands).
+    method_flags_committed  = 0x4,
+    // expanded by `find_next_plan_step`, which keeps alternatives of expanded methods.
+    method_flags_enumerating = 0x8,
 };
 
+// expand index 0 means no expand (operator tasks).
+const uint16_t expand_none = 0;
+
+// frames link to their neighbours with self-relative byte offsets (0 if none),
+// expands are referenced by index into `planner_state::expands`.
 struct method_instance
 {
-    uint8_t             flags;
-    uint16_t            expanding_branch;
-    uint32_t            arguments;
-    uint32_t            precondition;
-    uint32_t            size;
+    uint32_t            prev;
     uint32_t            task_rewind;
     uint32_t            journal_rewind;
     uint32_t            trace_rewind;
-    uint32_t            stage;
-    int32_t             type;
-    expand_func         expand;
-    method_instance*    prev;
+    uint16_t            arguments;
+    uint16_t            precondition;
+    uint16_t            size;
+    uint16_t            stage;
+    uint16_t            type;
+    uint16_t            expanding_branch;
+    uint16_t            expand;
+    uint8_t             flags;
 };
 
+inline method_instance* prev_method(method_instance* method)
+{
+    return method->prev ? reinterpret_cast<method_instance*>(reinterpret_cast<char*>(method) - method->prev) : 0;
+}
+
 inline void* arguments(method_instance* method)
 {
     return memory::offset(method, method->arguments);
@@ -142,43 +239,171 @@ T* precondition(method_instance* method)
 
 struct task_instance
 {
-    uint16_t        args_align;
+    uint32_t        prev;
+    uint32_t        next;
     uint32_t        args_size;
     int32_t         type;
-    expand_func     expand;
-    task_instance*  prev;
-    task_instance*  next;
+    // accumulated cost of the plan up to and including this task.
+    float           cost;
+    uint16_t        args_align;
+    uint16_t        expand;
 };
 
+inline task_instance* prev_task(task_instance* task)
+{
+    return task->prev ? reinterpret_cast<task_instance*>(reinterpret_cast<char*>(task) - task->prev) : 0;
+}
+
+inline task_instance* next_task(task_instance* task)
+{
+    return task->next ? reinterpret_cast<task_instance*>(reinterpret_cast<char*>(task) + task->next) : 0;
+}
+
+// adds an operator cost to the plan cost accumulated in `task`. branch-and-bound needs
+// the plan cost to never decrease, so a negative cost is an error and counts as zero.
+inline void add_cost(task_instance* task, float cost)
+{
+    plnnr_assert(cost >= 0.0f);
+    task->cost += cost > 0.0f ? cost : 0.0f;
+}
+
 inline void* arguments(task_instance* task)
 {
     return task->args_size > 0 ? memory::align(task + 1, task->args_align) : 0;
 }
 
+// primitive task of an exported plan, followed by its arguments.
+// steps are stored back to back, the plan ends with a step of size 0.
+struct plan_step
+{
+    int32_t     type;
+    // offset of the arguments from the step, 0 if none.
+    uint16_t    arguments;
+    // offset of the next step.
+    uint16_t    size;
+};
+
+inline void* arguments(plan_step* step)
+{
+    return step->arguments ? memory::offset(step, step->arguments) : 0;
+}
+
+inline plan_step* first_step(void* plan)
+{
+    plan_step* step = memory::align<plan_step>(plan);
+    return step->size ? step : 0;
+}
+
+inline plan_step* next_step(plan_step* step)
+{
+    plan_step* next = static_cast<plan_step*>(memory::offset(step, step->size));
+    return next->size ? next : 0;
+}
+
+enum effect_kind
+{
+    effect_add = 0,
+    effect_delete,
+};
+
+// journal entry: tuple `tuple` of atom list `atom` was added or deleted.
 struct operator_effect
 {
-    tuple_list::handle* list;
-    void* tuple;
+    uint32_t tuple;
+    uint16_t atom;
+    uint16_t kind;
 };
 
+// generated worldstate structs start with the array of atom lists.
+inline tuple_list::handle** atom_lists(void* worldstate)
+{
+    return static_cast<tuple_list::handle**>(worldstate);
+}
+
 struct method_trace
 {
     int32_t type;
     uint16_t branch_index;
 };
 
+// all links between frames are offsets, so a paused state can be copied
+// to other stacks (see `copy`) or its stacks can be grown in place.
 struct planner_state
 {
-    method_instance* top_method;
-    task_instance* top_task;
+    // offset of the top method/task frame in its stack plus one, 0 if empty.
+    uint32_t top_method;
+    uint32_t top_task;
     stack* methods;
     stack* tasks;
     stack* journal;
     stack* trace;
+    // expand table of the domain, indexed by `method_instance::expand`.
+    const expand_func* expands;
+    // `memo_tables` of the domain caching ':pure' function results for this planner, 0 to call them directly.
+    void* memo;
 };
 
 void reset(planner_state& pstate);
 
+// copies a paused search into the stacks of `destination`, false if they are too small.
+bool copy(planner_state& destination, const planner_state& source);
+
+// identifies the tuple lists of a worldstate for `save` and `load`, changes when a list is replaced or cleared.
+uint32_t world_fingerprint(void* worldstate, uint32_t atom_count);
+
+// number of bytes `save` writes for `pstate`.
+size_t save_size(const planner_state& pstate);
+
+// writes the used part of the stacks of a paused search to `buffer`, returns 0 if it doesn't fit.
+// the world isn't saved: the journal and precondition states refer to tuples of the worldstate the
+// search runs on, so a saved search can only be loaded back against that same worldstate.
+// effects stay applied, `undo_effects` takes them back and `redo_effects` re-applies them after `load`,
+// in between the worldstate must not be changed otherwise.
+size_t save(const planner_state& pstate, uint32_t world_fingerprint, void* buffer, size_t buffer_size);
+
+// restores a search written by `save` into the stacks of `pstate`,
+// false if `world_fingerprint` doesn't match the one it was saved with.
+bool load(planner_state& pstate, uint32_t world_fingerprint, const void* buffer, size_t buffer_size);
+
+// writes the primitive tasks of a found plan to `buffer` as plan steps (see `first_step`, `next_step`),
+// returns the number of bytes written or 0 if it doesn't fit. `buffer` should be aligned for the task arguments.
+size_t export_plan(const planner_state& pstate, void* buffer, size_t buffer_size);
+
+// tasks starting below this offset in `pstate.tasks` can't be removed by backtracking,
+// either the search fails or they are the prefix of the found plan.
+size_t committed_offset(const planner_state& pstate);
+
+// returns the next committed primitive task at `cursor` (an offset in `pstate.tasks`, starting at 0)
+// and moves `cursor` past it, 0 if no more tasks are committed yet.
+task_instance* next_committed_task(const planner_state& pstate, size_t& cursor);
+
+inline method_instance* top_method(const planner_state& pstate)
+{
+    return pstate.top_method ? static_cast<method_instance*>(pstate.methods->ptr(pstate.top_method - 1)) : 0;
+}
+
+inline task_instance* top_task(const planner_state& pstate)
+{
+    return pstate.top_task ? static_cast<task_instance*>(pstate.tasks->ptr(pstate.top_task - 1)) : 0;
+}
+
+// sum of operator costs of the tasks in the plan so far.
+inline float plan_cost(const planner_state& pstate)
+{
+    task_instance* task = top_task(pstate);
+    return task ? task->cost : 0.0f;
+}
+
+inline void set_top_method(planner_state& pstate, method_instance* method)
+{
+    pstate.top_method = method ? uint32_t(pstate.methods->offset(method) + 1) : 0;
+}
+
+inline void set_top_task(planner_state& pstate, task_instance* task)
+{
+    pstate.top_task = task ? uint32_t(pstate.tasks->offset(task) + 1) : 0;
+}
+
 enum find_plan_status
 {
     plan_not_found = 0,
@@ -186,14 +411,25 @@ enum find_plan_status
     plan_found,
 };
 
+// method frames address their contents with 16-bit offsets, generated code checks its frames fit.
+const size_t max_frame_size = 0xffff;
+
+// upper bound of the stack space taken by `T`, including alignment padding.
+template <typename T>
+struct padded_size
+{
+    enum { value = sizeof(T) + plnnr_alignof(T) - 1 };
+};
+
 template <typename T>
 T* push_arguments(planner_state& pstate, method_instance* method)
 {
     T* arguments = push<T>(pstate.methods);
     size_t method_offset = pstate.methods->offset(method);
     size_t arguments_offset = pstate.methods->offset(arguments);
-    method->arguments = arguments_offset - method_offset;
-    method->size = pstate.methods->top_offset() - method_offset;
+    plnnr_assert(pstate.methods->top_offset() - method_offset <= 0xffff);
+    method->arguments = uint16_t(arguments_offset - method_offset);
+    method->size = uint16_t(pstate.methods->top_offset() - method_offset);
     return arguments;
 }
 
@@ -204,11 +440,111 @@ T* push_precondition(planner_state& pstate, method_instance* method)
     precondition->stage = 0;
     size_t method_offset = pstate.methods->offset(method);
     size_t precondition_offset = pstate.methods->offset(precondition);
-    method->precondition = precondition_offset - method_offset;
-    method->size = pstate.methods->top_offset() - method_offset;
+    plnnr_assert(pstate.methods->top_offset() - method_offset <= 0xffff);
+    method->precondition = uint16_t(precondition_offset - method_offset);
+    method->size = uint16_t(pstate.methods->top_offset() - method_offset);
     return precondition;
 }
 
+// bindings of a ':sort-by' branch, pushed right after the precondition `T`:
+// the precondition is run in batches of up to `N` bindings, each batch is yielded in ascending key order.
+template <typename T, typename K, int N>
+struct sorted_bindings
+{
+    typedef T binding;
+    // precondition state between batches.
+    T search;
+    T items[N];
+    K keys[N];
+    // batch items in key order.
+    uint16_t order[N];
+    uint16_t count;
+    uint16_t cursor;
+    // precondition has no more bindings after this batch.
+    uint16_t exhausted;
+};
+
+template <typename S>
+S* sorted_bindings_of(method_instance* method)
+{
+    return memory::align<S>(precondition<typename S::binding>(method) + 1);
+}
+
+template <typename S>
+S* push_sorted_bindings(planner_state& pstate, method_instance* method)
+{
+    S* sorted = push<S>(pstate.methods);
+    sorted->search = *precondition<typename S::binding>(method);
+    sorted->count = 0;
+    sorted->cursor = 0;
+    sorted->exhausted = 0;
+    size_t method_offset = pstate.methods->offset(method);
+    plnnr_assert(pstate.methods->top_offset() - method_offset <= 0xffff);
+    method->size = uint16_t(pstate.methods->top_offset() - method_offset);
+    return sorted;
+}
+
+// once the batch is yielded, restores the precondition state in `state` and starts the next one. false if no batch to start.
+template <typename T, typename K, int N>
+bool begin_batch(sorted_bindings<T, K, N>& sorted, T& state)
+{
+    if (sorted.cursor < sorted.count || sorted.exhausted)
+    {
+        return false;
+    }
+
+    state = sorted.search;
+    sorted.count = 0;
+    sorted.cursor = 0;
+    return true;
+}
+
+template <typename T, typename K, int N>
+bool batch_full(const sorted_bindings<T, K, N>& sorted)
+{
+    return sorted.count == N;
+}
+
+// insertion sort, bindings with equal keys keep the precondition order.
+template <typename T, typename K, int N>
+void insert_binding(sorted_bindings<T, K, N>& sorted, const T& binding, const K& key)
+{
+    plnnr_assert(sorted.count < N);
+
+    uint16_t index = sorted.count++;
+    sorted.items[index] = binding;
+    sorted.keys[index] = key;
+
+    uint16_t position = index;
+
+    for (; position > 0 && key < sorted.keys[sorted.order[position - 1]]; --position)
+    {
+        sorted.order[position] = sorted.order[position - 1];
+    }
+
+    sorted.order[position] = index;
+}
+
+template <typename T, typename K, int N>
+void end_batch(sorted_bindings<T, K, N>& sorted, const T& state)
+{
+    sorted.search = state;
+    sorted.exhausted = sorted.count < N;
+}
+
+// copies the next binding of the batch to `binding`, false if the batch is done.
+template <typename T, typename K, int N>
+bool next_binding(sorted_bindings<T, K, N>& sorted, T& binding)
+{
+    if (sorted.cursor == sorted.count)
+    {
+        return false;
+    }
+
+    binding = sorted.items[sorted.order[sorted.cursor++]];
+    return true;
+}
+
 template <typename T>
 T* push_arguments(planner_state& pstate, task_instance* task)
 {
@@ -218,23 +554,48 @@ T* push_arguments(planner_state& pstate, task_instance* task)
     return arguments;
 }
 
-method_instance* push_method(planner_state& pstate, int task_type, expand_func expand);
+method_instance* push_method(planner_state& pstate, int task_type, uint16_t expand);
+// pushes the last task of a branch which can't fail or has no alternatives in place of the parent frame.
+// when enumerating plans, a parent with alternatives is kept and the callee is pushed above it.
+// the callee may reuse the parent's address, tasks and effects of the parent stay below its rewind points.
+method_instance* push_tail_method(planner_state& pstate, int task_type, uint16_t expand);
 
-task_instance* push_task(planner_state& pstate, int task_type, expand_func expand);
+task_instance* push_task(planner_state& pstate, int task_type, uint16_t expand);
 task_instance* push_task(planner_state& pstate, task_instance* task);
 
-method_instance* rewind_top_method(planner_state& pstate, bool rewind_tasks);
-bool expand_next_branch(planner_state& pstate, expand_func expand, void* worldstate);
+method_instance* rewind_top_method(planner_state& pstate, bool rewind_tasks, void* worldstate);
+bool expand_next_branch(planner_state& pstate, uint16_t expand, void* worldstate);
+// switches the top method to the next branch without expanding it, for code which expands it directly.
+void select_next_branch(planner_state& pstate, uint16_t expand);
 
-void undo_effects(stack* journal);
+void undo_effects(stack* journal, void* worldstate);
+// re-applies the journal to a worldstate it was undone from with `undo_effects`.
+void redo_effects(stack* journal, void* worldstate);
 method_instance* copy_method(method_instance* method, stack* destination);
 
-bool find_plan(planner_state& pstate, int root_method_type, expand_func root_method, void* worldstate);
+bool find_plan(planner_state& pstate, int root_method_type, uint16_t root_method, void* worldstate);
 
-void find_plan_init(planner_state& pstate, int root_method_type, expand_func root_method);
+void find_plan_init(planner_state& pstate, int root_method_type, uint16_t root_method);
 void find_plan_init(planner_state& pstate, task_instance* composite_task);
 
 find_plan_status find_plan_step(planner_state& pstate, void* worldstate);
+// second half of `find_plan_step`: pops fully expanded methods or backtracks after `method` was expanded by the caller.
+find_plan_status find_plan_advance(planner_state& pstate, method_instance* method, bool expanded, void* worldstate);
+
+// like `find_plan_step`, but keeps expanded methods on the stack until `reset`, so after a plan is found
+// the next call backtracks into the most recent alternative to search for another one.
+// `committed_offset` doesn't account for the kept methods.
+find_plan_status find_next_plan_step(planner_state& pstate, void* worldstate);
+// branch-and-bound version: fails a task which brings the plan cost to `cost_bound` or above.
+find_plan_status find_next_plan_step(planner_state& pstate, void* worldstate, float cost_bound);
+// runs `find_next_plan_step` until the next plan is found or the search space is exhausted.
+find_plan_status find_next_plan(planner_state& pstate, void* worldstate);
+
+// branch-and-bound search for the cheapest plan in at most `max_steps` steps. `best_cost` starts at FLT_MAX,
+// each cheaper plan is exported to `buffer` (see `export_plan`) and lowers it. returns `plan_in_progress` if the budget
+// runs out (call again to continue), `plan_found` once the search space is exhausted and the cheapest plan is in `buffer`,
+// `plan_not_found` if there's no plan or it doesn't fit.
+find_plan_status find_optimal_plan(planner_state& pstate, void* worldstate, uint32_t max_steps, float& best_cost, void* buffer, size_t buffer_size);
 
 }
 
@@ -22,6 +22,7 @@
 #define DERPLANNER_RUNTIME_WORLDSTATE_H_
 
 #include <stddef.h> // size_t, offsetof
+#include <stdint.h> // uint32_t
 #include <derplanner/runtime/memory.h> // plnnr_alignof
 
 namespace plnnr {
@@ -33,8 +34,13 @@ struct tuple_traits
     size_t alignment;
     size_t next_offset;
     size_t prev_offset;
+    // uint32_t field the list stores the tuple's slot in.
+    size_t slot_offset;
 };
 
+// returned by `slot` for a tuple which doesn't belong to the list.
+const uint32_t invalid_slot = 0xffffffff;
+
 struct handle;
 
 handle* create(tuple_traits traits, size_t items_per_page);
@@ -45,12 +51,28 @@ void* append(handle* tuple_list);
 
 void detach(handle* tuple_list, void* tuple);
 
+// re-links a tuple removed by `detach`, detaches must be restored in reverse order.
+void restore(handle* tuple_list, void* tuple);
+
+// detaches an appended tuple or restores a detached one.
 void undo(handle* tuple_list, void* tuple);
 
 void clear(handle* tuple_list);
 
 void* head(handle* tuple_list);
 
+// number of tuples currently in the list.
+size_t size(const handle* tuple_list);
+
+// number of times the list was cleared, slots are reused after `clear`.
+uint32_t generation(const handle* tuple_list);
+
+// allocation index of a tuple, stable for the lifetime of the list (until `clear`), or `invalid_slot`.
+uint32_t slot(const handle* tuple_list, const void* tuple);
+
+// tuple by allocation index.
+void* at(handle* tuple_list, uint32_t slot);
+
 template <typename T>
 inline handle* create(size_t items_per_page)
 {
@@ -59,6 +81,7 @@ inline handle* create(size_t items_per_page)
     traits.alignment = plnnr_alignof(T);
     traits.next_offset = offsetof(T, next);
     traits.prev_offset = offsetof(T, prev);
+    traits.slot_offset = offsetof(T, slot);
     return create(traits, items_per_page);
 }
 
@@ -74,6 +97,12 @@ inline T* head(handle* tuple_list)
     return static_cast<T*>(head(tuple_list));
 }
 
+template <typename T>
+inline T* at(handle* tuple_list, uint32_t slot)
+{
+    return static_cast<T*>(at(tuple_list, slot));
+}
+
 }
 }
 
@@ -0,0 +1,167 @@
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <derplanner/runtime/runtime.h>
+#include <derplanner/runtime/interface.h>
+#include "blocks.h"
+#include "travel.h"
+
+using namespace plnnr;
+
+static const int iterations = 200000;
+
+typedef find_plan_status (*step_func)(planner_state&, void*);
+
+static double run(const char* name, planner_state& pstate, const expand_func* expands, step_func step, int root_type, uint16_t root, void* world)
+{
+    pstate.expands = expands;
+    int found = 0;
+    clock_t start = clock();
+
+    for (int i = 0; i < iterations; ++i)
+    {
+        find_plan_init(pstate, root_type, root);
+
+        find_plan_status status = step(pstate, world);
+
+        while (status == plan_in_progress)
+        {
+            status = step(pstate, world);
+        }
+
+        found += (status == plan_found);
+
+        undo_effects(pstate.journal, world);
+        reset(pstate);
+    }
+
+    double seconds = double(clock() - start) / CLOCKS_PER_SEC;
+    printf("%-8s %8.3f us/plan (%d/%d found)\n", name, seconds * 1e6 / iterations, found, iterations);
+    return seconds;
+}
+
+static void init_blocks(blocks::worldstate& world_struct)
+{
+    using namespace blocks;
+
+    const size_t tuple_list_page = 1024;
+
+    memset(&world_struct, 0, sizeof(world_struct));
+
+    world_struct.atoms[atom_block] = tuple_list::create<block_tuple>(tuple_list_page);
+    world_struct.atoms[atom_on_table] = tuple_list::create<on_table_tuple>(tuple_list_page);
+    world_struct.atoms[atom_on] = tuple_list::create<on_tuple>(tuple_list_page);
+    world_struct.atoms[atom_clear] = tuple_list::create<clear_tuple>(tuple_list_page);
+    world_struct.atoms[atom_goal_on_table] = tuple_list::create<goal_on_table_tuple>(tuple_list_page);
+    world_struct.atoms[atom_goal_on] = tuple_list::create<goal_on_tuple>(tuple_list_page);
+    world_struct.atoms[atom_goal_clear] = tuple_list::create<goal_clear_tuple>(tuple_list_page);
+    world_struct.atoms[atom_holding] = tuple_list::create<holding_tuple>(tuple_list_page);
+    world_struct.atoms[atom_dont_move] = tuple_list::create<dont_move_tuple>(tuple_list_page);
+    world_struct.atoms[atom_need_to_move] = tuple_list::create<need_to_move_tuple>(tuple_list_page);
+    world_struct.atoms[atom_put_on_table] = tuple_list::create<put_on_table_tuple>(tuple_list_page);
+    world_struct.atoms[atom_stack_on_block] = tuple_list::create<stack_on_block_tuple>(tuple_list_page);
+
+    plnnr::worldstate world(&world_struct);
+
+    world.append(atom<block_tuple>(1));
+    world.append(atom<block_tuple>(2));
+    world.append(atom<block_tuple>(3));
+    world.append(atom<block_tuple>(4));
+
+    world.append(atom<on_table_tuple>(1));
+    world.append(atom<on_table_tuple>(3));
+
+    world.append(atom<on_tuple>(2, 1));
+    world.append(atom<on_tuple>(4, 3));
+
+    world.append(atom<clear_tuple>(2));
+    world.append(atom<clear_tuple>(4));
+
+    world.append(atom<goal_on_table_tuple>(1));
+    world.append(atom<goal_on_table_tuple>(3));
+
+    world.append(atom<goal_on_tuple>(4, 1));
+    world.append(atom<goal_on_tuple>(2, 3));
+
+    world.append(atom<goal_clear_tuple>(4));
+    world.append(atom<goal_clear_tuple>(2));
+}
+
+static void init_travel(travel::worldstate& world_struct)
+{
+    using namespace travel;
+
+    const size_t tuple_list_page = 1024;
+
+    memset(&world_struct, 0, sizeof(world_struct));
+
+    world_struct.atoms[atom_start] = tuple_list::create<start_tuple>(1);
+    world_struct.atoms[atom_finish] = tuple_list::create<finish_tuple>(1);
+    world_struct.atoms[atom_short_distance] = tuple_list::create<short_distance_tuple>(tuple_list_page);
+    world_struct.atoms[atom_long_distance] = tuple_list::create<long_distance_tuple>(tuple_list_page);
+    world_struct.atoms[atom_airport] = tuple_list::create<airport_tuple>(tuple_list_page);
+
+    plnnr::worldstate world(&world_struct);
+
+    const int spb = 0;
+    const int led = 1;
+    const int svo = 2;
+    const int msc = 3;
+
+    world.append(atom<start_tuple>(spb));
+    world.append(atom<finish_tuple>(msc));
+
+    world.append(atom<short_distance_tuple>(spb, led));
+    world.append(atom<short_distance_tuple>(led, spb));
+    world.append(atom<short_distance_tuple>(msc, svo));
+    world.append(atom<short_distance_tuple>(svo, msc));
+
+    world.append(atom<long_distance_tuple>(spb, msc));
+    world.append(atom<long_distance_tuple>(msc, spb));
+    world.append(atom<long_distance_tuple>(led, svo));
+    world.append(atom<long_distance_tuple>(svo, led));
+    world.append(atom<long_distance_tuple>(spb, svo));
+    world.append(atom<long_distance_tuple>(svo, spb));
+    world.append(atom<long_distance_tuple>(msc, led));
+    world.append(atom<long_distance_tuple>(led, msc));
+
+    world.append(atom<airport_tuple>(spb, led));
+    world.append(atom<airport_tuple>(msc, svo));
+}
+
+int main()
+{
+    blocks::worldstate blocks_world;
+    travel::worldstate travel_world;
+
+    init_blocks(blocks_world);
+    init_travel(travel_world);
+
+    plnnr::stack methods(32768);
+    plnnr::stack tasks(32768);
+    plnnr::stack jstack(32768);
+
+    planner_state pstate;
+    pstate.top_method = 0;
+    pstate.top_task = 0;
+    pstate.methods = &methods;
+    pstate.tasks = &tasks;
+    pstate.journal = &jstack;
+    pstate.trace = 0;
+    pstate.expands = 0;
+    pstate.memo = 0;
+
+#ifdef SINGLE_DISPATCH
+    // domains compiled with --single-dispatch provide step() with all branches in one function.
+    step_func blocks_step = blocks::step;
+    step_func travel_step = travel::step;
+#else
+    step_func blocks_step = find_plan_step;
+    step_func travel_step = find_plan_step;
+#endif
+
+    run("blocks", pstate, blocks::expands, blocks_step, blocks::task_solve, blocks::expand_solve_branch_0, &blocks_world);
+    run("travel", pstate, travel::expands, travel_step, travel::task_root, travel::expand_root_branch_0, &travel_world);
+
+    return 0;
+}
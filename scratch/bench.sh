@@ -0,0 +1,13 @@
+#!/bin/sh
+# times find_plan_step() on blocks and travel, arguments are passed to derplannerc (e.g. --computed-goto),
+# --single-dispatch domains are stepped with their generated step().
+set -e
+out=../.build/bench
+mkdir -p $out
+../bin/x64/release/derplannerc "$@" -o $out ../examples/blocks.txt
+../bin/x64/release/derplannerc "$@" -o $out ../examples/travel.txt
+cp bench.main.cpp $out
+defines=
+case " $* " in *" --single-dispatch "*) defines=-DSINGLE_DISPATCH;; esac
+g++ -O3 $defines -I../include -L../bin/x64/release $out/bench.main.cpp $out/blocks.cpp $out/travel.cpp -lderplanner-runtime -o$out/bench -lstdc++
+$out/bench
@@ -4,6 +4,7 @@
 using namespace plnnr;
 
 #pragma GCC diagnostic ignored "-Wunused-variable"
+#pragma GCC diagnostic ignored "-Wunused-parameter"
 
 namespace blocks {
 
@@ -63,7 +64,7 @@ bool next(p0_state& state, worldstate& world)
 {
 	PLNNR_COROUTINE_BEGIN(state);
 
-	PLNNR_COROUTINE_YIELD(state);
+	PLNNR_COROUTINE_YIELD(state, 1);
 
 	PLNNR_COROUTINE_END();
 }
@@ -71,9 +72,9 @@ bool next(p0_state& state, worldstate& world)
 // method mark-all-blocks [49:13]
 struct p1_state
 {
+	block_tuple* block_0;
 	// x [49:21]
 	int _0;
-	block_tuple* block_0;
 	int stage;
 };
 
@@ -85,7 +86,7 @@ bool next(p1_state& state, worldstate& world)
 	{
 		state._0 = state.block_0->_0;
 
-		PLNNR_COROUTINE_YIELD(state);
+		PLNNR_COROUTINE_YIELD(state, 1);
 	}
 
 	PLNNR_COROUTINE_END();
@@ -94,10 +95,10 @@ bool next(p1_state& state, worldstate& world)
 // method mark-block [55:9]
 struct p2_state
 {
-	// x [55:26]
-	int _0;
 	dont_move_tuple* dont_move_0;
 	need_to_move_tuple* need_to_move_1;
+	// x [55:26]
+	int _0;
 	int stage;
 };
 
@@ -125,7 +126,7 @@ bool next(p2_state& state, worldstate& world)
 
 		if (state.need_to_move_1 == 0)
 		{
-			PLNNR_COROUTINE_YIELD(state);
+			PLNNR_COROUTINE_YIELD(state, 1);
 		}
 	}
 
@@ -142,7 +143,7 @@ bool next(p3_state& state, worldstate& world)
 {
 	PLNNR_COROUTINE_BEGIN(state);
 
-	PLNNR_COROUTINE_YIELD(state);
+	PLNNR_COROUTINE_YIELD(state, 1);
 
 	PLNNR_COROUTINE_END();
 }
@@ -150,11 +151,11 @@ bool next(p3_state& state, worldstate& world)
 // method mark-block-recursive [63:9]
 struct p4_state
 {
+	on_tuple* on_0;
 	// x [63:13]
 	int _0;
 	// w [63:15]
 	int _1;
-	on_tuple* on_0;
 	int stage;
 };
 
@@ -171,7 +172,7 @@ bool next(p4_state& state, worldstate& world)
 
 		state._1 = state.on_0->_1;
 
-		PLNNR_COROUTINE_YIELD(state);
+		PLNNR_COROUTINE_YIELD(state, 1);
 	}
 
 	PLNNR_COROUTINE_END();
@@ -187,7 +188,7 @@ bool next(p5_state& state, worldstate& world)
 {
 	PLNNR_COROUTINE_BEGIN(state);
 
-	PLNNR_COROUTINE_YIELD(state);
+	PLNNR_COROUTINE_YIELD(state, 1);
 
 	PLNNR_COROUTINE_END();
 }
@@ -195,14 +196,14 @@ bool next(p5_state& state, worldstate& world)
 // method mark-block-term [71:9]
 struct p6_state
 {
+	on_tuple* on_0;
+	goal_on_tuple* goal_on_1;
 	// x [71:14]
 	int _0;
 	// y [71:16]
 	int _1;
 	// z [71:30]
 	int _2;
-	on_tuple* on_0;
-	goal_on_tuple* goal_on_1;
 	int stage;
 };
 
@@ -230,7 +231,7 @@ bool next(p6_state& state, worldstate& world)
 
 			if (state._1 != state._2)
 			{
-				PLNNR_COROUTINE_YIELD(state);
+				PLNNR_COROUTINE_YIELD(state, 1);
 			}
 		}
 	}
@@ -241,12 +242,12 @@ bool next(p6_state& state, worldstate& world)
 // method mark-block-term [74:9]
 struct p7_state
 {
+	on_table_tuple* on_table_0;
+	goal_on_tuple* goal_on_1;
 	// x [74:20]
 	int _0;
 	// z [74:34]
 	int _1;
-	on_table_tuple* on_table_0;
-	goal_on_tuple* goal_on_1;
 	int stage;
 };
 
@@ -270,8 +271,10 @@ bool next(p7_state& state, worldstate& world)
 
 			state._1 = state.goal_on_1->_1;
 
-			PLNNR_COROUTINE_YIELD(state);
+			PLNNR_COROUTINE_YIELD(state, 1);
+			break;
 		}
+		break;
 	}
 
 	PLNNR_COROUTINE_END();
@@ -280,12 +283,12 @@ bool next(p7_state& state, worldstate& world)
 // method mark-block-term [77:9]
 struct p8_state
 {
+	on_tuple* on_0;
+	goal_on_table_tuple* goal_on_table_1;
 	// x [77:14]
 	int _0;
 	// y [77:16]
 	int _1;
-	on_tuple* on_0;
-	goal_on_table_tuple* goal_on_table_1;
 	int stage;
 };
 
@@ -309,8 +312,10 @@ bool next(p8_state& state, worldstate& world)
 				continue;
 			}
 
-			PLNNR_COROUTINE_YIELD(state);
+			PLNNR_COROUTINE_YIELD(state, 1);
+			break;
 		}
+		break;
 	}
 
 	PLNNR_COROUTINE_END();
@@ -319,12 +324,12 @@ bool next(p8_state& state, worldstate& world)
 // method mark-block-term [80:9]
 struct p9_state
 {
+	on_tuple* on_0;
+	goal_clear_tuple* goal_clear_1;
 	// x [80:14]
 	int _0;
 	// y [80:16]
 	int _1;
-	on_tuple* on_0;
-	goal_clear_tuple* goal_clear_1;
 	int stage;
 };
 
@@ -348,7 +353,8 @@ bool next(p9_state& state, worldstate& world)
 				continue;
 			}
 
-			PLNNR_COROUTINE_YIELD(state);
+			PLNNR_COROUTINE_YIELD(state, 1);
+			break;
 		}
 	}
 
@@ -358,14 +364,14 @@ bool next(p9_state& state, worldstate& world)
 // method mark-block-term [83:9]
 struct p10_state
 {
+	on_tuple* on_0;
+	goal_on_tuple* goal_on_1;
 	// x [83:14]
 	int _0;
 	// z [83:16]
 	int _1;
 	// y [83:28]
 	int _2;
-	on_tuple* on_0;
-	goal_on_tuple* goal_on_1;
 	int stage;
 };
 
@@ -393,7 +399,7 @@ bool next(p10_state& state, worldstate& world)
 
 			if (state._0 != state._2)
 			{
-				PLNNR_COROUTINE_YIELD(state);
+				PLNNR_COROUTINE_YIELD(state, 1);
 			}
 		}
 	}
@@ -404,12 +410,12 @@ bool next(p10_state& state, worldstate& world)
 // method mark-block-term [86:9]
 struct p11_state
 {
+	on_tuple* on_0;
+	need_to_move_tuple* need_to_move_1;
 	// x [86:14]
 	int _0;
 	// w [86:16]
 	int _1;
-	on_tuple* on_0;
-	need_to_move_tuple* need_to_move_1;
 	int stage;
 };
 
@@ -433,7 +439,8 @@ bool next(p11_state& state, worldstate& world)
 				continue;
 			}
 
-			PLNNR_COROUTINE_YIELD(state);
+			PLNNR_COROUTINE_YIELD(state, 1);
+			break;
 		}
 	}
 
@@ -450,7 +457,7 @@ bool next(p12_state& state, worldstate& world)
 {
 	PLNNR_COROUTINE_BEGIN(state);
 
-	PLNNR_COROUTINE_YIELD(state);
+	PLNNR_COROUTINE_YIELD(state, 1);
 
 	PLNNR_COROUTINE_END();
 }
@@ -458,10 +465,10 @@ bool next(p12_state& state, worldstate& world)
 // method find-all-movable [95:13]
 struct p13_state
 {
-	// x [95:21]
-	int _0;
 	clear_tuple* clear_0;
 	need_to_move_tuple* need_to_move_1;
+	// x [95:21]
+	int _0;
 	int stage;
 };
 
@@ -480,7 +487,8 @@ bool next(p13_state& state, worldstate& world)
 				continue;
 			}
 
-			PLNNR_COROUTINE_YIELD(state);
+			PLNNR_COROUTINE_YIELD(state, 1);
+			break;
 		}
 	}
 
@@ -490,10 +498,10 @@ bool next(p13_state& state, worldstate& world)
 // method mark-move-type [101:9]
 struct p14_state
 {
-	// x [101:25]
-	int _0;
 	goal_on_table_tuple* goal_on_table_0;
 	put_on_table_tuple* put_on_table_1;
+	// x [101:25]
+	int _0;
 	int stage;
 };
 
@@ -518,8 +526,9 @@ bool next(p14_state& state, worldstate& world)
 
 		if (state.put_on_table_1 == 0)
 		{
-			PLNNR_COROUTINE_YIELD(state);
+			PLNNR_COROUTINE_YIELD(state, 1);
 		}
+		break;
 	}
 
 	PLNNR_COROUTINE_END();
@@ -528,14 +537,14 @@ bool next(p14_state& state, worldstate& world)
 // method mark-move-type [104:9]
 struct p15_state
 {
-	// x [104:19]
-	int _0;
-	// y [104:21]
-	int _1;
 	goal_on_tuple* goal_on_0;
 	stack_on_block_tuple* stack_on_block_1;
 	dont_move_tuple* dont_move_2;
 	clear_tuple* clear_3;
+	// x [104:19]
+	int _0;
+	// y [104:21]
+	int _1;
 	int stage;
 };
 
@@ -554,12 +563,7 @@ bool next(p15_state& state, worldstate& world)
 
 		for (state.stack_on_block_1 = tuple_list::head<stack_on_block_tuple>(world.atoms[atom_stack_on_block]); state.stack_on_block_1 != 0; state.stack_on_block_1 = state.stack_on_block_1->next)
 		{
-			if (state.stack_on_block_1->_0 == state._0)
-			{
-				break;
-			}
-
-			if (state.stack_on_block_1->_1 == state._1)
+			if (state.stack_on_block_1->_0 == state._0 && state.stack_on_block_1->_1 == state._1)
 			{
 				break;
 			}
@@ -581,8 +585,10 @@ bool next(p15_state& state, worldstate& world)
 						continue;
 					}
 
-					PLNNR_COROUTINE_YIELD(state);
+					PLNNR_COROUTINE_YIELD(state, 1);
+					break;
 				}
+				break;
 			}
 		}
 	}
@@ -600,7 +606,7 @@ bool next(p16_state& state, worldstate& world)
 {
 	PLNNR_COROUTINE_BEGIN(state);
 
-	PLNNR_COROUTINE_YIELD(state);
+	PLNNR_COROUTINE_YIELD(state, 1);
 
 	PLNNR_COROUTINE_END();
 }
@@ -608,11 +614,11 @@ bool next(p16_state& state, worldstate& world)
 // method move-block [112:9]
 struct p17_state
 {
+	stack_on_block_tuple* stack_on_block_0;
 	// x [112:25]
 	int _0;
 	// y [112:27]
 	int _1;
-	stack_on_block_tuple* stack_on_block_0;
 	int stage;
 };
 
@@ -626,7 +632,7 @@ bool next(p17_state& state, worldstate& world)
 
 		state._1 = state.stack_on_block_0->_1;
 
-		PLNNR_COROUTINE_YIELD(state);
+		PLNNR_COROUTINE_YIELD(state, 1);
 	}
 
 	PLNNR_COROUTINE_END();
@@ -635,12 +641,12 @@ bool next(p17_state& state, worldstate& world)
 // method move-block [115:9]
 struct p18_state
 {
+	put_on_table_tuple* put_on_table_0;
+	on_tuple* on_1;
 	// x [115:24]
 	int _0;
 	// y [115:33]
 	int _1;
-	put_on_table_tuple* put_on_table_0;
-	on_tuple* on_1;
 	int stage;
 };
 
@@ -661,7 +667,7 @@ bool next(p18_state& state, worldstate& world)
 
 			state._1 = state.on_1->_1;
 
-			PLNNR_COROUTINE_YIELD(state);
+			PLNNR_COROUTINE_YIELD(state, 1);
 		}
 	}
 
@@ -671,13 +677,13 @@ bool next(p18_state& state, worldstate& world)
 // method move-block [118:9]
 struct p19_state
 {
+	clear_tuple* clear_0;
+	need_to_move_tuple* need_to_move_1;
+	on_tuple* on_2;
 	// x [118:17]
 	int _0;
 	// y [118:43]
 	int _1;
-	clear_tuple* clear_0;
-	need_to_move_tuple* need_to_move_1;
-	on_tuple* on_2;
 	int stage;
 };
 
@@ -705,8 +711,9 @@ bool next(p19_state& state, worldstate& world)
 
 				state._1 = state.on_2->_1;
 
-				PLNNR_COROUTINE_YIELD(state);
+				PLNNR_COROUTINE_YIELD(state, 1);
 			}
+			break;
 		}
 	}
 
@@ -723,7 +730,7 @@ bool next(p20_state& state, worldstate& world)
 {
 	PLNNR_COROUTINE_BEGIN(state);
 
-	PLNNR_COROUTINE_YIELD(state);
+	PLNNR_COROUTINE_YIELD(state, 1);
 
 	PLNNR_COROUTINE_END();
 }
@@ -731,12 +738,12 @@ bool next(p20_state& state, worldstate& world)
 // method check [126:9]
 struct p21_state
 {
+	goal_on_tuple* goal_on_0;
+	clear_tuple* clear_1;
 	// y [126:19]
 	int _0;
 	// x [126:21]
 	int _1;
-	goal_on_tuple* goal_on_0;
-	clear_tuple* clear_1;
 	int stage;
 };
 
@@ -760,7 +767,8 @@ bool next(p21_state& state, worldstate& world)
 				continue;
 			}
 
-			PLNNR_COROUTINE_YIELD(state);
+			PLNNR_COROUTINE_YIELD(state, 1);
+			break;
 		}
 	}
 
@@ -777,7 +785,7 @@ bool next(p22_state& state, worldstate& world)
 {
 	PLNNR_COROUTINE_BEGIN(state);
 
-	PLNNR_COROUTINE_YIELD(state);
+	PLNNR_COROUTINE_YIELD(state, 1);
 
 	PLNNR_COROUTINE_END();
 }
@@ -785,13 +793,13 @@ bool next(p22_state& state, worldstate& world)
 // method check2 [134:9]
 struct p23_state
 {
+	dont_move_tuple* dont_move_0;
+	goal_on_tuple* goal_on_1;
+	clear_tuple* clear_2;
 	// x [134:21]
 	int _0;
 	// y [134:33]
 	int _1;
-	dont_move_tuple* dont_move_0;
-	goal_on_tuple* goal_on_1;
-	clear_tuple* clear_2;
 	int stage;
 };
 
@@ -822,9 +830,11 @@ bool next(p23_state& state, worldstate& world)
 					continue;
 				}
 
-				PLNNR_COROUTINE_YIELD(state);
+				PLNNR_COROUTINE_YIELD(state, 1);
+				break;
 			}
 		}
+		break;
 	}
 
 	PLNNR_COROUTINE_END();
@@ -840,7 +850,7 @@ bool next(p24_state& state, worldstate& world)
 {
 	PLNNR_COROUTINE_BEGIN(state);
 
-	PLNNR_COROUTINE_YIELD(state);
+	PLNNR_COROUTINE_YIELD(state, 1);
 
 	PLNNR_COROUTINE_END();
 }
@@ -848,9 +858,9 @@ bool next(p24_state& state, worldstate& world)
 // method check3 [142:9]
 struct p25_state
 {
+	dont_move_tuple* dont_move_0;
 	// x [142:20]
 	int _0;
-	dont_move_tuple* dont_move_0;
 	int stage;
 };
 
@@ -865,7 +875,8 @@ bool next(p25_state& state, worldstate& world)
 			continue;
 		}
 
-		PLNNR_COROUTINE_YIELD(state);
+		PLNNR_COROUTINE_YIELD(state, 1);
+		break;
 	}
 
 	PLNNR_COROUTINE_END();
@@ -874,13 +885,13 @@ bool next(p25_state& state, worldstate& world)
 // method check3 [145:9]
 struct p26_state
 {
+	goal_on_tuple* goal_on_0;
+	clear_tuple* clear_1;
+	dont_move_tuple* dont_move_2;
 	// x [145:19]
 	int _0;
 	// y [145:21]
 	int _1;
-	goal_on_tuple* goal_on_0;
-	clear_tuple* clear_1;
-	dont_move_tuple* dont_move_2;
 	int stage;
 };
 
@@ -911,8 +922,10 @@ bool next(p26_state& state, worldstate& world)
 					continue;
 				}
 
-				PLNNR_COROUTINE_YIELD(state);
+				PLNNR_COROUTINE_YIELD(state, 1);
+				break;
 			}
+			break;
 		}
 	}
 
@@ -922,9 +935,9 @@ bool next(p26_state& state, worldstate& world)
 // method check3 [148:9]
 struct p27_state
 {
+	goal_on_table_tuple* goal_on_table_0;
 	// x [148:25]
 	int _0;
-	goal_on_table_tuple* goal_on_table_0;
 	int stage;
 };
 
@@ -939,7 +952,8 @@ bool next(p27_state& state, worldstate& world)
 			continue;
 		}
 
-		PLNNR_COROUTINE_YIELD(state);
+		PLNNR_COROUTINE_YIELD(state, 1);
+		break;
 	}
 
 	PLNNR_COROUTINE_END();
@@ -955,7 +969,7 @@ bool next(p28_state& state, worldstate& world)
 {
 	PLNNR_COROUTINE_BEGIN(state);
 
-	PLNNR_COROUTINE_YIELD(state);
+	PLNNR_COROUTINE_YIELD(state, 1);
 
 	PLNNR_COROUTINE_END();
 }
@@ -963,11 +977,11 @@ bool next(p28_state& state, worldstate& world)
 // method move-block1 [156:9]
 struct p29_state
 {
+	on_tuple* on_0;
 	// x [156:13]
 	int _0;
 	// y [156:15]
 	int _1;
-	on_tuple* on_0;
 	int stage;
 };
 
@@ -984,7 +998,7 @@ bool next(p29_state& state, worldstate& world)
 
 		state._1 = state.on_0->_1;
 
-		PLNNR_COROUTINE_YIELD(state);
+		PLNNR_COROUTINE_YIELD(state, 1);
 	}
 
 	PLNNR_COROUTINE_END();
@@ -1000,11 +1014,13 @@ bool next(p30_state& state, worldstate& world)
 {
 	PLNNR_COROUTINE_BEGIN(state);
 
-	PLNNR_COROUTINE_YIELD(state);
+	PLNNR_COROUTINE_YIELD(state, 1);
 
 	PLNNR_COROUTINE_END();
 }
 
+plnnr_static_assert(sizeof(method_instance) + padded_size<p0_state>::value <= max_frame_size);
+
 bool solve_branch_0_expand(method_instance* method, planner_state& pstate, void* world)
 {
 	p0_state* precondition = plnnr::precondition<p0_state>(method);
@@ -1012,43 +1028,45 @@ bool solve_branch_0_expand(method_instance* method, planner_state& pstate, void*
 
 	PLNNR_COROUTINE_BEGIN(*method);
 
+	method->flags |= method_flags_committed;
 	precondition = push_precondition<p0_state>(pstate, method);
 
 	while (next(*precondition, *wstate))
 	{
 		{
-			method_instance* t = push_method(pstate, task_mark_all_blocks, mark_all_blocks_branch_0_expand);
+			method_instance* t = push_method(pstate, task_mark_all_blocks, expand_mark_all_blocks_branch_0);
 		}
 
-		PLNNR_COROUTINE_YIELD(*method);
+		PLNNR_COROUTINE_YIELD(*method, 1);
 
 		if (method->flags & method_flags_failed)
 		{
-			continue;
+			break;
 		}
 
 		{
-			method_instance* t = push_method(pstate, task_find_all_movable, find_all_movable_branch_0_expand);
+			method_instance* t = push_method(pstate, task_find_all_movable, expand_find_all_movable_branch_0);
 		}
 
-		PLNNR_COROUTINE_YIELD(*method);
+		PLNNR_COROUTINE_YIELD(*method, 2);
 
 		if (method->flags & method_flags_failed)
 		{
-			continue;
+			break;
 		}
 
 		{
-			method_instance* t = push_method(pstate, task_move_block, move_block_branch_0_expand);
+			method_instance* t = push_tail_method(pstate, task_move_block, expand_move_block_branch_0);
 		}
 
-		method->flags |= method_flags_expanded;
-		PLNNR_COROUTINE_YIELD(*method);
+		return true;
 	}
 
 	PLNNR_COROUTINE_END();
 }
 
+plnnr_static_assert(sizeof(method_instance) + padded_size<p1_state>::value <= max_frame_size);
+
 bool mark_all_blocks_branch_0_expand(method_instance* method, planner_state& pstate, void* world)
 {
 	p1_state* precondition = plnnr::precondition<p1_state>(method);
@@ -1061,23 +1079,25 @@ bool mark_all_blocks_branch_0_expand(method_instance* method, planner_state& pst
 	while (next(*precondition, *wstate))
 	{
 		{
-			method_instance* t = push_method(pstate, task_mark_block, mark_block_branch_0_expand);
+			method_instance* t = push_method(pstate, task_mark_block, expand_mark_block_branch_0);
 			mark_block_args* a = push_arguments<mark_block_args>(pstate, t);
 			a->_0 = precondition->_0;
 		}
 
-		PLNNR_COROUTINE_YIELD(*method);
+		PLNNR_COROUTINE_YIELD(*method, 1);
 	}
 
 	if (precondition->stage > 0)
 	{
 		method->flags |= method_flags_expanded;
-		PLNNR_COROUTINE_YIELD(*method);
+		PLNNR_COROUTINE_YIELD(*method, 2);
 	}
 
 	PLNNR_COROUTINE_END();
 }
 
+plnnr_static_assert(sizeof(method_instance) + padded_size<mark_block_args>::value + padded_size<p2_state>::value <= max_frame_size);
+
 bool mark_block_branch_0_expand(method_instance* method, planner_state& pstate, void* world)
 {
 	p2_state* precondition = plnnr::precondition<p2_state>(method);
@@ -1092,19 +1112,33 @@ bool mark_block_branch_0_expand(method_instance* method, planner_state& pstate,
 	while (next(*precondition, *wstate))
 	{
 		{
-			method_instance* t = push_method(pstate, task_mark_block_recursive, mark_block_recursive_branch_0_expand);
+			mark_block_recursive_args args;
+			args._0 = method_args->_0;
+			method_instance* t = push_tail_method(pstate, task_mark_block_recursive, expand_mark_block_recursive_branch_0);
 			mark_block_recursive_args* a = push_arguments<mark_block_recursive_args>(pstate, t);
-			a->_0 = method_args->_0;
+			*a = args;
+		}
+
+		if (prev_method(top_method(pstate)) != method)
+		{
+			return true;
 		}
 
 		method->flags |= method_flags_expanded;
-		PLNNR_COROUTINE_YIELD(*method);
+		PLNNR_COROUTINE_YIELD(*method, 1);
+
+		if (method->flags & method_flags_failed)
+		{
+			break;
+		}
 	}
 
-	return expand_next_branch(pstate, mark_block_branch_1_expand, world);
+	return expand_next_branch(pstate, expand_mark_block_branch_1, world);
 	PLNNR_COROUTINE_END();
 }
 
+plnnr_static_assert(sizeof(method_instance) + padded_size<mark_block_args>::value + padded_size<p3_state>::value <= max_frame_size);
+
 bool mark_block_branch_1_expand(method_instance* method, planner_state& pstate, void* world)
 {
 	p3_state* precondition = plnnr::precondition<p3_state>(method);
@@ -1113,17 +1147,20 @@ bool mark_block_branch_1_expand(method_instance* method, planner_state& pstate,
 
 	PLNNR_COROUTINE_BEGIN(*method);
 
+	method->flags |= method_flags_committed;
 	precondition = push_precondition<p3_state>(pstate, method);
 
 	while (next(*precondition, *wstate))
 	{
 		method->flags |= method_flags_expanded;
-		PLNNR_COROUTINE_YIELD(*method);
+		PLNNR_COROUTINE_YIELD(*method, 1);
 	}
 
 	PLNNR_COROUTINE_END();
 }
 
+plnnr_static_assert(sizeof(method_instance) + padded_size<mark_block_recursive_args>::value + padded_size<p4_state>::value <= max_frame_size);
+
 bool mark_block_recursive_branch_0_expand(method_instance* method, planner_state& pstate, void* world)
 {
 	p4_state* precondition = plnnr::precondition<p4_state>(method);
@@ -1138,12 +1175,12 @@ bool mark_block_recursive_branch_0_expand(method_instance* method, planner_state
 	while (next(*precondition, *wstate))
 	{
 		{
-			method_instance* t = push_method(pstate, task_mark_block_recursive, mark_block_recursive_branch_0_expand);
+			method_instance* t = push_method(pstate, task_mark_block_recursive, expand_mark_block_recursive_branch_0);
 			mark_block_recursive_args* a = push_arguments<mark_block_recursive_args>(pstate, t);
 			a->_0 = precondition->_1;
 		}
 
-		PLNNR_COROUTINE_YIELD(*method);
+		PLNNR_COROUTINE_YIELD(*method, 1);
 
 		if (method->flags & method_flags_failed)
 		{
@@ -1151,19 +1188,28 @@ bool mark_block_recursive_branch_0_expand(method_instance* method, planner_state
 		}
 
 		{
-			method_instance* t = push_method(pstate, task_mark_block_term, mark_block_term_branch_0_expand);
+			mark_block_term_args args;
+			args._0 = method_args->_0;
+			method_instance* t = push_tail_method(pstate, task_mark_block_term, expand_mark_block_term_branch_0);
 			mark_block_term_args* a = push_arguments<mark_block_term_args>(pstate, t);
-			a->_0 = method_args->_0;
+			*a = args;
+		}
+
+		if (prev_method(top_method(pstate)) != method)
+		{
+			return true;
 		}
 
 		method->flags |= method_flags_expanded;
-		PLNNR_COROUTINE_YIELD(*method);
+		PLNNR_COROUTINE_YIELD(*method, 2);
 	}
 
-	return expand_next_branch(pstate, mark_block_recursive_branch_1_expand, world);
+	return expand_next_branch(pstate, expand_mark_block_recursive_branch_1, world);
 	PLNNR_COROUTINE_END();
 }
 
+plnnr_static_assert(sizeof(method_instance) + padded_size<mark_block_recursive_args>::value + padded_size<p5_state>::value <= max_frame_size);
+
 bool mark_block_recursive_branch_1_expand(method_instance* method, planner_state& pstate, void* world)
 {
 	p5_state* precondition = plnnr::precondition<p5_state>(method);
@@ -1172,23 +1218,27 @@ bool mark_block_recursive_branch_1_expand(method_instance* method, planner_state
 
 	PLNNR_COROUTINE_BEGIN(*method);
 
+	method->flags |= method_flags_committed;
 	precondition = push_precondition<p5_state>(pstate, method);
 
 	while (next(*precondition, *wstate))
 	{
 		{
-			method_instance* t = push_method(pstate, task_mark_block_term, mark_block_term_branch_0_expand);
+			mark_block_term_args args;
+			args._0 = method_args->_0;
+			method_instance* t = push_tail_method(pstate, task_mark_block_term, expand_mark_block_term_branch_0);
 			mark_block_term_args* a = push_arguments<mark_block_term_args>(pstate, t);
-			a->_0 = method_args->_0;
+			*a = args;
 		}
 
-		method->flags |= method_flags_expanded;
-		PLNNR_COROUTINE_YIELD(*method);
+		return true;
 	}
 
 	PLNNR_COROUTINE_END();
 }
 
+plnnr_static_assert(sizeof(method_instance) + padded_size<mark_block_term_args>::value + padded_size<p6_state>::value <= max_frame_size);
+
 bool mark_block_term_branch_0_expand(method_instance* method, planner_state& pstate, void* world)
 {
 	p6_state* precondition = plnnr::precondition<p6_state>(method);
@@ -1208,19 +1258,22 @@ bool mark_block_term_branch_0_expand(method_instance* method, planner_state& pst
 				need_to_move_tuple* tuple = tuple_list::append<need_to_move_tuple>(list);
 				tuple->_0 = method_args->_0;
 				operator_effect* effect = push<operator_effect>(pstate.journal);
-				effect->tuple = tuple;
-				effect->list = list;
+				effect->tuple = tuple->slot;
+				effect->atom = atom_need_to_move;
+				effect->kind = effect_add;
 			}
 		}
 
 		method->flags |= method_flags_expanded;
-		PLNNR_COROUTINE_YIELD(*method);
+		PLNNR_COROUTINE_YIELD(*method, 1);
 	}
 
-	return expand_next_branch(pstate, mark_block_term_branch_1_expand, world);
+	return expand_next_branch(pstate, expand_mark_block_term_branch_1, world);
 	PLNNR_COROUTINE_END();
 }
 
+plnnr_static_assert(sizeof(method_instance) + padded_size<mark_block_term_args>::value + padded_size<p7_state>::value <= max_frame_size);
+
 bool mark_block_term_branch_1_expand(method_instance* method, planner_state& pstate, void* world)
 {
 	p7_state* precondition = plnnr::precondition<p7_state>(method);
@@ -1240,19 +1293,22 @@ bool mark_block_term_branch_1_expand(method_instance* method, planner_state& pst
 				need_to_move_tuple* tuple = tuple_list::append<need_to_move_tuple>(list);
 				tuple->_0 = method_args->_0;
 				operator_effect* effect = push<operator_effect>(pstate.journal);
-				effect->tuple = tuple;
-				effect->list = list;
+				effect->tuple = tuple->slot;
+				effect->atom = atom_need_to_move;
+				effect->kind = effect_add;
 			}
 		}
 
 		method->flags |= method_flags_expanded;
-		PLNNR_COROUTINE_YIELD(*method);
+		PLNNR_COROUTINE_YIELD(*method, 1);
 	}
 
-	return expand_next_branch(pstate, mark_block_term_branch_2_expand, world);
+	return expand_next_branch(pstate, expand_mark_block_term_branch_2, world);
 	PLNNR_COROUTINE_END();
 }
 
+plnnr_static_assert(sizeof(method_instance) + padded_size<mark_block_term_args>::value + padded_size<p8_state>::value <= max_frame_size);
+
 bool mark_block_term_branch_2_expand(method_instance* method, planner_state& pstate, void* world)
 {
 	p8_state* precondition = plnnr::precondition<p8_state>(method);
@@ -1272,19 +1328,22 @@ bool mark_block_term_branch_2_expand(method_instance* method, planner_state& pst
 				need_to_move_tuple* tuple = tuple_list::append<need_to_move_tuple>(list);
 				tuple->_0 = method_args->_0;
 				operator_effect* effect = push<operator_effect>(pstate.journal);
-				effect->tuple = tuple;
-				effect->list = list;
+				effect->tuple = tuple->slot;
+				effect->atom = atom_need_to_move;
+				effect->kind = effect_add;
 			}
 		}
 
 		method->flags |= method_flags_expanded;
-		PLNNR_COROUTINE_YIELD(*method);
+		PLNNR_COROUTINE_YIELD(*method, 1);
 	}
 
-	return expand_next_branch(pstate, mark_block_term_branch_3_expand, world);
+	return expand_next_branch(pstate, expand_mark_block_term_branch_3, world);
 	PLNNR_COROUTINE_END();
 }
 
+plnnr_static_assert(sizeof(method_instance) + padded_size<mark_block_term_args>::value + padded_size<p9_state>::value <= max_frame_size);
+
 bool mark_block_term_branch_3_expand(method_instance* method, planner_state& pstate, void* world)
 {
 	p9_state* precondition = plnnr::precondition<p9_state>(method);
@@ -1304,19 +1363,22 @@ bool mark_block_term_branch_3_expand(method_instance* method, planner_state& pst
 				need_to_move_tuple* tuple = tuple_list::append<need_to_move_tuple>(list);
 				tuple->_0 = method_args->_0;
 				operator_effect* effect = push<operator_effect>(pstate.journal);
-				effect->tuple = tuple;
-				effect->list = list;
+				effect->tuple = tuple->slot;
+				effect->atom = atom_need_to_move;
+				effect->kind = effect_add;
 			}
 		}
 
 		method->flags |= method_flags_expanded;
-		PLNNR_COROUTINE_YIELD(*method);
+		PLNNR_COROUTINE_YIELD(*method, 1);
 	}
 
-	return expand_next_branch(pstate, mark_block_term_branch_4_expand, world);
+	return expand_next_branch(pstate, expand_mark_block_term_branch_4, world);
 	PLNNR_COROUTINE_END();
 }
 
+plnnr_static_assert(sizeof(method_instance) + padded_size<mark_block_term_args>::value + padded_size<p10_state>::value <= max_frame_size);
+
 bool mark_block_term_branch_4_expand(method_instance* method, planner_state& pstate, void* world)
 {
 	p10_state* precondition = plnnr::precondition<p10_state>(method);
@@ -1336,19 +1398,22 @@ bool mark_block_term_branch_4_expand(method_instance* method, planner_state& pst
 				need_to_move_tuple* tuple = tuple_list::append<need_to_move_tuple>(list);
 				tuple->_0 = method_args->_0;
 				operator_effect* effect = push<operator_effect>(pstate.journal);
-				effect->tuple = tuple;
-				effect->list = list;
+				effect->tuple = tuple->slot;
+				effect->atom = atom_need_to_move;
+				effect->kind = effect_add;
 			}
 		}
 
 		method->flags |= method_flags_expanded;
-		PLNNR_COROUTINE_YIELD(*method);
+		PLNNR_COROUTINE_YIELD(*method, 1);
 	}
 
-	return expand_next_branch(pstate, mark_block_term_branch_5_expand, world);
+	return expand_next_branch(pstate, expand_mark_block_term_branch_5, world);
 	PLNNR_COROUTINE_END();
 }
 
+plnnr_static_assert(sizeof(method_instance) + padded_size<mark_block_term_args>::value + padded_size<p11_state>::value <= max_frame_size);
+
 bool mark_block_term_branch_5_expand(method_instance* method, planner_state& pstate, void* world)
 {
 	p11_state* precondition = plnnr::precondition<p11_state>(method);
@@ -1368,19 +1433,22 @@ bool mark_block_term_branch_5_expand(method_instance* method, planner_state& pst
 				need_to_move_tuple* tuple = tuple_list::append<need_to_move_tuple>(list);
 				tuple->_0 = method_args->_0;
 				operator_effect* effect = push<operator_effect>(pstate.journal);
-				effect->tuple = tuple;
-				effect->list = list;
+				effect->tuple = tuple->slot;
+				effect->atom = atom_need_to_move;
+				effect->kind = effect_add;
 			}
 		}
 
 		method->flags |= method_flags_expanded;
-		PLNNR_COROUTINE_YIELD(*method);
+		PLNNR_COROUTINE_YIELD(*method, 1);
 	}
 
-	return expand_next_branch(pstate, mark_block_term_branch_6_expand, world);
+	return expand_next_branch(pstate, expand_mark_block_term_branch_6, world);
 	PLNNR_COROUTINE_END();
 }
 
+plnnr_static_assert(sizeof(method_instance) + padded_size<mark_block_term_args>::value + padded_size<p12_state>::value <= max_frame_size);
+
 bool mark_block_term_branch_6_expand(method_instance* method, planner_state& pstate, void* world)
 {
 	p12_state* precondition = plnnr::precondition<p12_state>(method);
@@ -1389,6 +1457,7 @@ bool mark_block_term_branch_6_expand(method_instance* method, planner_state& pst
 
 	PLNNR_COROUTINE_BEGIN(*method);
 
+	method->flags |= method_flags_committed;
 	precondition = push_precondition<p12_state>(pstate, method);
 
 	while (next(*precondition, *wstate))
@@ -1399,18 +1468,21 @@ bool mark_block_term_branch_6_expand(method_instance* method, planner_state& pst
 				dont_move_tuple* tuple = tuple_list::append<dont_move_tuple>(list);
 				tuple->_0 = method_args->_0;
 				operator_effect* effect = push<operator_effect>(pstate.journal);
-				effect->tuple = tuple;
-				effect->list = list;
+				effect->tuple = tuple->slot;
+				effect->atom = atom_dont_move;
+				effect->kind = effect_add;
 			}
 		}
 
 		method->flags |= method_flags_expanded;
-		PLNNR_COROUTINE_YIELD(*method);
+		PLNNR_COROUTINE_YIELD(*method, 1);
 	}
 
 	PLNNR_COROUTINE_END();
 }
 
+plnnr_static_assert(sizeof(method_instance) + padded_size<p13_state>::value <= max_frame_size);
+
 bool find_all_movable_branch_0_expand(method_instance* method, planner_state& pstate, void* world)
 {
 	p13_state* precondition = plnnr::precondition<p13_state>(method);
@@ -1423,23 +1495,25 @@ bool find_all_movable_branch_0_expand(method_instance* method, planner_state& ps
 	while (next(*precondition, *wstate))
 	{
 		{
-			method_instance* t = push_method(pstate, task_mark_move_type, mark_move_type_branch_0_expand);
+			method_instance* t = push_method(pstate, task_mark_move_type, expand_mark_move_type_branch_0);
 			mark_move_type_args* a = push_arguments<mark_move_type_args>(pstate, t);
 			a->_0 = precondition->_0;
 		}
 
-		PLNNR_COROUTINE_YIELD(*method);
+		PLNNR_COROUTINE_YIELD(*method, 1);
 	}
 
 	if (precondition->stage > 0)
 	{
 		method->flags |= method_flags_expanded;
-		PLNNR_COROUTINE_YIELD(*method);
+		PLNNR_COROUTINE_YIELD(*method, 2);
 	}
 
 	PLNNR_COROUTINE_END();
 }
 
+plnnr_static_assert(sizeof(method_instance) + padded_size<mark_move_type_args>::value + padded_size<p14_state>::value <= max_frame_size);
+
 bool mark_move_type_branch_0_expand(method_instance* method, planner_state& pstate, void* world)
 {
 	p14_state* precondition = plnnr::precondition<p14_state>(method);
@@ -1459,19 +1533,22 @@ bool mark_move_type_branch_0_expand(method_instance* method, planner_state& psta
 				put_on_table_tuple* tuple = tuple_list::append<put_on_table_tuple>(list);
 				tuple->_0 = method_args->_0;
 				operator_effect* effect = push<operator_effect>(pstate.journal);
-				effect->tuple = tuple;
-				effect->list = list;
+				effect->tuple = tuple->slot;
+				effect->atom = atom_put_on_table;
+				effect->kind = effect_add;
 			}
 		}
 
 		method->flags |= method_flags_expanded;
-		PLNNR_COROUTINE_YIELD(*method);
+		PLNNR_COROUTINE_YIELD(*method, 1);
 	}
 
-	return expand_next_branch(pstate, mark_move_type_branch_1_expand, world);
+	return expand_next_branch(pstate, expand_mark_move_type_branch_1, world);
 	PLNNR_COROUTINE_END();
 }
 
+plnnr_static_assert(sizeof(method_instance) + padded_size<mark_move_type_args>::value + padded_size<p15_state>::value <= max_frame_size);
+
 bool mark_move_type_branch_1_expand(method_instance* method, planner_state& pstate, void* world)
 {
 	p15_state* precondition = plnnr::precondition<p15_state>(method);
@@ -1492,19 +1569,22 @@ bool mark_move_type_branch_1_expand(method_instance* method, planner_state& psta
 				tuple->_0 = method_args->_0;
 				tuple->_1 = precondition->_1;
 				operator_effect* effect = push<operator_effect>(pstate.journal);
-				effect->tuple = tuple;
-				effect->list = list;
+				effect->tuple = tuple->slot;
+				effect->atom = atom_stack_on_block;
+				effect->kind = effect_add;
 			}
 		}
 
 		method->flags |= method_flags_expanded;
-		PLNNR_COROUTINE_YIELD(*method);
+		PLNNR_COROUTINE_YIELD(*method, 1);
 	}
 
-	return expand_next_branch(pstate, mark_move_type_branch_2_expand, world);
+	return expand_next_branch(pstate, expand_mark_move_type_branch_2, world);
 	PLNNR_COROUTINE_END();
 }
 
+plnnr_static_assert(sizeof(method_instance) + padded_size<mark_move_type_args>::value + padded_size<p16_state>::value <= max_frame_size);
+
 bool mark_move_type_branch_2_expand(method_instance* method, planner_state& pstate, void* world)
 {
 	p16_state* precondition = plnnr::precondition<p16_state>(method);
@@ -1513,17 +1593,20 @@ bool mark_move_type_branch_2_expand(method_instance* method, planner_state& psta
 
 	PLNNR_COROUTINE_BEGIN(*method);
 
+	method->flags |= method_flags_committed;
 	precondition = push_precondition<p16_state>(pstate, method);
 
 	while (next(*precondition, *wstate))
 	{
 		method->flags |= method_flags_expanded;
-		PLNNR_COROUTINE_YIELD(*method);
+		PLNNR_COROUTINE_YIELD(*method, 1);
 	}
 
 	PLNNR_COROUTINE_END();
 }
 
+plnnr_static_assert(sizeof(method_instance) + padded_size<p17_state>::value <= max_frame_size);
+
 bool move_block_branch_0_expand(method_instance* method, planner_state& pstate, void* world)
 {
 	p17_state* precondition = plnnr::precondition<p17_state>(method);
@@ -1536,13 +1619,13 @@ bool move_block_branch_0_expand(method_instance* method, planner_state& pstate,
 	while (next(*precondition, *wstate))
 	{
 		{
-			method_instance* t = push_method(pstate, task_move_block1, move_block1_branch_0_expand);
+			method_instance* t = push_method(pstate, task_move_block1, expand_move_block1_branch_0);
 			move_block1_args* a = push_arguments<move_block1_args>(pstate, t);
 			a->_0 = precondition->_0;
 			a->_1 = precondition->_1;
 		}
 
-		PLNNR_COROUTINE_YIELD(*method);
+		PLNNR_COROUTINE_YIELD(*method, 1);
 
 		if (method->flags & method_flags_failed)
 		{
@@ -1550,17 +1633,24 @@ bool move_block_branch_0_expand(method_instance* method, planner_state& pstate,
 		}
 
 		{
-			method_instance* t = push_method(pstate, task_move_block, move_block_branch_0_expand);
+			method_instance* t = push_tail_method(pstate, task_move_block, expand_move_block_branch_0);
+		}
+
+		if (prev_method(top_method(pstate)) != method)
+		{
+			return true;
 		}
 
 		method->flags |= method_flags_expanded;
-		PLNNR_COROUTINE_YIELD(*method);
+		PLNNR_COROUTINE_YIELD(*method, 2);
 	}
 
-	return expand_next_branch(pstate, move_block_branch_1_expand, world);
+	return expand_next_branch(pstate, expand_move_block_branch_1, world);
 	PLNNR_COROUTINE_END();
 }
 
+plnnr_static_assert(sizeof(method_instance) + padded_size<p18_state>::value <= max_frame_size);
+
 bool move_block_branch_1_expand(method_instance* method, planner_state& pstate, void* world)
 {
 	p18_state* precondition = plnnr::precondition<p18_state>(method);
@@ -1573,7 +1663,7 @@ bool move_block_branch_1_expand(method_instance* method, planner_state& pstate,
 	while (next(*precondition, *wstate))
 	{
 		{
-			task_instance* t = push_task(pstate, task_unstack, 0);
+			task_instance* t = push_task(pstate, task_unstack, expand_none);
 			unstack_args* a = push_arguments<unstack_args>(pstate, t);
 			a->_0 = precondition->_0;
 			a->_1 = precondition->_1;
@@ -1587,32 +1677,21 @@ bool move_block_branch_1_expand(method_instance* method, planner_state& pstate,
 
 				tuple_list::handle* list = wstate->atoms[atom_clear];
 				operator_effect* effect = push<operator_effect>(pstate.journal);
-				effect->tuple = tuple;
-				effect->list = list;
+				effect->tuple = tuple->slot;
+				effect->atom = atom_clear;
+				effect->kind = effect_delete;
 				tuple_list::detach(list, tuple);
 
 				break;
 			}
 
-			for (on_tuple* tuple = tuple_list::head<on_tuple>(wstate->atoms[atom_on]); tuple != 0; tuple = tuple->next)
 			{
-				if (tuple->_0 != a->_0)
-				{
-					continue;
-				}
-
-				if (tuple->_1 != a->_1)
-				{
-					continue;
-				}
-
 				tuple_list::handle* list = wstate->atoms[atom_on];
 				operator_effect* effect = push<operator_effect>(pstate.journal);
-				effect->tuple = tuple;
-				effect->list = list;
-				tuple_list::detach(list, tuple);
-
-				break;
+				effect->tuple = precondition->on_1->slot;
+				effect->atom = atom_on;
+				effect->kind = effect_delete;
+				tuple_list::detach(list, precondition->on_1);
 			}
 
 			{
@@ -1620,8 +1699,9 @@ bool move_block_branch_1_expand(method_instance* method, planner_state& pstate,
 				holding_tuple* tuple = tuple_list::append<holding_tuple>(list);
 				tuple->_0 = a->_0;
 				operator_effect* effect = push<operator_effect>(pstate.journal);
-				effect->tuple = tuple;
-				effect->list = list;
+				effect->tuple = tuple->slot;
+				effect->atom = atom_holding;
+				effect->kind = effect_add;
 			}
 
 			{
@@ -1629,15 +1709,16 @@ bool move_block_branch_1_expand(method_instance* method, planner_state& pstate,
 				clear_tuple* tuple = tuple_list::append<clear_tuple>(list);
 				tuple->_0 = a->_1;
 				operator_effect* effect = push<operator_effect>(pstate.journal);
-				effect->tuple = tuple;
-				effect->list = list;
+				effect->tuple = tuple->slot;
+				effect->atom = atom_clear;
+				effect->kind = effect_add;
 			}
 		}
 
-		PLNNR_COROUTINE_YIELD(*method);
+		PLNNR_COROUTINE_YIELD(*method, 1);
 
 		{
-			task_instance* t = push_task(pstate, task_putdown, 0);
+			task_instance* t = push_task(pstate, task_putdown, expand_none);
 			putdown_args* a = push_arguments<putdown_args>(pstate, t);
 			a->_0 = precondition->_0;
 
@@ -1650,8 +1731,9 @@ bool move_block_branch_1_expand(method_instance* method, planner_state& pstate,
 
 				tuple_list::handle* list = wstate->atoms[atom_holding];
 				operator_effect* effect = push<operator_effect>(pstate.journal);
-				effect->tuple = tuple;
-				effect->list = list;
+				effect->tuple = tuple->slot;
+				effect->atom = atom_holding;
+				effect->kind = effect_delete;
 				tuple_list::detach(list, tuple);
 
 				break;
@@ -1662,8 +1744,9 @@ bool move_block_branch_1_expand(method_instance* method, planner_state& pstate,
 				on_table_tuple* tuple = tuple_list::append<on_table_tuple>(list);
 				tuple->_0 = a->_0;
 				operator_effect* effect = push<operator_effect>(pstate.journal);
-				effect->tuple = tuple;
-				effect->list = list;
+				effect->tuple = tuple->slot;
+				effect->atom = atom_on_table;
+				effect->kind = effect_add;
 			}
 
 			{
@@ -1671,12 +1754,13 @@ bool move_block_branch_1_expand(method_instance* method, planner_state& pstate,
 				clear_tuple* tuple = tuple_list::append<clear_tuple>(list);
 				tuple->_0 = a->_0;
 				operator_effect* effect = push<operator_effect>(pstate.journal);
-				effect->tuple = tuple;
-				effect->list = list;
+				effect->tuple = tuple->slot;
+				effect->atom = atom_clear;
+				effect->kind = effect_add;
 			}
 		}
 
-		PLNNR_COROUTINE_YIELD(*method);
+		PLNNR_COROUTINE_YIELD(*method, 2);
 
 		{
 			{
@@ -1684,8 +1768,9 @@ bool move_block_branch_1_expand(method_instance* method, planner_state& pstate,
 				dont_move_tuple* tuple = tuple_list::append<dont_move_tuple>(list);
 				tuple->_0 = precondition->_0;
 				operator_effect* effect = push<operator_effect>(pstate.journal);
-				effect->tuple = tuple;
-				effect->list = list;
+				effect->tuple = tuple->slot;
+				effect->atom = atom_dont_move;
+				effect->kind = effect_add;
 			}
 		}
 
@@ -1699,37 +1784,31 @@ bool move_block_branch_1_expand(method_instance* method, planner_state& pstate,
 
 				tuple_list::handle* list = wstate->atoms[atom_need_to_move];
 				operator_effect* effect = push<operator_effect>(pstate.journal);
-				effect->tuple = tuple;
-				effect->list = list;
+				effect->tuple = tuple->slot;
+				effect->atom = atom_need_to_move;
+				effect->kind = effect_delete;
 				tuple_list::detach(list, tuple);
 
 				break;
 			}
 
-			for (put_on_table_tuple* tuple = tuple_list::head<put_on_table_tuple>(wstate->atoms[atom_put_on_table]); tuple != 0; tuple = tuple->next)
 			{
-				if (tuple->_0 != precondition->_0)
-				{
-					continue;
-				}
-
 				tuple_list::handle* list = wstate->atoms[atom_put_on_table];
 				operator_effect* effect = push<operator_effect>(pstate.journal);
-				effect->tuple = tuple;
-				effect->list = list;
-				tuple_list::detach(list, tuple);
-
-				break;
+				effect->tuple = precondition->put_on_table_0->slot;
+				effect->atom = atom_put_on_table;
+				effect->kind = effect_delete;
+				tuple_list::detach(list, precondition->put_on_table_0);
 			}
 		}
 
 		{
-			method_instance* t = push_method(pstate, task_check, check_branch_0_expand);
+			method_instance* t = push_method(pstate, task_check, expand_check_branch_0);
 			check_args* a = push_arguments<check_args>(pstate, t);
 			a->_0 = precondition->_0;
 		}
 
-		PLNNR_COROUTINE_YIELD(*method);
+		PLNNR_COROUTINE_YIELD(*method, 3);
 
 		if (method->flags & method_flags_failed)
 		{
@@ -1737,12 +1816,12 @@ bool move_block_branch_1_expand(method_instance* method, planner_state& pstate,
 		}
 
 		{
-			method_instance* t = push_method(pstate, task_check2, check2_branch_0_expand);
+			method_instance* t = push_method(pstate, task_check2, expand_check2_branch_0);
 			check2_args* a = push_arguments<check2_args>(pstate, t);
 			a->_0 = precondition->_1;
 		}
 
-		PLNNR_COROUTINE_YIELD(*method);
+		PLNNR_COROUTINE_YIELD(*method, 4);
 
 		if (method->flags & method_flags_failed)
 		{
@@ -1750,12 +1829,12 @@ bool move_block_branch_1_expand(method_instance* method, planner_state& pstate,
 		}
 
 		{
-			method_instance* t = push_method(pstate, task_check3, check3_branch_0_expand);
+			method_instance* t = push_method(pstate, task_check3, expand_check3_branch_0);
 			check3_args* a = push_arguments<check3_args>(pstate, t);
 			a->_0 = precondition->_1;
 		}
 
-		PLNNR_COROUTINE_YIELD(*method);
+		PLNNR_COROUTINE_YIELD(*method, 5);
 
 		if (method->flags & method_flags_failed)
 		{
@@ -1763,17 +1842,24 @@ bool move_block_branch_1_expand(method_instance* method, planner_state& pstate,
 		}
 
 		{
-			method_instance* t = push_method(pstate, task_move_block, move_block_branch_0_expand);
+			method_instance* t = push_tail_method(pstate, task_move_block, expand_move_block_branch_0);
+		}
+
+		if (prev_method(top_method(pstate)) != method)
+		{
+			return true;
 		}
 
 		method->flags |= method_flags_expanded;
-		PLNNR_COROUTINE_YIELD(*method);
+		PLNNR_COROUTINE_YIELD(*method, 6);
 	}
 
-	return expand_next_branch(pstate, move_block_branch_2_expand, world);
+	return expand_next_branch(pstate, expand_move_block_branch_2, world);
 	PLNNR_COROUTINE_END();
 }
 
+plnnr_static_assert(sizeof(method_instance) + padded_size<p19_state>::value <= max_frame_size);
+
 bool move_block_branch_2_expand(method_instance* method, planner_state& pstate, void* world)
 {
 	p19_state* precondition = plnnr::precondition<p19_state>(method);
@@ -1786,46 +1872,27 @@ bool move_block_branch_2_expand(method_instance* method, planner_state& pstate,
 	while (next(*precondition, *wstate))
 	{
 		{
-			task_instance* t = push_task(pstate, task_unstack, 0);
+			task_instance* t = push_task(pstate, task_unstack, expand_none);
 			unstack_args* a = push_arguments<unstack_args>(pstate, t);
 			a->_0 = precondition->_0;
 			a->_1 = precondition->_1;
 
-			for (clear_tuple* tuple = tuple_list::head<clear_tuple>(wstate->atoms[atom_clear]); tuple != 0; tuple = tuple->next)
 			{
-				if (tuple->_0 != a->_0)
-				{
-					continue;
-				}
-
 				tuple_list::handle* list = wstate->atoms[atom_clear];
 				operator_effect* effect = push<operator_effect>(pstate.journal);
-				effect->tuple = tuple;
-				effect->list = list;
-				tuple_list::detach(list, tuple);
-
-				break;
+				effect->tuple = precondition->clear_0->slot;
+				effect->atom = atom_clear;
+				effect->kind = effect_delete;
+				tuple_list::detach(list, precondition->clear_0);
 			}
 
-			for (on_tuple* tuple = tuple_list::head<on_tuple>(wstate->atoms[atom_on]); tuple != 0; tuple = tuple->next)
 			{
-				if (tuple->_0 != a->_0)
-				{
-					continue;
-				}
-
-				if (tuple->_1 != a->_1)
-				{
-					continue;
-				}
-
 				tuple_list::handle* list = wstate->atoms[atom_on];
 				operator_effect* effect = push<operator_effect>(pstate.journal);
-				effect->tuple = tuple;
-				effect->list = list;
-				tuple_list::detach(list, tuple);
-
-				break;
+				effect->tuple = precondition->on_2->slot;
+				effect->atom = atom_on;
+				effect->kind = effect_delete;
+				tuple_list::detach(list, precondition->on_2);
 			}
 
 			{
@@ -1833,8 +1900,9 @@ bool move_block_branch_2_expand(method_instance* method, planner_state& pstate,
 				holding_tuple* tuple = tuple_list::append<holding_tuple>(list);
 				tuple->_0 = a->_0;
 				operator_effect* effect = push<operator_effect>(pstate.journal);
-				effect->tuple = tuple;
-				effect->list = list;
+				effect->tuple = tuple->slot;
+				effect->atom = atom_holding;
+				effect->kind = effect_add;
 			}
 
 			{
@@ -1842,15 +1910,16 @@ bool move_block_branch_2_expand(method_instance* method, planner_state& pstate,
 				clear_tuple* tuple = tuple_list::append<clear_tuple>(list);
 				tuple->_0 = a->_1;
 				operator_effect* effect = push<operator_effect>(pstate.journal);
-				effect->tuple = tuple;
-				effect->list = list;
+				effect->tuple = tuple->slot;
+				effect->atom = atom_clear;
+				effect->kind = effect_add;
 			}
 		}
 
-		PLNNR_COROUTINE_YIELD(*method);
+		PLNNR_COROUTINE_YIELD(*method, 1);
 
 		{
-			task_instance* t = push_task(pstate, task_putdown, 0);
+			task_instance* t = push_task(pstate, task_putdown, expand_none);
 			putdown_args* a = push_arguments<putdown_args>(pstate, t);
 			a->_0 = precondition->_0;
 
@@ -1863,8 +1932,9 @@ bool move_block_branch_2_expand(method_instance* method, planner_state& pstate,
 
 				tuple_list::handle* list = wstate->atoms[atom_holding];
 				operator_effect* effect = push<operator_effect>(pstate.journal);
-				effect->tuple = tuple;
-				effect->list = list;
+				effect->tuple = tuple->slot;
+				effect->atom = atom_holding;
+				effect->kind = effect_delete;
 				tuple_list::detach(list, tuple);
 
 				break;
@@ -1875,8 +1945,9 @@ bool move_block_branch_2_expand(method_instance* method, planner_state& pstate,
 				on_table_tuple* tuple = tuple_list::append<on_table_tuple>(list);
 				tuple->_0 = a->_0;
 				operator_effect* effect = push<operator_effect>(pstate.journal);
-				effect->tuple = tuple;
-				effect->list = list;
+				effect->tuple = tuple->slot;
+				effect->atom = atom_on_table;
+				effect->kind = effect_add;
 			}
 
 			{
@@ -1884,20 +1955,21 @@ bool move_block_branch_2_expand(method_instance* method, planner_state& pstate,
 				clear_tuple* tuple = tuple_list::append<clear_tuple>(list);
 				tuple->_0 = a->_0;
 				operator_effect* effect = push<operator_effect>(pstate.journal);
-				effect->tuple = tuple;
-				effect->list = list;
+				effect->tuple = tuple->slot;
+				effect->atom = atom_clear;
+				effect->kind = effect_add;
 			}
 		}
 
-		PLNNR_COROUTINE_YIELD(*method);
+		PLNNR_COROUTINE_YIELD(*method, 2);
 
 		{
-			method_instance* t = push_method(pstate, task_check2, check2_branch_0_expand);
+			method_instance* t = push_method(pstate, task_check2, expand_check2_branch_0);
 			check2_args* a = push_arguments<check2_args>(pstate, t);
 			a->_0 = precondition->_1;
 		}
 
-		PLNNR_COROUTINE_YIELD(*method);
+		PLNNR_COROUTINE_YIELD(*method, 3);
 
 		if (method->flags & method_flags_failed)
 		{
@@ -1905,12 +1977,12 @@ bool move_block_branch_2_expand(method_instance* method, planner_state& pstate,
 		}
 
 		{
-			method_instance* t = push_method(pstate, task_check3, check3_branch_0_expand);
+			method_instance* t = push_method(pstate, task_check3, expand_check3_branch_0);
 			check3_args* a = push_arguments<check3_args>(pstate, t);
 			a->_0 = precondition->_1;
 		}
 
-		PLNNR_COROUTINE_YIELD(*method);
+		PLNNR_COROUTINE_YIELD(*method, 4);
 
 		if (method->flags & method_flags_failed)
 		{
@@ -1918,17 +1990,24 @@ bool move_block_branch_2_expand(method_instance* method, planner_state& pstate,
 		}
 
 		{
-			method_instance* t = push_method(pstate, task_move_block, move_block_branch_0_expand);
+			method_instance* t = push_tail_method(pstate, task_move_block, expand_move_block_branch_0);
+		}
+
+		if (prev_method(top_method(pstate)) != method)
+		{
+			return true;
 		}
 
 		method->flags |= method_flags_expanded;
-		PLNNR_COROUTINE_YIELD(*method);
+		PLNNR_COROUTINE_YIELD(*method, 5);
 	}
 
-	return expand_next_branch(pstate, move_block_branch_3_expand, world);
+	return expand_next_branch(pstate, expand_move_block_branch_3, world);
 	PLNNR_COROUTINE_END();
 }
 
+plnnr_static_assert(sizeof(method_instance) + padded_size<p20_state>::value <= max_frame_size);
+
 bool move_block_branch_3_expand(method_instance* method, planner_state& pstate, void* world)
 {
 	p20_state* precondition = plnnr::precondition<p20_state>(method);
@@ -1936,17 +2015,20 @@ bool move_block_branch_3_expand(method_instance* method, planner_state& pstate,
 
 	PLNNR_COROUTINE_BEGIN(*method);
 
+	method->flags |= method_flags_committed;
 	precondition = push_precondition<p20_state>(pstate, method);
 
 	while (next(*precondition, *wstate))
 	{
 		method->flags |= method_flags_expanded;
-		PLNNR_COROUTINE_YIELD(*method);
+		PLNNR_COROUTINE_YIELD(*method, 1);
 	}
 
 	PLNNR_COROUTINE_END();
 }
 
+plnnr_static_assert(sizeof(method_instance) + padded_size<check_args>::value + padded_size<p21_state>::value <= max_frame_size);
+
 bool check_branch_0_expand(method_instance* method, planner_state& pstate, void* world)
 {
 	p21_state* precondition = plnnr::precondition<p21_state>(method);
@@ -1967,19 +2049,22 @@ bool check_branch_0_expand(method_instance* method, planner_state& pstate, void*
 				tuple->_0 = precondition->_0;
 				tuple->_1 = method_args->_0;
 				operator_effect* effect = push<operator_effect>(pstate.journal);
-				effect->tuple = tuple;
-				effect->list = list;
+				effect->tuple = tuple->slot;
+				effect->atom = atom_stack_on_block;
+				effect->kind = effect_add;
 			}
 		}
 
 		method->flags |= method_flags_expanded;
-		PLNNR_COROUTINE_YIELD(*method);
+		PLNNR_COROUTINE_YIELD(*method, 1);
 	}
 
-	return expand_next_branch(pstate, check_branch_1_expand, world);
+	return expand_next_branch(pstate, expand_check_branch_1, world);
 	PLNNR_COROUTINE_END();
 }
 
+plnnr_static_assert(sizeof(method_instance) + padded_size<check_args>::value + padded_size<p22_state>::value <= max_frame_size);
+
 bool check_branch_1_expand(method_instance* method, planner_state& pstate, void* world)
 {
 	p22_state* precondition = plnnr::precondition<p22_state>(method);
@@ -1988,17 +2073,20 @@ bool check_branch_1_expand(method_instance* method, planner_state& pstate, void*
 
 	PLNNR_COROUTINE_BEGIN(*method);
 
+	method->flags |= method_flags_committed;
 	precondition = push_precondition<p22_state>(pstate, method);
 
 	while (next(*precondition, *wstate))
 	{
 		method->flags |= method_flags_expanded;
-		PLNNR_COROUTINE_YIELD(*method);
+		PLNNR_COROUTINE_YIELD(*method, 1);
 	}
 
 	PLNNR_COROUTINE_END();
 }
 
+plnnr_static_assert(sizeof(method_instance) + padded_size<check2_args>::value + padded_size<p23_state>::value <= max_frame_size);
+
 bool check2_branch_0_expand(method_instance* method, planner_state& pstate, void* world)
 {
 	p23_state* precondition = plnnr::precondition<p23_state>(method);
@@ -2019,19 +2107,22 @@ bool check2_branch_0_expand(method_instance* method, planner_state& pstate, void
 				tuple->_0 = precondition->_1;
 				tuple->_1 = method_args->_0;
 				operator_effect* effect = push<operator_effect>(pstate.journal);
-				effect->tuple = tuple;
-				effect->list = list;
+				effect->tuple = tuple->slot;
+				effect->atom = atom_stack_on_block;
+				effect->kind = effect_add;
 			}
 		}
 
 		method->flags |= method_flags_expanded;
-		PLNNR_COROUTINE_YIELD(*method);
+		PLNNR_COROUTINE_YIELD(*method, 1);
 	}
 
-	return expand_next_branch(pstate, check2_branch_1_expand, world);
+	return expand_next_branch(pstate, expand_check2_branch_1, world);
 	PLNNR_COROUTINE_END();
 }
 
+plnnr_static_assert(sizeof(method_instance) + padded_size<check2_args>::value + padded_size<p24_state>::value <= max_frame_size);
+
 bool check2_branch_1_expand(method_instance* method, planner_state& pstate, void* world)
 {
 	p24_state* precondition = plnnr::precondition<p24_state>(method);
@@ -2040,17 +2131,20 @@ bool check2_branch_1_expand(method_instance* method, planner_state& pstate, void
 
 	PLNNR_COROUTINE_BEGIN(*method);
 
+	method->flags |= method_flags_committed;
 	precondition = push_precondition<p24_state>(pstate, method);
 
 	while (next(*precondition, *wstate))
 	{
 		method->flags |= method_flags_expanded;
-		PLNNR_COROUTINE_YIELD(*method);
+		PLNNR_COROUTINE_YIELD(*method, 1);
 	}
 
 	PLNNR_COROUTINE_END();
 }
 
+plnnr_static_assert(sizeof(method_instance) + padded_size<check3_args>::value + padded_size<p25_state>::value <= max_frame_size);
+
 bool check3_branch_0_expand(method_instance* method, planner_state& pstate, void* world)
 {
 	p25_state* precondition = plnnr::precondition<p25_state>(method);
@@ -2065,13 +2159,15 @@ bool check3_branch_0_expand(method_instance* method, planner_state& pstate, void
 	while (next(*precondition, *wstate))
 	{
 		method->flags |= method_flags_expanded;
-		PLNNR_COROUTINE_YIELD(*method);
+		PLNNR_COROUTINE_YIELD(*method, 1);
 	}
 
-	return expand_next_branch(pstate, check3_branch_1_expand, world);
+	return expand_next_branch(pstate, expand_check3_branch_1, world);
 	PLNNR_COROUTINE_END();
 }
 
+plnnr_static_assert(sizeof(method_instance) + padded_size<check3_args>::value + padded_size<p26_state>::value <= max_frame_size);
+
 bool check3_branch_1_expand(method_instance* method, planner_state& pstate, void* world)
 {
 	p26_state* precondition = plnnr::precondition<p26_state>(method);
@@ -2092,19 +2188,22 @@ bool check3_branch_1_expand(method_instance* method, planner_state& pstate, void
 				tuple->_0 = method_args->_0;
 				tuple->_1 = precondition->_1;
 				operator_effect* effect = push<operator_effect>(pstate.journal);
-				effect->tuple = tuple;
-				effect->list = list;
+				effect->tuple = tuple->slot;
+				effect->atom = atom_stack_on_block;
+				effect->kind = effect_add;
 			}
 		}
 
 		method->flags |= method_flags_expanded;
-		PLNNR_COROUTINE_YIELD(*method);
+		PLNNR_COROUTINE_YIELD(*method, 1);
 	}
 
-	return expand_next_branch(pstate, check3_branch_2_expand, world);
+	return expand_next_branch(pstate, expand_check3_branch_2, world);
 	PLNNR_COROUTINE_END();
 }
 
+plnnr_static_assert(sizeof(method_instance) + padded_size<check3_args>::value + padded_size<p27_state>::value <= max_frame_size);
+
 bool check3_branch_2_expand(method_instance* method, planner_state& pstate, void* world)
 {
 	p27_state* precondition = plnnr::precondition<p27_state>(method);
@@ -2124,19 +2223,22 @@ bool check3_branch_2_expand(method_instance* method, planner_state& pstate, void
 				put_on_table_tuple* tuple = tuple_list::append<put_on_table_tuple>(list);
 				tuple->_0 = method_args->_0;
 				operator_effect* effect = push<operator_effect>(pstate.journal);
-				effect->tuple = tuple;
-				effect->list = list;
+				effect->tuple = tuple->slot;
+				effect->atom = atom_put_on_table;
+				effect->kind = effect_add;
 			}
 		}
 
 		method->flags |= method_flags_expanded;
-		PLNNR_COROUTINE_YIELD(*method);
+		PLNNR_COROUTINE_YIELD(*method, 1);
 	}
 
-	return expand_next_branch(pstate, check3_branch_3_expand, world);
+	return expand_next_branch(pstate, expand_check3_branch_3, world);
 	PLNNR_COROUTINE_END();
 }
 
+plnnr_static_assert(sizeof(method_instance) + padded_size<check3_args>::value + padded_size<p28_state>::value <= max_frame_size);
+
 bool check3_branch_3_expand(method_instance* method, planner_state& pstate, void* world)
 {
 	p28_state* precondition = plnnr::precondition<p28_state>(method);
@@ -2145,17 +2247,20 @@ bool check3_branch_3_expand(method_instance* method, planner_state& pstate, void
 
 	PLNNR_COROUTINE_BEGIN(*method);
 
+	method->flags |= method_flags_committed;
 	precondition = push_precondition<p28_state>(pstate, method);
 
 	while (next(*precondition, *wstate))
 	{
 		method->flags |= method_flags_expanded;
-		PLNNR_COROUTINE_YIELD(*method);
+		PLNNR_COROUTINE_YIELD(*method, 1);
 	}
 
 	PLNNR_COROUTINE_END();
 }
 
+plnnr_static_assert(sizeof(method_instance) + padded_size<move_block1_args>::value + padded_size<p29_state>::value <= max_frame_size);
+
 bool move_block1_branch_0_expand(method_instance* method, planner_state& pstate, void* world)
 {
 	p29_state* precondition = plnnr::precondition<p29_state>(method);
@@ -2170,7 +2275,7 @@ bool move_block1_branch_0_expand(method_instance* method, planner_state& pstate,
 	while (next(*precondition, *wstate))
 	{
 		{
-			task_instance* t = push_task(pstate, task_unstack, 0);
+			task_instance* t = push_task(pstate, task_unstack, expand_none);
 			unstack_args* a = push_arguments<unstack_args>(pstate, t);
 			a->_0 = method_args->_0;
 			a->_1 = precondition->_1;
@@ -2184,32 +2289,21 @@ bool move_block1_branch_0_expand(method_instance* method, planner_state& pstate,
 
 				tuple_list::handle* list = wstate->atoms[atom_clear];
 				operator_effect* effect = push<operator_effect>(pstate.journal);
-				effect->tuple = tuple;
-				effect->list = list;
+				effect->tuple = tuple->slot;
+				effect->atom = atom_clear;
+				effect->kind = effect_delete;
 				tuple_list::detach(list, tuple);
 
 				break;
 			}
 
-			for (on_tuple* tuple = tuple_list::head<on_tuple>(wstate->atoms[atom_on]); tuple != 0; tuple = tuple->next)
 			{
-				if (tuple->_0 != a->_0)
-				{
-					continue;
-				}
-
-				if (tuple->_1 != a->_1)
-				{
-					continue;
-				}
-
 				tuple_list::handle* list = wstate->atoms[atom_on];
 				operator_effect* effect = push<operator_effect>(pstate.journal);
-				effect->tuple = tuple;
-				effect->list = list;
-				tuple_list::detach(list, tuple);
-
-				break;
+				effect->tuple = precondition->on_0->slot;
+				effect->atom = atom_on;
+				effect->kind = effect_delete;
+				tuple_list::detach(list, precondition->on_0);
 			}
 
 			{
@@ -2217,8 +2311,9 @@ bool move_block1_branch_0_expand(method_instance* method, planner_state& pstate,
 				holding_tuple* tuple = tuple_list::append<holding_tuple>(list);
 				tuple->_0 = a->_0;
 				operator_effect* effect = push<operator_effect>(pstate.journal);
-				effect->tuple = tuple;
-				effect->list = list;
+				effect->tuple = tuple->slot;
+				effect->atom = atom_holding;
+				effect->kind = effect_add;
 			}
 
 			{
@@ -2226,15 +2321,16 @@ bool move_block1_branch_0_expand(method_instance* method, planner_state& pstate,
 				clear_tuple* tuple = tuple_list::append<clear_tuple>(list);
 				tuple->_0 = a->_1;
 				operator_effect* effect = push<operator_effect>(pstate.journal);
-				effect->tuple = tuple;
-				effect->list = list;
+				effect->tuple = tuple->slot;
+				effect->atom = atom_clear;
+				effect->kind = effect_add;
 			}
 		}
 
-		PLNNR_COROUTINE_YIELD(*method);
+		PLNNR_COROUTINE_YIELD(*method, 1);
 
 		{
-			task_instance* t = push_task(pstate, task_stack, 0);
+			task_instance* t = push_task(pstate, task_stack, expand_none);
 			stack_args* a = push_arguments<stack_args>(pstate, t);
 			a->_0 = method_args->_0;
 			a->_1 = method_args->_1;
@@ -2248,8 +2344,9 @@ bool move_block1_branch_0_expand(method_instance* method, planner_state& pstate,
 
 				tuple_list::handle* list = wstate->atoms[atom_holding];
 				operator_effect* effect = push<operator_effect>(pstate.journal);
-				effect->tuple = tuple;
-				effect->list = list;
+				effect->tuple = tuple->slot;
+				effect->atom = atom_holding;
+				effect->kind = effect_delete;
 				tuple_list::detach(list, tuple);
 
 				break;
@@ -2264,8 +2361,9 @@ bool move_block1_branch_0_expand(method_instance* method, planner_state& pstate,
 
 				tuple_list::handle* list = wstate->atoms[atom_clear];
 				operator_effect* effect = push<operator_effect>(pstate.journal);
-				effect->tuple = tuple;
-				effect->list = list;
+				effect->tuple = tuple->slot;
+				effect->atom = atom_clear;
+				effect->kind = effect_delete;
 				tuple_list::detach(list, tuple);
 
 				break;
@@ -2277,8 +2375,9 @@ bool move_block1_branch_0_expand(method_instance* method, planner_state& pstate,
 				tuple->_0 = a->_0;
 				tuple->_1 = a->_1;
 				operator_effect* effect = push<operator_effect>(pstate.journal);
-				effect->tuple = tuple;
-				effect->list = list;
+				effect->tuple = tuple->slot;
+				effect->atom = atom_on;
+				effect->kind = effect_add;
 			}
 
 			{
@@ -2286,12 +2385,13 @@ bool move_block1_branch_0_expand(method_instance* method, planner_state& pstate,
 				clear_tuple* tuple = tuple_list::append<clear_tuple>(list);
 				tuple->_0 = a->_0;
 				operator_effect* effect = push<operator_effect>(pstate.journal);
-				effect->tuple = tuple;
-				effect->list = list;
+				effect->tuple = tuple->slot;
+				effect->atom = atom_clear;
+				effect->kind = effect_add;
 			}
 		}
 
-		PLNNR_COROUTINE_YIELD(*method);
+		PLNNR_COROUTINE_YIELD(*method, 2);
 
 		{
 			{
@@ -2299,8 +2399,9 @@ bool move_block1_branch_0_expand(method_instance* method, planner_state& pstate,
 				dont_move_tuple* tuple = tuple_list::append<dont_move_tuple>(list);
 				tuple->_0 = method_args->_0;
 				operator_effect* effect = push<operator_effect>(pstate.journal);
-				effect->tuple = tuple;
-				effect->list = list;
+				effect->tuple = tuple->slot;
+				effect->atom = atom_dont_move;
+				effect->kind = effect_add;
 			}
 		}
 
@@ -2314,8 +2415,9 @@ bool move_block1_branch_0_expand(method_instance* method, planner_state& pstate,
 
 				tuple_list::handle* list = wstate->atoms[atom_need_to_move];
 				operator_effect* effect = push<operator_effect>(pstate.journal);
-				effect->tuple = tuple;
-				effect->list = list;
+				effect->tuple = tuple->slot;
+				effect->atom = atom_need_to_move;
+				effect->kind = effect_delete;
 				tuple_list::detach(list, tuple);
 
 				break;
@@ -2335,8 +2437,9 @@ bool move_block1_branch_0_expand(method_instance* method, planner_state& pstate,
 
 				tuple_list::handle* list = wstate->atoms[atom_stack_on_block];
 				operator_effect* effect = push<operator_effect>(pstate.journal);
-				effect->tuple = tuple;
-				effect->list = list;
+				effect->tuple = tuple->slot;
+				effect->atom = atom_stack_on_block;
+				effect->kind = effect_delete;
 				tuple_list::detach(list, tuple);
 
 				break;
@@ -2344,12 +2447,12 @@ bool move_block1_branch_0_expand(method_instance* method, planner_state& pstate,
 		}
 
 		{
-			method_instance* t = push_method(pstate, task_check, check_branch_0_expand);
+			method_instance* t = push_method(pstate, task_check, expand_check_branch_0);
 			check_args* a = push_arguments<check_args>(pstate, t);
 			a->_0 = method_args->_0;
 		}
 
-		PLNNR_COROUTINE_YIELD(*method);
+		PLNNR_COROUTINE_YIELD(*method, 3);
 
 		if (method->flags & method_flags_failed)
 		{
@@ -2357,12 +2460,12 @@ bool move_block1_branch_0_expand(method_instance* method, planner_state& pstate,
 		}
 
 		{
-			method_instance* t = push_method(pstate, task_check2, check2_branch_0_expand);
+			method_instance* t = push_method(pstate, task_check2, expand_check2_branch_0);
 			check2_args* a = push_arguments<check2_args>(pstate, t);
 			a->_0 = precondition->_1;
 		}
 
-		PLNNR_COROUTINE_YIELD(*method);
+		PLNNR_COROUTINE_YIELD(*method, 4);
 
 		if (method->flags & method_flags_failed)
 		{
@@ -2370,19 +2473,28 @@ bool move_block1_branch_0_expand(method_instance* method, planner_state& pstate,
 		}
 
 		{
-			method_instance* t = push_method(pstate, task_check3, check3_branch_0_expand);
+			check3_args args;
+			args._0 = precondition->_1;
+			method_instance* t = push_tail_method(pstate, task_check3, expand_check3_branch_0);
 			check3_args* a = push_arguments<check3_args>(pstate, t);
-			a->_0 = precondition->_1;
+			*a = args;
+		}
+
+		if (prev_method(top_method(pstate)) != method)
+		{
+			return true;
 		}
 
 		method->flags |= method_flags_expanded;
-		PLNNR_COROUTINE_YIELD(*method);
+		PLNNR_COROUTINE_YIELD(*method, 5);
 	}
 
-	return expand_next_branch(pstate, move_block1_branch_1_expand, world);
+	return expand_next_branch(pstate, expand_move_block1_branch_1, world);
 	PLNNR_COROUTINE_END();
 }
 
+plnnr_static_assert(sizeof(method_instance) + padded_size<move_block1_args>::value + padded_size<p30_state>::value <= max_frame_size);
+
 bool move_block1_branch_1_expand(method_instance* method, planner_state& pstate, void* world)
 {
 	p30_state* precondition = plnnr::precondition<p30_state>(method);
@@ -2391,12 +2503,13 @@ bool move_block1_branch_1_expand(method_instance* method, planner_state& pstate,
 
 	PLNNR_COROUTINE_BEGIN(*method);
 
+	method->flags |= method_flags_committed;
 	precondition = push_precondition<p30_state>(pstate, method);
 
 	while (next(*precondition, *wstate))
 	{
 		{
-			task_instance* t = push_task(pstate, task_pickup, 0);
+			task_instance* t = push_task(pstate, task_pickup, expand_none);
 			pickup_args* a = push_arguments<pickup_args>(pstate, t);
 			a->_0 = method_args->_0;
 
@@ -2409,8 +2522,9 @@ bool move_block1_branch_1_expand(method_instance* method, planner_state& pstate,
 
 				tuple_list::handle* list = wstate->atoms[atom_clear];
 				operator_effect* effect = push<operator_effect>(pstate.journal);
-				effect->tuple = tuple;
-				effect->list = list;
+				effect->tuple = tuple->slot;
+				effect->atom = atom_clear;
+				effect->kind = effect_delete;
 				tuple_list::detach(list, tuple);
 
 				break;
@@ -2425,8 +2539,9 @@ bool move_block1_branch_1_expand(method_instance* method, planner_state& pstate,
 
 				tuple_list::handle* list = wstate->atoms[atom_on_table];
 				operator_effect* effect = push<operator_effect>(pstate.journal);
-				effect->tuple = tuple;
-				effect->list = list;
+				effect->tuple = tuple->slot;
+				effect->atom = atom_on_table;
+				effect->kind = effect_delete;
 				tuple_list::detach(list, tuple);
 
 				break;
@@ -2437,15 +2552,16 @@ bool move_block1_branch_1_expand(method_instance* method, planner_state& pstate,
 				holding_tuple* tuple = tuple_list::append<holding_tuple>(list);
 				tuple->_0 = a->_0;
 				operator_effect* effect = push<operator_effect>(pstate.journal);
-				effect->tuple = tuple;
-				effect->list = list;
+				effect->tuple = tuple->slot;
+				effect->atom = atom_holding;
+				effect->kind = effect_add;
 			}
 		}
 
-		PLNNR_COROUTINE_YIELD(*method);
+		PLNNR_COROUTINE_YIELD(*method, 1);
 
 		{
-			task_instance* t = push_task(pstate, task_stack, 0);
+			task_instance* t = push_task(pstate, task_stack, expand_none);
 			stack_args* a = push_arguments<stack_args>(pstate, t);
 			a->_0 = method_args->_0;
 			a->_1 = method_args->_1;
@@ -2459,8 +2575,9 @@ bool move_block1_branch_1_expand(method_instance* method, planner_state& pstate,
 
 				tuple_list::handle* list = wstate->atoms[atom_holding];
 				operator_effect* effect = push<operator_effect>(pstate.journal);
-				effect->tuple = tuple;
-				effect->list = list;
+				effect->tuple = tuple->slot;
+				effect->atom = atom_holding;
+				effect->kind = effect_delete;
 				tuple_list::detach(list, tuple);
 
 				break;
@@ -2475,8 +2592,9 @@ bool move_block1_branch_1_expand(method_instance* method, planner_state& pstate,
 
 				tuple_list::handle* list = wstate->atoms[atom_clear];
 				operator_effect* effect = push<operator_effect>(pstate.journal);
-				effect->tuple = tuple;
-				effect->list = list;
+				effect->tuple = tuple->slot;
+				effect->atom = atom_clear;
+				effect->kind = effect_delete;
 				tuple_list::detach(list, tuple);
 
 				break;
@@ -2488,8 +2606,9 @@ bool move_block1_branch_1_expand(method_instance* method, planner_state& pstate,
 				tuple->_0 = a->_0;
 				tuple->_1 = a->_1;
 				operator_effect* effect = push<operator_effect>(pstate.journal);
-				effect->tuple = tuple;
-				effect->list = list;
+				effect->tuple = tuple->slot;
+				effect->atom = atom_on;
+				effect->kind = effect_add;
 			}
 
 			{
@@ -2497,12 +2616,13 @@ bool move_block1_branch_1_expand(method_instance* method, planner_state& pstate,
 				clear_tuple* tuple = tuple_list::append<clear_tuple>(list);
 				tuple->_0 = a->_0;
 				operator_effect* effect = push<operator_effect>(pstate.journal);
-				effect->tuple = tuple;
-				effect->list = list;
+				effect->tuple = tuple->slot;
+				effect->atom = atom_clear;
+				effect->kind = effect_add;
 			}
 		}
 
-		PLNNR_COROUTINE_YIELD(*method);
+		PLNNR_COROUTINE_YIELD(*method, 2);
 
 		{
 			{
@@ -2510,8 +2630,9 @@ bool move_block1_branch_1_expand(method_instance* method, planner_state& pstate,
 				dont_move_tuple* tuple = tuple_list::append<dont_move_tuple>(list);
 				tuple->_0 = method_args->_0;
 				operator_effect* effect = push<operator_effect>(pstate.journal);
-				effect->tuple = tuple;
-				effect->list = list;
+				effect->tuple = tuple->slot;
+				effect->atom = atom_dont_move;
+				effect->kind = effect_add;
 			}
 		}
 
@@ -2525,8 +2646,9 @@ bool move_block1_branch_1_expand(method_instance* method, planner_state& pstate,
 
 				tuple_list::handle* list = wstate->atoms[atom_need_to_move];
 				operator_effect* effect = push<operator_effect>(pstate.journal);
-				effect->tuple = tuple;
-				effect->list = list;
+				effect->tuple = tuple->slot;
+				effect->atom = atom_need_to_move;
+				effect->kind = effect_delete;
 				tuple_list::detach(list, tuple);
 
 				break;
@@ -2546,8 +2668,9 @@ bool move_block1_branch_1_expand(method_instance* method, planner_state& pstate,
 
 				tuple_list::handle* list = wstate->atoms[atom_stack_on_block];
 				operator_effect* effect = push<operator_effect>(pstate.journal);
-				effect->tuple = tuple;
-				effect->list = list;
+				effect->tuple = tuple->slot;
+				effect->atom = atom_stack_on_block;
+				effect->kind = effect_delete;
 				tuple_list::detach(list, tuple);
 
 				break;
@@ -2555,16 +2678,53 @@ bool move_block1_branch_1_expand(method_instance* method, planner_state& pstate,
 		}
 
 		{
-			method_instance* t = push_method(pstate, task_check, check_branch_0_expand);
+			check_args args;
+			args._0 = method_args->_0;
+			method_instance* t = push_tail_method(pstate, task_check, expand_check_branch_0);
 			check_args* a = push_arguments<check_args>(pstate, t);
-			a->_0 = method_args->_0;
+			*a = args;
 		}
 
-		method->flags |= method_flags_expanded;
-		PLNNR_COROUTINE_YIELD(*method);
+		return true;
 	}
 
 	PLNNR_COROUTINE_END();
 }
 
+const expand_func expands[] =
+{
+	0,
+	solve_branch_0_expand,
+	mark_all_blocks_branch_0_expand,
+	mark_block_branch_0_expand,
+	mark_block_branch_1_expand,
+	mark_block_recursive_branch_0_expand,
+	mark_block_recursive_branch_1_expand,
+	mark_block_term_branch_0_expand,
+	mark_block_term_branch_1_expand,
+	mark_block_term_branch_2_expand,
+	mark_block_term_branch_3_expand,
+	mark_block_term_branch_4_expand,
+	mark_block_term_branch_5_expand,
+	mark_block_term_branch_6_expand,
+	find_all_movable_branch_0_expand,
+	mark_move_type_branch_0_expand,
+	mark_move_type_branch_1_expand,
+	mark_move_type_branch_2_expand,
+	move_block_branch_0_expand,
+	move_block_branch_1_expand,
+	move_block_branch_2_expand,
+	move_block_branch_3_expand,
+	check_branch_0_expand,
+	check_branch_1_expand,
+	check2_branch_0_expand,
+	check2_branch_1_expand,
+	check3_branch_0_expand,
+	check3_branch_1_expand,
+	check3_branch_2_expand,
+	check3_branch_3_expand,
+	move_block1_branch_0_expand,
+	move_block1_branch_1_expand,
+};
+
 }
@@ -15,6 +15,7 @@ namespace plnnr
 {
 	struct planner_state;
 	struct method_instance;
+	typedef bool (*expand_func)(method_instance*, planner_state&, void*);
 }
 
 namespace blocks {
@@ -48,6 +49,7 @@ struct block_tuple
 	int _0;
 	block_tuple* next;
 	block_tuple* prev;
+	uint32_t slot;
 	enum { id = atom_block };
 };
 
@@ -56,6 +58,7 @@ struct on_table_tuple
 	int _0;
 	on_table_tuple* next;
 	on_table_tuple* prev;
+	uint32_t slot;
 	enum { id = atom_on_table };
 };
 
@@ -65,6 +68,7 @@ struct on_tuple
 	int _1;
 	on_tuple* next;
 	on_tuple* prev;
+	uint32_t slot;
 	enum { id = atom_on };
 };
 
@@ -73,6 +77,7 @@ struct clear_tuple
 	int _0;
 	clear_tuple* next;
 	clear_tuple* prev;
+	uint32_t slot;
 	enum { id = atom_clear };
 };
 
@@ -81,6 +86,7 @@ struct goal_on_table_tuple
 	int _0;
 	goal_on_table_tuple* next;
 	goal_on_table_tuple* prev;
+	uint32_t slot;
 	enum { id = atom_goal_on_table };
 };
 
@@ -90,6 +96,7 @@ struct goal_on_tuple
 	int _1;
 	goal_on_tuple* next;
 	goal_on_tuple* prev;
+	uint32_t slot;
 	enum { id = atom_goal_on };
 };
 
@@ -98,6 +105,7 @@ struct goal_clear_tuple
 	int _0;
 	goal_clear_tuple* next;
 	goal_clear_tuple* prev;
+	uint32_t slot;
 	enum { id = atom_goal_clear };
 };
 
@@ -106,6 +114,7 @@ struct holding_tuple
 	int _0;
 	holding_tuple* next;
 	holding_tuple* prev;
+	uint32_t slot;
 	enum { id = atom_holding };
 };
 
@@ -114,6 +123,7 @@ struct dont_move_tuple
 	int _0;
 	dont_move_tuple* next;
 	dont_move_tuple* prev;
+	uint32_t slot;
 	enum { id = atom_dont_move };
 };
 
@@ -122,6 +132,7 @@ struct need_to_move_tuple
 	int _0;
 	need_to_move_tuple* next;
 	need_to_move_tuple* prev;
+	uint32_t slot;
 	enum { id = atom_need_to_move };
 };
 
@@ -130,6 +141,7 @@ struct put_on_table_tuple
 	int _0;
 	put_on_table_tuple* next;
 	put_on_table_tuple* prev;
+	uint32_t slot;
 	enum { id = atom_put_on_table };
 };
 
@@ -139,6 +151,7 @@ struct stack_on_block_tuple
 	int _1;
 	stack_on_block_tuple* next;
 	stack_on_block_tuple* prev;
+	uint32_t slot;
 	enum { id = atom_stack_on_block };
 };
 
@@ -342,6 +355,43 @@ bool check3_branch_3_expand(plnnr::method_instance*, plnnr::planner_state&, void
 bool move_block1_branch_0_expand(plnnr::method_instance*, plnnr::planner_state&, void*);
 bool move_block1_branch_1_expand(plnnr::method_instance*, plnnr::planner_state&, void*);
 
+enum expand_index
+{
+	expand_solve_branch_0 = 1,
+	expand_mark_all_blocks_branch_0,
+	expand_mark_block_branch_0,
+	expand_mark_block_branch_1,
+	expand_mark_block_recursive_branch_0,
+	expand_mark_block_recursive_branch_1,
+	expand_mark_block_term_branch_0,
+	expand_mark_block_term_branch_1,
+	expand_mark_block_term_branch_2,
+	expand_mark_block_term_branch_3,
+	expand_mark_block_term_branch_4,
+	expand_mark_block_term_branch_5,
+	expand_mark_block_term_branch_6,
+	expand_find_all_movable_branch_0,
+	expand_mark_move_type_branch_0,
+	expand_mark_move_type_branch_1,
+	expand_mark_move_type_branch_2,
+	expand_move_block_branch_0,
+	expand_move_block_branch_1,
+	expand_move_block_branch_2,
+	expand_move_block_branch_3,
+	expand_check_branch_0,
+	expand_check_branch_1,
+	expand_check2_branch_0,
+	expand_check2_branch_1,
+	expand_check3_branch_0,
+	expand_check3_branch_1,
+	expand_check3_branch_2,
+	expand_check3_branch_3,
+	expand_move_block1_branch_0,
+	expand_move_block1_branch_1,
+};
+
+extern const plnnr::expand_func expands[];
+
 }
 
 namespace plnnr {
@@ -69,8 +69,9 @@ int main()
     pstate.tasks = &tasks;
     pstate.journal = &jstack;
     pstate.trace = &trace;
+    pstate.expands = blocks::expands;
 
-    find_plan_init(pstate, blocks::task_solve, blocks::solve_branch_0_expand);
+    find_plan_init(pstate, blocks::task_solve, blocks::expand_solve_branch_0);
 
     find_plan_status status =  find_plan_step(pstate, world.data());
 
@@ -4,6 +4,7 @@
 using namespace plnnr;
 
 #pragma GCC diagnostic ignored "-Wunused-variable"
+#pragma GCC diagnostic ignored "-Wunused-parameter"
 
 namespace travel {
 
@@ -38,12 +39,12 @@ const char* task_name(task_type type) { return task_type_to_name[type]; }
 // method root [12:9]
 struct p0_state
 {
+	start_tuple* start_0;
+	finish_tuple* finish_1;
 	// s [12:17]
 	int _0;
 	// f [12:28]
 	int _1;
-	start_tuple* start_0;
-	finish_tuple* finish_1;
 	int stage;
 };
 
@@ -59,7 +60,7 @@ bool next(p0_state& state, worldstate& world)
 		{
 			state._1 = state.finish_1->_0;
 
-			PLNNR_COROUTINE_YIELD(state);
+			PLNNR_COROUTINE_YIELD(state, 1);
 		}
 	}
 
@@ -69,11 +70,11 @@ bool next(p0_state& state, worldstate& world)
 // method travel [17:9]
 struct p1_state
 {
+	short_distance_tuple* short_distance_0;
 	// x [17:25]
 	int _0;
 	// y [17:27]
 	int _1;
-	short_distance_tuple* short_distance_0;
 	int stage;
 };
 
@@ -93,7 +94,8 @@ bool next(p1_state& state, worldstate& world)
 			continue;
 		}
 
-		PLNNR_COROUTINE_YIELD(state);
+		PLNNR_COROUTINE_YIELD(state, 1);
+		break;
 	}
 
 	PLNNR_COROUTINE_END();
@@ -102,11 +104,11 @@ bool next(p1_state& state, worldstate& world)
 // method travel [20:9]
 struct p2_state
 {
+	long_distance_tuple* long_distance_0;
 	// x [20:24]
 	int _0;
 	// y [20:26]
 	int _1;
-	long_distance_tuple* long_distance_0;
 	int stage;
 };
 
@@ -126,7 +128,8 @@ bool next(p2_state& state, worldstate& world)
 			continue;
 		}
 
-		PLNNR_COROUTINE_YIELD(state);
+		PLNNR_COROUTINE_YIELD(state, 1);
+		break;
 	}
 
 	PLNNR_COROUTINE_END();
@@ -135,6 +138,8 @@ bool next(p2_state& state, worldstate& world)
 // method travel_by_air [25:9]
 struct p3_state
 {
+	airport_tuple* airport_0;
+	airport_tuple* airport_1;
 	// x [25:19]
 	int _0;
 	// ax [25:21]
@@ -143,8 +148,6 @@ struct p3_state
 	int _2;
 	// ay [25:36]
 	int _3;
-	airport_tuple* airport_0;
-	airport_tuple* airport_1;
 	int stage;
 };
 
@@ -170,13 +173,15 @@ bool next(p3_state& state, worldstate& world)
 
 			state._3 = state.airport_1->_1;
 
-			PLNNR_COROUTINE_YIELD(state);
+			PLNNR_COROUTINE_YIELD(state, 1);
 		}
 	}
 
 	PLNNR_COROUTINE_END();
 }
 
+plnnr_static_assert(sizeof(method_instance) + padded_size<p0_state>::value <= max_frame_size);
+
 bool root_branch_0_expand(method_instance* method, planner_state& pstate, void* world)
 {
 	p0_state* precondition = plnnr::precondition<p0_state>(method);
@@ -189,19 +194,21 @@ bool root_branch_0_expand(method_instance* method, planner_state& pstate, void*
 	while (next(*precondition, *wstate))
 	{
 		{
-			method_instance* t = push_method(pstate, task_travel, travel_branch_0_expand);
+			method_instance* t = push_method(pstate, task_travel, expand_travel_branch_0);
 			travel_args* a = push_arguments<travel_args>(pstate, t);
 			a->_0 = precondition->_0;
 			a->_1 = precondition->_1;
 		}
 
 		method->flags |= method_flags_expanded;
-		PLNNR_COROUTINE_YIELD(*method);
+		PLNNR_COROUTINE_YIELD(*method, 1);
 	}
 
 	PLNNR_COROUTINE_END();
 }
 
+plnnr_static_assert(sizeof(method_instance) + padded_size<travel_args>::value + padded_size<p1_state>::value <= max_frame_size);
+
 bool travel_branch_0_expand(method_instance* method, planner_state& pstate, void* world)
 {
 	p1_state* precondition = plnnr::precondition<p1_state>(method);
@@ -217,20 +224,22 @@ bool travel_branch_0_expand(method_instance* method, planner_state& pstate, void
 	while (next(*precondition, *wstate))
 	{
 		{
-			task_instance* t = push_task(pstate, task_ride_taxi, 0);
+			task_instance* t = push_task(pstate, task_ride_taxi, expand_none);
 			ride_taxi_args* a = push_arguments<ride_taxi_args>(pstate, t);
 			a->_0 = method_args->_0;
 			a->_1 = method_args->_1;
 		}
 
 		method->flags |= method_flags_expanded;
-		PLNNR_COROUTINE_YIELD(*method);
+		PLNNR_COROUTINE_YIELD(*method, 1);
 	}
 
-	return expand_next_branch(pstate, travel_branch_1_expand, world);
+	return expand_next_branch(pstate, expand_travel_branch_1, world);
 	PLNNR_COROUTINE_END();
 }
 
+plnnr_static_assert(sizeof(method_instance) + padded_size<travel_args>::value + padded_size<p2_state>::value <= max_frame_size);
+
 bool travel_branch_1_expand(method_instance* method, planner_state& pstate, void* world)
 {
 	p2_state* precondition = plnnr::precondition<p2_state>(method);
@@ -239,6 +248,7 @@ bool travel_branch_1_expand(method_instance* method, planner_state& pstate, void
 
 	PLNNR_COROUTINE_BEGIN(*method);
 
+	method->flags |= method_flags_committed;
 	precondition = push_precondition<p2_state>(pstate, method);
 	precondition->_0 = method_args->_0;
 	precondition->_1 = method_args->_1;
@@ -246,19 +256,22 @@ bool travel_branch_1_expand(method_instance* method, planner_state& pstate, void
 	while (next(*precondition, *wstate))
 	{
 		{
-			method_instance* t = push_method(pstate, task_travel_by_air, travel_by_air_branch_0_expand);
+			travel_by_air_args args;
+			args._0 = method_args->_0;
+			args._1 = method_args->_1;
+			method_instance* t = push_tail_method(pstate, task_travel_by_air, expand_travel_by_air_branch_0);
 			travel_by_air_args* a = push_arguments<travel_by_air_args>(pstate, t);
-			a->_0 = method_args->_0;
-			a->_1 = method_args->_1;
+			*a = args;
 		}
 
-		method->flags |= method_flags_expanded;
-		PLNNR_COROUTINE_YIELD(*method);
+		return true;
 	}
 
 	PLNNR_COROUTINE_END();
 }
 
+plnnr_static_assert(sizeof(method_instance) + padded_size<travel_by_air_args>::value + padded_size<p3_state>::value <= max_frame_size);
+
 bool travel_by_air_branch_0_expand(method_instance* method, planner_state& pstate, void* world)
 {
 	p3_state* precondition = plnnr::precondition<p3_state>(method);
@@ -274,13 +287,13 @@ bool travel_by_air_branch_0_expand(method_instance* method, planner_state& pstat
 	while (next(*precondition, *wstate))
 	{
 		{
-			method_instance* t = push_method(pstate, task_travel, travel_branch_0_expand);
+			method_instance* t = push_method(pstate, task_travel, expand_travel_branch_0);
 			travel_args* a = push_arguments<travel_args>(pstate, t);
 			a->_0 = method_args->_0;
 			a->_1 = precondition->_1;
 		}
 
-		PLNNR_COROUTINE_YIELD(*method);
+		PLNNR_COROUTINE_YIELD(*method, 1);
 
 		if (method->flags & method_flags_failed)
 		{
@@ -288,26 +301,35 @@ bool travel_by_air_branch_0_expand(method_instance* method, planner_state& pstat
 		}
 
 		{
-			task_instance* t = push_task(pstate, task_fly, 0);
+			task_instance* t = push_task(pstate, task_fly, expand_none);
 			fly_args* a = push_arguments<fly_args>(pstate, t);
 			a->_0 = precondition->_1;
 			a->_1 = precondition->_3;
 		}
 
-		PLNNR_COROUTINE_YIELD(*method);
+		PLNNR_COROUTINE_YIELD(*method, 2);
 
 		{
-			method_instance* t = push_method(pstate, task_travel, travel_branch_0_expand);
+			method_instance* t = push_method(pstate, task_travel, expand_travel_branch_0);
 			travel_args* a = push_arguments<travel_args>(pstate, t);
 			a->_0 = precondition->_3;
 			a->_1 = method_args->_1;
 		}
 
 		method->flags |= method_flags_expanded;
-		PLNNR_COROUTINE_YIELD(*method);
+		PLNNR_COROUTINE_YIELD(*method, 3);
 	}
 
 	PLNNR_COROUTINE_END();
 }
 
+const expand_func expands[] =
+{
+	0,
+	root_branch_0_expand,
+	travel_branch_0_expand,
+	travel_branch_1_expand,
+	travel_by_air_branch_0_expand,
+};
+
 }
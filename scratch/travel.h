@@ -15,6 +15,7 @@ namespace plnnr
 {
 	struct planner_state;
 	struct method_instance;
+	typedef bool (*expand_func)(method_instance*, planner_state&, void*);
 }
 
 namespace travel {
@@ -41,6 +42,7 @@ struct start_tuple
 	int _0;
 	start_tuple* next;
 	start_tuple* prev;
+	uint32_t slot;
 	enum { id = atom_start };
 };
 
@@ -49,6 +51,7 @@ struct finish_tuple
 	int _0;
 	finish_tuple* next;
 	finish_tuple* prev;
+	uint32_t slot;
 	enum { id = atom_finish };
 };
 
@@ -58,6 +61,7 @@ struct short_distance_tuple
 	int _1;
 	short_distance_tuple* next;
 	short_distance_tuple* prev;
+	uint32_t slot;
 	enum { id = atom_short_distance };
 };
 
@@ -67,6 +71,7 @@ struct long_distance_tuple
 	int _1;
 	long_distance_tuple* next;
 	long_distance_tuple* prev;
+	uint32_t slot;
 	enum { id = atom_long_distance };
 };
 
@@ -76,6 +81,7 @@ struct airport_tuple
 	int _1;
 	airport_tuple* next;
 	airport_tuple* prev;
+	uint32_t slot;
 	enum { id = atom_airport };
 };
 
@@ -155,6 +161,16 @@ bool travel_branch_0_expand(plnnr::method_instance*, plnnr::planner_state&, void
 bool travel_branch_1_expand(plnnr::method_instance*, plnnr::planner_state&, void*);
 bool travel_by_air_branch_0_expand(plnnr::method_instance*, plnnr::planner_state&, void*);
 
+enum expand_index
+{
+	expand_root_branch_0 = 1,
+	expand_travel_branch_0,
+	expand_travel_branch_1,
+	expand_travel_by_air_branch_0,
+};
+
+extern const plnnr::expand_func expands[];
+
 }
 
 namespace plnnr {
@@ -63,8 +63,9 @@ int main()
     pstate.tasks = &tasks;
     pstate.journal = &jstack;
     pstate.trace = &trace;
+    pstate.expands = travel::expands;
 
-    find_plan_init(pstate, travel::task_root, travel::root_branch_0_expand);
+    find_plan_init(pstate, travel::task_root, travel::expand_root_branch_0);
 
     find_plan_status status;
 
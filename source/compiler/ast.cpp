@@ -66,6 +66,13 @@ namespace
             return result;
         }
 
+        if (type == node_function)
+        {
+            result.size = sizeof(func_ann);
+            result.alignment = plnnrc_alignof(func_ann);
+            return result;
+        }
+
         if (type == node_branch)
         {
             result.size = sizeof(branch_ann);
@@ -41,7 +41,7 @@ namespace
 {
     sexpr::node* next_branch_expr(sexpr::node* branch_expr)
     {
-        if (is_token(branch_expr->first_child, token_foreach))
+        if (is_token(branch_expr->first_child, token_foreach) || is_token(branch_expr->first_child, token_sort_by))
         {
             return branch_expr->next_sibling;
         }
@@ -55,6 +55,10 @@ namespace
         return branch_expr->next_sibling->next_sibling;
     }
 
+    // task types and expand indices are 16-bit in runtime frames.
+    const uint32_t max_task_types = 0xffff;
+    const uint32_t max_expands = 0xffff;
+
     int count_elements(sexpr::node* root, str_ref token)
     {
         int result = 0;
@@ -119,17 +123,15 @@ namespace
             PLNNRC_SKIP_ERROR_NODE(p);
             link_to_parameter(p, precondition);
             link_to_parameter(p, tasklist);
-        }
 
-        for (node* n = precondition; n != 0; n = preorder_traversal_next(precondition, n))
-        {
-            if (is_term_variable(n) && !definition(n))
+            if (node* sort_key = branch_sort_key(precondition->parent))
             {
-                link_to_variable(n, precondition, preorder_traversal_next(precondition, n));
-                link_to_variable(n, tasklist, tasklist);
+                link_to_parameter(p, sort_key);
             }
         }
 
+        link_precondition_variables(precondition, tasklist);
+
         for (node* n = precondition; n != 0; n = preorder_traversal_next(precondition, n))
         {
             if (is_term_call(n) || is_comparison_op(n))
@@ -157,6 +159,19 @@ namespace
                 }
             }
         }
+
+        node* sort_key = branch_sort_key(precondition->parent);
+
+        for (node* n = sort_key; n != 0; n = preorder_traversal_next(sort_key, n))
+        {
+            if (is_term_variable(n))
+            {
+                if (!definition(n) || is_error(definition(n)))
+                {
+                    replace_with_error(ast, n, error_unbound_var) << n->s_expr << 4;
+                }
+            }
+        }
     }
 
     void link_method_variables(tree& ast, node* method)
@@ -185,7 +200,7 @@ namespace
         }
     }
 
-    void link_operator_variables(node* operatr)
+    void link_operator_variables(tree& ast, node* operatr)
     {
         node* atom = operatr->first_child;
         plnnrc_assert(atom && is_atom(atom));
@@ -201,6 +216,36 @@ namespace
                 }
             }
         }
+
+        if (node* cost = operator_cost(operatr))
+        {
+            for (node* n = cost; n != 0; n = preorder_traversal_next(cost, n))
+            {
+                if (is_term_variable(n) && !definition(n))
+                {
+                    replace_with_error(ast, n, error_unbound_var) << n->s_expr << 3;
+                }
+            }
+        }
+    }
+}
+
+void link_precondition_variables(node* precondition, node* tasklist)
+{
+    node* sort_key = branch_sort_key(precondition->parent);
+
+    for (node* n = precondition; n != 0; n = preorder_traversal_next(precondition, n))
+    {
+        if (is_term_variable(n) && !definition(n))
+        {
+            link_to_variable(n, precondition, preorder_traversal_next(precondition, n));
+            link_to_variable(n, tasklist, tasklist);
+
+            if (sort_key)
+            {
+                link_to_variable(n, sort_key, sort_key);
+            }
+        }
     }
 }
 
@@ -246,6 +291,23 @@ node* build_domain(tree& ast, sexpr::node* s_expr)
 
     PLNNRC_CHECK(build_operator_stubs(ast));
 
+    uint32_t num_branches = 0;
+
+    for (node* method = domain->first_child; method != 0; method = method->next_sibling)
+    {
+        if (is_method(method))
+        {
+            for (node* branch = method->first_child->next_sibling; branch != 0; branch = branch->next_sibling)
+            {
+                ++num_branches;
+            }
+        }
+    }
+
+    // expand index 0 is reserved for operator tasks.
+    expect_condition(ast, s_expr, ast.methods.count() + ast.operators.count() <= max_task_types, error_limit_exceeded, domain) << 0;
+    expect_condition(ast, s_expr, num_branches + 1 <= max_expands, error_limit_exceeded, domain) << 1;
+
     for (id_table_values methods = ast.methods.values(); !methods.empty(); methods.pop())
     {
         node* method = methods.value();
@@ -263,7 +325,7 @@ node* build_domain(tree& ast, sexpr::node* s_expr)
         plnnrc_assert(operator_atom && is_atom(operator_atom));
         (void)(operator_atom);
 
-        link_operator_variables(operatr);
+        link_operator_variables(ast, operatr);
     }
 
     return domain;
@@ -305,6 +367,8 @@ node* build_branch(tree& ast, sexpr::node* s_expr)
     sexpr::node* precondition_expr = 0;
     sexpr::node* tasklist_expr = 0;
 
+    sexpr::node* sort_key_expr = 0;
+
     branch_ann* ann = annotation<branch_ann>(branch);
     ann->foreach = is_token(s_expr->first_child, token_foreach);
 
@@ -315,6 +379,18 @@ node* build_branch(tree& ast, sexpr::node* s_expr)
         PLNNRC_RETURN(expect_next_type(ast, precondition_expr, sexpr::node_list));
         tasklist_expr = precondition_expr->next_sibling;
     }
+    else if (is_token(s_expr->first_child, token_sort_by))
+    {
+        // (:sort-by <key> (precondition) (task list)): bindings are tried in ascending key order.
+        // they are sorted in batches of `codegen_options::sort_buffer_size` (derplannerc --sort-buffer),
+        // so the order is only total if the precondition has at most that many bindings.
+        PLNNRC_RETURN(expect_condition(ast, s_expr->first_child, s_expr->first_child->next_sibling != 0, error_expected_sort_key));
+        sort_key_expr = s_expr->first_child->next_sibling;
+        PLNNRC_RETURN(expect_next_type(ast, sort_key_expr, sexpr::node_list));
+        precondition_expr = sort_key_expr->next_sibling;
+        PLNNRC_RETURN(expect_next_type(ast, precondition_expr, sexpr::node_list));
+        tasklist_expr = precondition_expr->next_sibling;
+    }
     else
     {
         precondition_expr = s_expr;
@@ -326,9 +402,9 @@ node* build_branch(tree& ast, sexpr::node* s_expr)
 
     if (!find_descendant(precondition, node_error))
     {
-        PLNNRC_CHECK_NODE(precondition_dnf, convert_to_dnf(ast, precondition));
-        precondition_dnf->s_expr = precondition_expr;
-        append_child(branch, precondition_dnf);
+        PLNNRC_CHECK_NODE(precondition_nnf, convert_to_nnf_clauses(ast, precondition));
+        precondition_nnf->s_expr = precondition_expr;
+        append_child(branch, precondition_nnf);
     }
     else
     {
@@ -338,6 +414,15 @@ node* build_branch(tree& ast, sexpr::node* s_expr)
     PLNNRC_CHECK_NODE(task_list, build_task_list(ast, tasklist_expr));
     append_child(branch, task_list);
 
+    if (sort_key_expr)
+    {
+        PLNNRC_CHECK_NODE(sort_by, ast.make_node(node_sort_by, sort_key_expr));
+        append_child(branch, sort_by);
+
+        PLNNRC_CHECK_NODE(sort_key, build_term(ast, sort_key_expr));
+        append_child(sort_by, sort_key);
+    }
+
     return branch;
 }
 
@@ -393,6 +478,7 @@ node* build_operator(tree& ast, sexpr::node* s_expr)
 
     sexpr::node* delete_effects_expr = 0;
     sexpr::node* add_effects_expr = 0;
+    sexpr::node* cost_expr = 0;
 
     for (sexpr::node* child = task_atom_expr->next_sibling; child != 0; child = child->next_sibling)
     {
@@ -412,6 +498,15 @@ node* build_operator(tree& ast, sexpr::node* s_expr)
             continue;
         }
 
+        if (is_token(child->first_child, token_cost))
+        {
+            PLNNRC_CONTINUE(expect_condition(ast, child, cost_expr == 0, error_multiple_definitions, operatr) << 4);
+            PLNNRC_CONTINUE(expect_condition(ast, child->first_child, child->first_child->next_sibling != 0, error_expected_type, operatr) << static_cast<int>(sexpr::node_int));
+            PLNNRC_CONTINUE(expect_condition(ast, child->first_child->next_sibling->next_sibling, child->first_child->next_sibling->next_sibling == 0, error_unexpected, operatr));
+            cost_expr = child;
+            continue;
+        }
+
         emit_error(ast, operatr, error_unexpected, child);
     }
 
@@ -439,6 +534,19 @@ node* build_operator(tree& ast, sexpr::node* s_expr)
         }
     }
 
+    // optional, non-negative cost of the operator: a constant, a parameter or a function call.
+    if (cost_expr)
+    {
+        PLNNRC_CHECK_NODE(cost, ast.make_node(node_cost, cost_expr));
+        append_child(operatr, cost);
+
+        PLNNRC_CHECK_NODE(cost_term, build_term(ast, cost_expr->first_child->next_sibling));
+        append_child(cost, cost_term);
+
+        // branch-and-bound relies on the plan cost never decreasing.
+        expect_condition(ast, cost_term->s_expr, !is_term_constant(cost_term) || cost_term->s_expr->token[0] != '-', error_negative_cost, operatr);
+    }
+
     return operatr;
 }
 
@@ -37,6 +37,9 @@ node* build_operator(tree& ast, sexpr::node* s_expr);
 node* build_operator_stub(tree& ast, sexpr::node* s_expr);
 bool  build_operator_stubs(tree& ast);
 
+// links unbound variables of precondition, tasklist and sort key to their first occurrence in precondition.
+void link_precondition_variables(node* precondition, node* tasklist);
+
 }
 }
 
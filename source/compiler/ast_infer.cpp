@@ -56,6 +56,11 @@ namespace
                 }
             }
 
+            if (is_term_constant(c))
+            {
+                type_tag(c, annotation<ws_type_ann>(ws_type)->type_tag);
+            }
+
             if (is_term_call(c))
             {
                 node* ws_func = ast.ws_funcs.find(c->s_expr->token);
@@ -230,6 +235,19 @@ namespace
                                 }
                             }
 
+                            // constants take the type of the parameter or the worldstate type named after the literal.
+                            if (is_term_constant(arg))
+                            {
+                                if (!type_tag(param))
+                                {
+                                    node* ws_type = ast.ws_types.find(is_term_int(arg) ? "int" : "float");
+                                    PLNNRC_CONTINUE(replace_with_error_if(!ws_type, ast, arg, error_unable_to_infer_type) << arg->s_expr);
+                                    type_tag(param, annotation<ws_type_ann>(ws_type)->type_tag);
+                                }
+
+                                type_tag(arg, type_tag(param));
+                            }
+
                             if (is_term_call(arg))
                             {
                                 node* ws_func = ast.ws_funcs.find(arg->s_expr->token);
@@ -370,6 +388,12 @@ void seed_types(tree& ast)
         for (node* branch = method_atom->next_sibling; branch != 0; branch = branch->next_sibling)
         {
             seed_types(ast, branch->first_child);
+
+            // function calls in the sort key are checked like the ones in precondition.
+            if (node* sort_by = find_child(branch, node_sort_by))
+            {
+                seed_types(ast, sort_by);
+            }
         }
     }
 
@@ -0,0 +1,271 @@
+//
+// Copyright (c) 2013 Alexander Shafranov shafranov@gmail.com
+//
+// This software is provided 'as-is', without any express or implied
+// warranty.  In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software. If you use this software
+// in a product, an acknowledgment in the product documentation would be
+// appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+
+#include <string.h> // memcpy
+#include "derplanner/compiler/assert.h"
+#include "derplanner/compiler/s_expression.h"
+#include "derplanner/compiler/ast.h"
+#include "derplanner/compiler/ast_build.h"
+#include "tree_tools.h"
+#include "ast_tools.h"
+
+namespace plnnrc {
+namespace ast {
+
+namespace
+{
+    bool is_task_atom(node* n)
+    {
+        return is_atom(n) && n->parent && is_task_list(n->parent);
+    }
+
+    // depth first search of the call graph, `processed` marks visited methods.
+    bool calls(tree& ast, node* method, node* target)
+    {
+        for (node* branch = method->first_child->next_sibling; branch != 0; branch = branch->next_sibling)
+        {
+            node* tasklist = branch->first_child->next_sibling;
+
+            for (node* n = tasklist; n != 0; n = preorder_traversal_next(tasklist, n))
+            {
+                if (!is_task_atom(n) || is_lazy(n))
+                {
+                    continue;
+                }
+
+                node* callee = ast.methods.find(n->s_expr->token);
+
+                if (!callee)
+                {
+                    continue;
+                }
+
+                if (callee == target)
+                {
+                    return true;
+                }
+
+                method_ann* ann = annotation<method_ann>(callee);
+
+                if (ann->processed)
+                {
+                    continue;
+                }
+
+                ann->processed = true;
+
+                if (calls(ast, callee, target))
+                {
+                    return true;
+                }
+            }
+        }
+
+        return false;
+    }
+
+    bool is_recursive(tree& ast, node* domain, node* method)
+    {
+        for (node* m = domain->first_child; m != 0; m = m->next_sibling)
+        {
+            if (is_method(m))
+            {
+                annotation<method_ann>(m)->processed = false;
+            }
+        }
+
+        return calls(ast, method, method);
+    }
+
+    bool is_empty_precondition(node* precondition)
+    {
+        for (node* n = precondition; n != 0; n = preorder_traversal_next(precondition, n))
+        {
+            if (!is_op_or(n) && !is_op_and(n))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    unsigned task_count(node* tasklist)
+    {
+        unsigned count = 0;
+
+        for (node* task = first_task(tasklist); task != 0; task = next_task(tasklist, task))
+        {
+            ++count;
+        }
+
+        return count;
+    }
+
+    // single non-foreach branch with empty precondition: the method always expands to the same tasks.
+    bool is_inlinable(tree& ast, node* domain, node* method, unsigned max_tasks)
+    {
+        node* branch = method->first_child->next_sibling;
+
+        if (!branch || branch->next_sibling || annotation<branch_ann>(branch)->foreach)
+        {
+            return false;
+        }
+
+        node* precondition = branch->first_child;
+        node* tasklist = precondition->next_sibling;
+
+        if (!is_empty_precondition(precondition))
+        {
+            return false;
+        }
+
+        unsigned count = task_count(tasklist);
+
+        if (count == 0 || count > max_tasks)
+        {
+            return false;
+        }
+
+        return !is_recursive(ast, domain, method);
+    }
+
+    bool all_variables(node* atom)
+    {
+        for (node* arg = atom->first_child; arg != 0; arg = arg->next_sibling)
+        {
+            if (!is_term_variable(arg))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    // rebinds callee parameters in the cloned task list to the call site arguments.
+    void substitute_parameters(node* tasklist, node* callee_atom, node* call_site)
+    {
+        for (node* n = tasklist; n != 0; n = preorder_traversal_next(tasklist, n))
+        {
+            if (!is_term_variable(n))
+            {
+                continue;
+            }
+
+            node* def = definition(n);
+
+            if (!def || def->parent != callee_atom)
+            {
+                continue;
+            }
+
+            node* arg = call_site->first_child;
+
+            for (node* param = callee_atom->first_child; param != def; param = param->next_sibling)
+            {
+                arg = arg->next_sibling;
+            }
+
+            plnnrc_assert(arg);
+            n->s_expr = arg->s_expr;
+            memcpy(n->annotation, arg->annotation, sizeof(term_ann));
+        }
+    }
+
+    unsigned inline_tasks(tree& ast, node* domain, node* tasklist, unsigned max_tasks)
+    {
+        unsigned inlined = 0;
+
+        for (node* task = tasklist->first_child; task != 0; task = task->next_sibling)
+        {
+            if (is_task_list(task))
+            {
+                inlined += inline_tasks(ast, domain, task, max_tasks);
+                continue;
+            }
+
+            if (!is_atom(task) || is_lazy(task) || !all_variables(task))
+            {
+                continue;
+            }
+
+            node* callee = ast.methods.find(task->s_expr->token);
+
+            if (!callee || !is_inlinable(ast, domain, callee, max_tasks))
+            {
+                continue;
+            }
+
+            node* callee_atom = callee->first_child;
+            node* callee_tasklist = callee_atom->next_sibling->first_child->next_sibling;
+
+            node* body = ast.clone_subtree(callee_tasklist);
+
+            if (!body)
+            {
+                return inlined;
+            }
+
+            // nested task list remembers the call it replaces.
+            body->s_expr = task->s_expr;
+            substitute_parameters(body, callee_atom, task);
+
+            insert_child(task, body);
+            detach_node(task);
+            task = body;
+
+            inlined += 1 + inline_tasks(ast, domain, body, max_tasks);
+        }
+
+        return inlined;
+    }
+}
+
+unsigned inline_methods(tree& ast, unsigned max_tasks)
+{
+    node* domain = find_child(ast.root(), node_domain);
+
+    if (!domain || !max_tasks)
+    {
+        return 0;
+    }
+
+    unsigned inlined = 0;
+
+    for (node* method = domain->first_child; method != 0; method = method->next_sibling)
+    {
+        if (!is_method(method))
+        {
+            continue;
+        }
+
+        for (node* branch = method->first_child->next_sibling; branch != 0; branch = branch->next_sibling)
+        {
+            node* tasklist = branch->first_child->next_sibling;
+            inlined += inline_tasks(ast, domain, tasklist, max_tasks);
+        }
+    }
+
+    return inlined;
+}
+
+}
+}
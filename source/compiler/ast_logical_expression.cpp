@@ -379,6 +379,64 @@ namespace
     }
 }
 
+namespace
+{
+    // (and (or x y)) -> (or x y)
+    void hoist_single_disjunctions(node* root)
+    {
+        for (node* p = root; p != 0; p = preorder_traversal_next(root, p))
+        {
+            while (p != root && is_op_and(p) && p->first_child && !p->first_child->next_sibling && is_op_or(p->first_child))
+            {
+                node* c = p->first_child;
+                detach_node(c);
+                insert_child(p, c);
+                detach_node(p);
+                p = c;
+            }
+        }
+    }
+}
+
+node* convert_to_nnf_clauses(tree& ast, node* root)
+{
+    plnnrc_assert(root);
+
+    PLNNRC_CHECK_NODE(nnf_root, convert_to_nnf(ast, root));
+    PLNNRC_CHECK_NODE(new_root, ast.make_node(node_op_or));
+
+    append_child(new_root, nnf_root);
+    flatten(new_root);
+    hoist_single_disjunctions(new_root);
+    flatten(new_root);
+
+    // every disjunct becomes a conjunction: (or x (and y z)) -> (or (and x) (and y z))
+    for (node* p = new_root; p != 0; p = preorder_traversal_next(new_root, p))
+    {
+        if (!is_op_or(p))
+        {
+            continue;
+        }
+
+        for (node* c = p->first_child; c != 0;)
+        {
+            node* next_c = c->next_sibling;
+
+            if (!is_op_and(c))
+            {
+                PLNNRC_CHECK_NODE(new_and, ast.make_node(node_op_and));
+                insert_child(c, new_and);
+                detach_node(c);
+                append_child(new_and, c);
+            }
+
+            c = next_c;
+        }
+    }
+
+    return new_root;
+}
+
 node* convert_to_dnf(tree& ast, node* root)
 {
     plnnrc_assert(root);
@@ -38,6 +38,10 @@ void flatten(node* root);
 node* convert_to_nnf(tree& ast, node* root);
 node* convert_to_dnf(tree& ast, node* root);
 
+// converts to nnf where disjunctions are made of conjunctions only and the root is a disjunction.
+// unlike dnf, nested disjunctions are kept in place, so shared conjuncts are not duplicated.
+node* convert_to_nnf_clauses(tree& ast, node* root);
+
 }
 }
 
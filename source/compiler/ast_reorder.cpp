@@ -0,0 +1,391 @@
+//
+// Copyright (c) 2013 Alexander Shafranov shafranov@gmail.com
+//
+// This software is provided 'as-is', without any express or implied
+// warranty.  In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software. If you use this software
+// in a product, an acknowledgment in the product documentation would be
+// appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+
+#include <limits.h> // INT_MAX
+#include <string.h> // strcmp
+#include "derplanner/compiler/assert.h"
+#include "derplanner/compiler/s_expression.h"
+#include "derplanner/compiler/node_array.h"
+#include "derplanner/compiler/ast.h"
+#include "derplanner/compiler/ast_build.h"
+#include "tree_tools.h"
+#include "ast_tools.h"
+#include "ast_domain.h"
+#include "ast_annotate.h"
+#include "ast_reorder.h"
+
+namespace plnnrc {
+namespace ast {
+
+namespace
+{
+    // variable occurrences are identified by their first occurrence (definition).
+    node* variable_id(node* var)
+    {
+        node* def = definition(var);
+        return def ? def : var;
+    }
+
+    bool is_inside(node* n, node* root)
+    {
+        for (node* p = n; p != 0; p = p->parent)
+        {
+            if (p == root)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    bool is_bound(node_array& bound, node* var)
+    {
+        node* id = variable_id(var);
+
+        // parameters are bound on entry.
+        if (is_parameter(id))
+        {
+            return true;
+        }
+
+        for (unsigned i = 0; i < bound.size(); ++i)
+        {
+            if (bound[i] == id)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void bind(node_array& bound, node* literal)
+    {
+        for (node* n = literal; n != 0; n = preorder_traversal_next(literal, n))
+        {
+            if (is_term_variable(n) && !is_bound(bound, n))
+            {
+                bound.append(variable_id(n));
+            }
+        }
+    }
+
+    // positive atoms bind their direct variable arguments, everything else is a filter
+    // and can be evaluated only once all its variables are bound.
+    bool is_ready(node_array& bound, node* literal)
+    {
+        for (node* n = literal; n != 0; n = preorder_traversal_next(literal, n))
+        {
+            if (!is_term_variable(n))
+            {
+                continue;
+            }
+
+            if (is_atom(literal) && n->parent == literal)
+            {
+                continue;
+            }
+
+            if (!is_bound(bound, n))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    struct atom_score
+    {
+        int bound_args;
+        int unbound_args;
+        int cardinality;
+    };
+
+    atom_score score(tree& ast, node_array& bound, node* atom)
+    {
+        atom_score result = {0, 0, INT_MAX};
+
+        for (node* arg = atom->first_child; arg != 0; arg = arg->next_sibling)
+        {
+            if (is_term_variable(arg) && !is_bound(bound, arg))
+            {
+                result.unbound_args++;
+            }
+            else
+            {
+                result.bound_args++;
+            }
+        }
+
+        node* ws_atom = ast.ws_atoms.find(atom->s_expr->token);
+
+        if (ws_atom && annotation<atom_ann>(ws_atom)->cardinality > 0)
+        {
+            result.cardinality = annotation<atom_ann>(ws_atom)->cardinality;
+        }
+
+        return result;
+    }
+
+    bool better(const atom_score& a, const atom_score& b)
+    {
+        if (a.bound_args != b.bound_args)
+        {
+            return a.bound_args > b.bound_args;
+        }
+
+        if (a.unbound_args != b.unbound_args)
+        {
+            return a.unbound_args < b.unbound_args;
+        }
+
+        return a.cardinality < b.cardinality;
+    }
+
+    unsigned count_variables(node* root)
+    {
+        unsigned count = 0;
+
+        for (node* n = root; n != 0; n = preorder_traversal_next(root, n))
+        {
+            if (is_term_variable(n))
+            {
+                ++count;
+            }
+        }
+
+        return count;
+    }
+
+    void relink_branch(node* branch)
+    {
+        node* precondition = branch->first_child;
+        node* tasklist = precondition->next_sibling;
+
+        for (node* n = precondition; n != 0; n = preorder_traversal_next(precondition, n))
+        {
+            if (is_term_variable(n) && definition(n) && !is_parameter(definition(n)))
+            {
+                annotation<term_ann>(n)->var_def = 0;
+            }
+        }
+
+        for (node* n = tasklist; n != 0; n = preorder_traversal_next(tasklist, n))
+        {
+            if (is_term_variable(n) && definition(n) && !is_parameter(definition(n)))
+            {
+                annotation<term_ann>(n)->var_def = 0;
+            }
+        }
+
+        node* sort_key = branch_sort_key(branch);
+
+        for (node* n = sort_key; n != 0; n = preorder_traversal_next(sort_key, n))
+        {
+            if (is_term_variable(n) && definition(n) && !is_parameter(definition(n)))
+            {
+                annotation<term_ann>(n)->var_def = 0;
+            }
+        }
+
+        link_precondition_variables(precondition, tasklist);
+        annotate_precondition(precondition);
+    }
+}
+
+bool order_literals(tree& ast, node* clause, node* lead, node_array& ordered)
+{
+    unsigned num_literals = 0;
+
+    for (node* literal = clause->first_child; literal != 0; literal = literal->next_sibling)
+    {
+        ++num_literals;
+    }
+
+    if (num_literals < 2)
+    {
+        return false;
+    }
+
+    node_array literals;
+    node_array bound;
+
+    if (!literals.init(num_literals) || !bound.init(count_variables(clause) + 1))
+    {
+        return false;
+    }
+
+    // leave clauses which rely on the written order (e.g. filters with unbound variables) untouched.
+    for (node* literal = clause->first_child; literal != 0; literal = literal->next_sibling)
+    {
+        if (!is_ready(bound, literal))
+        {
+            return false;
+        }
+
+        bind(bound, literal);
+        literals.append(literal);
+    }
+
+    if (!ordered.init(num_literals) || !bound.init(count_variables(clause) + 1))
+    {
+        return false;
+    }
+
+    while (ordered.size() < num_literals)
+    {
+        int choice = -1;
+        bool forced = false;
+        atom_score best = {0, 0, INT_MAX};
+
+        for (unsigned i = 0; i < num_literals; ++i)
+        {
+            node* literal = literals[i];
+
+            if (!literal || !is_ready(bound, literal))
+            {
+                continue;
+            }
+
+            // filters go first as soon as they can be evaluated.
+            if (!is_atom(literal))
+            {
+                choice = i;
+                break;
+            }
+
+            if (literal == lead)
+            {
+                choice = i;
+                forced = true;
+                continue;
+            }
+
+            atom_score s = score(ast, bound, literal);
+
+            if (!forced && (choice < 0 || better(s, best)))
+            {
+                choice = i;
+                best = s;
+            }
+        }
+
+        // the original order is valid, so the earliest remaining literal is always ready.
+        plnnrc_assert(choice >= 0);
+
+        node* literal = literals[choice];
+        literals[choice] = 0;
+        bind(bound, literal);
+        ordered.append(literal);
+    }
+
+    return true;
+}
+
+void apply_literal_order(node* clause, node_array& ordered)
+{
+    for (node* n = clause; n != 0; n = preorder_traversal_next(clause, n))
+    {
+        if (is_term_variable(n) && definition(n) && is_inside(definition(n), clause))
+        {
+            annotation<term_ann>(n)->var_def = 0;
+        }
+    }
+
+    for (unsigned i = 0; i < ordered.size(); ++i)
+    {
+        detach_node(ordered[i]);
+    }
+
+    for (unsigned i = 0; i < ordered.size(); ++i)
+    {
+        append_child(clause, ordered[i]);
+    }
+
+    // variables introduced by the clause are linked to their new first occurrence.
+    for (node* n = clause; n != 0; n = preorder_traversal_next(clause, n))
+    {
+        if (!is_term_variable(n) || definition(n))
+        {
+            continue;
+        }
+
+        for (node* m = preorder_traversal_next(clause, n); m != 0; m = preorder_traversal_next(clause, m))
+        {
+            if (is_term_variable(m) && !definition(m) && strcmp(m->s_expr->token, n->s_expr->token) == 0)
+            {
+                annotation<term_ann>(m)->var_def = n;
+            }
+        }
+    }
+}
+
+unsigned reorder_literals(tree& ast)
+{
+    unsigned reordered = 0;
+
+    for (id_table_values methods = ast.methods.values(); !methods.empty(); methods.pop())
+    {
+        node* method = methods.value();
+
+        for (node* branch = method->first_child->next_sibling; branch != 0; branch = branch->next_sibling)
+        {
+            node* precondition = branch->first_child;
+            bool changed = false;
+
+            for (node* clause = precondition->first_child; clause != 0; clause = clause->next_sibling)
+            {
+                node_array ordered;
+
+                if (!is_op_and(clause) || !order_literals(ast, clause, 0, ordered))
+                {
+                    continue;
+                }
+
+                unsigned index = 0;
+                bool clause_changed = false;
+
+                for (node* literal = clause->first_child; literal != 0; literal = literal->next_sibling, ++index)
+                {
+                    clause_changed |= (literal != ordered[index]);
+                }
+
+                if (clause_changed)
+                {
+                    apply_literal_order(clause, ordered);
+                    changed = true;
+                    ++reordered;
+                }
+            }
+
+            if (changed)
+            {
+                relink_branch(branch);
+            }
+        }
+    }
+
+    return reordered;
+}
+
+}
+}
@@ -0,0 +1,44 @@
+//
+// Copyright (c) 2013 Alexander Shafranov shafranov@gmail.com
+//
+// This software is provided 'as-is', without any express or implied
+// warranty.  In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software. If you use this software
+// in a product, an acknowledgment in the product documentation would be
+// appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+
+#ifndef DERPLANNER_COMPILER_AST_REORDER_H_
+#define DERPLANNER_COMPILER_AST_REORDER_H_
+
+namespace plnnrc {
+
+class node_array;
+
+namespace ast { struct node; }
+namespace ast { class tree; }
+
+namespace ast {
+
+// computes evaluation order of the literals in conjunction `clause`, starting with atom `lead` as soon
+// as it can be evaluated (or picking atoms by selectivity if `lead` is 0).
+// returns false if the clause has less than two literals or its written order is not a valid one.
+bool order_literals(tree& ast, node* clause, node* lead, node_array& ordered);
+
+// rearranges literals of `clause` and relinks variables introduced by the clause.
+void apply_literal_order(node* clause, node_array& ordered);
+
+}
+}
+
+#endif
@@ -0,0 +1,133 @@
+//
+// Copyright (c) 2013 Alexander Shafranov shafranov@gmail.com
+//
+// This software is provided 'as-is', without any express or implied
+// warranty.  In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software. If you use this software
+// in a product, an acknowledgment in the product documentation would be
+// appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+
+#include "derplanner/compiler/assert.h"
+#include "derplanner/compiler/s_expression.h"
+#include "derplanner/compiler/ast.h"
+#include "derplanner/compiler/ast_build.h"
+#include "tree_tools.h"
+#include "ast_tools.h"
+
+namespace plnnrc {
+namespace ast {
+
+namespace
+{
+    void mark_modified_atoms(tree& ast, node* effects)
+    {
+        for (node* atom = effects->first_child; atom != 0; atom = atom->next_sibling)
+        {
+            node* ws_atom = ast.ws_atoms.find(atom->s_expr->token);
+
+            if (ws_atom)
+            {
+                annotation<atom_ann>(ws_atom)->modified = true;
+            }
+        }
+    }
+
+    // number of precondition occurrences of `ws_atom` where argument `key` is known before the atom is visited.
+    int count_bound_uses(tree& ast, node* ws_atom, int key)
+    {
+        int uses = 0;
+
+        for (id_table_values methods = ast.methods.values(); !methods.empty(); methods.pop())
+        {
+            node* method = methods.value();
+
+            for (node* branch = method->first_child->next_sibling; branch != 0; branch = branch->next_sibling)
+            {
+                node* precondition = branch->first_child;
+
+                for (node* n = precondition; n != 0; n = preorder_traversal_next(precondition, n))
+                {
+                    if (!is_atom(n) || ast.ws_atoms.find(n->s_expr->token) != ws_atom)
+                    {
+                        continue;
+                    }
+
+                    node* arg = n->first_child;
+
+                    for (int i = 0; i < key && arg != 0; ++i)
+                    {
+                        arg = arg->next_sibling;
+                    }
+
+                    if (arg && (is_term_call(arg) || is_term_constant(arg) || (is_term_variable(arg) && is_bound(arg))))
+                    {
+                        ++uses;
+                    }
+                }
+            }
+        }
+
+        return uses;
+    }
+}
+
+unsigned find_static_atoms(tree& ast)
+{
+    // effects are listed by operators and inline in task lists.
+    for (node* n = ast.root(); n != 0; n = preorder_traversal_next(ast.root(), n))
+    {
+        if (is_effect_list(n))
+        {
+            mark_modified_atoms(ast, n);
+        }
+    }
+
+    unsigned num_indexed = 0;
+
+    for (id_table_values atoms = ast.ws_atoms.values(); !atoms.empty(); atoms.pop())
+    {
+        node* ws_atom = atoms.value();
+        atom_ann* ann = annotation<atom_ann>(ws_atom);
+
+        if (ann->modified)
+        {
+            continue;
+        }
+
+        int best_uses = 0;
+        int key = 0;
+
+        for (node* param = ws_atom->first_child; param != 0; param = param->next_sibling, ++key)
+        {
+            int uses = count_bound_uses(ast, ws_atom, key);
+
+            if (uses > best_uses)
+            {
+                best_uses = uses;
+                ann->index_key = key;
+            }
+        }
+
+        if (best_uses > 0)
+        {
+            ann->indexed = true;
+            ++num_indexed;
+        }
+    }
+
+    return num_indexed;
+}
+
+}
+}
@@ -66,6 +66,11 @@ inline bool all_unbound(node* atom)
     return true;
 }
 
+inline bool is_term_constant(node* term)
+{
+    return is_term_int(term) || is_term_float(term);
+}
+
 inline node* definition(node* var)
 {
     plnnrc_assert(is_term_variable(var));
@@ -110,6 +115,29 @@ inline void type_tag(node* node, int new_type_tag)
     annotation<term_ann>(node)->type_tag = new_type_tag;
 }
 
+// true if the world function called by `call` is declared ':pure' and its results are memoized.
+inline bool is_pure_function(tree& ast, node* call)
+{
+    plnnrc_assert(is_term_call(call));
+    node* function_def = ast.ws_funcs.find(call->s_expr->token);
+    plnnrc_assert(function_def);
+    return annotation<func_ann>(function_def)->pure;
+}
+
+// true if some world function is declared ':pure', then generated code takes `memo_tables`.
+inline bool has_pure_functions(tree& ast)
+{
+    for (id_table_values funcs = ast.ws_funcs.values(); !funcs.empty(); funcs.pop())
+    {
+        if (annotation<func_ann>(funcs.value())->pure)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
 inline node* first_parameter_usage(node* parameter, node* precondition)
 {
     for (node* var = precondition; var != 0; var = preorder_traversal_next(precondition, var))
@@ -123,6 +151,81 @@ inline node* first_parameter_usage(node* parameter, node* precondition)
     return 0;
 }
 
+// true if any variable in the subtree is bound by the branch precondition (and not by a parameter).
+inline bool depends_on_precondition(node* root)
+{
+    for (node* var = root; var != 0; var = preorder_traversal_next(root, var))
+    {
+        if (is_term_variable(var))
+        {
+            node* def = definition(var);
+
+            if (def && !is_parameter(def))
+            {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+// task lists may contain nested task lists spliced in by method inlining.
+inline node* first_task(node* tasklist)
+{
+    for (node* child = tasklist->first_child; child != 0; child = child->next_sibling)
+    {
+        if (!is_task_list(child))
+        {
+            return child;
+        }
+
+        node* task = first_task(child);
+
+        if (task)
+        {
+            return task;
+        }
+    }
+
+    return 0;
+}
+
+inline node* next_task(node* tasklist, node* task)
+{
+    for (node* n = task; n != tasklist; n = n->parent)
+    {
+        for (node* sibling = n->next_sibling; sibling != 0; sibling = sibling->next_sibling)
+        {
+            if (!is_task_list(sibling))
+            {
+                return sibling;
+            }
+
+            node* first = first_task(sibling);
+
+            if (first)
+            {
+                return first;
+            }
+        }
+    }
+
+    return 0;
+}
+
+inline node* last_task(node* tasklist)
+{
+    node* last = 0;
+
+    for (node* task = first_task(tasklist); task != 0; task = next_task(tasklist, task))
+    {
+        last = task;
+    }
+
+    return last;
+}
+
 inline bool is_lazy(node* atom)
 {
     return is_atom(atom) && annotation<atom_ann>(atom)->lazy;
@@ -151,6 +254,20 @@ inline node* find_child(node* parent, node_type type)
     return 0;
 }
 
+// cost term of an operator, 0 if it has no ':cost'.
+inline node* operator_cost(node* operatr)
+{
+    node* cost = find_child(operatr, node_cost);
+    return cost ? cost->first_child : 0;
+}
+
+// key term of a ':sort-by' branch, 0 for other branches.
+inline node* branch_sort_key(node* branch)
+{
+    node* sort_by = find_child(branch, node_sort_by);
+    return sort_by ? sort_by->first_child : 0;
+}
+
 inline node* find_descendant(node* parent, node_type type)
 {
     for (node* n = parent; n != 0; n = preorder_traversal_next(parent, n))
@@ -90,6 +90,12 @@ node* build_worldstate(tree& ast, sexpr::node* s_expr)
             PLNNRC_CHECK_NODE(return_type, build_worldstate_type(ast, return_type_expr, type_tag));
             append_child(function_def, return_type);
 
+            if (return_type_expr->next_sibling)
+            {
+                PLNNRC_CONTINUE(expect_next_token(ast, return_type_expr, token_pure, worldstate));
+                annotation<func_ann>(function_def)->pure = true;
+            }
+
             append_child(worldstate, function_def);
         }
         else
@@ -131,6 +137,14 @@ node* build_worldstate_atom(tree& ast, sexpr::node* s_expr, int& type_tag)
 
     for (sexpr::node* t_expr = s_expr->first_child->next_sibling; t_expr != 0; t_expr = t_expr->next_sibling)
     {
+        if (is_token(t_expr, token_size))
+        {
+            PLNNRC_RETURN(expect_next_type(ast, t_expr, sexpr::node_int));
+            t_expr = t_expr->next_sibling;
+            annotation<atom_ann>(atom)->cardinality = sexpr::as_int(t_expr);
+            continue;
+        }
+
         PLNNRC_RETURN(expect_type(ast, t_expr, sexpr::node_list));
         PLNNRC_CHECK_NODE(type_node, build_worldstate_type(ast, t_expr, type_tag));
         append_child(atom, type_node);
@@ -124,7 +124,7 @@ bool generate_header(ast::tree& ast, writer& writer, codegen_options options)
         namespace_wrap wrap(domain_namespace, output);
         generate_task_type_enum(ast, domain, output);
         generate_param_structs(ast, domain, output);
-        generate_forward_decls(ast, domain, output);
+        generate_forward_decls(ast, domain, options, output);
     }
 
     if (options.enable_reflection)
@@ -169,6 +169,8 @@ bool generate_source(ast::tree& ast, writer& writer, codegen_options options)
 
         namespace_wrap wrap(worldstate_namespace, output, domain != 0);
         generate_atom_name_function(ast, worldstate, options.runtime_atom_names, output);
+        generate_memoized_functions(ast, worldstate, output);
+        generate_static_index_functions(ast, worldstate, output);
     }
 
     if (domain)
@@ -178,8 +180,18 @@ bool generate_source(ast::tree& ast, writer& writer, codegen_options options)
 
         namespace_wrap wrap(domain_namespace, output, false);
         generate_task_name_function(ast, domain, options.runtime_task_names, output);
-        generate_preconditions(ast, domain, output);
-        generate_branch_expands(ast, domain, output);
+        if (!generate_preconditions(ast, domain, options, output))
+        {
+            return false;
+        }
+
+        if (!options.inline_operator_effects)
+        {
+            generate_operator_effect_functions(ast, domain, options, output);
+        }
+
+        generate_branch_expands(ast, domain, options, output);
+        generate_expand_table(ast, domain, options, output);
     }
 
     return true;
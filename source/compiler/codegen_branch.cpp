@@ -18,11 +18,14 @@
 // 3. This notice may not be removed or altered from any source distribution.
 //
 
+#include <string.h>
 #include "derplanner/compiler/assert.h"
 #include "derplanner/compiler/s_expression.h"
 #include "derplanner/compiler/ast.h"
+#include "derplanner/compiler/codegen.h"
 #include "ast_tools.h"
 #include "formatter.h"
+#include "codegen_coroutine.h"
 #include "codegen_branch.h"
 
 namespace plnnrc {
@@ -30,68 +33,883 @@ namespace plnnrc {
 class paste_function_call : public paste_func
 {
 public:
+    ast::tree& tree;
     ast::node* function_call;
+    // expression giving the memo tables for ':pure' functions.
+    const char* memo;
 
-    paste_function_call(ast::node* function_call)
-        : function_call(function_call)
+    paste_function_call(ast::tree& tree, ast::node* function_call, const char* memo="pstate.memo")
+        : tree(tree)
+        , function_call(function_call)
+        , memo(memo)
     {
     }
 
     virtual void operator()(formatter& output)
     {
-        output.put_id(function_call->s_expr->token);
-        output.put_char('(');
+        bool memoized = ast::is_pure_function(tree, function_call);
+
+        if (memoized)
+        {
+            output.put_id(function_call->s_expr->token);
+            output.put_str("_memoized(*wstate, ");
+            output.put_str(memo);
+        }
+        else
+        {
+            output.put_str("wstate->");
+            output.put_id(function_call->s_expr->token);
+            output.put_char('(');
+        }
 
         for (ast::node* argument = function_call->first_child; argument != 0; argument = argument->next_sibling)
         {
-            switch (argument->type)
+            if (memoized || argument != function_call->first_child)
+            {
+                output.put_str(", ");
+            }
+
+            switch (argument->type)
+            {
+            case ast::node_term_variable:
+                {
+                    ast::node* def = definition(argument);
+                    plnnrc_assert(def);
+                    int var_index = ast::annotation<ast::term_ann>(def)->var_index;
+
+                    if (is_operator_parameter(def))
+                    {
+                        output.put_str("a->_");
+                        output.put_int(var_index);
+                    }
+                    else if (is_method_parameter(def))
+                    {
+                        output.put_str("method_args->_");
+                        output.put_int(var_index);
+                    }
+                    else
+                    {
+                        output.put_str("precondition->_");
+                        output.put_int(var_index);
+                    }
+                }
+                break;
+            case ast::node_term_call:
+                {
+                    paste_function_call paste(tree, argument);
+                    paste(output);
+                }
+                break;
+            case ast::node_term_int:
+            case ast::node_term_float:
+                output.put_str(argument->s_expr->token);
+                break;
+            default:
+                // unsupported argument type
+                plnnrc_assert(false);
+            }
+        }
+
+        output.put_char(')');
+    }
+};
+
+// upper bound of the method frame size: header, arguments, precondition state and sorted bindings.
+class paste_frame_size : public paste_func
+{
+public:
+    ast::node* method;
+    unsigned precondition_index;
+    bool sorted;
+
+    paste_frame_size(ast::node* method, unsigned precondition_index, bool sorted)
+        : method(method)
+        , precondition_index(precondition_index)
+        , sorted(sorted)
+    {
+    }
+
+    virtual void operator()(formatter& output)
+    {
+        output.put_str("sizeof(method_instance)");
+
+        if (has_parameters(method))
+        {
+            output.put_str(" + padded_size<");
+            output.put_id(method->first_child->s_expr->token);
+            output.put_str("_args>::value");
+        }
+
+        output.put_str(" + padded_size<p");
+        output.put_int(int(precondition_index));
+        output.put_str("_state>::value");
+
+        if (sorted)
+        {
+            output.put_str(" + padded_size<p");
+            output.put_int(int(precondition_index));
+            output.put_str("_sorted>::value");
+        }
+    }
+};
+
+namespace
+{
+    // assigns task atom arguments to the fields of `target` (e.g. "a->" or "args.").
+    void generate_task_arguments(ast::tree& ast, ast::node* task_atom, const char* target, formatter& output)
+    {
+        int param_index = 0;
+
+        for (ast::node* arg = task_atom->first_child; arg != 0; arg = arg->next_sibling)
+        {
+            if (ast::is_term_variable(arg))
+            {
+                ast::node* def = definition(arg);
+                plnnrc_assert(def);
+                int var_index = ast::annotation<ast::term_ann>(def)->var_index;
+
+                if (is_parameter(def))
+                {
+                    output.writeln("%s_%d = method_args->_%d;", target, param_index, var_index);
+                }
+                else
+                {
+                    output.writeln("%s_%d = precondition->_%d;", target, param_index, var_index);
+                }
+            }
+
+            if (ast::is_term_call(arg))
+            {
+                paste_function_call paste(ast, arg);
+                output.writeln("%s_%d = %p;", target, param_index, &paste);
+            }
+
+            if (ast::is_term_constant(arg))
+            {
+                output.writeln("%s_%d = %s;", target, param_index, arg->s_expr->token);
+            }
+
+            ++param_index;
+        }
+    }
+
+    // branch of the task list containing `task`, walking out of inlined task lists.
+    ast::node* enclosing_branch(ast::node* task)
+    {
+        ast::node* n = task;
+
+        while (n && !ast::is_branch(n))
+        {
+            n = n->parent;
+        }
+
+        return n;
+    }
+
+    // variables with the same key always hold the same value.
+    ast::node* variable_key(ast::node* var)
+    {
+        ast::node* def = definition(var);
+        return def ? def : var;
+    }
+
+    // key of the value passed for `arg` of an effect, resolving operator parameters through the call site.
+    ast::node* effect_argument_key(ast::node* task, ast::node* arg)
+    {
+        if (!ast::is_term_variable(arg))
+        {
+            return 0;
+        }
+
+        ast::node* def = definition(arg);
+
+        if (def && is_operator_parameter(def))
+        {
+            plnnrc_assert(ast::is_atom(task));
+
+            ast::node* call_arg = task->first_child;
+
+            for (ast::node* param = def->parent->first_child; param != def; param = param->next_sibling)
+            {
+                call_arg = call_arg->next_sibling;
+            }
+
+            if (!call_arg || !ast::is_term_variable(call_arg))
+            {
+                return 0;
+            }
+
+            return variable_key(call_arg);
+        }
+
+        return variable_key(arg);
+    }
+
+    bool deletes_atom(ast::node* effects, const char* atom_id, ast::node* until)
+    {
+        for (ast::node* effect = effects->first_child; effect != 0 && effect != until; effect = effect->next_sibling)
+        {
+            if (strcmp(effect->s_expr->token, atom_id) == 0)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    // true if tuples of `atom_id` could have been removed by the branch before `task` executes `effect`.
+    bool may_delete_before(ast::tree& ast, ast::node* tasklist, ast::node* task, ast::node* effects, ast::node* effect)
+    {
+        const char* atom_id = effect->s_expr->token;
+
+        if (deletes_atom(effects, atom_id, effect))
+        {
+            return true;
+        }
+
+        for (ast::node* prev = first_task(tasklist); prev != task; prev = next_task(tasklist, prev))
+        {
+            plnnrc_assert(prev);
+
+            if (ast::is_delete_list(prev) && deletes_atom(prev, atom_id, 0))
+            {
+                return true;
+            }
+
+            if (is_lazy(prev) || ast::is_effect_list(prev))
+            {
+                continue;
+            }
+
+            if (is_method(ast, prev))
+            {
+                return true;
+            }
+
+            ast::node* operatr = ast.operators.find(prev->s_expr->token);
+
+            if (operatr && deletes_atom(operatr->first_child->next_sibling, atom_id, 0))
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    // positive precondition atom which matched exactly the tuple removed by `effect` and still points to it, or 0.
+    ast::node* find_bound_tuple(ast::tree& ast, ast::node* task, ast::node* effects, ast::node* effect)
+    {
+        ast::node* branch = task ? enclosing_branch(task) : 0;
+
+        if (!branch)
+        {
+            return 0;
+        }
+
+        ast::node* precondition = branch->first_child;
+        ast::node* tasklist = precondition->next_sibling;
+        ast::node* clause = precondition->first_child;
+
+        // with several clauses the matched atom depends on which one was satisfied.
+        if (!clause || clause->next_sibling)
+        {
+            return 0;
+        }
+
+        if (may_delete_before(ast, tasklist, task, effects, effect))
+        {
+            return 0;
+        }
+
+        for (ast::node* atom = clause->first_child; atom != 0; atom = atom->next_sibling)
+        {
+            if (!ast::is_atom(atom) || strcmp(atom->s_expr->token, effect->s_expr->token) != 0)
+            {
+                continue;
+            }
+
+            ast::node* atom_arg = atom->first_child;
+            ast::node* effect_arg = effect->first_child;
+
+            for (; atom_arg != 0 && effect_arg != 0; atom_arg = atom_arg->next_sibling, effect_arg = effect_arg->next_sibling)
+            {
+                if (ast::is_term_constant(atom_arg) && atom_arg->type == effect_arg->type && strcmp(atom_arg->s_expr->token, effect_arg->s_expr->token) == 0)
+                {
+                    continue;
+                }
+
+                ast::node* key = effect_argument_key(task, effect_arg);
+
+                if (!key || !ast::is_term_variable(atom_arg) || variable_key(atom_arg) != key)
+                {
+                    break;
+                }
+            }
+
+            if (!atom_arg && !effect_arg)
+            {
+                return atom;
+            }
+        }
+
+        return 0;
+    }
+
+    // comments each nested task list (spliced by inlining) which starts with this task, outermost first.
+    void generate_inline_comments(ast::node* tasklist, ast::node* task, formatter& output)
+    {
+        if (task->parent == tasklist || !is_first(task))
+        {
+            return;
+        }
+
+        generate_inline_comments(tasklist, task->parent, output);
+        output.writeln("// inlined %s", task->parent->s_expr->token);
+    }
+
+    // non-lazy operator task with a ':cost' term.
+    bool has_cost(ast::tree& ast, ast::node* task_atom)
+    {
+        return !is_lazy(task_atom) && is_operator(ast, task_atom) && operator_cost(ast.operators.find(task_atom->s_expr->token));
+    }
+
+    // adds the operator cost to the accumulated plan cost stored in the pushed task `t`.
+    void generate_operator_cost(ast::tree& ast, ast::node* task_atom, formatter& output)
+    {
+        ast::node* cost = operator_cost(ast.operators.find(task_atom->s_expr->token));
+
+        if (ast::is_term_variable(cost))
+        {
+            output.writeln("add_cost(t, a->_%d);", ast::annotation<ast::term_ann>(definition(cost))->var_index);
+        }
+
+        if (ast::is_term_call(cost))
+        {
+            paste_function_call paste(ast, cost);
+            output.writeln("add_cost(t, %p);", &paste);
+        }
+
+        if (ast::is_term_constant(cost))
+        {
+            output.writeln("add_cost(t, %s);", cost->s_expr->token);
+        }
+    }
+
+    // last branch whose tasks don't depend on precondition bindings:
+    // a failed method task fails the whole method instead of trying other bindings.
+    bool is_committed(ast::node* branch)
+    {
+        if (!is_last(branch) || ast::annotation<ast::branch_ann>(branch)->foreach)
+        {
+            return false;
+        }
+
+        ast::node* tasklist = branch->first_child->next_sibling;
+
+        for (ast::node* task_atom = first_task(tasklist); task_atom != 0; task_atom = next_task(tasklist, task_atom))
+        {
+            if (depends_on_precondition(task_atom))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool is_infallible(ast::tree& ast, ast::node* method);
+
+    // precondition in disjunctive normal form with an empty conjunct.
+    bool is_always_true(ast::node* precondition)
+    {
+        for (ast::node* clause = precondition->first_child; clause != 0; clause = clause->next_sibling)
+        {
+            if (ast::is_op_and(clause) && !clause->first_child)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    bool is_infallible_branch(ast::tree& ast, ast::node* branch)
+    {
+        ast::node* precondition = branch->first_child;
+        ast::node* tasklist = precondition->next_sibling;
+
+        if (ast::annotation<ast::branch_ann>(branch)->foreach || !ast::is_op_or(precondition) || !is_always_true(precondition))
+        {
+            return false;
+        }
+
+        for (ast::node* task_atom = first_task(tasklist); task_atom != 0; task_atom = next_task(tasklist, task_atom))
+        {
+            // costed operators fail in branch-and-bound search.
+            if (has_cost(ast, task_atom))
+            {
+                return false;
+            }
+
+            if (!is_lazy(task_atom) && is_method(ast, task_atom) && !is_infallible(ast, ast.methods.find(task_atom->s_expr->token)))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    // some branch always expands, so the method never fails. recursion is assumed to fail.
+    bool is_infallible(ast::tree& ast, ast::node* method)
+    {
+        ast::method_ann* ann = ast::annotation<ast::method_ann>(method);
+
+        if (ann->infallible == 0)
+        {
+            ann->infallible = 1;
+
+            bool infallible = false;
+
+            for (ast::node* branch = method->first_child->next_sibling; branch != 0 && !infallible; branch = branch->next_sibling)
+            {
+                infallible = is_infallible_branch(ast, branch);
+            }
+
+            ann->infallible = infallible ? 3 : 2;
+        }
+
+        return ann->infallible == 3;
+    }
+
+    // the last task of a non-foreach branch is a method call, which either can't fail
+    // or the parent has nothing else to try when it does, so the callee can take over the parent's frame.
+    bool is_tail_call(ast::tree& ast, ast::node* branch)
+    {
+        ast::node* tasklist = branch->first_child->next_sibling;
+
+        ast::node* last = last_task(tasklist);
+
+        if (!last || is_lazy(last) || !is_method(ast, last) || ast::annotation<ast::branch_ann>(branch)->foreach)
+        {
+            return false;
+        }
+
+        return is_committed(branch) || is_infallible(ast, ast.methods.find(last->s_expr->token));
+    }
+
+    const char* sort_key_type(ast::tree& ast, ast::node* sort_key)
+    {
+        if (ast::is_term_variable(sort_key))
+        {
+            return ast.type_tag_to_node[ast::type_tag(definition(sort_key))]->s_expr->first_child->token;
+        }
+
+        if (ast::is_term_call(sort_key))
+        {
+            ast::node* return_type = ast.ws_funcs.find(sort_key->s_expr->token)->first_child->next_sibling;
+            return return_type->s_expr->first_child->token;
+        }
+
+        return ast::is_term_int(sort_key) ? "int" : "float";
+    }
+
+    bool uses_method_parameters(ast::node* root)
+    {
+        for (ast::node* var = root; var != 0; var = preorder_traversal_next(root, var))
+        {
+            if (ast::is_term_variable(var) && is_parameter(definition(var)))
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    // yields the bindings of precondition `precondition_index` in batches sorted by the ':sort-by' key.
+    void generate_sorted_next(ast::tree& ast, ast::node* method, ast::node* sort_key, unsigned precondition_index, const codegen_options& options, formatter& output)
+    {
+        const char* method_name = method->first_child->s_expr->token;
+        const char* memo_param = ast::has_pure_functions(ast) ? ", void* memo" : "";
+
+        output.writeln("typedef sorted_bindings<p%d_state, %s, %d> p%d_sorted;", precondition_index, sort_key_type(ast, sort_key), options.sort_buffer_size, precondition_index);
+        output.newline();
+
+        if (uses_method_parameters(sort_key))
+        {
+            output.writeln("bool next(p%d_sorted& sorted, p%d_state* precondition, worldstate* wstate%s, %i_args* method_args)", precondition_index, precondition_index, memo_param, method_name);
+        }
+        else
+        {
+            output.writeln("bool next(p%d_sorted& sorted, p%d_state* precondition, worldstate* wstate%s)", precondition_index, precondition_index, memo_param);
+        }
+
+        {
+            scope s(output);
+
+            output.writeln("if (begin_batch(sorted, *precondition))");
+            {
+                scope s(output);
+
+                output.writeln("while (!batch_full(sorted) && next(*precondition, *wstate%s))", ast::has_pure_functions(ast) ? ", memo" : "");
+                {
+                    scope s(output);
+
+                    if (ast::is_term_variable(sort_key))
+                    {
+                        ast::node* def = definition(sort_key);
+                        int var_index = ast::annotation<ast::term_ann>(def)->var_index;
+                        output.writeln("insert_binding(sorted, *precondition, %s_%d);", is_parameter(def) ? "method_args->" : "precondition->", var_index);
+                    }
+
+                    if (ast::is_term_call(sort_key))
+                    {
+                        paste_function_call paste(ast, sort_key, "memo");
+                        output.writeln("insert_binding(sorted, *precondition, %p);", &paste);
+                    }
+
+                    if (ast::is_term_constant(sort_key))
+                    {
+                        output.writeln("insert_binding(sorted, *precondition, %s);", sort_key->s_expr->token);
+                    }
+                }
+
+                output.writeln("end_batch(sorted, *precondition);");
+            }
+
+            output.writeln("return next_binding(sorted, *precondition);");
+        }
+    }
+}
+
+void generate_operator_effect_functions(ast::tree& ast, ast::node* domain, const codegen_options& options, formatter& output)
+{
+    for (ast::node* operatr = domain->first_child; operatr != 0; operatr = operatr->next_sibling)
+    {
+        if (!ast::is_operator(operatr))
+        {
+            continue;
+        }
+
+        ast::node* atom = operatr->first_child;
+        ast::node* effects_delete = atom->next_sibling;
+        ast::node* effects_add = effects_delete->next_sibling;
+
+        if (!effects_delete->first_child && !effects_add->first_child)
+        {
+            continue;
+        }
+
+        const char* operator_id = atom->s_expr->token;
+
+        if (atom->first_child)
+        {
+            output.writeln("void apply_%i(planner_state& pstate, worldstate* wstate, %i_args* a)", operator_id, operator_id);
+        }
+        else
+        {
+            output.writeln("void apply_%i(planner_state& pstate, worldstate* wstate)", operator_id);
+        }
+
+        {
+            scope s(output);
+
+            if (effects_delete->first_child)
+            {
+                generate_effects_delete(ast, 0, effects_delete, options, output);
+
+                if (effects_add->first_child)
+                {
+                    output.newline();
+                }
+            }
+
+            if (effects_add->first_child)
+            {
+                generate_effects_add(ast, effects_add, output);
+            }
+        }
+    }
+}
+
+namespace
+{
+    // coroutine expanding `branch`: the body of its expand function, or its case of `dispatch_expand` with `single_dispatch`.
+    void generate_branch_body(ast::tree& ast, ast::node* method, ast::node* branch, unsigned branch_index, unsigned precondition_index, const codegen_options& options, formatter& output)
+    {
+        ast::node* atom = method->first_child;
+        const char* method_name = atom->s_expr->token;
+        ast::branch_ann* ann = ast::annotation<ast::branch_ann>(branch);
+        ast::node* precondition = branch->first_child;
+        ast::node* tasklist = precondition->next_sibling;
+        ast::node* sort_key = ast::branch_sort_key(branch);
+
+        output.writeln("p%d_state* precondition = plnnr::precondition<p%d_state>(method);", precondition_index, precondition_index);
+
+        if (sort_key)
+        {
+            output.writeln("p%d_sorted* sorted = sorted_bindings_of<p%d_sorted>(method);", precondition_index, precondition_index);
+        }
+
+        if (has_parameters(method))
+        {
+            output.writeln("%i_args* method_args = plnnr::arguments<%i_args>(method);", method_name, method_name);
+        }
+
+        output.writeln("worldstate* wstate = static_cast<worldstate*>(world);");
+
+        output.newline();
+        generate_coroutine_begin("*method", options.computed_goto, output);
+        output.newline();
+
+        int last_stage = 0;
+
+        if (is_committed(branch))
+        {
+            output.writeln("method->flags |= method_flags_committed;");
+        }
+
+        output.writeln("precondition = push_precondition<p%d_state>(pstate, method);", precondition_index);
+
+        for (ast::node* param = atom->first_child; param != 0; param = param->next_sibling)
+        {
+            ast::node* var = first_parameter_usage(param, precondition);
+
+            if (var)
+            {
+                int param_index = ast::annotation<ast::term_ann>(param)->var_index;
+                int var_index = ast::annotation<ast::term_ann>(var)->var_index;
+
+                output.writeln("precondition->_%d = method_args->_%d;", var_index, param_index);
+            }
+        }
+
+        if (sort_key)
+        {
+            output.writeln("sorted = push_sorted_bindings<p%d_sorted>(pstate, method);", precondition_index);
+        }
+
+        output.newline();
+
+        const char* memo_arg = ast::has_pure_functions(ast) ? ", pstate.memo" : "";
+
+        if (!sort_key)
+        {
+            output.writeln("while (next(*precondition, *wstate%s))", memo_arg);
+        }
+        else if (uses_method_parameters(sort_key))
+        {
+            output.writeln("while (next(*sorted, precondition, wstate%s, method_args))", memo_arg);
+        }
+        else
+        {
+            output.writeln("while (next(*sorted, precondition, wstate%s))", memo_arg);
+        }
+
+        {
+            scope s(output);
+
+            if (!first_task(tasklist))
             {
-            case ast::node_term_variable:
+                if (!ann->foreach)
                 {
-                    ast::node* def = definition(argument);
-                    plnnrc_assert(def);
-                    int var_index = ast::annotation<ast::term_ann>(def)->var_index;
+                    output.writeln("method->flags |= method_flags_expanded;");
+                }
 
-                    if (is_operator_parameter(def))
+                generate_coroutine_yield("*method", ++last_stage, options.computed_goto, output);
+            }
+
+            // while none of the tasks so far depend on precondition bindings,
+            // other bindings can't change the outcome of a failed method task.
+            // this only prunes bindings of the current branch, failures still
+            // propagate to the parent frame one level at a time.
+            bool binding_independent = !ann->foreach;
+            bool tail_call = is_tail_call(ast, branch);
+
+            for (ast::node* task_atom = first_task(tasklist); task_atom != 0; task_atom = next_task(tasklist, task_atom))
+            {
+                binding_independent = binding_independent && !depends_on_precondition(task_atom);
+                bool last = !next_task(tasklist, task_atom);
+
+                generate_inline_comments(tasklist, task_atom, output);
+
+                {
+                    scope s(output);
+
+                    if (ast::is_add_list(task_atom))
                     {
-                        output.put_str("a->_");
-                        output.put_int(var_index);
+                        generate_effects_add(ast, task_atom, output);
                     }
-                    else if (is_method_parameter(def))
+                    else if (ast::is_delete_list(task_atom))
                     {
-                        output.put_str("method_args->_");
-                        output.put_int(var_index);
+                        generate_effects_delete(ast, task_atom, task_atom, options, output);
+                    }
+                    else if (is_lazy(task_atom))
+                    {
+                        generate_operator_task(ast, method, task_atom, options, output);
+                    }
+                    else if (is_operator(ast, task_atom))
+                    {
+                        generate_operator_task(ast, method, task_atom, options, output);
+                    }
+                    else if (last && tail_call)
+                    {
+                        generate_tail_method_task(ast, method, task_atom, output);
+                    }
+                    else if (is_method(ast, task_atom))
+                    {
+                        generate_method_task(ast, method, task_atom, output);
                     }
                     else
                     {
-                        output.put_str("precondition->_");
-                        output.put_int(var_index);
+                        // unknown construct in task list
+                        plnnrc_assert(false);
                     }
                 }
-                break;
-            case ast::node_term_call:
+
+                if (last && tail_call && is_committed(branch))
                 {
-                    paste_function_call paste(argument);
-                    output.put_str("wstate->");
-                    paste(output);
+                    output.writeln("return true;");
+                    continue;
+                }
+
+                // parent frame is kept when enumerating plans, then it yields like for a regular call.
+                if (last && tail_call)
+                {
+                    output.writeln("if (prev_method(top_method(pstate)) != method)");
+                    {
+                        scope s(output, false);
+                        output.writeln("return true;");
+                    }
+
+                    output.newline();
+                }
+
+                if (last && !ann->foreach)
+                {
+                    output.writeln("method->flags |= method_flags_expanded;");
+                }
+
+                if (last || !is_effect_list(task_atom))
+                {
+                    generate_coroutine_yield("*method", ++last_stage, options.computed_goto, output);
+
+                    if (!last)
+                    {
+                        output.newline();
+
+                        // branch-and-bound search fails tasks which make the plan too expensive.
+                        if (is_method(ast, task_atom) || has_cost(ast, task_atom))
+                        {
+                            output.writeln("if (method->flags & method_flags_failed)");
+                            {
+                                scope s(output, true);
+                                // binding independent: skip the remaining bindings of this branch.
+                                output.writeln(binding_independent ? "break;" : "continue;");
+                            }
+                        }
+                    }
+                    else if (binding_independent && (is_method(ast, task_atom) || has_cost(ast, task_atom)))
+                    {
+                        output.newline();
+                        output.writeln("if (method->flags & method_flags_failed)");
+                        {
+                            scope s(output, false);
+                            output.writeln("break;");
+                        }
+                    }
                 }
-                break;
-            default:
-                // unsupported argument type
-                plnnrc_assert(false);
             }
+        }
 
-            if (!is_last(argument))
+        if (ann->foreach)
+        {
+            output.writeln("if (precondition->stage > 0)");
             {
-                output.put_str(", ");
+                scope s(output);
+                output.writeln("method->flags |= method_flags_expanded;");
+                generate_coroutine_yield("*method", ++last_stage, options.computed_goto, output);
             }
         }
 
-        output.put_char(')');
+        if (!is_last(branch) && options.single_dispatch)
+        {
+            output.writeln("select_next_branch(pstate, expand_%i_branch_%d);", method_name, branch_index+1);
+            output.writeln("goto %i_branch_%d;", method_name, branch_index+1);
+        }
+        else if (!is_last(branch))
+        {
+            output.writeln("return expand_next_branch(pstate, expand_%i_branch_%d, world);", method_name, branch_index+1);
+        }
+
+        generate_coroutine_end("*method", last_stage, options.computed_goto, output);
     }
-};
 
-void generate_branch_expands(ast::tree& ast, ast::node* domain, formatter& output)
+    // single function with the coroutines of all branches, which continues with the next branch by a jump.
+    void generate_dispatch_expand(ast::tree& ast, ast::node* domain, const codegen_options& options, formatter& output)
+    {
+        output.writeln("bool dispatch_expand(method_instance* method, planner_state& pstate, void* world)");
+        {
+            scope s(output);
+            output.writeln("switch (method->expand)");
+            {
+                scope s(output);
+                unsigned precondition_index = 0;
+
+                for (ast::node* method = domain->first_child; method != 0; method = method->next_sibling)
+                {
+                    if (!ast::is_method(method))
+                    {
+                        continue;
+                    }
+
+                    const char* method_name = method->first_child->s_expr->token;
+                    unsigned branch_index = 0;
+
+                    for (ast::node* branch = method->first_child->next_sibling; branch != 0; branch = branch->next_sibling)
+                    {
+                        output.writeln("case expand_%i_branch_%d:", method_name, branch_index);
+
+                        // target of the jump from the previous branch.
+                        if (branch_index > 0)
+                        {
+                            output.writeln("%i_branch_%d:", method_name, branch_index);
+                        }
+
+                        {
+                            indented i(output);
+                            scope s(output);
+                            generate_branch_body(ast, method, branch, branch_index, precondition_index, options, output);
+                        }
+
+                        ++branch_index;
+                        ++precondition_index;
+                    }
+                }
+
+                output.writeln("default:");
+                {
+                    indented i(output);
+                    output.writeln("plnnr_assert(false);");
+                    output.writeln("return false;");
+                }
+            }
+        }
+
+        output.writeln("find_plan_status step(planner_state& pstate, void* world)");
+        {
+            scope s(output);
+            output.writeln("plnnr_assert(pstate.top_method);");
+            output.writeln("method_instance* method = top_method(pstate);");
+            output.writeln("return find_plan_advance(pstate, method, dispatch_expand(method, pstate, world), world);");
+        }
+    }
+}
+
+void generate_branch_expands(ast::tree& ast, ast::node* domain, const codegen_options& options, formatter& output)
 {
     unsigned precondition_index = 0;
 
@@ -102,153 +920,82 @@ void generate_branch_expands(ast::tree& ast, ast::node* domain, formatter& outpu
             continue;
         }
 
-        ast::node* atom = method->first_child;
-        const char* method_name = atom->s_expr->token;
+        const char* method_name = method->first_child->s_expr->token;
 
         unsigned branch_index = 0;
 
         for (ast::node* branch = method->first_child->next_sibling; branch != 0; branch = branch->next_sibling)
         {
             plnnrc_assert(ast::is_branch(branch));
+            plnnrc_assert(ast::is_task_list(branch->first_child->next_sibling));
 
-            ast::branch_ann* ann = ast::annotation<ast::branch_ann>(branch);
-
-            ast::node* precondition = branch->first_child;
-            ast::node* tasklist = precondition->next_sibling;
+            ast::node* sort_key = ast::branch_sort_key(branch);
 
-            plnnrc_assert(ast::is_task_list(tasklist));
-
-            output.writeln("bool %i_branch_%d_expand(method_instance* method, planner_state& pstate, void* world)", method_name, branch_index);
+            if (sort_key)
             {
-                scope s(output);
-
-                output.writeln("p%d_state* precondition = plnnr::precondition<p%d_state>(method);", precondition_index, precondition_index);
-
-                if (has_parameters(method))
-                {
-                    output.writeln("%i_args* method_args = plnnr::arguments<%i_args>(method);", method_name, method_name);
-                }
-
-                output.writeln("worldstate* wstate = static_cast<worldstate*>(world);");
-
-                output.newline();
-                output.writeln("PLNNR_COROUTINE_BEGIN(*method);");
-                output.newline();
-
-                output.writeln("precondition = push_precondition<p%d_state>(pstate, method);", precondition_index);
-
-                for (ast::node* param = atom->first_child; param != 0; param = param->next_sibling)
-                {
-                    ast::node* var = first_parameter_usage(param, precondition);
-
-                    if (var)
-                    {
-                        int param_index = ast::annotation<ast::term_ann>(param)->var_index;
-                        int var_index = ast::annotation<ast::term_ann>(var)->var_index;
-
-                        output.writeln("precondition->_%d = method_args->_%d;", var_index, param_index);
-                    }
-                }
+                generate_sorted_next(ast, method, sort_key, precondition_index, options, output);
+            }
 
-                output.newline();
+            paste_frame_size frame_size(method, precondition_index, sort_key != 0);
+            output.writeln("plnnr_static_assert(%p <= max_frame_size);", &frame_size);
+            output.newline();
 
-                output.writeln("while (next(*precondition, *wstate))");
+            if (!options.single_dispatch)
+            {
+                output.writeln("bool %i_branch_%d_expand(method_instance* method, planner_state& pstate, void* world)", method_name, branch_index);
                 {
                     scope s(output);
+                    generate_branch_body(ast, method, branch, branch_index, precondition_index, options, output);
+                }
+            }
 
-                    if (!tasklist->first_child)
-                    {
-                        if (!ann->foreach)
-                        {
-                            output.writeln("method->flags |= method_flags_expanded;");
-                        }
-
-                        output.writeln("PLNNR_COROUTINE_YIELD(*method);");
-                    }
+            ++branch_index;
+            ++precondition_index;
+        }
+    }
 
-                    for (ast::node* task_atom = tasklist->first_child; task_atom != 0; task_atom = task_atom->next_sibling)
-                    {
-                        {
-                            scope s(output);
+    if (options.single_dispatch)
+    {
+        generate_dispatch_expand(ast, domain, options, output);
+    }
+}
 
-                            if (ast::is_add_list(task_atom))
-                            {
-                                generate_effects_add(task_atom, output);
-                            }
-                            else if (ast::is_delete_list(task_atom))
-                            {
-                                generate_effects_delete(task_atom, output);
-                            }
-                            else if (is_lazy(task_atom))
-                            {
-                                generate_operator_task(ast, method, task_atom, output);
-                            }
-                            else if (is_operator(ast, task_atom))
-                            {
-                                generate_operator_task(ast, method, task_atom, output);
-                            }
-                            else if (is_method(ast, task_atom))
-                            {
-                                generate_method_task(ast, method, task_atom, output);
-                            }
-                            else
-                            {
-                                // unknown construct in task list
-                                plnnrc_assert(false);
-                            }
-                        }
+void generate_expand_table(ast::tree& /*ast*/, ast::node* domain, const codegen_options& options, formatter& output)
+{
+    output.writeln("const expand_func expands[] =");
+    {
+        class_scope s(output);
+        output.writeln("0,");
 
-                        if (is_last(task_atom) && !ann->foreach)
-                        {
-                            output.writeln("method->flags |= method_flags_expanded;");
-                        }
+        for (ast::node* method = domain->first_child; method != 0; method = method->next_sibling)
+        {
+            if (!ast::is_method(method))
+            {
+                continue;
+            }
 
-                        if (is_last(task_atom) || !is_effect_list(task_atom))
-                        {
-                            output.writeln("PLNNR_COROUTINE_YIELD(*method);");
+            const char* method_name = method->first_child->s_expr->token;
 
-                            if (!is_last(task_atom))
-                            {
-                                output.newline();
-
-                                if (is_method(ast, task_atom))
-                                {
-                                    output.writeln("if (method->flags & method_flags_failed)");
-                                    {
-                                        scope s(output, true);
-                                        output.writeln("continue;");
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
+            unsigned branch_index = 0;
 
-                if (ann->foreach)
+            for (ast::node* branch = method->first_child->next_sibling; branch != 0; branch = branch->next_sibling)
+            {
+                if (options.single_dispatch)
                 {
-                    output.writeln("if (precondition->stage > 0)");
-                    {
-                        scope s(output);
-                        output.writeln("method->flags |= method_flags_expanded;");
-                        output.writeln("PLNNR_COROUTINE_YIELD(*method);");
-                    }
+                    output.writeln("dispatch_expand,");
                 }
-
-                if (!is_last(branch))
+                else
                 {
-                    output.writeln("return expand_next_branch(pstate, %i_branch_%d_expand, world);", method_name, branch_index+1);
+                    output.writeln("%i_branch_%d_expand,", method_name, branch_index);
                 }
 
-                output.writeln("PLNNR_COROUTINE_END();");
-
                 ++branch_index;
-                ++precondition_index;
             }
         }
     }
 }
 
-void generate_operator_effects(ast::tree& ast, ast::node* /*method*/, ast::node* task_atom, formatter& output)
+void generate_operator_effects(ast::tree& ast, ast::node* /*method*/, ast::node* task_atom, const codegen_options& options, formatter& output)
 {
     ast::node* operatr = ast.operators.find(task_atom->s_expr->token);
     plnnrc_assert(operatr);
@@ -261,7 +1008,7 @@ void generate_operator_effects(ast::tree& ast, ast::node* /*method*/, ast::node*
     {
         output.newline();
 
-        generate_effects_delete(effects_delete, output);
+        generate_effects_delete(ast, task_atom, effects_delete, options, output);
 
         if (effects_add->first_child)
         {
@@ -276,11 +1023,11 @@ void generate_operator_effects(ast::tree& ast, ast::node* /*method*/, ast::node*
             output.newline();
         }
 
-        generate_effects_add(effects_add, output);
+        generate_effects_add(ast, effects_add, output);
     }
 }
 
-void generate_effects_add(ast::node* effects, formatter& output)
+void generate_effects_add(ast::tree& ast, ast::node* effects, formatter& output)
 {
     for (ast::node* effect = effects->first_child; effect != 0; effect = effect->next_sibling)
     {
@@ -317,25 +1064,68 @@ void generate_effects_add(ast::node* effects, formatter& output)
 
             if (ast::is_term_call(arg))
             {
-                paste_function_call paste(arg);
-                output.writeln("tuple->_%d = wstate->%p;", param_index, &paste);
+                paste_function_call paste(ast, arg);
+                output.writeln("tuple->_%d = %p;", param_index, &paste);
+            }
+
+            if (ast::is_term_constant(arg))
+            {
+                output.writeln("tuple->_%d = %s;", param_index, arg->s_expr->token);
             }
 
             ++param_index;
         }
 
         output.writeln("operator_effect* effect = push<operator_effect>(pstate.journal);");
-        output.writeln("effect->tuple = tuple;");
-        output.writeln("effect->list = list;");
+        output.writeln("effect->tuple = tuple->slot;");
+        output.writeln("effect->atom = atom_%i;", atom_id);
+        output.writeln("effect->kind = effect_add;");
     }
 }
 
-void generate_effects_delete(ast::node* effects, formatter& output)
+void generate_effects_delete(ast::tree& ast, ast::node* task, ast::node* effects, const codegen_options& options, formatter& output)
 {
     for (ast::node* effect = effects->first_child; effect != 0; effect = effect->next_sibling)
     {
         const char* atom_id = effect->s_expr->token;
 
+        // the precondition already holds the tuple, no need to search the list for it.
+        ast::node* bound = find_bound_tuple(ast, task, effects, effect);
+
+        if (bound)
+        {
+            int atom_index = ast::annotation<ast::atom_ann>(bound)->index;
+
+            scope s(output, !is_last(effect));
+
+            output.writeln("tuple_list::handle* list = wstate->atoms[atom_%i];", atom_id);
+            output.writeln("operator_effect* effect = push<operator_effect>(pstate.journal);");
+
+            // with slot cursors the precondition keeps the slot of the tuple rather than a pointer to it.
+            if (options.slot_cursors)
+            {
+                output.writeln("effect->tuple = precondition->%i_%d;", atom_id, atom_index);
+            }
+            else
+            {
+                output.writeln("effect->tuple = precondition->%i_%d->slot;", atom_id, atom_index);
+            }
+
+            output.writeln("effect->atom = atom_%i;", atom_id);
+            output.writeln("effect->kind = effect_delete;");
+
+            if (options.slot_cursors)
+            {
+                output.writeln("tuple_list::detach(list, tuple_list::at<%i_tuple>(list, precondition->%i_%d));", atom_id, atom_id, atom_index);
+            }
+            else
+            {
+                output.writeln("tuple_list::detach(list, precondition->%i_%d);", atom_id, atom_index);
+            }
+
+            continue;
+        }
+
         output.writeln("for (%i_tuple* tuple = tuple_list::head<%i_tuple>(wstate->atoms[atom_%i]); tuple != 0; tuple = tuple->next)", atom_id, atom_id, atom_id);
         {
             scope s(output, !is_last(effect));
@@ -366,8 +1156,13 @@ void generate_effects_delete(ast::node* effects, formatter& output)
 
                 if (ast::is_term_call(arg))
                 {
-                    paste_function_call paste(arg);
-                    output.writeln("if (tuple->_%d != wstate->%p)", param_index, &paste);
+                    paste_function_call paste(ast, arg);
+                    output.writeln("if (tuple->_%d != %p)", param_index, &paste);
+                }
+
+                if (ast::is_term_constant(arg))
+                {
+                    output.writeln("if (tuple->_%d != %s)", param_index, arg->s_expr->token);
                 }
 
                 {
@@ -380,8 +1175,9 @@ void generate_effects_delete(ast::node* effects, formatter& output)
 
             output.writeln("tuple_list::handle* list = wstate->atoms[atom_%i];", atom_id, atom_id);
             output.writeln("operator_effect* effect = push<operator_effect>(pstate.journal);");
-            output.writeln("effect->tuple = tuple;");
-            output.writeln("effect->list = list;");
+            output.writeln("effect->tuple = tuple->slot;");
+            output.writeln("effect->atom = atom_%i;", atom_id);
+            output.writeln("effect->kind = effect_delete;");
             output.writeln("tuple_list::detach(list, tuple);");
             output.newline();
             output.writeln("break;");
@@ -389,17 +1185,17 @@ void generate_effects_delete(ast::node* effects, formatter& output)
     }
 }
 
-void generate_operator_task(ast::tree& ast, ast::node* method, ast::node* task_atom, formatter& output)
+void generate_operator_task(ast::tree& ast, ast::node* method, ast::node* task_atom, const codegen_options& options, formatter& output)
 {
     plnnrc_assert(is_lazy(task_atom) || is_operator(ast, task_atom));
 
     if (is_lazy(task_atom))
     {
-        output.writeln("task_instance* t = push_task(pstate, task_%i, %i_branch_0_expand);", task_atom->s_expr->token, task_atom->s_expr->token);
+        output.writeln("task_instance* t = push_task(pstate, task_%i, expand_%i_branch_0);", task_atom->s_expr->token, task_atom->s_expr->token);
     }
     else
     {
-        output.writeln("task_instance* t = push_task(pstate, task_%i, 0);", task_atom->s_expr->token);
+        output.writeln("task_instance* t = push_task(pstate, task_%i, expand_none);", task_atom->s_expr->token);
     }
 
     if (task_atom->first_child)
@@ -407,38 +1203,40 @@ void generate_operator_task(ast::tree& ast, ast::node* method, ast::node* task_a
         output.writeln("%i_args* a = push_arguments<%i_args>(pstate, t);", task_atom->s_expr->token, task_atom->s_expr->token);
     }
 
-    int param_index = 0;
+    generate_task_arguments(ast, task_atom, "a->", output);
 
-    for (ast::node* arg = task_atom->first_child; arg != 0; arg = arg->next_sibling)
+    if (is_lazy(task_atom))
     {
-        if (ast::is_term_variable(arg))
-        {
-            ast::node* def = definition(arg);
-            plnnrc_assert(def);
-            int var_index = ast::annotation<ast::term_ann>(def)->var_index;
-
-            if (is_parameter(def))
-            {
-                output.writeln("a->_%d = method_args->_%d;", param_index, var_index);
-            }
-            else
-            {
-                output.writeln("a->_%d = precondition->_%d;", param_index, var_index);
-            }
-        }
+        return;
+    }
 
-        if (ast::is_term_call(arg))
-        {
-            paste_function_call paste(arg);
-            output.writeln("a->_%d = wstate->%p;", param_index, &paste);
-        }
+    if (has_cost(ast, task_atom))
+    {
+        generate_operator_cost(ast, task_atom, output);
+    }
 
-        ++param_index;
+    if (options.inline_operator_effects)
+    {
+        generate_operator_effects(ast, method, task_atom, options, output);
+        return;
     }
 
-    if (!is_lazy(task_atom))
+    ast::node* operatr = ast.operators.find(task_atom->s_expr->token);
+    plnnrc_assert(operatr);
+
+    ast::node* effects_delete = operatr->first_child->next_sibling;
+    ast::node* effects_add = effects_delete->next_sibling;
+
+    if (effects_delete->first_child || effects_add->first_child)
     {
-        generate_operator_effects(ast, method, task_atom, output);
+        if (task_atom->first_child)
+        {
+            output.writeln("apply_%i(pstate, wstate, a);", task_atom->s_expr->token);
+        }
+        else
+        {
+            output.writeln("apply_%i(pstate, wstate);", task_atom->s_expr->token);
+        }
     }
 }
 
@@ -447,40 +1245,36 @@ void generate_method_task(ast::tree& ast, ast::node* /*method*/, ast::node* task
     plnnrc_assert(is_method(ast, task_atom));
     (void)(ast);
 
-    output.writeln("method_instance* t = push_method(pstate, task_%i, %i_branch_0_expand);", task_atom->s_expr->token, task_atom->s_expr->token);
+    output.writeln("method_instance* t = push_method(pstate, task_%i, expand_%i_branch_0);", task_atom->s_expr->token, task_atom->s_expr->token);
 
     if (task_atom->first_child)
     {
         output.writeln("%i_args* a = push_arguments<%i_args>(pstate, t);", task_atom->s_expr->token, task_atom->s_expr->token);
     }
 
-    int param_index = 0;
+    generate_task_arguments(ast, task_atom, "a->", output);
+}
 
-    for (ast::node* arg = task_atom->first_child; arg != 0; arg = arg->next_sibling)
-    {
-        if (ast::is_term_variable(arg))
-        {
-            ast::node* def = definition(arg);
-            plnnrc_assert(def);
-            int var_index = ast::annotation<ast::term_ann>(def)->var_index;
+void generate_tail_method_task(ast::tree& ast, ast::node* /*method*/, ast::node* task_atom, formatter& output)
+{
+    plnnrc_assert(is_method(ast, task_atom));
+    (void)(ast);
 
-            if (is_parameter(def))
-            {
-                output.writeln("a->_%d = method_args->_%d;", param_index, var_index);
-            }
-            else
-            {
-                output.writeln("a->_%d = precondition->_%d;", param_index, var_index);
-            }
-        }
+    const char* task_id = task_atom->s_expr->token;
 
-        if (ast::is_term_call(arg))
-        {
-            paste_function_call paste(arg);
-            output.writeln("a->_%d = wstate->%p;", param_index, &paste);
-        }
+    // arguments are evaluated before the parent frame is overwritten.
+    if (task_atom->first_child)
+    {
+        output.writeln("%i_args args;", task_id);
+        generate_task_arguments(ast, task_atom, "args.", output);
+    }
+
+    output.writeln("method_instance* t = push_tail_method(pstate, task_%i, expand_%i_branch_0);", task_id, task_id);
 
-        ++param_index;
+    if (task_atom->first_child)
+    {
+        output.writeln("%i_args* a = push_arguments<%i_args>(pstate, t);", task_id, task_id);
+        output.writeln("*a = args;");
     }
 }
 
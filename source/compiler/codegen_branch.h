@@ -26,14 +26,18 @@ namespace plnnrc {
 namespace ast { struct node; }
 namespace ast { class tree; }
 class formatter;
+struct codegen_options;
 
-void generate_branch_expands(ast::tree& ast, ast::node* domain, formatter& output);
+void generate_operator_effect_functions(ast::tree& ast, ast::node* domain, const codegen_options& options, formatter& output);
+void generate_branch_expands(ast::tree& ast, ast::node* domain, const codegen_options& options, formatter& output);
+void generate_expand_table(ast::tree& ast, ast::node* domain, const codegen_options& options, formatter& output);
 
-void generate_operator_effects(ast::tree& ast, ast::node* method, ast::node* task_atom, formatter& output);
-void generate_effects_add(ast::node* effects, formatter& output);
-void generate_effects_delete(ast::node* effects, formatter& output);
-void generate_operator_task(ast::tree& ast, ast::node* method, ast::node* task_atom, formatter& output);
+void generate_operator_effects(ast::tree& ast, ast::node* method, ast::node* task_atom, const codegen_options& options, formatter& output);
+void generate_effects_add(ast::tree& ast, ast::node* effects, formatter& output);
+void generate_effects_delete(ast::tree& ast, ast::node* task, ast::node* effects, const codegen_options& options, formatter& output);
+void generate_operator_task(ast::tree& ast, ast::node* method, ast::node* task_atom, const codegen_options& options, formatter& output);
 void generate_method_task(ast::tree& ast, ast::node* method, ast::node* task_atom, formatter& output);
+void generate_tail_method_task(ast::tree& ast, ast::node* method, ast::node* task_atom, formatter& output);
 
 }
 
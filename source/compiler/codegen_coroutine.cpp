@@ -0,0 +1,72 @@
+//
+// Copyright (c) 2013 Alexander Shafranov shafranov@gmail.com
+//
+// This software is provided 'as-is', without any express or implied
+// warranty.  In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software. If you use this software
+// in a product, an acknowledgment in the product documentation would be
+// appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+
+#include "formatter.h"
+#include "codegen_coroutine.h"
+
+namespace plnnrc {
+
+void generate_coroutine_begin(const char* state, bool computed_goto, formatter& output)
+{
+    if (computed_goto)
+    {
+        output.writeln("PLNNR_COROUTINE_GOTO_BEGIN(%s);", state);
+    }
+    else
+    {
+        output.writeln("PLNNR_COROUTINE_BEGIN(%s);", state);
+    }
+}
+
+void generate_coroutine_yield(const char* state, int stage, bool computed_goto, formatter& output)
+{
+    if (computed_goto)
+    {
+        output.writeln("PLNNR_COROUTINE_GOTO_YIELD(%s, %d);", state, stage);
+    }
+    else
+    {
+        output.writeln("PLNNR_COROUTINE_YIELD(%s, %d);", state, stage);
+    }
+}
+
+void generate_coroutine_end(const char* state, int last_stage, bool computed_goto, formatter& output)
+{
+    if (!computed_goto)
+    {
+        output.writeln("PLNNR_COROUTINE_END();");
+        return;
+    }
+
+    output.writeln("static void* const resume_table[] =");
+    {
+        class_scope s(output);
+        output.writeln("0,");
+
+        for (int stage = 1; stage <= last_stage; ++stage)
+        {
+            output.writeln("PLNNR_COROUTINE_GOTO_LABEL(%d),", stage);
+        }
+    }
+
+    output.writeln("PLNNR_COROUTINE_GOTO_END(%s, resume_table);", state);
+}
+
+}
@@ -0,0 +1,36 @@
+//
+// Copyright (c) 2013 Alexander Shafranov shafranov@gmail.com
+//
+// This software is provided 'as-is', without any express or implied
+// warranty.  In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software. If you use this software
+// in a product, an acknowledgment in the product documentation would be
+// appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+
+#ifndef DERPLANNER_COMPILER_CODEGEN_COROUTINE_H_
+#define DERPLANNER_COMPILER_CODEGEN_COROUTINE_H_
+
+namespace plnnrc {
+
+class formatter;
+
+// `state` is the expression holding the resume stage of the generated function (e.g. "state" or "*method"),
+// yields are numbered densely from 1 and `last_stage` is the number of yields generated.
+void generate_coroutine_begin(const char* state, bool computed_goto, formatter& output);
+void generate_coroutine_yield(const char* state, int stage, bool computed_goto, formatter& output);
+void generate_coroutine_end(const char* state, int last_stage, bool computed_goto, formatter& output);
+
+}
+
+#endif
@@ -21,6 +21,7 @@
 #include "derplanner/compiler/assert.h"
 #include "derplanner/compiler/s_expression.h"
 #include "derplanner/compiler/ast.h"
+#include "derplanner/compiler/codegen.h"
 #include "tree_tools.h"
 #include "ast_tools.h"
 #include "formatter.h"
@@ -28,6 +29,12 @@
 
 namespace plnnrc {
 
+namespace
+{
+    // number of direct-mapped entries in the memo table of each ':pure' world function.
+    const int memo_table_size = 256;
+}
+
 class paste_function_parameters : public paste_func
 {
 public:
@@ -78,6 +85,7 @@ void generate_header_top(ast::tree& /*ast*/, const char* custom_header, formatte
         scope s(output);
         output.writeln("struct planner_state;");
         output.writeln("struct method_instance;");
+        output.writeln("typedef bool (*expand_func)(method_instance*, planner_state&, void*);");
     }
 }
 
@@ -105,6 +113,85 @@ void generate_worldstate(ast::tree& /*ast*/, ast::node* worldstate, formatter& o
     output.writeln("const char* atom_name(atom_type type);");
     output.newline();
 
+    bool has_pure_functions = false;
+
+    for (ast::node* function_def = worldstate->first_child->next_sibling; function_def != 0; function_def = function_def->next_sibling)
+    {
+        if (!ast::is_function(function_def) || !ast::annotation<ast::func_ann>(function_def)->pure)
+        {
+            continue;
+        }
+
+        ast::node* function_atom = function_def->first_child;
+        ast::node* return_type = function_atom->next_sibling;
+
+        output.writeln("struct %i_memo", function_atom->s_expr->token);
+        {
+            class_scope s(output);
+            output.writeln("enum { size = %d };", memo_table_size);
+            output.newline();
+
+            output.writeln("struct entry");
+            {
+                class_scope s(output);
+
+                unsigned param_index = 0;
+
+                for (ast::node* param = function_atom->first_child; param != 0; param = param->next_sibling)
+                {
+                    output.writeln("%s _%d;", param->s_expr->first_child->token, param_index++);
+                }
+
+                output.writeln("%s result;", return_type->s_expr->first_child->token);
+                output.writeln("unsigned fingerprint;");
+                output.writeln("bool valid;");
+            }
+
+            output.writeln("entry entries[size];");
+        }
+
+        has_pure_functions = true;
+    }
+
+    if (has_pure_functions)
+    {
+        output.writeln("// results of ':pure' functions cached by one planner, set 'planner_state::memo' to a zero-initialized instance.");
+        output.writeln("// results are kept across planning steps and plans until 'invalidate_memo' is called.");
+        output.writeln("struct memo_tables");
+        {
+            class_scope s(output);
+            output.writeln("unsigned fingerprint;");
+
+            for (ast::node* function_def = worldstate->first_child->next_sibling; function_def != 0; function_def = function_def->next_sibling)
+            {
+                if (ast::is_function(function_def) && ast::annotation<ast::func_ann>(function_def)->pure)
+                {
+                    output.writeln("%i_memo %i_table;", function_def->first_child->s_expr->token, function_def->first_child->s_expr->token);
+                }
+            }
+        }
+
+        output.writeln("// drops cached results, call it when the values the ':pure' functions compute change.");
+        output.writeln("void invalidate_memo(memo_tables& memo);");
+        output.newline();
+    }
+
+    bool has_indexed_atoms = false;
+
+    for (ast::node* atom = worldstate->first_child->next_sibling; atom != 0; atom = atom->next_sibling)
+    {
+        if (ast::is_atom(atom) && ast::annotation<ast::atom_ann>(atom)->indexed)
+        {
+            output.writeln("struct %i_tuple;", atom->s_expr->token);
+            has_indexed_atoms = true;
+        }
+    }
+
+    if (has_indexed_atoms)
+    {
+        output.newline();
+    }
+
     output.writeln("struct worldstate");
     {
         class_scope s(output);
@@ -124,6 +211,15 @@ void generate_worldstate(ast::tree& /*ast*/, ast::node* worldstate, formatter& o
 
             output.writeln("%s (*%i)(%p);", return_type->s_expr->first_child->token, function_atom->s_expr->token, &paste);
         }
+
+        for (ast::node* atom = worldstate->first_child->next_sibling; atom != 0; atom = atom->next_sibling)
+        {
+            if (ast::is_atom(atom) && ast::annotation<ast::atom_ann>(atom)->indexed)
+            {
+                output.writeln("%i_tuple** %i_index;", atom->s_expr->token, atom->s_expr->token);
+                output.writeln("size_t %i_index_size;", atom->s_expr->token);
+            }
+        }
     }
 
     for (ast::node* atom = worldstate->first_child->next_sibling; atom != 0; atom = atom->next_sibling)
@@ -146,9 +242,17 @@ void generate_worldstate(ast::tree& /*ast*/, ast::node* worldstate, formatter& o
 
             output.writeln("%i_tuple* next;", atom->s_expr->token);
             output.writeln("%i_tuple* prev;", atom->s_expr->token);
+            output.writeln("uint32_t slot;");
             output.writeln("enum { id = atom_%i };", atom->s_expr->token);
         }
     }
+
+    if (has_indexed_atoms)
+    {
+        output.writeln("bool build_static_indices(worldstate& world);");
+        output.writeln("void destroy_static_indices(worldstate& world);");
+        output.newline();
+    }
 }
 
 void generate_task_type_enum(ast::tree& ast, ast::node* domain, formatter& output)
@@ -253,9 +357,17 @@ void generate_param_struct(ast::tree& ast, ast::node* task, formatter& output)
     }
 }
 
-void generate_forward_decls(ast::tree& ast, ast::node* domain, formatter& output)
+void generate_forward_decls(ast::tree& ast, ast::node* domain, const codegen_options& options, formatter& output)
 {
-    for (ast::node* method = domain->first_child; method != 0; method = method->next_sibling)
+    if (options.single_dispatch)
+    {
+        output.writeln("bool dispatch_expand(plnnr::method_instance*, plnnr::planner_state&, void*);");
+        output.writeln("// expands the top method directly, use instead of plnnr::find_plan_step.");
+        output.writeln("plnnr::find_plan_status step(plnnr::planner_state&, void*);");
+        output.newline();
+    }
+
+    for (ast::node* method = domain->first_child; method != 0 && !options.single_dispatch; method = method->next_sibling)
     {
         if (!ast::is_method(method))
         {
@@ -275,10 +387,40 @@ void generate_forward_decls(ast::tree& ast, ast::node* domain, formatter& output
         }
     }
 
-    if (ast.methods.count() > 0)
+    if (ast.methods.count() > 0 && !options.single_dispatch)
     {
         output.newline();
     }
+
+    // indices into `expands`, 0 is plnnr::expand_none.
+    output.writeln("enum expand_index");
+    {
+        class_scope s(output);
+
+        bool first = true;
+
+        for (ast::node* method = domain->first_child; method != 0; method = method->next_sibling)
+        {
+            if (!ast::is_method(method))
+            {
+                continue;
+            }
+
+            const char* method_name = method->first_child->s_expr->token;
+
+            unsigned branch_index = 0;
+
+            for (ast::node* branch = method->first_child->next_sibling; branch != 0; branch = branch->next_sibling)
+            {
+                output.writeln(first ? "expand_%i_branch_%d = 1," : "expand_%i_branch_%d,", method_name, branch_index);
+                first = false;
+                ++branch_index;
+            }
+        }
+    }
+
+    output.writeln("extern const plnnr::expand_func expands[];");
+    output.newline();
 }
 
 }
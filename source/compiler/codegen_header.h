@@ -26,13 +26,14 @@ namespace plnnrc {
 namespace ast { struct node; }
 namespace ast { class tree; }
 class formatter;
+struct codegen_options;
 
 void generate_header_top(ast::tree& ast, const char* custom_header, formatter& output);
 void generate_worldstate(ast::tree& ast, ast::node* worldstate, formatter& output);
 void generate_task_type_enum(ast::tree& ast, ast::node* domain, formatter& output);
 void generate_param_structs(ast::tree& ast, ast::node* domain, formatter& output);
 void generate_param_struct(ast::tree& ast, ast::node* task, formatter& output);
-void generate_forward_decls(ast::tree& ast, ast::node* domain, formatter& output);
+void generate_forward_decls(ast::tree& ast, ast::node* domain, const codegen_options& options, formatter& output);
 
 }
 
@@ -18,12 +18,18 @@
 // 3. This notice may not be removed or altered from any source distribution.
 //
 
+#include <string.h> // strcmp
 #include "derplanner/compiler/assert.h"
+#include "derplanner/compiler/memory.h"
 #include "derplanner/compiler/s_expression.h"
+#include "derplanner/compiler/node_array.h"
 #include "derplanner/compiler/ast.h"
+#include "derplanner/compiler/codegen.h"
 #include "tree_tools.h"
 #include "ast_tools.h"
+#include "ast_reorder.h"
 #include "formatter.h"
+#include "codegen_coroutine.h"
 #include "codegen_precondition.h"
 
 namespace plnnrc {
@@ -31,22 +37,40 @@ namespace plnnrc {
 class paste_precondition_function_call : public paste_func
 {
 public:
+    ast::tree& tree;
     ast::node* function_call;
     const char* var_prefix;
 
-    paste_precondition_function_call(ast::node* function_call, const char* var_prefix)
-        : function_call(function_call)
+    paste_precondition_function_call(ast::tree& tree, ast::node* function_call, const char* var_prefix)
+        : tree(tree)
+        , function_call(function_call)
         , var_prefix(var_prefix)
     {
     }
 
     virtual void operator()(formatter& output)
     {
-        output.put_id(function_call->s_expr->token);
-        output.put_char('(');
+        bool memoized = ast::is_pure_function(tree, function_call);
+
+        if (memoized)
+        {
+            output.put_id(function_call->s_expr->token);
+            output.put_str("_memoized(world, memo");
+        }
+        else
+        {
+            output.put_str("world.");
+            output.put_id(function_call->s_expr->token);
+            output.put_char('(');
+        }
 
         for (ast::node* argument = function_call->first_child; argument != 0; argument = argument->next_sibling)
         {
+            if (memoized || argument != function_call->first_child)
+            {
+                output.put_str(", ");
+            }
+
             switch (argument->type)
             {
             case ast::node_term_variable:
@@ -58,27 +82,75 @@ public:
                 break;
             case ast::node_term_call:
                 {
-                    paste_precondition_function_call paste(argument, var_prefix);
-                    output.put_str("world.");
+                    paste_precondition_function_call paste(tree, argument, var_prefix);
                     paste(output);
                 }
                 break;
+            case ast::node_term_int:
+            case ast::node_term_float:
+                output.put_str(argument->s_expr->token);
+                break;
             default:
                 // unsupported argument type
                 plnnrc_assert(false);
             }
+        }
+
+        output.put_char(')');
+    }
+};
 
-            if (!is_last(argument))
+// comparison operand: a bound variable, a constant or a function call.
+class paste_precondition_term : public paste_func
+{
+public:
+    ast::tree& tree;
+    ast::node* term;
+    int* hoisted;
+
+    paste_precondition_term(ast::tree& tree, ast::node* term, int* hoisted)
+        : tree(tree)
+        , term(term)
+        , hoisted(hoisted)
+    {
+    }
+
+    virtual void operator()(formatter& output)
+    {
+        switch (term->type)
+        {
+        case ast::node_term_variable:
+            plnnrc_assert(ast::definition(term));
+            output.put_str("state._");
+            output.put_int(ast::annotation<ast::term_ann>(term)->var_index);
+            break;
+        case ast::node_term_call:
             {
-                output.put_str(", ");
+                int call_index = ast::annotation<ast::term_ann>(term)->call_index;
+
+                if (hoisted[call_index])
+                {
+                    output.put_str("state.call_");
+                    output.put_int(call_index);
+                    break;
+                }
+
+                paste_precondition_function_call paste(tree, term, "state._");
+                paste(output);
             }
+            break;
+        case ast::node_term_int:
+        case ast::node_term_float:
+            output.put_str(term->s_expr->token);
+            break;
+        default:
+            // unsupported argument type
+            plnnrc_assert(false);
         }
-
-        output.put_char(')');
     }
 };
 
-void generate_preconditions(ast::tree& ast, ast::node* domain, formatter& output)
+bool generate_preconditions(ast::tree& ast, ast::node* domain, const codegen_options& options, formatter& output)
 {
     unsigned branch_index = 0;
 
@@ -95,15 +167,84 @@ void generate_preconditions(ast::tree& ast, ast::node* domain, formatter& output
 
             ast::node* precondition = branch->first_child;
 
-            generate_precondition_state(ast, precondition, branch_index, output);
-            generate_precondition_next(ast, precondition, branch_index, output);
+            generate_precondition_state(ast, precondition, branch_index, options, output);
+            if (!generate_precondition_next(ast, precondition, branch_index, options, output))
+            {
+                return false;
+            }
 
             ++branch_index;
         }
     }
+
+    return true;
 }
 
-void generate_precondition_state(ast::tree& ast, ast::node* root, unsigned branch_index, formatter& output)
+namespace
+{
+    // fields are emitted from the largest size class down to avoid padding between them.
+    enum field_size_class
+    {
+        // types from the custom header, size unknown, assumed to have the strictest alignment.
+        size_class_custom = 0,
+        size_class_8,
+        size_class_4,
+        size_class_2,
+        size_class_1,
+        size_class_count,
+    };
+
+    field_size_class type_size_class(const char* type_name)
+    {
+        static const char* types_8[] = { "double", "int64_t", "uint64_t", "size_t", "intptr_t", "uintptr_t", "long", "long long", 0 };
+        static const char* types_4[] = { "int", "unsigned", "float", "int32_t", "uint32_t", 0 };
+        static const char* types_2[] = { "short", "int16_t", "uint16_t", 0 };
+        static const char* types_1[] = { "char", "bool", "int8_t", "uint8_t", 0 };
+
+        const char** classes[] = { types_8, types_4, types_2, types_1 };
+
+        for (int c = 0; c < 4; ++c)
+        {
+            for (const char** type = classes[c]; *type != 0; ++type)
+            {
+                if (strcmp(*type, type_name) == 0)
+                {
+                    return static_cast<field_size_class>(size_class_8 + c);
+                }
+            }
+        }
+
+        return size_class_custom;
+    }
+
+    // function call compared in a precondition, evaluated before the innermost loop which binds its arguments.
+    bool is_comparison_call(ast::node* term)
+    {
+        return ast::is_term_call(term) && ast::is_comparison_op(term->parent);
+    }
+
+    // with slot cursors tuple pointers of the enclosing loops are locals: saved as slots before the yield and restored on resume.
+    void generate_precondition_yield(precondition_context& context, formatter& output)
+    {
+        for (int i = 0; i < context.num_loops; ++i)
+        {
+            const char* atom_id = context.loops[i]->s_expr->token;
+            int atom_index = ast::annotation<ast::atom_ann>(context.loops[i])->index;
+            output.writeln("state.%i_%d = %i_%d->slot;", atom_id, atom_index, atom_id, atom_index);
+        }
+
+        generate_coroutine_yield("state", ++context.last_stage, context.computed_goto, output);
+
+        for (int i = 0; i < context.num_loops; ++i)
+        {
+            const char* atom_id = context.loops[i]->s_expr->token;
+            int atom_index = ast::annotation<ast::atom_ann>(context.loops[i])->index;
+            output.writeln("%i_%d = tuple_list::at<%i_tuple>(world.atoms[atom_%i], state.%i_%d);", atom_id, atom_index, atom_id, atom_id, atom_id, atom_index);
+        }
+    }
+}
+
+void generate_precondition_state(ast::tree& ast, ast::node* root, unsigned branch_index, const codegen_options& options, formatter& output)
 {
     output.writeln("// method %s [%d:%d]", root->parent->parent->first_child->s_expr->token, root->s_expr->line, root->s_expr->column);
 
@@ -111,188 +252,840 @@ void generate_precondition_state(ast::tree& ast, ast::node* root, unsigned branc
     {
         class_scope s(output);
 
-        int last_var_index = -1;
-
-        for (ast::node* n = root; n != 0; n = preorder_traversal_next(root, n))
+        for (int size_class = 0; size_class < size_class_count; ++size_class)
         {
-            if (ast::is_term_variable(n))
+            int last_var_index = -1;
+
+            for (ast::node* n = root; n != 0; n = preorder_traversal_next(root, n))
             {
-                int var_index = ast::annotation<ast::term_ann>(n)->var_index;
+                if (ast::is_term_variable(n))
+                {
+                    int var_index = ast::annotation<ast::term_ann>(n)->var_index;
+
+                    if (var_index > last_var_index)
+                    {
+                        const char* type_name = ast.type_tag_to_node[ast::type_tag(n)]->s_expr->first_child->token;
+                        last_var_index = var_index;
+
+                        if (type_size_class(type_name) != size_class)
+                        {
+                            continue;
+                        }
+
+                        output.writeln("// %s [%d:%d]", n->s_expr->token, n->s_expr->line, n->s_expr->column);
+                        output.writeln("%s _%d;", type_name, var_index);
+                    }
+                }
+            }
 
-                if (var_index > last_var_index)
+            // tuple pointers, or slots of the tuples with slot cursors.
+            for (ast::node* n = root; n != 0 && size_class == (options.slot_cursors ? size_class_4 : size_class_8); n = preorder_traversal_next(root, n))
+            {
+                if (ast::is_atom(n))
                 {
-                    ast::node* ws_type = ast.type_tag_to_node[ast::type_tag(n)];
-                    output.writeln("// %s [%d:%d]", n->s_expr->token, n->s_expr->line, n->s_expr->column);
-                    output.writeln("%s _%d;", ws_type->s_expr->first_child->token, var_index);
-                    last_var_index = var_index;
+                    const char* id = n->s_expr->token;
+
+                    if (options.slot_cursors)
+                    {
+                        output.writeln("uint32_t %i_%d;", id, ast::annotation<ast::atom_ann>(n)->index);
+                    }
+                    else
+                    {
+                        output.writeln("%i_tuple* %i_%d;", id, id, ast::annotation<ast::atom_ann>(n)->index);
+                    }
                 }
             }
-        }
 
-        for (ast::node* n = root; n != 0; n = preorder_traversal_next(root, n))
-        {
-            if (ast::is_atom(n))
+            // static index cursors are positions in the index, 32 bits are enough.
+            for (ast::node* n = root; n != 0 && size_class == size_class_4; n = preorder_traversal_next(root, n))
             {
-                const char* id = n->s_expr->token;
-                output.writeln("%i_tuple* %i_%d;", id, id, ast::annotation<ast::atom_ann>(n)->index);
+                if (ast::is_atom(n) && ast::annotation<ast::atom_ann>(ast.ws_atoms.find(n->s_expr->token))->indexed)
+                {
+                    output.writeln("uint32_t %i_%d_cursor;", n->s_expr->token, ast::annotation<ast::atom_ann>(n)->index);
+                }
             }
-        }
 
-        output.writeln("int stage;");
+            // results of function calls in atom arguments, computed once before the atom loop.
+            for (ast::node* n = root; n != 0; n = preorder_traversal_next(root, n))
+            {
+                if (!ast::is_atom(n))
+                {
+                    continue;
+                }
+
+                int atom_param_index = 0;
+
+                for (ast::node* term = n->first_child; term != 0; term = term->next_sibling, ++atom_param_index)
+                {
+                    if (ast::is_term_call(term))
+                    {
+                        ast::node* return_type = ast.ws_funcs.find(term->s_expr->token)->first_child->next_sibling;
+                        const char* type_name = return_type->s_expr->first_child->token;
+
+                        if (type_size_class(type_name) == size_class)
+                        {
+                            output.writeln("%s %i_%d_arg%d;", type_name, n->s_expr->token, ast::annotation<ast::atom_ann>(n)->index, atom_param_index);
+                        }
+                    }
+                }
+            }
+
+            // results of function calls in comparisons.
+            int call_index = 0;
+
+            for (ast::node* n = root; n != 0; n = preorder_traversal_next(root, n))
+            {
+                if (!is_comparison_call(n))
+                {
+                    continue;
+                }
+
+                ast::node* return_type = ast.ws_funcs.find(n->s_expr->token)->first_child->next_sibling;
+                const char* type_name = return_type->s_expr->first_child->token;
+
+                ast::annotation<ast::term_ann>(n)->call_index = call_index;
+
+                if (type_size_class(type_name) == size_class)
+                {
+                    output.writeln("%s call_%d;", type_name, call_index);
+                }
+
+                ++call_index;
+            }
+
+            if (size_class == size_class_4)
+            {
+                output.writeln("int stage;");
+            }
+        }
     }
 }
 
-void generate_precondition_next(ast::tree& ast, ast::node* root, unsigned branch_index, formatter& output)
+bool generate_precondition_next(ast::tree& ast, ast::node* root, unsigned branch_index, const codegen_options& options, formatter& output)
 {
     plnnrc_assert(is_logical_op(root));
 
-    output.writeln("bool next(p%d_state& state, worldstate& world)", branch_index);
+    int num_vars = 0;
+    int num_calls = 0;
+    int num_atoms = 0;
+
+    for (ast::node* n = root; n != 0; n = preorder_traversal_next(root, n))
+    {
+        if (ast::is_atom(n))
+        {
+            ++num_atoms;
+        }
+
+        if (ast::is_term_variable(n))
+        {
+            int var_index = ast::annotation<ast::term_ann>(n)->var_index;
+            num_vars = var_index >= num_vars ? var_index + 1 : num_vars;
+        }
+
+        if (is_comparison_call(n))
+        {
+            ++num_calls;
+        }
+    }
+
+    precondition_context context;
+    context.last_stage = 0;
+    context.computed_goto = options.computed_goto;
+    context.tuple_prefix = options.slot_cursors ? "" : "state.";
+    context.num_loops = 0;
+
+    // parameters are bound on entry.
+    context.bound = static_cast<int*>(memory::allocate(sizeof(int) * (num_vars + 1)));
+
+    if (!context.bound)
+    {
+        return false;
+    }
+
+    context.hoisted = static_cast<int*>(memory::allocate(sizeof(int) * (num_calls + 1)));
+
+    if (!context.hoisted)
+    {
+        memory::deallocate(context.bound);
+        return false;
+    }
+
+    context.loops = static_cast<ast::node**>(memory::allocate(sizeof(ast::node*) * (num_atoms + 1)));
+
+    if (!context.loops)
+    {
+        memory::deallocate(context.hoisted);
+        memory::deallocate(context.bound);
+        return false;
+    }
+
+    for (int i = 0; i < num_vars; ++i)
+    {
+        context.bound[i] = 0;
+    }
+
+    for (int i = 0; i < num_calls; ++i)
+    {
+        context.hoisted[i] = 0;
+    }
+
+    for (ast::node* n = root; n != 0; n = preorder_traversal_next(root, n))
+    {
+        if (ast::is_term_variable(n) && ast::definition(n) && ast::is_parameter(ast::definition(n)))
+        {
+            context.bound[ast::annotation<ast::term_ann>(n)->var_index] = 1;
+        }
+    }
+
+    output.writeln("bool next(p%d_state& state, worldstate& world%s)", branch_index, ast::has_pure_functions(ast) ? ", void* memo" : "");
     {
         scope s(output);
 
-        output.writeln("PLNNR_COROUTINE_BEGIN(state);");
+        // tuple pointers live across the coroutine switch, on resume they are restored from the slots in the state.
+        if (options.slot_cursors && num_atoms > 0)
+        {
+            for (ast::node* n = root; n != 0; n = preorder_traversal_next(root, n))
+            {
+                if (ast::is_atom(n))
+                {
+                    const char* id = n->s_expr->token;
+                    output.writeln("%i_tuple* %i_%d = 0;", id, id, ast::annotation<ast::atom_ann>(n)->index);
+                }
+            }
+
+            output.newline();
+        }
+
+        generate_coroutine_begin("state", context.computed_goto, output);
         output.newline();
 
-        generate_precondition_satisfier(ast, root, output);
+        generate_precondition_satisfier(ast, root, options, context, output);
 
-        output.writeln("PLNNR_COROUTINE_END();");
+        generate_coroutine_end("state", context.last_stage, context.computed_goto, output);
     }
+
+    memory::deallocate(context.loops);
+    memory::deallocate(context.hoisted);
+    memory::deallocate(context.bound);
+
+    return true;
 }
 
-void generate_precondition_satisfier(ast::tree& ast, ast::node* root, formatter& output)
+void generate_precondition_satisfier(ast::tree& ast, ast::node* root, const codegen_options& options, precondition_context& context, formatter& output)
 {
     plnnrc_assert(ast::is_op_or(root));
 
     for (ast::node* child = root->first_child; child != 0; child = child->next_sibling)
     {
         plnnrc_assert(ast::is_op_and(child));
-        generate_conjunctive_clause(ast, child, output);
+        generate_conjunctive_clause(ast, child, options, context, output);
     }
 }
 
-void generate_conjunctive_clause(ast::tree& ast, ast::node* root, formatter& output)
+namespace
+{
+    const unsigned max_join_orders = 3;
+
+    // atom can start a loop nest if it binds variables of the clause and
+    // its call term arguments depend only on parameters.
+    bool can_lead(ast::node* atom)
+    {
+        bool binds = false;
+
+        for (ast::node* n = atom->first_child; n != 0; n = preorder_traversal_next(atom, n))
+        {
+            if (!ast::is_term_variable(n))
+            {
+                continue;
+            }
+
+            ast::node* def = ast::definition(n);
+            bool local = !def || !ast::is_parameter(def);
+
+            if (n->parent == atom)
+            {
+                binds |= local;
+            }
+            else if (local)
+            {
+                return false;
+            }
+        }
+
+        return binds;
+    }
+
+    void generate_size_comparison(ast::node* lead, ast::node* other, formatter& output)
+    {
+        output.put_str("tuple_list::size(world.atoms[atom_");
+        output.put_id(lead->s_expr->token);
+        output.put_str("]) <= tuple_list::size(world.atoms[atom_");
+        output.put_id(other->s_expr->token);
+        output.put_str("])");
+    }
+}
+
+bool generate_adaptive_clause(ast::tree& ast, ast::node* root, precondition_context& context, formatter& output)
+{
+    ast::node* leads[max_join_orders];
+    unsigned num_leads = 0;
+
+    // the first nest keeps the written order, others start from a different atom.
+    for (ast::node* literal = root->first_child; literal != 0 && num_leads < max_join_orders; literal = literal->next_sibling)
+    {
+        if (!ast::is_atom(literal) || !can_lead(literal))
+        {
+            continue;
+        }
+
+        bool seen = false;
+
+        for (unsigned i = 0; i < num_leads; ++i)
+        {
+            seen |= (strcmp(leads[i]->s_expr->token, literal->s_expr->token) == 0);
+        }
+
+        if (!seen)
+        {
+            leads[num_leads++] = literal;
+        }
+    }
+
+    if (num_leads < 2)
+    {
+        return false;
+    }
+
+    node_array written;
+    node_array orders[max_join_orders];
+
+    for (unsigned i = 1; i < num_leads; ++i)
+    {
+        if (!ast::order_literals(ast, root, leads[i], orders[i]))
+        {
+            return false;
+        }
+    }
+
+    if (!written.init(orders[1].size()))
+    {
+        return false;
+    }
+
+    for (ast::node* literal = root->first_child; literal != 0; literal = literal->next_sibling)
+    {
+        written.append(literal);
+    }
+
+    output.writeln("// pick the loop nest starting with the smallest atom list.");
+
+    for (unsigned i = 0; i < num_leads; ++i)
+    {
+        if (i + 1 < num_leads)
+        {
+            output.put_indent();
+            output.put_str(i == 0 ? "if (" : "else if (");
+
+            for (unsigned j = i + 1; j < num_leads; ++j)
+            {
+                generate_size_comparison(leads[i], leads[j], output);
+
+                if (j + 1 < num_leads)
+                {
+                    output.put_str(" && ");
+                }
+            }
+
+            output.put_char(')');
+            output.newline();
+        }
+        else
+        {
+            output.writeln("else");
+        }
+
+        {
+            scope s(output, i + 1 == num_leads);
+
+            if (i > 0)
+            {
+                ast::apply_literal_order(root, orders[i]);
+            }
+
+            generate_literal_chain(ast, root->first_child, context, output);
+
+            if (i > 0)
+            {
+                ast::apply_literal_order(root, written);
+            }
+        }
+    }
+
+    return true;
+}
+
+void generate_conjunctive_clause(ast::tree& ast, ast::node* root, const codegen_options& options, precondition_context& context, formatter& output)
 {
     plnnrc_assert(ast::is_op_and(root));
 
+    if (options.adaptive_join_order && generate_adaptive_clause(ast, root, context, output))
+    {
+        return;
+    }
+
     if (root->first_child)
     {
-        generate_literal_chain(ast, root->first_child, output);
+        generate_literal_chain(ast, root->first_child, context, output);
     }
     else
     {
         // the formula is trivial: (or (and))
-        output.writeln("PLNNR_COROUTINE_YIELD(state);");
+        generate_precondition_yield(context, output);
         output.newline();
     }
 }
 
-void generate_literal_chain(ast::tree& ast, ast::node* root, formatter& output)
+namespace
 {
-    plnnrc_assert(ast::is_op_not(root) || ast::is_term_call(root) || is_atom(root) || is_comparison_op(root));
+    // literal evaluated after `literal` on the current path: next conjunct or the one following enclosing disjunction.
+    ast::node* next_literal(ast::node* literal)
+    {
+        for (ast::node* n = literal; ;)
+        {
+            if (n->next_sibling)
+            {
+                return n->next_sibling;
+            }
 
-    ast::node* atom = root;
+            ast::node* disjunction = n->parent->parent;
+            plnnrc_assert(ast::is_op_or(disjunction));
 
-    if (ast::is_op_not(root))
+            if (!ast::is_op_and(disjunction->parent))
+            {
+                return 0;
+            }
+
+            n = disjunction;
+        }
+    }
+
+    void generate_literal_chain_next(ast::tree& ast, ast::node* literal, precondition_context& context, formatter& output)
     {
-        atom = root->first_child;
+        ast::node* next = next_literal(literal);
+
+        if (next)
+        {
+            generate_literal_chain(ast, next, context, output);
+        }
+        else
+        {
+            generate_precondition_yield(context, output);
+        }
     }
 
-    if (ast::is_comparison_op(atom))
+    bool is_bound(ast::node* var, int* bound)
     {
-        generate_literal_chain_comparison(ast, root, atom, output);
-        return;
+        return bound[ast::annotation<ast::term_ann>(var)->var_index] != 0;
     }
 
-    if (ast::is_term_call(atom))
+    bool all_bound(ast::node* atom, int* bound)
     {
-        generate_literal_chain_call_term(ast, root, atom, output);
-        return;
+        for (ast::node* arg = atom->first_child; arg != 0; arg = arg->next_sibling)
+        {
+            if (ast::is_term_variable(arg) && !is_bound(arg, bound))
+            {
+                return false;
+            }
+        }
+
+        return true;
     }
 
-    const char* atom_id = atom->s_expr->token;
-    int atom_index = ast::annotation<ast::atom_ann>(atom)->index;
+    // true if `root` refers to precondition variable `var_index`.
+    bool refers_to(ast::node* root, int var_index)
+    {
+        for (ast::node* n = root; n != 0; n = preorder_traversal_next(root, n))
+        {
+            if (!ast::is_term_variable(n))
+            {
+                continue;
+            }
+
+            ast::node* def = ast::definition(n);
+
+            if (def && !ast::is_parameter(def) && ast::annotation<ast::term_ann>(def)->var_index == var_index)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
 
-    if (ast::is_op_not(root) && all_unbound(atom))
+    // true if variable `var_index` occurs in the precondition after `literal`, in the task list or in the sort key.
+    bool is_used_after(ast::node* literal, int var_index)
     {
-        output.writeln("if (!tuple_list::head<%i_tuple>(world.atoms[atom_%i]))", atom_id, atom_id);
+        ast::node* precondition = literal;
+
+        while (!ast::is_branch(precondition->parent))
         {
-            scope s(output);
+            precondition = precondition->parent;
+        }
+
+        // a foreach branch runs its task list for every binding.
+        if (ast::annotation<ast::branch_ann>(precondition->parent)->foreach)
+        {
+            return true;
+        }
+
+        ast::node* after = literal;
+
+        while (after != precondition && !after->next_sibling)
+        {
+            after = after->parent;
+        }
 
-            if (root->next_sibling)
+        after = (after != precondition) ? after->next_sibling : 0;
+
+        for (ast::node* n = after; n != 0; n = preorder_traversal_next(precondition, n))
+        {
+            if (ast::is_term_variable(n) && ast::annotation<ast::term_ann>(n)->var_index == var_index)
             {
-                generate_literal_chain(ast, root->next_sibling, output);
+                return true;
+            }
+        }
+
+        // each binding of a sort key variable gives another key to sort by.
+        return refers_to(precondition->next_sibling, var_index) || refers_to(ast::branch_sort_key(precondition->parent), var_index);
+    }
+
+    // value looked up in the sorted index of a static atom: a bound variable, a constant or a hoisted call result.
+    class paste_index_key : public paste_func
+    {
+    public:
+        ast::node* atom;
+        ast::node* key;
+        int key_index;
+
+        paste_index_key(ast::node* atom, ast::node* key, int key_index)
+            : atom(atom)
+            , key(key)
+            , key_index(key_index)
+        {
+        }
+
+        virtual void operator()(formatter& output)
+        {
+            if (ast::is_term_constant(key))
+            {
+                output.put_str(key->s_expr->token);
+                return;
+            }
+
+            output.put_str("state.");
+
+            if (ast::is_term_call(key))
+            {
+                output.put_id(atom->s_expr->token);
+                output.put_char('_');
+                output.put_int(ast::annotation<ast::atom_ann>(atom)->index);
+                output.put_str("_arg");
+                output.put_int(key_index);
             }
             else
             {
-                output.writeln("PLNNR_COROUTINE_YIELD(state);");
+                output.put_char('_');
+                output.put_int(ast::annotation<ast::term_ann>(key)->var_index);
             }
         }
-    }
-    else if (ast::is_op_not(root) && all_bound(atom))
+    };
+
+    // conjunction of equalities between the current tuple of a fully bound `atom` and its arguments.
+    class paste_tuple_match : public paste_func
     {
-        output.writeln("for (state.%i_%d = tuple_list::head<%i_tuple>(world.atoms[atom_%i]); state.%i_%d != 0; state.%i_%d = state.%i_%d->next)",
-            atom_id, atom_index,
-            atom_id,
-            atom_id,
-            atom_id, atom_index,
-            atom_id, atom_index,
-            atom_id, atom_index);
+    public:
+        ast::node* atom;
+        const char* tuple_prefix;
+
+        paste_tuple_match(ast::node* atom, const char* tuple_prefix)
+            : atom(atom)
+            , tuple_prefix(tuple_prefix)
         {
-            scope s(output);
+        }
 
+        virtual void operator()(formatter& output)
+        {
+            int atom_index = ast::annotation<ast::atom_ann>(atom)->index;
             int atom_param_index = 0;
 
-            for (ast::node* term = atom->first_child; term != 0; term = term->next_sibling)
+            for (ast::node* term = atom->first_child; term != 0; term = term->next_sibling, ++atom_param_index)
             {
+                if (term != atom->first_child)
+                {
+                    output.put_str(" && ");
+                }
+
+                output.put_str(tuple_prefix);
+                output.put_id(atom->s_expr->token);
+                output.put_char('_');
+                output.put_int(atom_index);
+                output.put_str("->_");
+                output.put_int(atom_param_index);
+                output.put_str(" == ");
+
                 if (ast::is_term_variable(term))
                 {
-                    int var_index = ast::annotation<ast::term_ann>(term)->var_index;
+                    output.put_str("state._");
+                    output.put_int(ast::annotation<ast::term_ann>(term)->var_index);
+                }
+                else if (ast::is_term_call(term))
+                {
+                    output.put_str("state.");
+                    output.put_id(atom->s_expr->token);
+                    output.put_char('_');
+                    output.put_int(atom_index);
+                    output.put_str("_arg");
+                    output.put_int(atom_param_index);
+                }
+                else
+                {
+                    output.put_str(term->s_expr->token);
+                }
+            }
+        }
+    };
 
-                    output.writeln("if (state.%i_%d->_%d == state._%d)", atom_id, atom_index, atom_param_index, var_index);
-                    {
-                        scope s(output, !is_last(term));
-                        output.writeln("break;");
-                    }
+    // loops over tuples of `atom`: a range of the sorted index if the atom is static and its key is known, the whole list otherwise.
+    void generate_atom_loop(ast::tree& ast, ast::node* atom, precondition_context& context, formatter& output)
+    {
+        const char* atom_id = atom->s_expr->token;
+        int atom_index = ast::annotation<ast::atom_ann>(atom)->index;
+        const char* tuple = context.tuple_prefix;
+        ast::atom_ann* ws_ann = ast::annotation<ast::atom_ann>(ast.ws_atoms.find(atom_id));
+
+        ast::node* key = 0;
+
+        if (ws_ann->indexed)
+        {
+            key = atom->first_child;
+
+            for (int i = 0; i < ws_ann->index_key; ++i)
+            {
+                key = key->next_sibling;
+            }
+
+            if (ast::is_term_variable(key) && !is_bound(key, context.bound))
+            {
+                key = 0;
+            }
+        }
+
+        if (!key)
+        {
+            output.writeln("for (%s%i_%d = tuple_list::head<%i_tuple>(world.atoms[atom_%i]); %s%i_%d != 0; %s%i_%d = %s%i_%d->next)",
+                tuple, atom_id, atom_index,
+                atom_id,
+                atom_id,
+                tuple, atom_id, atom_index,
+                tuple, atom_id, atom_index,
+                tuple, atom_id, atom_index);
+            return;
+        }
+
+        paste_index_key key_expr(atom, key, ws_ann->index_key);
+
+        output.writeln("for (state.%i_%d_cursor = uint32_t(%i_lower_bound(world, %p)), %s%i_%d = %i_at(world, state.%i_%d_cursor, %p); %s%i_%d != 0; %s%i_%d = %i_at(world, ++state.%i_%d_cursor, %p))",
+            atom_id, atom_index, atom_id, &key_expr,
+            tuple, atom_id, atom_index, atom_id, atom_id, atom_index, &key_expr,
+            tuple, atom_id, atom_index,
+            tuple, atom_id, atom_index, atom_id, atom_id, atom_index, &key_expr);
+    }
+
+    bool all_arguments_bound(ast::node* call, int* bound)
+    {
+        for (ast::node* n = call->first_child; n != 0; n = preorder_traversal_next(call, n))
+        {
+            if (ast::is_term_variable(n) && !is_bound(n, bound))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    // comparison evaluated by `literal`, 0 if it is not one.
+    ast::node* comparison_of(ast::node* literal)
+    {
+        ast::node* comparison = ast::is_op_not(literal) ? literal->first_child : literal;
+        return ast::is_comparison_op(comparison) ? comparison : 0;
+    }
+
+    // evaluates function call arguments of `atom` once, before the loop over its tuples.
+    // calls compared after the loop whose arguments are already bound are evaluated here too and marked hoisted with `marker`.
+    void generate_hoisted_calls(ast::tree& ast, ast::node* root, ast::node* atom, int marker, precondition_context& context, formatter& output)
+    {
+        const char* atom_id = atom->s_expr->token;
+        int atom_index = ast::annotation<ast::atom_ann>(atom)->index;
+        int atom_param_index = 0;
+        bool hoisted = false;
+
+        for (ast::node* term = atom->first_child; term != 0; term = term->next_sibling, ++atom_param_index)
+        {
+            if (ast::is_term_call(term))
+            {
+                paste_precondition_function_call paste(ast, term, "state._");
+                output.writeln("state.%i_%d_arg%d = %p;", atom_id, atom_index, atom_param_index, &paste);
+                hoisted = true;
+            }
+        }
+
+        for (ast::node* literal = next_literal(root); literal != 0; literal = next_literal(literal))
+        {
+            ast::node* comparison = comparison_of(literal);
+
+            for (ast::node* term = comparison ? comparison->first_child : 0; term != 0; term = term->next_sibling)
+            {
+                if (!ast::is_term_call(term))
+                {
+                    continue;
                 }
 
-                if (ast::is_term_call(term))
+                int call_index = ast::annotation<ast::term_ann>(term)->call_index;
+
+                if (!context.hoisted[call_index] && all_arguments_bound(term, context.bound))
                 {
-                    paste_precondition_function_call paste(term, "state._");
+                    paste_precondition_function_call paste(ast, term, "state._");
+                    output.writeln("state.call_%d = %p;", call_index, &paste);
+                    context.hoisted[call_index] = marker;
+                    hoisted = true;
+                }
+            }
+        }
 
-                    output.writeln("if (state.%i_%d->_%d == world.%p)", atom_id, atom_index, atom_param_index, &paste);
-                    {
-                        scope s(output, !is_last(term));
-                        output.writeln("break;");
-                    }
+        if (hoisted)
+        {
+            output.newline();
+        }
+    }
+
+    void unmark_hoisted_calls(ast::node* root, int marker, precondition_context& context)
+    {
+        for (ast::node* literal = next_literal(root); literal != 0; literal = next_literal(literal))
+        {
+            ast::node* comparison = comparison_of(literal);
+
+            for (ast::node* term = comparison ? comparison->first_child : 0; term != 0; term = term->next_sibling)
+            {
+                if (ast::is_term_call(term) && context.hoisted[ast::annotation<ast::term_ann>(term)->call_index] == marker)
+                {
+                    context.hoisted[ast::annotation<ast::term_ann>(term)->call_index] = 0;
                 }
+            }
+        }
+    }
 
-                ++atom_param_index;
+    bool all_unbound(ast::node* atom, int* bound)
+    {
+        for (ast::node* arg = atom->first_child; arg != 0; arg = arg->next_sibling)
+        {
+            if (!ast::is_term_variable(arg) || is_bound(arg, bound))
+            {
+                return false;
             }
         }
 
-        output.writeln("if (state.%i_%d == 0)", atom_id, atom_index);
+        return true;
+    }
+}
+
+void generate_literal_chain(ast::tree& ast, ast::node* root, precondition_context& context, formatter& output)
+{
+    plnnrc_assert(ast::is_op_or(root) || ast::is_op_not(root) || ast::is_term_call(root) || is_atom(root) || is_comparison_op(root));
+
+    // nested disjunction: each disjunct is followed by its own copy of the rest of the chain.
+    if (ast::is_op_or(root))
+    {
+        for (ast::node* conjunct = root->first_child; conjunct != 0; conjunct = conjunct->next_sibling)
         {
-            scope s(output, is_first(root));
+            plnnrc_assert(ast::is_op_and(conjunct));
 
-            if (root->next_sibling)
+            if (conjunct->first_child)
             {
-                generate_literal_chain(ast, root->next_sibling, output);
+                generate_literal_chain(ast, conjunct->first_child, context, output);
             }
             else
             {
-                output.writeln("PLNNR_COROUTINE_YIELD(state);");
+                generate_literal_chain_next(ast, root, context, output);
+            }
+        }
+
+        return;
+    }
+
+    ast::node* atom = root;
+
+    if (ast::is_op_not(root))
+    {
+        atom = root->first_child;
+    }
+
+    if (ast::is_comparison_op(atom))
+    {
+        generate_literal_chain_comparison(ast, root, atom, context, output);
+        return;
+    }
+
+    if (ast::is_term_call(atom))
+    {
+        generate_literal_chain_call_term(ast, root, atom, context, output);
+        return;
+    }
+
+    const char* atom_id = atom->s_expr->token;
+    int atom_index = ast::annotation<ast::atom_ann>(atom)->index;
+    // variables and hoisted calls are marked with the atom whose loop binds them and unmarked once the loop is generated.
+    int marker = atom_index + 2;
+
+    if (ast::is_op_not(root) && all_unbound(atom, context.bound))
+    {
+        output.writeln("if (!tuple_list::head<%i_tuple>(world.atoms[atom_%i]))", atom_id, atom_id);
+        {
+            scope s(output);
+            generate_literal_chain_next(ast, root, context, output);
+        }
+    }
+    else if (ast::is_op_not(root) && all_bound(atom, context.bound))
+    {
+        generate_hoisted_calls(ast, root, atom, marker, context, output);
+
+        generate_atom_loop(ast, atom, context, output);
+        {
+            scope s(output);
+
+            // the tuple matches only if all of its arguments do.
+            paste_tuple_match match(atom, context.tuple_prefix);
+
+            output.writeln("if (%p)", &match);
+            {
+                scope s(output, false);
+                output.writeln("break;");
             }
         }
+
+        output.writeln("if (%s%i_%d == 0)", context.tuple_prefix, atom_id, atom_index);
+        {
+            scope s(output, is_first(root));
+            generate_literal_chain_next(ast, root, context, output);
+        }
+
+        unmark_hoisted_calls(root, marker, context);
     }
     else
     {
-        output.writeln("for (state.%i_%d = tuple_list::head<%i_tuple>(world.atoms[atom_%i]); state.%i_%d != 0; state.%i_%d = state.%i_%d->next)",
-            atom_id, atom_index,
-            atom_id,
-            atom_id,
-            atom_id, atom_index,
-            atom_id, atom_index,
-            atom_id, atom_index);
+        generate_hoisted_calls(ast, root, atom, marker, context, output);
+
+        generate_atom_loop(ast, atom, context, output);
         {
             scope s(output, is_first(root));
 
@@ -307,11 +1100,11 @@ void generate_literal_chain(ast::tree& ast, ast::node* root, formatter& output)
 
             for (ast::node* term = atom->first_child; term != 0; term = term->next_sibling)
             {
-                if (ast::is_term_variable(term) && definition(term))
+                if (ast::is_term_variable(term) && is_bound(term, context.bound))
                 {
                     int var_index = ast::annotation<ast::term_ann>(term)->var_index;
 
-                    output.writeln("if (state.%i_%d->_%d %s state._%d)", atom_id, atom_index, atom_param_index, comparison_op, var_index);
+                    output.writeln("if (%s%i_%d->_%d %s state._%d)", context.tuple_prefix, atom_id, atom_index, atom_param_index, comparison_op, var_index);
                     {
                         scope s(output);
                         output.writeln("continue;");
@@ -320,9 +1113,16 @@ void generate_literal_chain(ast::tree& ast, ast::node* root, formatter& output)
 
                 if (ast::is_term_call(term))
                 {
-                    paste_precondition_function_call paste(term, "state._");
+                    output.writeln("if (%s%i_%d->_%d %s state.%i_%d_arg%d)", context.tuple_prefix, atom_id, atom_index, atom_param_index, comparison_op, atom_id, atom_index, atom_param_index);
+                    {
+                        scope s(output);
+                        output.writeln("continue;");
+                    }
+                }
 
-                    output.writeln("if (state.%i_%d->_%d %s world.%p)", atom_id, atom_index, atom_param_index, comparison_op, &paste);
+                if (ast::is_term_constant(term))
+                {
+                    output.writeln("if (%s%i_%d->_%d %s %s)", context.tuple_prefix, atom_id, atom_index, atom_param_index, comparison_op, term->s_expr->token);
                     {
                         scope s(output);
                         output.writeln("continue;");
@@ -336,81 +1136,105 @@ void generate_literal_chain(ast::tree& ast, ast::node* root, formatter& output)
 
             for (ast::node* term = atom->first_child; term != 0; term = term->next_sibling)
             {
-                if (ast::is_term_variable(term) && !definition(term))
+                if (ast::is_term_variable(term))
                 {
                     int var_index = ast::annotation<ast::term_ann>(term)->var_index;
-                    output.writeln("state._%d = state.%i_%d->_%d;", var_index, atom_id, atom_index, atom_param_index);
-                    output.newline();
+
+                    if (context.bound[var_index] == marker)
+                    {
+                        output.writeln("if (%s%i_%d->_%d != state._%d)", context.tuple_prefix, atom_id, atom_index, atom_param_index, var_index);
+                        {
+                            scope s(output);
+                            output.writeln("continue;");
+                        }
+                    }
+                    else if (!context.bound[var_index])
+                    {
+                        output.writeln("state._%d = %s%i_%d->_%d;", var_index, context.tuple_prefix, atom_id, atom_index, atom_param_index);
+                        output.newline();
+                        context.bound[var_index] = marker;
+                    }
                 }
 
                 ++atom_param_index;
             }
 
-            if (root->next_sibling)
+            // semi-join: if nothing after this atom depends on its bindings, the first match is enough.
+            bool existential = !ast::is_op_not(root);
+
+            for (ast::node* term = atom->first_child; term != 0; term = term->next_sibling)
             {
-                generate_literal_chain(ast, root->next_sibling, output);
+                if (ast::is_term_variable(term) && context.bound[ast::annotation<ast::term_ann>(term)->var_index] == marker)
+                {
+                    existential = existential && !is_used_after(root, ast::annotation<ast::term_ann>(term)->var_index);
+                }
             }
-            else
+
+            if (context.tuple_prefix[0] == 0)
+            {
+                context.loops[context.num_loops++] = atom;
+            }
+
+            generate_literal_chain_next(ast, root, context, output);
+
+            if (context.tuple_prefix[0] == 0)
             {
-                output.writeln("PLNNR_COROUTINE_YIELD(state);");
+                --context.num_loops;
+            }
+
+            if (existential)
+            {
+                output.writeln("break;");
+            }
+
+            for (ast::node* term = atom->first_child; term != 0; term = term->next_sibling)
+            {
+                if (ast::is_term_variable(term) && context.bound[ast::annotation<ast::term_ann>(term)->var_index] == marker)
+                {
+                    context.bound[ast::annotation<ast::term_ann>(term)->var_index] = 0;
+                }
             }
         }
+
+        unmark_hoisted_calls(root, marker, context);
     }
 }
 
-void generate_literal_chain_comparison(ast::tree& ast, ast::node* root, ast::node* atom, formatter& output)
+void generate_literal_chain_comparison(ast::tree& ast, ast::node* root, ast::node* atom, precondition_context& context, formatter& output)
 {
     ast::node* arg_0 = atom->first_child;
-    plnnrc_assert(arg_0 && ast::is_term_variable(arg_0));
+    plnnrc_assert(arg_0);
     ast::node* arg_1 = arg_0->next_sibling;
-    plnnrc_assert(arg_1 && ast::is_term_variable(arg_1) && !arg_1->next_sibling);
-
-    plnnrc_assert(definition(arg_0) && definition(arg_1));
+    plnnrc_assert(arg_1 && !arg_1->next_sibling);
 
     const char* comparison_op = atom->s_expr->token;
 
-    int var_index_0 = ast::annotation<ast::term_ann>(arg_0)->var_index;
-    int var_index_1 = ast::annotation<ast::term_ann>(arg_1)->var_index;
+    paste_precondition_term paste_0(ast, arg_0, context.hoisted);
+    paste_precondition_term paste_1(ast, arg_1, context.hoisted);
 
     if (ast::is_op_not(root))
     {
-        output.writeln("if (!(state._%d %s state._%d))", var_index_0, comparison_op, var_index_1);
+        output.writeln("if (!(%p %s %p))", &paste_0, comparison_op, &paste_1);
     }
     else
     {
-        output.writeln("if (state._%d %s state._%d)", var_index_0, comparison_op, var_index_1);
+        output.writeln("if (%p %s %p)", &paste_0, comparison_op, &paste_1);
     }
 
     {
-        scope s(output, root->next_sibling != 0);
-
-        if (root->next_sibling)
-        {
-            generate_literal_chain(ast, root->next_sibling, output);
-        }
-        else
-        {
-            output.writeln("PLNNR_COROUTINE_YIELD(state);");
-        }
+        scope s(output, next_literal(root) != 0);
+        generate_literal_chain_next(ast, root, context, output);
     }
 }
 
-void generate_literal_chain_call_term(ast::tree& ast, ast::node* root, ast::node* atom, formatter& output)
+void generate_literal_chain_call_term(ast::tree& ast, ast::node* root, ast::node* atom, precondition_context& context, formatter& output)
 {
-    paste_precondition_function_call paste(atom, "state._");
+    paste_precondition_function_call paste(ast, atom, "state._");
 
-    output.writeln("if (%sworld.%p)", ast::is_op_not(root) ? "!" : "", &paste);
+    output.writeln("if (%s%p)", ast::is_op_not(root) ? "!" : "", &paste);
     {
-        scope s(output, root->next_sibling != 0);
-
-        if (root->next_sibling)
-        {
-            generate_literal_chain(ast, root->next_sibling, output);
-        }
-        else
-        {
-            output.writeln("PLNNR_COROUTINE_YIELD(state);");
-        }
+        scope s(output, next_literal(root) != 0);
+        generate_literal_chain_next(ast, root, context, output);
     }
 }
 
@@ -26,17 +26,36 @@ namespace plnnrc {
 namespace ast { struct node; }
 namespace ast { class tree; }
 class formatter;
-
-void generate_preconditions(ast::tree& ast, ast::node* domain, formatter& output);
-
-void generate_precondition_state(ast::tree& ast, ast::node* root, unsigned branch_index, formatter& output);
-void generate_precondition_next(ast::tree& ast, ast::node* root, unsigned branch_index, formatter& output);
-
-void generate_precondition_satisfier(ast::tree& ast, ast::node* root, formatter& output);
-void generate_conjunctive_clause(ast::tree& ast, ast::node* root, formatter& output);
-void generate_literal_chain(ast::tree& ast, ast::node* root, formatter& output);
-void generate_literal_chain_call_term(ast::tree& ast, ast::node* root, ast::node* atom, formatter& output);
-void generate_literal_chain_comparison(ast::tree& ast, ast::node* root, ast::node* atom, formatter& output);
+struct codegen_options;
+
+bool generate_preconditions(ast::tree& ast, ast::node* domain, const codegen_options& options, formatter& output);
+
+void generate_precondition_state(ast::tree& ast, ast::node* root, unsigned branch_index, const codegen_options& options, formatter& output);
+bool generate_precondition_next(ast::tree& ast, ast::node* root, unsigned branch_index, const codegen_options& options, formatter& output);
+
+// state of the precondition `next` function being generated.
+struct precondition_context
+{
+    // indexed by variable index, non-zero for variables bound on the current path.
+    int* bound;
+    // indexed by comparison call index, non-zero for calls hoisted into the state on the current path.
+    int* hoisted;
+    // resume stage of the last generated yield, stages are numbered densely from 1.
+    int last_stage;
+    bool computed_goto;
+    // "state." if tuple pointers are state fields, empty with slot cursors where they are locals of `next`.
+    const char* tuple_prefix;
+    // atoms whose loops enclose the generated code, innermost last. tracked with slot cursors only.
+    ast::node** loops;
+    int num_loops;
+};
+
+void generate_precondition_satisfier(ast::tree& ast, ast::node* root, const codegen_options& options, precondition_context& context, formatter& output);
+void generate_conjunctive_clause(ast::tree& ast, ast::node* root, const codegen_options& options, precondition_context& context, formatter& output);
+bool generate_adaptive_clause(ast::tree& ast, ast::node* root, precondition_context& context, formatter& output);
+void generate_literal_chain(ast::tree& ast, ast::node* root, precondition_context& context, formatter& output);
+void generate_literal_chain_call_term(ast::tree& ast, ast::node* root, ast::node* atom, precondition_context& context, formatter& output);
+void generate_literal_chain_comparison(ast::tree& ast, ast::node* root, ast::node* atom, precondition_context& context, formatter& output);
 
 }
 
@@ -21,11 +21,66 @@
 #include "derplanner/compiler/assert.h"
 #include "derplanner/compiler/s_expression.h"
 #include "derplanner/compiler/ast.h"
+#include "ast_tools.h"
 #include "formatter.h"
 #include "codegen_source.h"
 
 namespace plnnrc {
 
+// parameter list, argument comparison or call argument list of a memoized world function.
+class paste_memo_parameters : public paste_func
+{
+public:
+    enum paste_mode
+    {
+        mode_declaration,
+        mode_comparison,
+        mode_call,
+    };
+
+    ast::node* function_atom;
+    paste_mode mode;
+
+    paste_memo_parameters(ast::node* function_atom, paste_mode mode)
+        : function_atom(function_atom)
+        , mode(mode)
+    {
+    }
+
+    virtual void operator()(formatter& output)
+    {
+        int param_index = 0;
+
+        for (ast::node* param = function_atom->first_child; param != 0; param = param->next_sibling, ++param_index)
+        {
+            if (mode == mode_declaration)
+            {
+                output.put_str(", ");
+                output.put_str(param->s_expr->first_child->token);
+                output.put_str(" _");
+                output.put_int(param_index);
+            }
+            else if (mode == mode_call)
+            {
+                if (param_index > 0)
+                {
+                    output.put_str(", ");
+                }
+
+                output.put_char('_');
+                output.put_int(param_index);
+            }
+            else
+            {
+                output.put_str(" && e._");
+                output.put_int(param_index);
+                output.put_str(" == _");
+                output.put_int(param_index);
+            }
+        }
+    }
+};
+
 void generate_source_top(const char* header_file_name, formatter& output)
 {
     output.writeln("#include <derplanner/runtime/runtime.h>");
@@ -36,6 +91,7 @@ void generate_source_top(const char* header_file_name, formatter& output)
     output.newline();
 
     output.writeln("#pragma GCC diagnostic ignored \"-Wunused-variable\"");
+    output.writeln("#pragma GCC diagnostic ignored \"-Wunused-parameter\"");
     output.newline();
 }
 
@@ -111,4 +167,241 @@ void generate_atom_name_function(ast::tree& /*ast*/, ast::node* worldstate, bool
     }
 }
 
+void generate_memoized_functions(ast::tree& ast, ast::node* worldstate, formatter& output)
+{
+    if (ast::has_pure_functions(ast))
+    {
+        output.writeln("void invalidate_memo(memo_tables& memo)");
+        {
+            scope s(output);
+
+            output.writeln("// once the fingerprint wraps around, entries stamped with it long ago would be valid again.");
+            output.writeln("if (++memo.fingerprint == 0)");
+            {
+                scope s(output, false);
+                output.writeln("memo = memo_tables();");
+            }
+        }
+    }
+
+    for (ast::node* function_def = worldstate->first_child->next_sibling; function_def != 0; function_def = function_def->next_sibling)
+    {
+        if (!ast::is_function(function_def) || !ast::annotation<ast::func_ann>(function_def)->pure)
+        {
+            continue;
+        }
+
+        ast::node* function_atom = function_def->first_child;
+        ast::node* return_type = function_atom->next_sibling;
+        const char* function_id = function_atom->s_expr->token;
+
+        paste_memo_parameters paste_params(function_atom, paste_memo_parameters::mode_declaration);
+        paste_memo_parameters paste_args(function_atom, paste_memo_parameters::mode_comparison);
+        paste_memo_parameters paste_call(function_atom, paste_memo_parameters::mode_call);
+
+        output.writeln("static %s %i_memoized(worldstate& world, void* memo%p)", return_type->s_expr->first_child->token, function_id, &paste_params);
+        {
+            scope s(output);
+            output.writeln("if (!memo)");
+            {
+                scope s(output);
+                output.writeln("return world.%i(%p);", function_id, &paste_call);
+            }
+
+            output.writeln("memo_tables& tables = *static_cast<memo_tables*>(memo);");
+            output.writeln("%i_memo& table = tables.%i_table;", function_id, function_id);
+            output.newline();
+
+            output.writeln("uint32_t hash = memo_hash_seed;");
+
+            unsigned param_index = 0;
+
+            for (ast::node* param = function_atom->first_child; param != 0; param = param->next_sibling)
+            {
+                output.writeln("hash = memo_hash(hash, _%d);", param_index++);
+            }
+
+            output.writeln("%i_memo::entry& e = table.entries[hash %% %i_memo::size];", function_id, function_id);
+            output.newline();
+
+            output.writeln("if (e.valid && e.fingerprint == tables.fingerprint%p)", &paste_args);
+            {
+                scope s(output);
+                output.writeln("return e.result;");
+            }
+
+            param_index = 0;
+
+            for (ast::node* param = function_atom->first_child; param != 0; param = param->next_sibling)
+            {
+                output.writeln("e._%d = _%d;", param_index, param_index);
+                ++param_index;
+            }
+
+            output.writeln("e.result = world.%i(%p);", function_id, &paste_call);
+            output.writeln("e.fingerprint = tables.fingerprint;");
+            output.writeln("e.valid = true;");
+            output.newline();
+            output.writeln("return e.result;");
+        }
+    }
+}
+
+void generate_static_index_functions(ast::tree& /*ast*/, ast::node* worldstate, formatter& output)
+{
+    bool has_indexed_atoms = false;
+
+    for (ast::node* atom = worldstate->first_child->next_sibling; atom != 0; atom = atom->next_sibling)
+    {
+        if (!ast::is_atom(atom) || !ast::annotation<ast::atom_ann>(atom)->indexed)
+        {
+            continue;
+        }
+
+        const char* atom_id = atom->s_expr->token;
+        int key = ast::annotation<ast::atom_ann>(atom)->index_key;
+        ast::node* key_type = atom->first_child;
+
+        for (int i = 0; i < key; ++i)
+        {
+            key_type = key_type->next_sibling;
+        }
+
+        const char* key_type_id = key_type->s_expr->first_child->token;
+
+        output.writeln("inline bool %i_less(const %i_tuple* a, const %i_tuple* b)", atom_id, atom_id, atom_id);
+        {
+            scope s(output);
+            output.writeln("return a->_%d < b->_%d;", key, key);
+        }
+
+        output.writeln("inline size_t %i_lower_bound(worldstate& world, %s key)", atom_id, key_type_id);
+        {
+            scope s(output);
+            output.writeln("// the index is empty or stale unless `build_static_indices` was called after the worldstate was loaded.");
+            output.writeln("plnnr_assert(world.%i_index_size == tuple_list::size(world.atoms[atom_%i]));", atom_id, atom_id);
+            output.writeln("size_t first = 0;");
+            output.writeln("size_t count = world.%i_index_size;", atom_id);
+            output.newline();
+
+            output.writeln("while (count > 0)");
+            {
+                scope s(output);
+                output.writeln("size_t step = count / 2;");
+                output.newline();
+
+                output.writeln("if (world.%i_index[first + step]->_%d < key)", atom_id, key);
+                {
+                    scope s(output, false);
+                    output.writeln("first += step + 1;");
+                    output.writeln("count -= step + 1;");
+                }
+
+                output.writeln("else");
+                {
+                    scope s(output);
+                    output.writeln("count = step;");
+                }
+            }
+
+            output.writeln("return first;");
+        }
+
+        output.writeln("inline %i_tuple* %i_at(worldstate& world, size_t cursor, %s key)", atom_id, atom_id, key_type_id);
+        {
+            scope s(output);
+            output.writeln("if (cursor < world.%i_index_size && world.%i_index[cursor]->_%d == key)", atom_id, atom_id, key);
+            {
+                scope s(output);
+                output.writeln("return world.%i_index[cursor];", atom_id);
+            }
+
+            output.writeln("return 0;");
+        }
+
+        has_indexed_atoms = true;
+    }
+
+    if (!has_indexed_atoms)
+    {
+        return;
+    }
+
+    output.writeln("bool build_static_indices(worldstate& world)");
+    {
+        scope s(output);
+        output.writeln("destroy_static_indices(world);");
+        output.newline();
+
+        for (ast::node* atom = worldstate->first_child->next_sibling; atom != 0; atom = atom->next_sibling)
+        {
+            if (!ast::is_atom(atom) || !ast::annotation<ast::atom_ann>(atom)->indexed)
+            {
+                continue;
+            }
+
+            const char* atom_id = atom->s_expr->token;
+
+            output.writeln("world.%i_index_size = tuple_list::size(world.atoms[atom_%i]);", atom_id, atom_id);
+            output.newline();
+
+            output.writeln("if (world.%i_index_size > 0)", atom_id);
+            {
+                scope s(output);
+                output.writeln("world.%i_index = static_cast<%i_tuple**>(memory::allocate(sizeof(%i_tuple*) * world.%i_index_size));", atom_id, atom_id, atom_id, atom_id);
+                output.newline();
+
+                output.writeln("if (!world.%i_index)", atom_id);
+                {
+                    scope s(output);
+                    output.writeln("world.%i_index_size = 0;", atom_id);
+                    output.writeln("return false;");
+                }
+
+                output.writeln("size_t i = 0;");
+                output.newline();
+
+                output.writeln("for (%i_tuple* t = tuple_list::head<%i_tuple>(world.atoms[atom_%i]); t != 0; t = t->next)", atom_id, atom_id, atom_id);
+                {
+                    scope s(output);
+                    output.writeln("world.%i_index[i++] = t;", atom_id);
+                }
+
+                output.writeln("if (!stable_sort(world.%i_index, world.%i_index_size, %i_less))", atom_id, atom_id, atom_id);
+                {
+                    scope s(output, false);
+                    output.writeln("return false;");
+                }
+            }
+        }
+
+        output.writeln("return true;");
+    }
+
+    output.writeln("void destroy_static_indices(worldstate& world)");
+    {
+        scope s(output);
+
+        for (ast::node* atom = worldstate->first_child->next_sibling; atom != 0; atom = atom->next_sibling)
+        {
+            if (!ast::is_atom(atom) || !ast::annotation<ast::atom_ann>(atom)->indexed)
+            {
+                continue;
+            }
+
+            const char* atom_id = atom->s_expr->token;
+
+            output.writeln("if (world.%i_index)", atom_id);
+            {
+                scope s(output);
+                output.writeln("memory::deallocate(world.%i_index);", atom_id);
+            }
+
+            output.writeln("world.%i_index = 0;", atom_id);
+            output.writeln("world.%i_index_size = 0;", atom_id);
+            output.newline();
+        }
+    }
+}
+
 }
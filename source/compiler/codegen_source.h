@@ -30,6 +30,8 @@ class formatter;
 void generate_source_top(const char* header_file_name, formatter& output);
 void generate_task_name_function(ast::tree& ast, ast::node* domain, bool enabled, formatter& output);
 void generate_atom_name_function(ast::tree& ast, ast::node* worldstate, bool enabled, formatter& output);
+void generate_memoized_functions(ast::tree& ast, ast::node* worldstate, formatter& output);
+void generate_static_index_functions(ast::tree& ast, ast::node* worldstate, formatter& output);
 
 }
 
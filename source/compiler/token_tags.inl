@@ -26,9 +26,13 @@ PLNNRC_TOKEN(token_domain,      ":domain")
 PLNNRC_TOKEN(token_method,      ":method")
 PLNNRC_TOKEN(token_operator,    ":operator")
 PLNNRC_TOKEN(token_foreach,     ":foreach")
+PLNNRC_TOKEN(token_sort_by,     ":sort-by")
 PLNNRC_TOKEN(token_add,         ":add")
 PLNNRC_TOKEN(token_delete,      ":delete")
+PLNNRC_TOKEN(token_cost,        ":cost")
 PLNNRC_TOKEN(token_lazy,        ":lazy")
+PLNNRC_TOKEN(token_size,        ":size")
+PLNNRC_TOKEN(token_pure,        ":pure")
 PLNNRC_TOKEN(token_and,         "and")
 PLNNRC_TOKEN(token_or,          "or")
 PLNNRC_TOKEN(token_not,         "not")
@@ -19,6 +19,7 @@
 //
 
 #include <string.h>
+#include <float.h>
 #include "derplanner/runtime/assert.h"
 #include "derplanner/runtime/memory.h"
 #include "derplanner/runtime/worldstate.h"
@@ -63,6 +64,301 @@ void stack::reset()
     rewind(_buffer);
 }
 
+bool stack::grow(size_t capacity)
+{
+    plnnr_assert(capacity >= top_offset());
+
+    char* buffer = static_cast<char*>(memory::allocate(capacity));
+
+    if (!buffer)
+    {
+        return false;
+    }
+
+    size_t used = top_offset();
+    ::memcpy(buffer, _buffer, used);
+    memory::deallocate(_buffer);
+
+    _capacity = capacity;
+    _buffer = buffer;
+    _top = buffer + used;
+
+    return true;
+}
+
+bool stack::assign(const stack& source)
+{
+    return assign(source._buffer, source.top_offset());
+}
+
+bool stack::assign(const void* data, size_t size)
+{
+    if (size > _capacity)
+    {
+        return false;
+    }
+
+    ::memcpy(_buffer, data, size);
+    _top = _buffer + size;
+
+    return true;
+}
+
+bool copy(planner_state& destination, const planner_state& source)
+{
+    if (!destination.methods->assign(*source.methods) ||
+        !destination.tasks->assign(*source.tasks) ||
+        !destination.journal->assign(*source.journal))
+    {
+        return false;
+    }
+
+    if (source.trace && destination.trace && !destination.trace->assign(*source.trace))
+    {
+        return false;
+    }
+
+    destination.top_method = source.top_method;
+    destination.top_task = source.top_task;
+    destination.expands = source.expands;
+
+    return true;
+}
+
+namespace
+{
+    const uint32_t saved_state_magic = 0x706c6e32; // "pln2"
+
+    struct saved_state_header
+    {
+        uint32_t magic;
+        uint32_t world_fingerprint;
+        uint32_t top_method;
+        uint32_t top_task;
+        uint32_t methods_size;
+        uint32_t tasks_size;
+        uint32_t journal_size;
+        uint32_t trace_size;
+    };
+
+    char* write(char* output, const stack* s)
+    {
+        size_t size = s->top_offset();
+        ::memcpy(output, s->buffer(), size);
+        return output + size;
+    }
+}
+
+uint32_t world_fingerprint(void* worldstate, uint32_t atom_count)
+{
+    tuple_list::handle** atoms = atom_lists(worldstate);
+    uint32_t hash = memo_hash_seed;
+
+    for (uint32_t i = 0; i < atom_count; ++i)
+    {
+        hash = memo_hash(hash, atoms[i]);
+        hash = memo_hash(hash, tuple_list::generation(atoms[i]));
+    }
+
+    return hash;
+}
+
+size_t save_size(const planner_state& pstate)
+{
+    size_t trace_size = pstate.trace ? pstate.trace->top_offset() : 0;
+
+    return sizeof(saved_state_header) +
+        pstate.methods->top_offset() +
+        pstate.tasks->top_offset() +
+        pstate.journal->top_offset() +
+        trace_size;
+}
+
+size_t save(const planner_state& pstate, uint32_t world_fingerprint, void* buffer, size_t buffer_size)
+{
+    size_t size = save_size(pstate);
+
+    if (size > buffer_size)
+    {
+        return 0;
+    }
+
+    saved_state_header header;
+    header.magic = saved_state_magic;
+    header.world_fingerprint = world_fingerprint;
+    header.top_method = pstate.top_method;
+    header.top_task = pstate.top_task;
+    header.methods_size = (uint32_t)pstate.methods->top_offset();
+    header.tasks_size = (uint32_t)pstate.tasks->top_offset();
+    header.journal_size = (uint32_t)pstate.journal->top_offset();
+    header.trace_size = pstate.trace ? (uint32_t)pstate.trace->top_offset() : 0;
+
+    char* output = static_cast<char*>(buffer);
+    ::memcpy(output, &header, sizeof(header));
+    output += sizeof(header);
+
+    output = write(output, pstate.methods);
+    output = write(output, pstate.tasks);
+    output = write(output, pstate.journal);
+
+    if (pstate.trace)
+    {
+        write(output, pstate.trace);
+    }
+
+    return size;
+}
+
+bool load(planner_state& pstate, uint32_t world_fingerprint, const void* buffer, size_t buffer_size)
+{
+    saved_state_header header;
+
+    if (buffer_size < sizeof(header))
+    {
+        return false;
+    }
+
+    ::memcpy(&header, buffer, sizeof(header));
+
+    if (header.magic != saved_state_magic || header.world_fingerprint != world_fingerprint)
+    {
+        return false;
+    }
+
+    size_t stacks_size = (size_t)header.methods_size + header.tasks_size + header.journal_size + header.trace_size;
+
+    if (buffer_size < sizeof(header) + stacks_size)
+    {
+        return false;
+    }
+
+    const char* input = static_cast<const char*>(buffer) + sizeof(header);
+
+    if (!pstate.methods->assign(input, header.methods_size))
+    {
+        return false;
+    }
+
+    input += header.methods_size;
+
+    if (!pstate.tasks->assign(input, header.tasks_size))
+    {
+        return false;
+    }
+
+    input += header.tasks_size;
+
+    if (!pstate.journal->assign(input, header.journal_size))
+    {
+        return false;
+    }
+
+    input += header.journal_size;
+
+    // trace is optional on both sides.
+    if (pstate.trace && !pstate.trace->assign(input, header.trace_size))
+    {
+        return false;
+    }
+
+    pstate.top_method = header.top_method;
+    pstate.top_task = header.top_task;
+
+    return true;
+}
+
+size_t export_plan(const planner_state& pstate, void* buffer, size_t buffer_size)
+{
+    char* begin = static_cast<char*>(buffer);
+    char* end = begin + buffer_size;
+    plan_step* step = memory::align<plan_step>(buffer);
+
+    task_instance* task = pstate.tasks->empty() ? 0 : memory::align<task_instance>(pstate.tasks->buffer());
+
+    for (; task != 0; task = next_task(task))
+    {
+        if (task->expand != expand_none)
+        {
+            continue;
+        }
+
+        char* args = static_cast<char*>(task->args_size ? memory::align(step + 1, task->args_align) : static_cast<void*>(step + 1));
+        plan_step* next = memory::align<plan_step>(args + task->args_size);
+
+        if (reinterpret_cast<char*>(next + 1) > end)
+        {
+            return 0;
+        }
+
+        plnnr_assert(reinterpret_cast<char*>(next) - reinterpret_cast<char*>(step) <= 0xffff);
+
+        step->type = task->type;
+        step->arguments = task->args_size ? uint16_t(args - reinterpret_cast<char*>(step)) : 0;
+        step->size = uint16_t(reinterpret_cast<char*>(next) - reinterpret_cast<char*>(step));
+
+        if (task->args_size)
+        {
+            ::memcpy(args, arguments(task), task->args_size);
+        }
+
+        step = next;
+    }
+
+    if (reinterpret_cast<char*>(step + 1) > end)
+    {
+        return 0;
+    }
+
+    // terminator.
+    step->type = -1;
+    step->arguments = 0;
+    step->size = 0;
+
+    return reinterpret_cast<char*>(step + 1) - begin;
+}
+
+size_t committed_offset(const planner_state& pstate)
+{
+    size_t offset = pstate.tasks->top_offset();
+
+    // a failure below a committed method propagates to its parent,
+    // so the prefix ends where the deepest method with alternatives (closest to the root) started.
+    for (method_instance* method = top_method(pstate); method != 0; method = prev_method(method))
+    {
+        if (!(method->flags & method_flags_committed))
+        {
+            offset = method->task_rewind;
+        }
+    }
+
+    return offset;
+}
+
+task_instance* next_committed_task(const planner_state& pstate, size_t& cursor)
+{
+    size_t end = committed_offset(pstate);
+
+    while (cursor < end)
+    {
+        task_instance* task = memory::align<task_instance>(pstate.tasks->ptr(cursor));
+
+        if (pstate.tasks->offset(task) >= end)
+        {
+            break;
+        }
+
+        void* args_end = task->args_size ? memory::offset(arguments(task), task->args_size) : static_cast<void*>(task + 1);
+        cursor = pstate.tasks->offset(args_end);
+
+        if (task->expand == expand_none)
+        {
+            return task;
+        }
+    }
+
+    return 0;
+}
+
 void reset(planner_state& pstate)
 {
     pstate.top_method = 0;
@@ -82,11 +378,21 @@ method_instance* copy_method(method_instance* method, stack* destination)
 {
     void* dest = destination->push(method->size, plnnr_alignof(method_instance));
     ::memcpy(dest, method, method->size);
+    // the parent frame stays behind in the source stack.
+    static_cast<method_instance*>(dest)->prev = 0;
     return static_cast<method_instance*>(dest);
 }
 
-method_instance* push_method(planner_state& pstate, int task_type, expand_func expand)
+method_instance* push_method(planner_state& pstate, int task_type, uint16_t expand)
 {
+    method_instance* parent = top_method(pstate);
+
+    // parent is expanding again, any failure reported by previous child is consumed.
+    if (parent)
+    {
+        parent->flags &= ~method_flags_failed;
+    }
+
     method_instance* new_method = push<method_instance>(pstate.methods);
 
     new_method->flags = method_flags_none;
@@ -98,9 +404,9 @@ method_instance* push_method(planner_state& pstate, int task_type, expand_func e
     new_method->journal_rewind = (uint32_t)pstate.journal->top_offset();
     new_method->trace_rewind = 0;
     new_method->stage = 0;
-    new_method->type = task_type;
+    new_method->type = (uint16_t)task_type;
     new_method->expand = expand;
-    new_method->prev = pstate.top_method;
+    new_method->prev = parent ? uint32_t((char*)new_method - (char*)parent) : 0;
 
     if (pstate.trace)
     {
@@ -111,28 +417,64 @@ method_instance* push_method(planner_state& pstate, int task_type, expand_func e
         new_method->trace_rewind = (uint32_t)pstate.trace->top_offset();
     }
 
-    pstate.top_method = new_method;
+    set_top_method(pstate, new_method);
 
     return new_method;
 }
 
-task_instance* push_task(planner_state& pstate, int task_type, expand_func expand)
+method_instance* push_tail_method(planner_state& pstate, int task_type, uint16_t expand)
+{
+    method_instance* parent = top_method(pstate);
+    plnnr_assert(parent);
+
+    // the callee can't fail, but other plans may still use the parent's alternatives.
+    if ((parent->flags & method_flags_enumerating) && !(parent->flags & method_flags_committed))
+    {
+        return push_method(pstate, task_type, expand);
+    }
+
+    // parent is fully expanded and has nothing left to try => the callee takes its place on the stack.
+    set_top_method(pstate, prev_method(parent));
+
+    // unless methods expanded by the parent are kept for `find_next_plan_step`,
+    // then the parent frame stays below them to be resumed on backtracking.
+    if (pstate.methods->top() == end(parent))
+    {
+        pstate.methods->rewind(parent);
+    }
+
+    return push_method(pstate, task_type, expand);
+}
+
+task_instance* push_task(planner_state& pstate, int task_type, uint16_t expand)
 {
+    // a pushed task may be failed by branch-and-bound search, like a method task.
+    if (method_instance* parent = top_method(pstate))
+    {
+        parent->flags &= ~method_flags_failed;
+    }
+
     task_instance* new_task = push<task_instance>(pstate.tasks);
 
     new_task->args_align = 0;
     new_task->args_size = 0;
     new_task->type = task_type;
+    new_task->cost = 0.0f;
     new_task->expand = expand;
-    new_task->prev = pstate.top_task;
+    new_task->prev = 0;
     new_task->next = 0;
 
-    if (pstate.top_task)
+    task_instance* prev = top_task(pstate);
+
+    if (prev)
     {
-        pstate.top_task->next = new_task;
+        uint32_t distance = uint32_t((char*)new_task - (char*)prev);
+        new_task->prev = distance;
+        new_task->cost = prev->cost;
+        prev->next = distance;
     }
 
-    pstate.top_task = new_task;
+    set_top_task(pstate, new_task);
 
     return new_task;
 }
@@ -141,6 +483,9 @@ task_instance* push_task(planner_state& pstate, task_instance* task)
 {
     task_instance* new_task = push_task(pstate, task->type, task->expand);
 
+    task_instance* prev = prev_task(task);
+    new_task->cost += task->cost - (prev ? prev->cost : 0.0f);
+
     if (arguments(task))
     {
         void* args_dst = pstate.tasks->push(task->args_size, task->args_align);
@@ -152,76 +497,248 @@ task_instance* push_task(planner_state& pstate, task_instance* task)
     return new_task;
 }
 
-method_instance* rewind_top_method(planner_state& pstate, bool rewind_tasks_and_effects)
+namespace
 {
-    method_instance* old_top = pstate.top_method;
-    method_instance* new_top = old_top->prev;
-
-    if (new_top)
+    // undoes journal entries [bottom, top) in reverse order.
+    void undo_range(operator_effect* bottom, operator_effect* top, void* worldstate)
     {
-        // rewind everything after parent method precondition
-        pstate.methods->rewind(end(new_top));
+        tuple_list::handle** atoms = atom_lists(worldstate);
 
-        if (rewind_tasks_and_effects)
+        while (top != bottom)
         {
-            new_top->flags |= method_flags_failed;
+            --top;
+
+            tuple_list::handle* list = atoms[top->atom];
+            void* tuple = tuple_list::at(list, top->tuple);
 
-            // rewind tasks
-            if (new_top->task_rewind < pstate.tasks->top_offset())
+            if (top->kind == effect_add)
             {
-                task_instance* task = memory::align<task_instance>(pstate.tasks->ptr(new_top->task_rewind));
-                task_instance* top_task = task->prev;
+                tuple_list::detach(list, tuple);
+            }
+            else
+            {
+                tuple_list::restore(list, tuple);
+            }
+        }
+    }
 
-                pstate.tasks->rewind(new_top->task_rewind);
+    // rewinds everything `method` has produced and marks it for resuming with the next binding or branch.
+    void rewind_tasks_and_effects_of(planner_state& pstate, method_instance* method, void* worldstate)
+    {
+        // method resumes with the next binding or branch, so it's not expanded anymore.
+        method->flags &= ~method_flags_expanded;
+        method->flags |= method_flags_failed;
 
-                pstate.top_task = top_task;
-                pstate.top_task->next = 0;
-            }
+        // rewind tasks
+        if (method->task_rewind < pstate.tasks->top_offset())
+        {
+            task_instance* task = memory::align<task_instance>(pstate.tasks->ptr(method->task_rewind));
+            task_instance* last_task = prev_task(task);
+
+            pstate.tasks->rewind(method->task_rewind);
 
-            // rewind effects
-            if (new_top->journal_rewind < pstate.journal->top_offset())
+            set_top_task(pstate, last_task);
+
+            if (last_task)
             {
-                operator_effect* bottom = static_cast<operator_effect*>(pstate.journal->ptr(new_top->journal_rewind));
-                operator_effect* top = static_cast<operator_effect*>(pstate.journal->top()) - 1;
+                last_task->next = 0;
+            }
+        }
 
-                for (; top != bottom-1; --top)
-                {
-                    tuple_list::undo(top->list, top->tuple);
-                }
+        // rewind effects
+        if (method->journal_rewind < pstate.journal->top_offset())
+        {
+            operator_effect* bottom = static_cast<operator_effect*>(pstate.journal->ptr(method->journal_rewind));
+            operator_effect* top = static_cast<operator_effect*>(pstate.journal->top());
+
+            undo_range(bottom, top, worldstate);
+
+            pstate.journal->rewind(method->journal_rewind);
+        }
+
+        // rewind trace
+        if (pstate.trace)
+        {
+            pstate.trace->rewind(method->trace_rewind);
+        }
+    }
+
+    // the search is exhausted: undoes everything, including tasks and effects
+    // of frames replaced by tail calls, which are below the rewind points of the remaining frames.
+    void rewind_all_tasks_and_effects(planner_state& pstate, void* worldstate)
+    {
+        if (!pstate.journal->empty())
+        {
+            undo_range(memory::align<operator_effect>(pstate.journal->buffer()), static_cast<operator_effect*>(pstate.journal->top()), worldstate);
+        }
+
+        pstate.journal->reset();
+        pstate.tasks->reset();
+        set_top_task(pstate, 0);
+
+        if (pstate.trace)
+        {
+            pstate.trace->reset();
+        }
+    }
+
+    // pushed above a fully expanded method kept on the stack by `find_next_plan_step`,
+    // preceded by a copy of the parent precondition (foreach branches move on to other bindings).
+    struct kept_method
+    {
+        // offset of the method in the methods stack.
+        uint32_t frame;
+        // stage and flags of the parent right after it pushed the method.
+        uint16_t parent_stage;
+        uint16_t precondition_size;
+        uint8_t parent_flags;
+    };
+
+    // precondition copy is padded to keep `kept_method` right after it.
+    inline size_t kept_copy_size(size_t precondition_size)
+    {
+        return (precondition_size + plnnr_alignof(kept_method) - 1) & ~(plnnr_alignof(kept_method) - 1);
+    }
+
+    // keeps the expanded top method for backtracking and makes its parent the top.
+    method_instance* keep_top_method(planner_state& pstate)
+    {
+        method_instance* method = top_method(pstate);
+        method_instance* parent = prev_method(method);
+
+        uint16_t precondition_size = (parent && parent->precondition) ? uint16_t(parent->size - parent->precondition) : 0;
+        void* copy = 0;
+
+        if (precondition_size)
+        {
+            copy = pstate.methods->push(kept_copy_size(precondition_size), plnnr_alignof(kept_method));
+            ::memcpy(copy, precondition(parent), precondition_size);
+        }
+
+        kept_method* kept = push<kept_method>(pstate.methods);
+        kept->frame = uint32_t(pstate.methods->offset(method));
+        kept->parent_stage = parent ? parent->stage : 0;
+        kept->precondition_size = precondition_size;
+        kept->parent_flags = parent ? parent->flags : 0;
 
-                pstate.journal->rewind(new_top->journal_rewind);
+        plnnr_assert(!copy || static_cast<char*>(copy) + kept_copy_size(precondition_size) == reinterpret_cast<char*>(kept));
+
+        set_top_method(pstate, parent);
+
+        return parent;
+    }
+
+    // the frame at `position` failed, resumes the most recent method below it with alternatives:
+    // the last kept descendant of `parent` or `parent` itself.
+    method_instance* backtrack(planner_state& pstate, method_instance* parent, void* position, void* worldstate)
+    {
+        method_instance* target = parent;
+        char* top = static_cast<char*>(position);
+
+        for (;;)
+        {
+            void* first_child = memory::align<method_instance>(target ? end(target) : pstate.methods->buffer());
+
+            if (first_child == top)
+            {
+                break;
             }
 
-            // rewind trace
-            if (pstate.trace)
+            // kept methods are pushed in expansion order, the last one is the most recent choice.
+            kept_method* kept = reinterpret_cast<kept_method*>(top) - 1;
+            char* copy = reinterpret_cast<char*>(kept) - kept_copy_size(kept->precondition_size);
+            target = static_cast<method_instance*>(pstate.methods->ptr(kept->frame));
+
+            // the parent continues right after pushing the kept method once it's expanded again.
+            if (method_instance* target_parent = prev_method(target))
             {
-                pstate.trace->rewind(new_top->trace_rewind);
+                target_parent->stage = kept->parent_stage;
+                target_parent->flags = kept->parent_flags;
+                ::memcpy(precondition(target_parent), copy, kept->precondition_size);
             }
+
+            top = copy;
         }
+
+        if (!target)
+        {
+            pstate.methods->rewind(pstate.methods->buffer());
+            set_top_method(pstate, 0);
+            rewind_all_tasks_and_effects(pstate, worldstate);
+            return 0;
+        }
+
+        pstate.methods->rewind(end(target));
+        set_top_method(pstate, target);
+        rewind_tasks_and_effects_of(pstate, target, worldstate);
+
+        return target;
+    }
+}
+
+method_instance* rewind_top_method(planner_state& pstate, bool rewind_tasks_and_effects, void* worldstate)
+{
+    method_instance* old_top = top_method(pstate);
+    method_instance* new_top = prev_method(old_top);
+
+    if (new_top)
+    {
+        // rewind everything after parent method precondition
+        pstate.methods->rewind(end(new_top));
+
+        if (rewind_tasks_and_effects)
+        {
+            rewind_tasks_and_effects_of(pstate, new_top, worldstate);
+        }
+    }
+    else if (rewind_tasks_and_effects)
+    {
+        rewind_all_tasks_and_effects(pstate, worldstate);
     }
 
-    pstate.top_method = new_top;
+    set_top_method(pstate, new_top);
 
-    return pstate.top_method;
+    return new_top;
 }
 
-void undo_effects(stack* journal)
+void redo_effects(stack* journal, void* worldstate)
 {
-    if (!journal->empty())
+    tuple_list::handle** atoms = atom_lists(worldstate);
+
+    operator_effect* top = static_cast<operator_effect*>(journal->top());
+    operator_effect* effect = memory::align<operator_effect>(journal->buffer());
+
+    // forward order mirrors `undo_effects`, so restored tuples find their old neighbours.
+    for (; effect < top; ++effect)
     {
-        operator_effect* top = static_cast<operator_effect*>(journal->top()) - 1;
-        operator_effect* bottom = memory::align<operator_effect>(journal->buffer());
+        tuple_list::handle* list = atoms[effect->atom];
+        void* tuple = tuple_list::at(list, effect->tuple);
 
-        for (; top != bottom-1 ; --top)
+        if (effect->kind == effect_add)
         {
-            tuple_list::undo(top->list, top->tuple);
+            tuple_list::restore(list, tuple);
+        }
+        else
+        {
+            tuple_list::detach(list, tuple);
         }
     }
 }
 
-bool expand_next_branch(planner_state& pstate, expand_func expand, void* worldstate)
+void undo_effects(stack* journal, void* worldstate)
 {
-    method_instance* method = pstate.top_method;
+    if (!journal->empty())
+    {
+        operator_effect* top = static_cast<operator_effect*>(journal->top());
+        operator_effect* bottom = memory::align<operator_effect>(journal->buffer());
+
+        undo_range(bottom, top, worldstate);
+    }
+}
+
+void select_next_branch(planner_state& pstate, uint16_t expand)
+{
+    method_instance* method = top_method(pstate);
 
     method->stage = 0;
     method->expanding_branch++;
@@ -236,11 +753,16 @@ bool expand_next_branch(planner_state& pstate, expand_func expand, void* worldst
         method_trace* trace = memory::align<method_trace>(pstate.trace->ptr(method->trace_rewind)) - 1;
         trace->branch_index = method->expanding_branch;
     }
+}
 
-    return method->expand(method, pstate, worldstate);
+bool expand_next_branch(planner_state& pstate, uint16_t expand, void* worldstate)
+{
+    select_next_branch(pstate, expand);
+    method_instance* method = top_method(pstate);
+    return pstate.expands[method->expand](method, pstate, worldstate);
 }
 
-bool find_plan(planner_state& pstate, int root_method_type, expand_func root_method, void* worldstate)
+bool find_plan(planner_state& pstate, int root_method_type, uint16_t root_method, void* worldstate)
 {
     find_plan_init(pstate, root_method_type, root_method);
 
@@ -254,7 +776,7 @@ bool find_plan(planner_state& pstate, int root_method_type, expand_func root_met
     return status == plan_found;
 }
 
-void find_plan_init(planner_state& pstate, int root_method_type, expand_func root_method)
+void find_plan_init(planner_state& pstate, int root_method_type, uint16_t root_method)
 {
     push_method(pstate, root_method_type, root_method);
 }
@@ -269,8 +791,8 @@ void find_plan_init(planner_state& pstate, task_instance* composite_task)
         ::memcpy(args_dst, arguments(composite_task), composite_task->args_size);
         size_t method_offset = pstate.methods->offset(method);
         size_t arguments_offset = pstate.methods->offset(args_dst);
-        method->arguments = uint32_t(arguments_offset - method_offset);
-        method->size = uint32_t(pstate.methods->top_offset() - method_offset);
+        method->arguments = uint16_t(arguments_offset - method_offset);
+        method->size = uint16_t(pstate.methods->top_offset() - method_offset);
     }
 }
 
@@ -278,17 +800,24 @@ find_plan_status find_plan_step(planner_state& pstate, void* worldstate)
 {
     plnnr_assert(pstate.top_method);
 
-    method_instance* method = pstate.top_method;
+    method_instance* method = top_method(pstate);
+
+    return find_plan_advance(pstate, method, pstate.expands[method->expand](method, pstate, worldstate), worldstate);
+}
 
+find_plan_status find_plan_advance(planner_state& pstate, method_instance* method, bool expanded, void* worldstate)
+{
     // if found satisfying preconditions
-    if (method->expand(method, pstate, worldstate))
+    if (expanded)
     {
         // expanded to primitive tasks => go up popping expanded methods.
-        if (method == pstate.top_method && method->flags & method_flags_expanded)
+        // a tail call may have replaced `method` by a callee at the same address,
+        // which is never expanded on push, so it's left on the stack.
+        if (method == top_method(pstate) && method->flags & method_flags_expanded)
         {
             while (method && (method->flags & method_flags_expanded))
             {
-                method = rewind_top_method(pstate, false);
+                method = rewind_top_method(pstate, false, worldstate);
             }
 
             // all methods were expanded => plan found.
@@ -301,7 +830,7 @@ find_plan_status find_plan_step(planner_state& pstate, void* worldstate)
     // backtrack otherwise
     else
     {
-        method = rewind_top_method(pstate, true);
+        method = rewind_top_method(pstate, true, worldstate);
 
         if (!method)
         {
@@ -312,4 +841,106 @@ find_plan_status find_plan_step(planner_state& pstate, void* worldstate)
     return plan_in_progress;
 }
 
+find_plan_status find_next_plan_step(planner_state& pstate, void* worldstate)
+{
+    return find_next_plan_step(pstate, worldstate, FLT_MAX);
+}
+
+find_plan_status find_next_plan_step(planner_state& pstate, void* worldstate, float cost_bound)
+{
+    method_instance* method = top_method(pstate);
+
+    if (!method)
+    {
+        if (pstate.methods->empty())
+        {
+            return plan_not_found;
+        }
+
+        // resuming after a found plan: backtrack as if a task appended to the plan failed.
+        return backtrack(pstate, 0, pstate.methods->top(), worldstate) ? plan_in_progress : plan_not_found;
+    }
+
+    float cost = plan_cost(pstate);
+
+    method->flags |= method_flags_enumerating;
+
+    if (pstate.expands[method->expand](method, pstate, worldstate))
+    {
+        // the operator task just pushed is too expensive => fail it, the method resumes with other alternatives.
+        if (plan_cost(pstate) > cost && plan_cost(pstate) >= cost_bound)
+        {
+            return backtrack(pstate, method, pstate.methods->top(), worldstate) ? plan_in_progress : plan_not_found;
+        }
+
+        // expanded methods stay on the stack, so alternatives of finished subtrees are still reachable.
+        // `method` may be a tail callee pushed in its place, as in `find_plan_step`.
+        if (method == top_method(pstate) && method->flags & method_flags_expanded)
+        {
+            while (method && (method->flags & method_flags_expanded))
+            {
+                method = keep_top_method(pstate);
+            }
+
+            if (!method)
+            {
+                // only a plan of zero cost can get here with a non-positive bound.
+                if (plan_cost(pstate) >= cost_bound)
+                {
+                    return backtrack(pstate, 0, pstate.methods->top(), worldstate) ? plan_in_progress : plan_not_found;
+                }
+
+                return plan_found;
+            }
+        }
+    }
+    else
+    {
+        if (!backtrack(pstate, prev_method(method), method, worldstate))
+        {
+            return plan_not_found;
+        }
+    }
+
+    return plan_in_progress;
+}
+
+find_plan_status find_next_plan(planner_state& pstate, void* worldstate)
+{
+    find_plan_status status = find_next_plan_step(pstate, worldstate);
+
+    while (status == plan_in_progress)
+    {
+        status = find_next_plan_step(pstate, worldstate);
+    }
+
+    return status;
+}
+
+find_plan_status find_optimal_plan(planner_state& pstate, void* worldstate, uint32_t max_steps, float& best_cost, void* buffer, size_t buffer_size)
+{
+    for (uint32_t step = 0; step < max_steps; ++step)
+    {
+        find_plan_status status = find_next_plan_step(pstate, worldstate, best_cost);
+
+        if (status == plan_found)
+        {
+            if (!export_plan(pstate, buffer, buffer_size))
+            {
+                return plan_not_found;
+            }
+
+            best_cost = plan_cost(pstate);
+        }
+
+        if (status == plan_not_found)
+        {
+            // search space is exhausted, the last exported plan is the cheapest one.
+            return best_cost < FLT_MAX ? plan_found : plan_not_found;
+        }
+    }
+
+    return plan_in_progress;
+}
+
 }
@@ -18,6 +18,7 @@
 // 3. This notice may not be removed or altered from any source distribution.
 //
 
+#include <string.h> // memcpy
 #include "derplanner/runtime/assert.h"
 #include "derplanner/runtime/memory.h"
 #include "derplanner/runtime/worldstate.h"
@@ -31,7 +32,8 @@ struct page
 {
     page* prev;
     char* memory;
-    char* top;
+    char* first;
+    size_t count;
     char  data[1];
 };
 
@@ -39,8 +41,16 @@ struct handle
 {
     page* head_page;
     void* head_tuple;
+    size_t num_tuples;
     tuple_traits tuple;
     size_t page_size;
+    size_t items_per_page;
+    // pages in allocation order, maps tuple slots to pages.
+    page** pages;
+    uint32_t num_pages;
+    uint32_t max_pages;
+    // number of `clear` calls.
+    uint32_t generation;
 };
 
 namespace
@@ -57,15 +67,46 @@ namespace
         return *p;
     }
 
+    void init_page(page* p, page* prev, char* memory, size_t alignment)
+    {
+        p->prev = prev;
+        p->memory = memory;
+        p->first = static_cast<char*>(memory::align(p->data, alignment));
+        p->count = 0;
+    }
+
+    bool add_page(handle* tuple_list, page* p)
+    {
+        if (tuple_list->num_pages == tuple_list->max_pages)
+        {
+            uint32_t max_pages = tuple_list->max_pages ? tuple_list->max_pages * 2 : 8;
+            page** pages = static_cast<page**>(memory::allocate(sizeof(page*) * max_pages));
+
+            if (!pages)
+            {
+                return false;
+            }
+
+            if (tuple_list->pages)
+            {
+                memcpy(pages, tuple_list->pages, sizeof(page*) * tuple_list->num_pages);
+                memory::deallocate(tuple_list->pages);
+            }
+
+            tuple_list->pages = pages;
+            tuple_list->max_pages = max_pages;
+        }
+
+        tuple_list->pages[tuple_list->num_pages++] = p;
+
+        return true;
+    }
+
     void* allocate(handle* tuple_list)
     {
-        size_t bytes = tuple_list->tuple.size;
-        size_t alignment = tuple_list->tuple.alignment;
         page* p = tuple_list->head_page;
 
-        char* top = static_cast<char*>(memory::align(p->top, alignment));
-
-        if (top + bytes > p->memory + tuple_list->page_size)
+        if (p->count == tuple_list->items_per_page)
         {
             char* memory = static_cast<char*>(memory::allocate(tuple_list->page_size));
 
@@ -75,18 +116,22 @@ namespace
             }
 
             p = memory::align<page>(memory);
-            p->prev = tuple_list->head_page;
-            p->memory = memory;
-            p->top = p->data;
+            init_page(p, tuple_list->head_page, memory, tuple_list->tuple.alignment);
 
-            tuple_list->head_page = p;
+            if (!add_page(tuple_list, p))
+            {
+                memory::deallocate(memory);
+                return 0;
+            }
 
-            top = static_cast<char*>(memory::align(p->top, alignment));
+            tuple_list->head_page = p;
         }
 
-        p->top = top + bytes;
+        void* tuple = p->first + tuple_list->tuple.size * p->count;
+        uint32_t* slot = reinterpret_cast<uint32_t*>(static_cast<char*>(tuple) + tuple_list->tuple.slot_offset);
+        *slot = uint32_t((tuple_list->num_pages - 1) * tuple_list->items_per_page + p->count++);
 
-        return top;
+        return tuple;
     }
 }
 
@@ -106,14 +151,24 @@ handle* create(tuple_traits traits, size_t items_per_page)
     handle* tuple_list = memory::align<handle>(memory);
     page* head_page = memory::align<page>(tuple_list + 1);
 
-    head_page->prev = 0;
-    head_page->memory = memory;
-    head_page->top = head_page->data;
+    init_page(head_page, 0, memory, traits.alignment);
 
     tuple_list->head_page = head_page;
     tuple_list->head_tuple = 0;
+    tuple_list->num_tuples = 0;
     tuple_list->tuple = traits;
     tuple_list->page_size = page_size;
+    tuple_list->items_per_page = items_per_page;
+    tuple_list->pages = 0;
+    tuple_list->num_pages = 0;
+    tuple_list->max_pages = 0;
+    tuple_list->generation = 0;
+
+    if (!add_page(tuple_list, head_page))
+    {
+        memory::deallocate(memory);
+        return 0;
+    }
 
     return tuple_list;
 }
@@ -129,13 +184,18 @@ void clear(handle* tuple_list)
         p = n;
     }
 
-    p->top = p->data;
+    p->count = 0;
     tuple_list->head_page = p;
     tuple_list->head_tuple = 0;
+    tuple_list->num_tuples = 0;
+    tuple_list->num_pages = 1;
+    ++tuple_list->generation;
 }
 
 void destroy(const handle* tuple_list)
 {
+    memory::deallocate(tuple_list->pages);
+
     for (page* p = tuple_list->head_page; p != 0;)
     {
         page* n = p->prev;
@@ -175,6 +235,8 @@ void* append(handle* tuple_list)
         set_ptr(tuple, prev_offset, tuple);
     }
 
+    tuple_list->num_tuples++;
+
     return tuple;
 }
 
@@ -206,6 +268,43 @@ void detach(handle* tuple_list, void* tuple)
     {
         tuple_list->head_tuple = next;
     }
+
+    plnnr_assert(tuple_list->num_tuples > 0);
+    tuple_list->num_tuples--;
+}
+
+void restore(handle* tuple_list, void* tuple)
+{
+    size_t next_offset = tuple_list->tuple.next_offset;
+    size_t prev_offset = tuple_list->tuple.prev_offset;
+
+    void* head = tuple_list->head_tuple;
+    void* prev = get_ptr(tuple, prev_offset);
+    void* next = get_ptr(tuple, next_offset);
+
+    if (prev)
+    {
+        set_ptr(prev, next_offset, tuple);
+    }
+
+    if (next)
+    {
+        set_ptr(next, prev_offset, tuple);
+    }
+
+    if (!head || head == next)
+    {
+        tuple_list->head_tuple = tuple;
+        head = tuple;
+        set_ptr(prev, next_offset, 0);
+    }
+
+    if (!next)
+    {
+        set_ptr(head, prev_offset, tuple);
+    }
+
+    tuple_list->num_tuples++;
 }
 
 void undo(handle* tuple_list, void* tuple)
@@ -225,28 +324,39 @@ void undo(handle* tuple_list, void* tuple)
     }
     else
     {
-        if (prev)
-        {
-            set_ptr(prev, next_offset, tuple);
-        }
+        restore(tuple_list, tuple);
+    }
+}
 
-        if (next)
-        {
-            set_ptr(next, prev_offset, tuple);
-        }
+uint32_t slot(const handle* tuple_list, const void* tuple)
+{
+    const char* t = static_cast<const char*>(tuple);
+    uint32_t slot = *reinterpret_cast<const uint32_t*>(t + tuple_list->tuple.slot_offset);
 
-        if (!head || head == next)
-        {
-            tuple_list->head_tuple = tuple;
-            head = tuple;
-            set_ptr(prev, next_offset, 0);
-        }
+    // the slot field of a foreign tuple may point anywhere, so check it maps back to `tuple`.
+    uint32_t page_index = uint32_t(slot / tuple_list->items_per_page);
 
-        if (!next)
-        {
-            set_ptr(head, prev_offset, tuple);
-        }
+    if (page_index >= tuple_list->num_pages)
+    {
+        return invalid_slot;
+    }
+
+    const page* p = tuple_list->pages[page_index];
+
+    if (p->first + tuple_list->tuple.size * (slot % tuple_list->items_per_page) != t)
+    {
+        return invalid_slot;
     }
+
+    return slot;
+}
+
+void* at(handle* tuple_list, uint32_t slot)
+{
+    uint32_t page_index = uint32_t(slot / tuple_list->items_per_page);
+    plnnr_assert(page_index < tuple_list->num_pages);
+    page* p = tuple_list->pages[page_index];
+    return p->first + tuple_list->tuple.size * (slot % tuple_list->items_per_page);
 }
 
 void* head(handle* tuple_list)
@@ -255,5 +365,17 @@ void* head(handle* tuple_list)
     return tuple_list->head_tuple;
 }
 
+size_t size(const handle* tuple_list)
+{
+    plnnr_assert(tuple_list);
+    return tuple_list->num_tuples;
+}
+
+uint32_t generation(const handle* tuple_list)
+{
+    plnnr_assert(tuple_list);
+    return tuple_list->generation;
+}
+
 }
 }
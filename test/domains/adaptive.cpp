@@ -0,0 +1,133 @@
+#include <derplanner/runtime/runtime.h>
+#include "adaptive.h"
+
+using namespace plnnr;
+
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+
+namespace adaptive {
+
+static const char* atom_type_to_name[] =
+{
+	"left",
+	"right",
+	"<none>",
+};
+
+const char* atom_name(atom_type type) { return atom_type_to_name[type]; }
+
+}
+
+namespace adaptive {
+
+static const char* task_type_to_name[] =
+{
+	"!pair",
+	"pairs",
+	"<none>",
+};
+
+const char* task_name(task_type type) { return task_type_to_name[type]; }
+
+// method pairs [11:19]
+struct p0_state
+{
+	left_tuple* left_0;
+	right_tuple* right_1;
+	// x [11:26]
+	int _0;
+	// y [11:36]
+	int _1;
+	int stage;
+};
+
+bool next(p0_state& state, worldstate& world)
+{
+	PLNNR_COROUTINE_BEGIN(state);
+
+	// pick the loop nest starting with the smallest atom list.
+	if (tuple_list::size(world.atoms[atom_left]) <= tuple_list::size(world.atoms[atom_right]))
+	{
+		for (state.left_0 = tuple_list::head<left_tuple>(world.atoms[atom_left]); state.left_0 != 0; state.left_0 = state.left_0->next)
+		{
+			state._0 = state.left_0->_0;
+
+			for (state.right_1 = tuple_list::head<right_tuple>(world.atoms[atom_right]); state.right_1 != 0; state.right_1 = state.right_1->next)
+			{
+				if (state.right_1->_1 != state._0)
+				{
+					continue;
+				}
+
+				state._1 = state.right_1->_0;
+
+				PLNNR_COROUTINE_YIELD(state, 1);
+			}
+		}
+
+	}
+	else
+	{
+		for (state.right_1 = tuple_list::head<right_tuple>(world.atoms[atom_right]); state.right_1 != 0; state.right_1 = state.right_1->next)
+		{
+			state._1 = state.right_1->_0;
+
+			state._0 = state.right_1->_1;
+
+			for (state.left_0 = tuple_list::head<left_tuple>(world.atoms[atom_left]); state.left_0 != 0; state.left_0 = state.left_0->next)
+			{
+				if (state.left_0->_0 != state._0)
+				{
+					continue;
+				}
+
+				PLNNR_COROUTINE_YIELD(state, 2);
+				break;
+			}
+		}
+
+	}
+
+	PLNNR_COROUTINE_END();
+}
+
+plnnr_static_assert(sizeof(method_instance) + padded_size<p0_state>::value <= max_frame_size);
+
+bool pairs_branch_0_expand(method_instance* method, planner_state& pstate, void* world)
+{
+	p0_state* precondition = plnnr::precondition<p0_state>(method);
+	worldstate* wstate = static_cast<worldstate*>(world);
+
+	PLNNR_COROUTINE_BEGIN(*method);
+
+	precondition = push_precondition<p0_state>(pstate, method);
+
+	while (next(*precondition, *wstate))
+	{
+		{
+			task_instance* t = push_task(pstate, task_pair, expand_none);
+			pair_args* a = push_arguments<pair_args>(pstate, t);
+			a->_0 = precondition->_0;
+			a->_1 = precondition->_1;
+		}
+
+		PLNNR_COROUTINE_YIELD(*method, 1);
+	}
+
+	if (precondition->stage > 0)
+	{
+		method->flags |= method_flags_expanded;
+		PLNNR_COROUTINE_YIELD(*method, 2);
+	}
+
+	PLNNR_COROUTINE_END();
+}
+
+const expand_func expands[] =
+{
+	0,
+	pairs_branch_0_expand,
+};
+
+}
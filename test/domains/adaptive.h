@@ -0,0 +1,165 @@
+#ifndef adaptive_H_
+#define adaptive_H_
+
+#include <derplanner/runtime/interface.h>
+
+namespace plnnr
+{
+	namespace tuple_list
+	{
+		struct handle;
+	}
+}
+
+namespace plnnr
+{
+	struct planner_state;
+	struct method_instance;
+	typedef bool (*expand_func)(method_instance*, planner_state&, void*);
+}
+
+namespace adaptive {
+
+enum atom_type
+{
+	atom_left,
+	atom_right,
+	atom_count,
+};
+
+const char* atom_name(atom_type type);
+
+struct worldstate
+{
+	plnnr::tuple_list::handle* atoms[atom_count];
+};
+
+struct left_tuple
+{
+	int _0;
+	left_tuple* next;
+	left_tuple* prev;
+	uint32_t slot;
+	enum { id = atom_left };
+};
+
+struct right_tuple
+{
+	int _0;
+	int _1;
+	right_tuple* next;
+	right_tuple* prev;
+	uint32_t slot;
+	enum { id = atom_right };
+};
+
+}
+
+namespace adaptive {
+
+enum task_type
+{
+	task_pair,
+	task_pairs,
+	task_count,
+};
+
+static const int operator_count = 1;
+static const int method_count = 1;
+
+const char* task_name(task_type type);
+
+struct pair_args
+{
+	int _0;
+	int _1;
+};
+
+inline bool operator==(const pair_args& a, const pair_args& b)
+{
+	return \
+		a._0 == b._0 &&
+		a._1 == b._1 ;
+}
+
+bool pairs_branch_0_expand(plnnr::method_instance*, plnnr::planner_state&, void*);
+
+enum expand_index
+{
+	expand_pairs_branch_0 = 1,
+};
+
+extern const plnnr::expand_func expands[];
+
+}
+
+namespace plnnr {
+
+template <typename V>
+struct generated_type_reflector<adaptive::worldstate, V>
+{
+	void operator()(const adaptive::worldstate& world, V& visitor)
+	{
+		PLNNR_GENCODE_VISIT_ATOM_LIST(adaptive, atom_left, left_tuple, visitor);
+		PLNNR_GENCODE_VISIT_ATOM_LIST(adaptive, atom_right, right_tuple, visitor);
+	}
+};
+
+template <typename V>
+struct generated_type_reflector<adaptive::left_tuple, V>
+{
+	void operator()(const adaptive::left_tuple& tuple, V& visitor)
+	{
+		PLNNR_GENCODE_VISIT_TUPLE_BEGIN(visitor, adaptive, atom_name, atom_left, 1);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 0);
+		PLNNR_GENCODE_VISIT_TUPLE_END(visitor, adaptive, atom_name, atom_left, 1);
+	}
+};
+
+template <typename V>
+struct generated_type_reflector<adaptive::right_tuple, V>
+{
+	void operator()(const adaptive::right_tuple& tuple, V& visitor)
+	{
+		PLNNR_GENCODE_VISIT_TUPLE_BEGIN(visitor, adaptive, atom_name, atom_right, 2);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 0);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 1);
+		PLNNR_GENCODE_VISIT_TUPLE_END(visitor, adaptive, atom_name, atom_right, 2);
+	}
+};
+
+template <typename V>
+struct generated_type_reflector<adaptive::pair_args, V>
+{
+	void operator()(const adaptive::pair_args& tuple, V& visitor)
+	{
+		PLNNR_GENCODE_VISIT_TUPLE_BEGIN(visitor, adaptive, task_name, task_pair, 2);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 0);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 1);
+		PLNNR_GENCODE_VISIT_TUPLE_END(visitor, adaptive, task_name, task_pair, 2);
+	}
+};
+
+template <typename V>
+struct task_type_dispatcher<adaptive::task_type, V>
+{
+	void operator()(const adaptive::task_type& task_type, void* args, V& visitor)
+	{
+		switch (task_type)
+		{
+			case adaptive::task_pairs:
+				PLNNR_GENCODE_VISIT_TASK_NO_ARGS(visitor, adaptive, task_pairs);
+				break;
+			case adaptive::task_pair:
+				PLNNR_GENCODE_VISIT_TASK_WITH_ARGS(visitor, adaptive, task_pair, pair_args);
+				break;
+			default:
+				plnnr_assert(false);
+				break;
+		}
+	}
+};
+
+}
+
+#endif
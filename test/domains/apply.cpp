@@ -0,0 +1,216 @@
+#include <derplanner/runtime/runtime.h>
+#include "apply.h"
+
+using namespace plnnr;
+
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+
+namespace apply {
+
+static const char* atom_type_to_name[] =
+{
+	"at",
+	"road",
+	"visited",
+	"dest",
+	"<none>",
+};
+
+const char* atom_name(atom_type type) { return atom_type_to_name[type]; }
+
+}
+
+namespace apply {
+
+static const char* task_type_to_name[] =
+{
+	"!move",
+	"!wait",
+	"arrived",
+	"travel",
+	"<none>",
+};
+
+const char* task_name(task_type type) { return task_type_to_name[type]; }
+
+// method arrived [18:9]
+struct p0_state
+{
+	at_tuple* at_0;
+	// z [18:14]
+	int _0;
+	int stage;
+};
+
+bool next(p0_state& state, worldstate& world)
+{
+	PLNNR_COROUTINE_BEGIN(state);
+
+	for (state.at_0 = tuple_list::head<at_tuple>(world.atoms[atom_at]); state.at_0 != 0; state.at_0 = state.at_0->next)
+	{
+		if (state.at_0->_0 != state._0)
+		{
+			continue;
+		}
+
+		PLNNR_COROUTINE_YIELD(state, 1);
+		break;
+	}
+
+	PLNNR_COROUTINE_END();
+}
+
+// method travel [23:9]
+struct p1_state
+{
+	road_tuple* road_0;
+	dest_tuple* dest_1;
+	// x [23:16]
+	int _0;
+	// y [23:18]
+	int _1;
+	// z [23:27]
+	int _2;
+	int stage;
+};
+
+bool next(p1_state& state, worldstate& world)
+{
+	PLNNR_COROUTINE_BEGIN(state);
+
+	for (state.road_0 = tuple_list::head<road_tuple>(world.atoms[atom_road]); state.road_0 != 0; state.road_0 = state.road_0->next)
+	{
+		if (state.road_0->_0 != state._0)
+		{
+			continue;
+		}
+
+		state._1 = state.road_0->_1;
+
+		for (state.dest_1 = tuple_list::head<dest_tuple>(world.atoms[atom_dest]); state.dest_1 != 0; state.dest_1 = state.dest_1->next)
+		{
+			state._2 = state.dest_1->_0;
+
+			PLNNR_COROUTINE_YIELD(state, 1);
+		}
+	}
+
+	PLNNR_COROUTINE_END();
+}
+
+void apply_move(planner_state& pstate, worldstate* wstate, move_args* a)
+{
+	for (at_tuple* tuple = tuple_list::head<at_tuple>(wstate->atoms[atom_at]); tuple != 0; tuple = tuple->next)
+	{
+		if (tuple->_0 != a->_0)
+		{
+			continue;
+		}
+
+		tuple_list::handle* list = wstate->atoms[atom_at];
+		operator_effect* effect = push<operator_effect>(pstate.journal);
+		effect->tuple = tuple->slot;
+		effect->atom = atom_at;
+		effect->kind = effect_delete;
+		tuple_list::detach(list, tuple);
+
+		break;
+	}
+
+	{
+		tuple_list::handle* list = wstate->atoms[atom_at];
+		at_tuple* tuple = tuple_list::append<at_tuple>(list);
+		tuple->_0 = a->_1;
+		operator_effect* effect = push<operator_effect>(pstate.journal);
+		effect->tuple = tuple->slot;
+		effect->atom = atom_at;
+		effect->kind = effect_add;
+	}
+
+	{
+		tuple_list::handle* list = wstate->atoms[atom_visited];
+		visited_tuple* tuple = tuple_list::append<visited_tuple>(list);
+		tuple->_0 = a->_1;
+		operator_effect* effect = push<operator_effect>(pstate.journal);
+		effect->tuple = tuple->slot;
+		effect->atom = atom_visited;
+		effect->kind = effect_add;
+	}
+}
+
+plnnr_static_assert(sizeof(method_instance) + padded_size<arrived_args>::value + padded_size<p0_state>::value <= max_frame_size);
+
+bool arrived_branch_0_expand(method_instance* method, planner_state& pstate, void* world)
+{
+	p0_state* precondition = plnnr::precondition<p0_state>(method);
+	arrived_args* method_args = plnnr::arguments<arrived_args>(method);
+	worldstate* wstate = static_cast<worldstate*>(world);
+
+	PLNNR_COROUTINE_BEGIN(*method);
+
+	method->flags |= method_flags_committed;
+	precondition = push_precondition<p0_state>(pstate, method);
+	precondition->_0 = method_args->_0;
+
+	while (next(*precondition, *wstate))
+	{
+		method->flags |= method_flags_expanded;
+		PLNNR_COROUTINE_YIELD(*method, 1);
+	}
+
+	PLNNR_COROUTINE_END();
+}
+
+plnnr_static_assert(sizeof(method_instance) + padded_size<travel_args>::value + padded_size<p1_state>::value <= max_frame_size);
+
+bool travel_branch_0_expand(method_instance* method, planner_state& pstate, void* world)
+{
+	p1_state* precondition = plnnr::precondition<p1_state>(method);
+	travel_args* method_args = plnnr::arguments<travel_args>(method);
+	worldstate* wstate = static_cast<worldstate*>(world);
+
+	PLNNR_COROUTINE_BEGIN(*method);
+
+	precondition = push_precondition<p1_state>(pstate, method);
+	precondition->_0 = method_args->_0;
+
+	while (next(*precondition, *wstate))
+	{
+		{
+			task_instance* t = push_task(pstate, task_wait, expand_none);
+		}
+
+		PLNNR_COROUTINE_YIELD(*method, 1);
+
+		{
+			task_instance* t = push_task(pstate, task_move, expand_none);
+			move_args* a = push_arguments<move_args>(pstate, t);
+			a->_0 = method_args->_0;
+			a->_1 = precondition->_1;
+			apply_move(pstate, wstate, a);
+		}
+
+		PLNNR_COROUTINE_YIELD(*method, 2);
+
+		{
+			method_instance* t = push_method(pstate, task_arrived, expand_arrived_branch_0);
+			arrived_args* a = push_arguments<arrived_args>(pstate, t);
+			a->_0 = precondition->_2;
+		}
+
+		method->flags |= method_flags_expanded;
+		PLNNR_COROUTINE_YIELD(*method, 3);
+	}
+
+	PLNNR_COROUTINE_END();
+}
+
+const expand_func expands[] =
+{
+	0,
+	arrived_branch_0_expand,
+	travel_branch_0_expand,
+};
+
+}
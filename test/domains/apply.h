@@ -0,0 +1,263 @@
+#ifndef apply_H_
+#define apply_H_
+
+#include <derplanner/runtime/interface.h>
+
+namespace plnnr
+{
+	namespace tuple_list
+	{
+		struct handle;
+	}
+}
+
+namespace plnnr
+{
+	struct planner_state;
+	struct method_instance;
+	typedef bool (*expand_func)(method_instance*, planner_state&, void*);
+}
+
+namespace apply {
+
+enum atom_type
+{
+	atom_at,
+	atom_road,
+	atom_visited,
+	atom_dest,
+	atom_count,
+};
+
+const char* atom_name(atom_type type);
+
+struct worldstate
+{
+	plnnr::tuple_list::handle* atoms[atom_count];
+};
+
+struct at_tuple
+{
+	int _0;
+	at_tuple* next;
+	at_tuple* prev;
+	uint32_t slot;
+	enum { id = atom_at };
+};
+
+struct road_tuple
+{
+	int _0;
+	int _1;
+	road_tuple* next;
+	road_tuple* prev;
+	uint32_t slot;
+	enum { id = atom_road };
+};
+
+struct visited_tuple
+{
+	int _0;
+	visited_tuple* next;
+	visited_tuple* prev;
+	uint32_t slot;
+	enum { id = atom_visited };
+};
+
+struct dest_tuple
+{
+	int _0;
+	dest_tuple* next;
+	dest_tuple* prev;
+	uint32_t slot;
+	enum { id = atom_dest };
+};
+
+}
+
+namespace apply {
+
+enum task_type
+{
+	task_move,
+	task_wait,
+	task_arrived,
+	task_travel,
+	task_count,
+};
+
+static const int operator_count = 2;
+static const int method_count = 2;
+
+const char* task_name(task_type type);
+
+struct move_args
+{
+	int _0;
+	int _1;
+};
+
+inline bool operator==(const move_args& a, const move_args& b)
+{
+	return \
+		a._0 == b._0 &&
+		a._1 == b._1 ;
+}
+
+struct arrived_args
+{
+	int _0;
+};
+
+inline bool operator==(const arrived_args& a, const arrived_args& b)
+{
+	return \
+		a._0 == b._0 ;
+}
+
+struct travel_args
+{
+	int _0;
+};
+
+inline bool operator==(const travel_args& a, const travel_args& b)
+{
+	return \
+		a._0 == b._0 ;
+}
+
+bool arrived_branch_0_expand(plnnr::method_instance*, plnnr::planner_state&, void*);
+bool travel_branch_0_expand(plnnr::method_instance*, plnnr::planner_state&, void*);
+
+enum expand_index
+{
+	expand_arrived_branch_0 = 1,
+	expand_travel_branch_0,
+};
+
+extern const plnnr::expand_func expands[];
+
+}
+
+namespace plnnr {
+
+template <typename V>
+struct generated_type_reflector<apply::worldstate, V>
+{
+	void operator()(const apply::worldstate& world, V& visitor)
+	{
+		PLNNR_GENCODE_VISIT_ATOM_LIST(apply, atom_at, at_tuple, visitor);
+		PLNNR_GENCODE_VISIT_ATOM_LIST(apply, atom_road, road_tuple, visitor);
+		PLNNR_GENCODE_VISIT_ATOM_LIST(apply, atom_visited, visited_tuple, visitor);
+		PLNNR_GENCODE_VISIT_ATOM_LIST(apply, atom_dest, dest_tuple, visitor);
+	}
+};
+
+template <typename V>
+struct generated_type_reflector<apply::at_tuple, V>
+{
+	void operator()(const apply::at_tuple& tuple, V& visitor)
+	{
+		PLNNR_GENCODE_VISIT_TUPLE_BEGIN(visitor, apply, atom_name, atom_at, 1);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 0);
+		PLNNR_GENCODE_VISIT_TUPLE_END(visitor, apply, atom_name, atom_at, 1);
+	}
+};
+
+template <typename V>
+struct generated_type_reflector<apply::road_tuple, V>
+{
+	void operator()(const apply::road_tuple& tuple, V& visitor)
+	{
+		PLNNR_GENCODE_VISIT_TUPLE_BEGIN(visitor, apply, atom_name, atom_road, 2);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 0);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 1);
+		PLNNR_GENCODE_VISIT_TUPLE_END(visitor, apply, atom_name, atom_road, 2);
+	}
+};
+
+template <typename V>
+struct generated_type_reflector<apply::visited_tuple, V>
+{
+	void operator()(const apply::visited_tuple& tuple, V& visitor)
+	{
+		PLNNR_GENCODE_VISIT_TUPLE_BEGIN(visitor, apply, atom_name, atom_visited, 1);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 0);
+		PLNNR_GENCODE_VISIT_TUPLE_END(visitor, apply, atom_name, atom_visited, 1);
+	}
+};
+
+template <typename V>
+struct generated_type_reflector<apply::dest_tuple, V>
+{
+	void operator()(const apply::dest_tuple& tuple, V& visitor)
+	{
+		PLNNR_GENCODE_VISIT_TUPLE_BEGIN(visitor, apply, atom_name, atom_dest, 1);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 0);
+		PLNNR_GENCODE_VISIT_TUPLE_END(visitor, apply, atom_name, atom_dest, 1);
+	}
+};
+
+template <typename V>
+struct generated_type_reflector<apply::move_args, V>
+{
+	void operator()(const apply::move_args& tuple, V& visitor)
+	{
+		PLNNR_GENCODE_VISIT_TUPLE_BEGIN(visitor, apply, task_name, task_move, 2);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 0);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 1);
+		PLNNR_GENCODE_VISIT_TUPLE_END(visitor, apply, task_name, task_move, 2);
+	}
+};
+
+template <typename V>
+struct generated_type_reflector<apply::arrived_args, V>
+{
+	void operator()(const apply::arrived_args& tuple, V& visitor)
+	{
+		PLNNR_GENCODE_VISIT_TUPLE_BEGIN(visitor, apply, task_name, task_arrived, 1);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 0);
+		PLNNR_GENCODE_VISIT_TUPLE_END(visitor, apply, task_name, task_arrived, 1);
+	}
+};
+
+template <typename V>
+struct generated_type_reflector<apply::travel_args, V>
+{
+	void operator()(const apply::travel_args& tuple, V& visitor)
+	{
+		PLNNR_GENCODE_VISIT_TUPLE_BEGIN(visitor, apply, task_name, task_travel, 1);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 0);
+		PLNNR_GENCODE_VISIT_TUPLE_END(visitor, apply, task_name, task_travel, 1);
+	}
+};
+
+template <typename V>
+struct task_type_dispatcher<apply::task_type, V>
+{
+	void operator()(const apply::task_type& task_type, void* args, V& visitor)
+	{
+		switch (task_type)
+		{
+			case apply::task_arrived:
+				PLNNR_GENCODE_VISIT_TASK_WITH_ARGS(visitor, apply, task_arrived, arrived_args);
+				break;
+			case apply::task_travel:
+				PLNNR_GENCODE_VISIT_TASK_WITH_ARGS(visitor, apply, task_travel, travel_args);
+				break;
+			case apply::task_move:
+				PLNNR_GENCODE_VISIT_TASK_WITH_ARGS(visitor, apply, task_move, move_args);
+				break;
+			case apply::task_wait:
+				PLNNR_GENCODE_VISIT_TASK_NO_ARGS(visitor, apply, task_wait);
+				break;
+			default:
+				plnnr_assert(false);
+				break;
+		}
+	}
+};
+
+}
+
+#endif
@@ -0,0 +1,202 @@
+#include <derplanner/runtime/runtime.h>
+#include "cursor.h"
+
+using namespace plnnr;
+
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+
+namespace cursor {
+
+static const char* atom_type_to_name[] =
+{
+	"link",
+	"token",
+	"blocked",
+	"goal",
+	"<none>",
+};
+
+const char* atom_name(atom_type type) { return atom_type_to_name[type]; }
+
+}
+
+namespace cursor {
+
+static const char* task_type_to_name[] =
+{
+	"!take",
+	"accept",
+	"pick",
+	"<none>",
+};
+
+const char* task_name(task_type type) { return task_type_to_name[type]; }
+
+// method accept [15:9]
+struct p0_state
+{
+	// y [15:16]
+	int _0;
+	uint32_t goal_0;
+	int stage;
+};
+
+bool next(p0_state& state, worldstate& world)
+{
+	goal_tuple* goal_0 = 0;
+
+	PLNNR_COROUTINE_BEGIN(state);
+
+	for (goal_0 = tuple_list::head<goal_tuple>(world.atoms[atom_goal]); goal_0 != 0; goal_0 = goal_0->next)
+	{
+		if (goal_0->_0 != state._0)
+		{
+			continue;
+		}
+
+		state.goal_0 = goal_0->slot;
+		PLNNR_COROUTINE_YIELD(state, 1);
+		goal_0 = tuple_list::at<goal_tuple>(world.atoms[atom_goal], state.goal_0);
+		break;
+	}
+
+	PLNNR_COROUTINE_END();
+}
+
+// method pick [20:9]
+struct p1_state
+{
+	// x [20:16]
+	int _0;
+	// y [20:18]
+	int _1;
+	uint32_t link_0;
+	uint32_t token_1;
+	uint32_t blocked_2;
+	int stage;
+};
+
+bool next(p1_state& state, worldstate& world)
+{
+	link_tuple* link_0 = 0;
+	token_tuple* token_1 = 0;
+	blocked_tuple* blocked_2 = 0;
+
+	PLNNR_COROUTINE_BEGIN(state);
+
+	for (link_0 = tuple_list::head<link_tuple>(world.atoms[atom_link]); link_0 != 0; link_0 = link_0->next)
+	{
+		if (link_0->_0 != state._0)
+		{
+			continue;
+		}
+
+		state._1 = link_0->_1;
+
+		for (token_1 = tuple_list::head<token_tuple>(world.atoms[atom_token]); token_1 != 0; token_1 = token_1->next)
+		{
+			if (token_1->_0 != state._1)
+			{
+				continue;
+			}
+
+			for (blocked_2 = tuple_list::head<blocked_tuple>(world.atoms[atom_blocked]); blocked_2 != 0; blocked_2 = blocked_2->next)
+			{
+				if (blocked_2->_0 == state._1)
+				{
+					break;
+				}
+			}
+
+			if (blocked_2 == 0)
+			{
+				state.link_0 = link_0->slot;
+				state.token_1 = token_1->slot;
+				PLNNR_COROUTINE_YIELD(state, 1);
+				link_0 = tuple_list::at<link_tuple>(world.atoms[atom_link], state.link_0);
+				token_1 = tuple_list::at<token_tuple>(world.atoms[atom_token], state.token_1);
+			}
+			break;
+		}
+	}
+
+	PLNNR_COROUTINE_END();
+}
+
+plnnr_static_assert(sizeof(method_instance) + padded_size<accept_args>::value + padded_size<p0_state>::value <= max_frame_size);
+
+bool accept_branch_0_expand(method_instance* method, planner_state& pstate, void* world)
+{
+	p0_state* precondition = plnnr::precondition<p0_state>(method);
+	accept_args* method_args = plnnr::arguments<accept_args>(method);
+	worldstate* wstate = static_cast<worldstate*>(world);
+
+	PLNNR_COROUTINE_BEGIN(*method);
+
+	method->flags |= method_flags_committed;
+	precondition = push_precondition<p0_state>(pstate, method);
+	precondition->_0 = method_args->_0;
+
+	while (next(*precondition, *wstate))
+	{
+		method->flags |= method_flags_expanded;
+		PLNNR_COROUTINE_YIELD(*method, 1);
+	}
+
+	PLNNR_COROUTINE_END();
+}
+
+plnnr_static_assert(sizeof(method_instance) + padded_size<pick_args>::value + padded_size<p1_state>::value <= max_frame_size);
+
+bool pick_branch_0_expand(method_instance* method, planner_state& pstate, void* world)
+{
+	p1_state* precondition = plnnr::precondition<p1_state>(method);
+	pick_args* method_args = plnnr::arguments<pick_args>(method);
+	worldstate* wstate = static_cast<worldstate*>(world);
+
+	PLNNR_COROUTINE_BEGIN(*method);
+
+	precondition = push_precondition<p1_state>(pstate, method);
+	precondition->_0 = method_args->_0;
+
+	while (next(*precondition, *wstate))
+	{
+		{
+			task_instance* t = push_task(pstate, task_take, expand_none);
+			take_args* a = push_arguments<take_args>(pstate, t);
+			a->_0 = precondition->_1;
+
+			{
+				tuple_list::handle* list = wstate->atoms[atom_token];
+				operator_effect* effect = push<operator_effect>(pstate.journal);
+				effect->tuple = precondition->token_1;
+				effect->atom = atom_token;
+				effect->kind = effect_delete;
+				tuple_list::detach(list, tuple_list::at<token_tuple>(list, precondition->token_1));
+			}
+		}
+
+		PLNNR_COROUTINE_YIELD(*method, 1);
+
+		{
+			method_instance* t = push_method(pstate, task_accept, expand_accept_branch_0);
+			accept_args* a = push_arguments<accept_args>(pstate, t);
+			a->_0 = precondition->_1;
+		}
+
+		method->flags |= method_flags_expanded;
+		PLNNR_COROUTINE_YIELD(*method, 2);
+	}
+
+	PLNNR_COROUTINE_END();
+}
+
+const expand_func expands[] =
+{
+	0,
+	accept_branch_0_expand,
+	pick_branch_0_expand,
+};
+
+}
@@ -0,0 +1,256 @@
+#ifndef cursor_H_
+#define cursor_H_
+
+#include <derplanner/runtime/interface.h>
+
+namespace plnnr
+{
+	namespace tuple_list
+	{
+		struct handle;
+	}
+}
+
+namespace plnnr
+{
+	struct planner_state;
+	struct method_instance;
+	typedef bool (*expand_func)(method_instance*, planner_state&, void*);
+}
+
+namespace cursor {
+
+enum atom_type
+{
+	atom_link,
+	atom_token,
+	atom_blocked,
+	atom_goal,
+	atom_count,
+};
+
+const char* atom_name(atom_type type);
+
+struct worldstate
+{
+	plnnr::tuple_list::handle* atoms[atom_count];
+};
+
+struct link_tuple
+{
+	int _0;
+	int _1;
+	link_tuple* next;
+	link_tuple* prev;
+	uint32_t slot;
+	enum { id = atom_link };
+};
+
+struct token_tuple
+{
+	int _0;
+	token_tuple* next;
+	token_tuple* prev;
+	uint32_t slot;
+	enum { id = atom_token };
+};
+
+struct blocked_tuple
+{
+	int _0;
+	blocked_tuple* next;
+	blocked_tuple* prev;
+	uint32_t slot;
+	enum { id = atom_blocked };
+};
+
+struct goal_tuple
+{
+	int _0;
+	goal_tuple* next;
+	goal_tuple* prev;
+	uint32_t slot;
+	enum { id = atom_goal };
+};
+
+}
+
+namespace cursor {
+
+enum task_type
+{
+	task_take,
+	task_accept,
+	task_pick,
+	task_count,
+};
+
+static const int operator_count = 1;
+static const int method_count = 2;
+
+const char* task_name(task_type type);
+
+struct take_args
+{
+	int _0;
+};
+
+inline bool operator==(const take_args& a, const take_args& b)
+{
+	return \
+		a._0 == b._0 ;
+}
+
+struct accept_args
+{
+	int _0;
+};
+
+inline bool operator==(const accept_args& a, const accept_args& b)
+{
+	return \
+		a._0 == b._0 ;
+}
+
+struct pick_args
+{
+	int _0;
+};
+
+inline bool operator==(const pick_args& a, const pick_args& b)
+{
+	return \
+		a._0 == b._0 ;
+}
+
+bool accept_branch_0_expand(plnnr::method_instance*, plnnr::planner_state&, void*);
+bool pick_branch_0_expand(plnnr::method_instance*, plnnr::planner_state&, void*);
+
+enum expand_index
+{
+	expand_accept_branch_0 = 1,
+	expand_pick_branch_0,
+};
+
+extern const plnnr::expand_func expands[];
+
+}
+
+namespace plnnr {
+
+template <typename V>
+struct generated_type_reflector<cursor::worldstate, V>
+{
+	void operator()(const cursor::worldstate& world, V& visitor)
+	{
+		PLNNR_GENCODE_VISIT_ATOM_LIST(cursor, atom_link, link_tuple, visitor);
+		PLNNR_GENCODE_VISIT_ATOM_LIST(cursor, atom_token, token_tuple, visitor);
+		PLNNR_GENCODE_VISIT_ATOM_LIST(cursor, atom_blocked, blocked_tuple, visitor);
+		PLNNR_GENCODE_VISIT_ATOM_LIST(cursor, atom_goal, goal_tuple, visitor);
+	}
+};
+
+template <typename V>
+struct generated_type_reflector<cursor::link_tuple, V>
+{
+	void operator()(const cursor::link_tuple& tuple, V& visitor)
+	{
+		PLNNR_GENCODE_VISIT_TUPLE_BEGIN(visitor, cursor, atom_name, atom_link, 2);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 0);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 1);
+		PLNNR_GENCODE_VISIT_TUPLE_END(visitor, cursor, atom_name, atom_link, 2);
+	}
+};
+
+template <typename V>
+struct generated_type_reflector<cursor::token_tuple, V>
+{
+	void operator()(const cursor::token_tuple& tuple, V& visitor)
+	{
+		PLNNR_GENCODE_VISIT_TUPLE_BEGIN(visitor, cursor, atom_name, atom_token, 1);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 0);
+		PLNNR_GENCODE_VISIT_TUPLE_END(visitor, cursor, atom_name, atom_token, 1);
+	}
+};
+
+template <typename V>
+struct generated_type_reflector<cursor::blocked_tuple, V>
+{
+	void operator()(const cursor::blocked_tuple& tuple, V& visitor)
+	{
+		PLNNR_GENCODE_VISIT_TUPLE_BEGIN(visitor, cursor, atom_name, atom_blocked, 1);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 0);
+		PLNNR_GENCODE_VISIT_TUPLE_END(visitor, cursor, atom_name, atom_blocked, 1);
+	}
+};
+
+template <typename V>
+struct generated_type_reflector<cursor::goal_tuple, V>
+{
+	void operator()(const cursor::goal_tuple& tuple, V& visitor)
+	{
+		PLNNR_GENCODE_VISIT_TUPLE_BEGIN(visitor, cursor, atom_name, atom_goal, 1);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 0);
+		PLNNR_GENCODE_VISIT_TUPLE_END(visitor, cursor, atom_name, atom_goal, 1);
+	}
+};
+
+template <typename V>
+struct generated_type_reflector<cursor::take_args, V>
+{
+	void operator()(const cursor::take_args& tuple, V& visitor)
+	{
+		PLNNR_GENCODE_VISIT_TUPLE_BEGIN(visitor, cursor, task_name, task_take, 1);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 0);
+		PLNNR_GENCODE_VISIT_TUPLE_END(visitor, cursor, task_name, task_take, 1);
+	}
+};
+
+template <typename V>
+struct generated_type_reflector<cursor::accept_args, V>
+{
+	void operator()(const cursor::accept_args& tuple, V& visitor)
+	{
+		PLNNR_GENCODE_VISIT_TUPLE_BEGIN(visitor, cursor, task_name, task_accept, 1);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 0);
+		PLNNR_GENCODE_VISIT_TUPLE_END(visitor, cursor, task_name, task_accept, 1);
+	}
+};
+
+template <typename V>
+struct generated_type_reflector<cursor::pick_args, V>
+{
+	void operator()(const cursor::pick_args& tuple, V& visitor)
+	{
+		PLNNR_GENCODE_VISIT_TUPLE_BEGIN(visitor, cursor, task_name, task_pick, 1);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 0);
+		PLNNR_GENCODE_VISIT_TUPLE_END(visitor, cursor, task_name, task_pick, 1);
+	}
+};
+
+template <typename V>
+struct task_type_dispatcher<cursor::task_type, V>
+{
+	void operator()(const cursor::task_type& task_type, void* args, V& visitor)
+	{
+		switch (task_type)
+		{
+			case cursor::task_accept:
+				PLNNR_GENCODE_VISIT_TASK_WITH_ARGS(visitor, cursor, task_accept, accept_args);
+				break;
+			case cursor::task_pick:
+				PLNNR_GENCODE_VISIT_TASK_WITH_ARGS(visitor, cursor, task_pick, pick_args);
+				break;
+			case cursor::task_take:
+				PLNNR_GENCODE_VISIT_TASK_WITH_ARGS(visitor, cursor, task_take, take_args);
+				break;
+			default:
+				plnnr_assert(false);
+				break;
+		}
+	}
+};
+
+}
+
+#endif
@@ -0,0 +1,276 @@
+#include <derplanner/runtime/runtime.h>
+#include "detach.h"
+
+using namespace plnnr;
+
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+
+namespace detach {
+
+static const char* atom_type_to_name[] =
+{
+	"item",
+	"want",
+	"<none>",
+};
+
+const char* atom_name(atom_type type) { return atom_type_to_name[type]; }
+
+}
+
+namespace detach {
+
+static const char* task_type_to_name[] =
+{
+	"!drop",
+	"check",
+	"drop-heavy",
+	"drop-pair",
+	"<none>",
+};
+
+const char* task_name(task_type type) { return task_type_to_name[type]; }
+
+// method check [12:9]
+struct p0_state
+{
+	want_tuple* want_0;
+	// x [12:16]
+	int _0;
+	int stage;
+};
+
+bool next(p0_state& state, worldstate& world)
+{
+	PLNNR_COROUTINE_BEGIN(state);
+
+	for (state.want_0 = tuple_list::head<want_tuple>(world.atoms[atom_want]); state.want_0 != 0; state.want_0 = state.want_0->next)
+	{
+		if (state.want_0->_0 != state._0)
+		{
+			continue;
+		}
+
+		PLNNR_COROUTINE_YIELD(state, 1);
+		break;
+	}
+
+	PLNNR_COROUTINE_END();
+}
+
+// method drop-heavy [17:9]
+struct p1_state
+{
+	item_tuple* item_0;
+	// x [17:16]
+	int _0;
+	// w [17:18]
+	int _1;
+	int stage;
+};
+
+bool next(p1_state& state, worldstate& world)
+{
+	PLNNR_COROUTINE_BEGIN(state);
+
+	for (state.item_0 = tuple_list::head<item_tuple>(world.atoms[atom_item]); state.item_0 != 0; state.item_0 = state.item_0->next)
+	{
+		state._0 = state.item_0->_0;
+
+		state._1 = state.item_0->_1;
+
+		if (state._1 > 5)
+		{
+			PLNNR_COROUTINE_YIELD(state, 1);
+		}
+	}
+
+	PLNNR_COROUTINE_END();
+}
+
+// method drop-pair [22:9]
+struct p2_state
+{
+	item_tuple* item_0;
+	item_tuple* item_1;
+	// x [22:16]
+	int _0;
+	// w [22:18]
+	int _1;
+	// y [22:27]
+	int _2;
+	// v [22:29]
+	int _3;
+	int stage;
+};
+
+bool next(p2_state& state, worldstate& world)
+{
+	PLNNR_COROUTINE_BEGIN(state);
+
+	for (state.item_0 = tuple_list::head<item_tuple>(world.atoms[atom_item]); state.item_0 != 0; state.item_0 = state.item_0->next)
+	{
+		state._0 = state.item_0->_0;
+
+		state._1 = state.item_0->_1;
+
+		for (state.item_1 = tuple_list::head<item_tuple>(world.atoms[atom_item]); state.item_1 != 0; state.item_1 = state.item_1->next)
+		{
+			state._2 = state.item_1->_0;
+
+			state._3 = state.item_1->_1;
+
+			if (state._3 > state._1)
+			{
+				PLNNR_COROUTINE_YIELD(state, 1);
+			}
+		}
+	}
+
+	PLNNR_COROUTINE_END();
+}
+
+plnnr_static_assert(sizeof(method_instance) + padded_size<check_args>::value + padded_size<p0_state>::value <= max_frame_size);
+
+bool check_branch_0_expand(method_instance* method, planner_state& pstate, void* world)
+{
+	p0_state* precondition = plnnr::precondition<p0_state>(method);
+	check_args* method_args = plnnr::arguments<check_args>(method);
+	worldstate* wstate = static_cast<worldstate*>(world);
+
+	PLNNR_COROUTINE_BEGIN(*method);
+
+	method->flags |= method_flags_committed;
+	precondition = push_precondition<p0_state>(pstate, method);
+	precondition->_0 = method_args->_0;
+
+	while (next(*precondition, *wstate))
+	{
+		method->flags |= method_flags_expanded;
+		PLNNR_COROUTINE_YIELD(*method, 1);
+	}
+
+	PLNNR_COROUTINE_END();
+}
+
+plnnr_static_assert(sizeof(method_instance) + padded_size<p1_state>::value <= max_frame_size);
+
+bool drop_heavy_branch_0_expand(method_instance* method, planner_state& pstate, void* world)
+{
+	p1_state* precondition = plnnr::precondition<p1_state>(method);
+	worldstate* wstate = static_cast<worldstate*>(world);
+
+	PLNNR_COROUTINE_BEGIN(*method);
+
+	precondition = push_precondition<p1_state>(pstate, method);
+
+	while (next(*precondition, *wstate))
+	{
+		{
+			task_instance* t = push_task(pstate, task_drop, expand_none);
+			drop_args* a = push_arguments<drop_args>(pstate, t);
+			a->_0 = precondition->_0;
+			a->_1 = precondition->_1;
+
+			{
+				tuple_list::handle* list = wstate->atoms[atom_item];
+				operator_effect* effect = push<operator_effect>(pstate.journal);
+				effect->tuple = precondition->item_0->slot;
+				effect->atom = atom_item;
+				effect->kind = effect_delete;
+				tuple_list::detach(list, precondition->item_0);
+			}
+		}
+
+		PLNNR_COROUTINE_YIELD(*method, 1);
+
+		{
+			method_instance* t = push_method(pstate, task_check, expand_check_branch_0);
+			check_args* a = push_arguments<check_args>(pstate, t);
+			a->_0 = precondition->_0;
+		}
+
+		method->flags |= method_flags_expanded;
+		PLNNR_COROUTINE_YIELD(*method, 2);
+	}
+
+	PLNNR_COROUTINE_END();
+}
+
+plnnr_static_assert(sizeof(method_instance) + padded_size<p2_state>::value <= max_frame_size);
+
+bool drop_pair_branch_0_expand(method_instance* method, planner_state& pstate, void* world)
+{
+	p2_state* precondition = plnnr::precondition<p2_state>(method);
+	worldstate* wstate = static_cast<worldstate*>(world);
+
+	PLNNR_COROUTINE_BEGIN(*method);
+
+	precondition = push_precondition<p2_state>(pstate, method);
+
+	while (next(*precondition, *wstate))
+	{
+		{
+			task_instance* t = push_task(pstate, task_drop, expand_none);
+			drop_args* a = push_arguments<drop_args>(pstate, t);
+			a->_0 = precondition->_0;
+			a->_1 = precondition->_1;
+
+			{
+				tuple_list::handle* list = wstate->atoms[atom_item];
+				operator_effect* effect = push<operator_effect>(pstate.journal);
+				effect->tuple = precondition->item_0->slot;
+				effect->atom = atom_item;
+				effect->kind = effect_delete;
+				tuple_list::detach(list, precondition->item_0);
+			}
+		}
+
+		PLNNR_COROUTINE_YIELD(*method, 1);
+
+		{
+			task_instance* t = push_task(pstate, task_drop, expand_none);
+			drop_args* a = push_arguments<drop_args>(pstate, t);
+			a->_0 = precondition->_2;
+			a->_1 = precondition->_3;
+
+			for (item_tuple* tuple = tuple_list::head<item_tuple>(wstate->atoms[atom_item]); tuple != 0; tuple = tuple->next)
+			{
+				if (tuple->_0 != a->_0)
+				{
+					continue;
+				}
+
+				if (tuple->_1 != a->_1)
+				{
+					continue;
+				}
+
+				tuple_list::handle* list = wstate->atoms[atom_item];
+				operator_effect* effect = push<operator_effect>(pstate.journal);
+				effect->tuple = tuple->slot;
+				effect->atom = atom_item;
+				effect->kind = effect_delete;
+				tuple_list::detach(list, tuple);
+
+				break;
+			}
+		}
+
+		method->flags |= method_flags_expanded;
+		PLNNR_COROUTINE_YIELD(*method, 2);
+	}
+
+	PLNNR_COROUTINE_END();
+}
+
+const expand_func expands[] =
+{
+	0,
+	check_branch_0_expand,
+	drop_heavy_branch_0_expand,
+	drop_pair_branch_0_expand,
+};
+
+}
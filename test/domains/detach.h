@@ -0,0 +1,199 @@
+#ifndef detach_H_
+#define detach_H_
+
+#include <derplanner/runtime/interface.h>
+
+namespace plnnr
+{
+	namespace tuple_list
+	{
+		struct handle;
+	}
+}
+
+namespace plnnr
+{
+	struct planner_state;
+	struct method_instance;
+	typedef bool (*expand_func)(method_instance*, planner_state&, void*);
+}
+
+namespace detach {
+
+enum atom_type
+{
+	atom_item,
+	atom_want,
+	atom_count,
+};
+
+const char* atom_name(atom_type type);
+
+struct worldstate
+{
+	plnnr::tuple_list::handle* atoms[atom_count];
+};
+
+struct item_tuple
+{
+	int _0;
+	int _1;
+	item_tuple* next;
+	item_tuple* prev;
+	uint32_t slot;
+	enum { id = atom_item };
+};
+
+struct want_tuple
+{
+	int _0;
+	want_tuple* next;
+	want_tuple* prev;
+	uint32_t slot;
+	enum { id = atom_want };
+};
+
+}
+
+namespace detach {
+
+enum task_type
+{
+	task_drop,
+	task_check,
+	task_drop_heavy,
+	task_drop_pair,
+	task_count,
+};
+
+static const int operator_count = 1;
+static const int method_count = 3;
+
+const char* task_name(task_type type);
+
+struct drop_args
+{
+	int _0;
+	int _1;
+};
+
+inline bool operator==(const drop_args& a, const drop_args& b)
+{
+	return \
+		a._0 == b._0 &&
+		a._1 == b._1 ;
+}
+
+struct check_args
+{
+	int _0;
+};
+
+inline bool operator==(const check_args& a, const check_args& b)
+{
+	return \
+		a._0 == b._0 ;
+}
+
+bool check_branch_0_expand(plnnr::method_instance*, plnnr::planner_state&, void*);
+bool drop_heavy_branch_0_expand(plnnr::method_instance*, plnnr::planner_state&, void*);
+bool drop_pair_branch_0_expand(plnnr::method_instance*, plnnr::planner_state&, void*);
+
+enum expand_index
+{
+	expand_check_branch_0 = 1,
+	expand_drop_heavy_branch_0,
+	expand_drop_pair_branch_0,
+};
+
+extern const plnnr::expand_func expands[];
+
+}
+
+namespace plnnr {
+
+template <typename V>
+struct generated_type_reflector<detach::worldstate, V>
+{
+	void operator()(const detach::worldstate& world, V& visitor)
+	{
+		PLNNR_GENCODE_VISIT_ATOM_LIST(detach, atom_item, item_tuple, visitor);
+		PLNNR_GENCODE_VISIT_ATOM_LIST(detach, atom_want, want_tuple, visitor);
+	}
+};
+
+template <typename V>
+struct generated_type_reflector<detach::item_tuple, V>
+{
+	void operator()(const detach::item_tuple& tuple, V& visitor)
+	{
+		PLNNR_GENCODE_VISIT_TUPLE_BEGIN(visitor, detach, atom_name, atom_item, 2);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 0);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 1);
+		PLNNR_GENCODE_VISIT_TUPLE_END(visitor, detach, atom_name, atom_item, 2);
+	}
+};
+
+template <typename V>
+struct generated_type_reflector<detach::want_tuple, V>
+{
+	void operator()(const detach::want_tuple& tuple, V& visitor)
+	{
+		PLNNR_GENCODE_VISIT_TUPLE_BEGIN(visitor, detach, atom_name, atom_want, 1);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 0);
+		PLNNR_GENCODE_VISIT_TUPLE_END(visitor, detach, atom_name, atom_want, 1);
+	}
+};
+
+template <typename V>
+struct generated_type_reflector<detach::drop_args, V>
+{
+	void operator()(const detach::drop_args& tuple, V& visitor)
+	{
+		PLNNR_GENCODE_VISIT_TUPLE_BEGIN(visitor, detach, task_name, task_drop, 2);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 0);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 1);
+		PLNNR_GENCODE_VISIT_TUPLE_END(visitor, detach, task_name, task_drop, 2);
+	}
+};
+
+template <typename V>
+struct generated_type_reflector<detach::check_args, V>
+{
+	void operator()(const detach::check_args& tuple, V& visitor)
+	{
+		PLNNR_GENCODE_VISIT_TUPLE_BEGIN(visitor, detach, task_name, task_check, 1);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 0);
+		PLNNR_GENCODE_VISIT_TUPLE_END(visitor, detach, task_name, task_check, 1);
+	}
+};
+
+template <typename V>
+struct task_type_dispatcher<detach::task_type, V>
+{
+	void operator()(const detach::task_type& task_type, void* args, V& visitor)
+	{
+		switch (task_type)
+		{
+			case detach::task_check:
+				PLNNR_GENCODE_VISIT_TASK_WITH_ARGS(visitor, detach, task_check, check_args);
+				break;
+			case detach::task_drop_heavy:
+				PLNNR_GENCODE_VISIT_TASK_NO_ARGS(visitor, detach, task_drop_heavy);
+				break;
+			case detach::task_drop_pair:
+				PLNNR_GENCODE_VISIT_TASK_NO_ARGS(visitor, detach, task_drop_pair);
+				break;
+			case detach::task_drop:
+				PLNNR_GENCODE_VISIT_TASK_WITH_ARGS(visitor, detach, task_drop, drop_args);
+				break;
+			default:
+				plnnr_assert(false);
+				break;
+		}
+	}
+};
+
+}
+
+#endif
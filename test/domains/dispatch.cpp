@@ -0,0 +1,283 @@
+#include <derplanner/runtime/runtime.h>
+#include "dispatch.h"
+
+using namespace plnnr;
+
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+
+namespace dispatch {
+
+static const char* atom_type_to_name[] =
+{
+	"cand",
+	"good",
+	"<none>",
+};
+
+const char* atom_name(atom_type type) { return atom_type_to_name[type]; }
+
+}
+
+namespace dispatch {
+
+static const char* task_type_to_name[] =
+{
+	"!pick",
+	"check",
+	"choose",
+	"<none>",
+};
+
+const char* task_name(task_type type) { return task_type_to_name[type]; }
+
+// method check [11:9]
+struct p0_state
+{
+	good_tuple* good_0;
+	// x [11:16]
+	int _0;
+	int stage;
+};
+
+bool next(p0_state& state, worldstate& world)
+{
+	PLNNR_COROUTINE_BEGIN(state);
+
+	for (state.good_0 = tuple_list::head<good_tuple>(world.atoms[atom_good]); state.good_0 != 0; state.good_0 = state.good_0->next)
+	{
+		if (state.good_0->_0 != state._0)
+		{
+			continue;
+		}
+
+		PLNNR_COROUTINE_YIELD(state, 1);
+		break;
+	}
+
+	PLNNR_COROUTINE_END();
+}
+
+// method choose [16:9]
+struct p1_state
+{
+	cand_tuple* cand_0;
+	good_tuple* good_1;
+	// x [16:16]
+	int _0;
+	int stage;
+};
+
+bool next(p1_state& state, worldstate& world)
+{
+	PLNNR_COROUTINE_BEGIN(state);
+
+	for (state.cand_0 = tuple_list::head<cand_tuple>(world.atoms[atom_cand]); state.cand_0 != 0; state.cand_0 = state.cand_0->next)
+	{
+		state._0 = state.cand_0->_0;
+
+		for (state.good_1 = tuple_list::head<good_tuple>(world.atoms[atom_good]); state.good_1 != 0; state.good_1 = state.good_1->next)
+		{
+			if (state.good_1->_0 != state._0)
+			{
+				continue;
+			}
+
+			if (state._0 > 5)
+			{
+				PLNNR_COROUTINE_YIELD(state, 1);
+			}
+			break;
+		}
+	}
+
+	PLNNR_COROUTINE_END();
+}
+
+// method choose [19:9]
+struct p2_state
+{
+	cand_tuple* cand_0;
+	// x [19:16]
+	int _0;
+	int stage;
+};
+
+bool next(p2_state& state, worldstate& world)
+{
+	PLNNR_COROUTINE_BEGIN(state);
+
+	for (state.cand_0 = tuple_list::head<cand_tuple>(world.atoms[atom_cand]); state.cand_0 != 0; state.cand_0 = state.cand_0->next)
+	{
+		state._0 = state.cand_0->_0;
+
+		PLNNR_COROUTINE_YIELD(state, 1);
+	}
+
+	PLNNR_COROUTINE_END();
+}
+
+// method choose [22:9]
+struct p3_state
+{
+	int stage;
+};
+
+bool next(p3_state& state, worldstate& world)
+{
+	PLNNR_COROUTINE_BEGIN(state);
+
+	PLNNR_COROUTINE_YIELD(state, 1);
+
+	PLNNR_COROUTINE_END();
+}
+
+plnnr_static_assert(sizeof(method_instance) + padded_size<check_args>::value + padded_size<p0_state>::value <= max_frame_size);
+
+plnnr_static_assert(sizeof(method_instance) + padded_size<p1_state>::value <= max_frame_size);
+
+plnnr_static_assert(sizeof(method_instance) + padded_size<p2_state>::value <= max_frame_size);
+
+plnnr_static_assert(sizeof(method_instance) + padded_size<p3_state>::value <= max_frame_size);
+
+bool dispatch_expand(method_instance* method, planner_state& pstate, void* world)
+{
+	switch (method->expand)
+	{
+		case expand_check_branch_0:
+			{
+				p0_state* precondition = plnnr::precondition<p0_state>(method);
+				check_args* method_args = plnnr::arguments<check_args>(method);
+				worldstate* wstate = static_cast<worldstate*>(world);
+
+				PLNNR_COROUTINE_BEGIN(*method);
+
+				method->flags |= method_flags_committed;
+				precondition = push_precondition<p0_state>(pstate, method);
+				precondition->_0 = method_args->_0;
+
+				while (next(*precondition, *wstate))
+				{
+					method->flags |= method_flags_expanded;
+					PLNNR_COROUTINE_YIELD(*method, 1);
+				}
+
+				PLNNR_COROUTINE_END();
+			}
+
+		case expand_choose_branch_0:
+			{
+				p1_state* precondition = plnnr::precondition<p1_state>(method);
+				worldstate* wstate = static_cast<worldstate*>(world);
+
+				PLNNR_COROUTINE_BEGIN(*method);
+
+				precondition = push_precondition<p1_state>(pstate, method);
+
+				while (next(*precondition, *wstate))
+				{
+					{
+						task_instance* t = push_task(pstate, task_pick, expand_none);
+						pick_args* a = push_arguments<pick_args>(pstate, t);
+						a->_0 = precondition->_0;
+					}
+
+					method->flags |= method_flags_expanded;
+					PLNNR_COROUTINE_YIELD(*method, 1);
+				}
+
+				select_next_branch(pstate, expand_choose_branch_1);
+				goto choose_branch_1;
+				PLNNR_COROUTINE_END();
+			}
+
+		case expand_choose_branch_1:
+		choose_branch_1:
+			{
+				p2_state* precondition = plnnr::precondition<p2_state>(method);
+				worldstate* wstate = static_cast<worldstate*>(world);
+
+				PLNNR_COROUTINE_BEGIN(*method);
+
+				precondition = push_precondition<p2_state>(pstate, method);
+
+				while (next(*precondition, *wstate))
+				{
+					{
+						method_instance* t = push_method(pstate, task_check, expand_check_branch_0);
+						check_args* a = push_arguments<check_args>(pstate, t);
+						a->_0 = precondition->_0;
+					}
+
+					PLNNR_COROUTINE_YIELD(*method, 1);
+
+					if (method->flags & method_flags_failed)
+					{
+						continue;
+					}
+
+					{
+						task_instance* t = push_task(pstate, task_pick, expand_none);
+						pick_args* a = push_arguments<pick_args>(pstate, t);
+						a->_0 = precondition->_0;
+					}
+
+					method->flags |= method_flags_expanded;
+					PLNNR_COROUTINE_YIELD(*method, 2);
+				}
+
+				select_next_branch(pstate, expand_choose_branch_2);
+				goto choose_branch_2;
+				PLNNR_COROUTINE_END();
+			}
+
+		case expand_choose_branch_2:
+		choose_branch_2:
+			{
+				p3_state* precondition = plnnr::precondition<p3_state>(method);
+				worldstate* wstate = static_cast<worldstate*>(world);
+
+				PLNNR_COROUTINE_BEGIN(*method);
+
+				method->flags |= method_flags_committed;
+				precondition = push_precondition<p3_state>(pstate, method);
+
+				while (next(*precondition, *wstate))
+				{
+					{
+						task_instance* t = push_task(pstate, task_pick, expand_none);
+						pick_args* a = push_arguments<pick_args>(pstate, t);
+						a->_0 = 0;
+					}
+
+					method->flags |= method_flags_expanded;
+					PLNNR_COROUTINE_YIELD(*method, 1);
+				}
+
+				PLNNR_COROUTINE_END();
+			}
+
+		default:
+			plnnr_assert(false);
+			return false;
+	}
+
+}
+
+find_plan_status step(planner_state& pstate, void* world)
+{
+	plnnr_assert(pstate.top_method);
+	method_instance* method = top_method(pstate);
+	return find_plan_advance(pstate, method, dispatch_expand(method, pstate, world), world);
+}
+
+const expand_func expands[] =
+{
+	0,
+	dispatch_expand,
+	dispatch_expand,
+	dispatch_expand,
+	dispatch_expand,
+};
+
+}
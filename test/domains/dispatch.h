@@ -0,0 +1,191 @@
+#ifndef dispatch_H_
+#define dispatch_H_
+
+#include <derplanner/runtime/interface.h>
+
+namespace plnnr
+{
+	namespace tuple_list
+	{
+		struct handle;
+	}
+}
+
+namespace plnnr
+{
+	struct planner_state;
+	struct method_instance;
+	typedef bool (*expand_func)(method_instance*, planner_state&, void*);
+}
+
+namespace dispatch {
+
+enum atom_type
+{
+	atom_cand,
+	atom_good,
+	atom_count,
+};
+
+const char* atom_name(atom_type type);
+
+struct worldstate
+{
+	plnnr::tuple_list::handle* atoms[atom_count];
+};
+
+struct cand_tuple
+{
+	int _0;
+	cand_tuple* next;
+	cand_tuple* prev;
+	uint32_t slot;
+	enum { id = atom_cand };
+};
+
+struct good_tuple
+{
+	int _0;
+	good_tuple* next;
+	good_tuple* prev;
+	uint32_t slot;
+	enum { id = atom_good };
+};
+
+}
+
+namespace dispatch {
+
+enum task_type
+{
+	task_pick,
+	task_check,
+	task_choose,
+	task_count,
+};
+
+static const int operator_count = 1;
+static const int method_count = 2;
+
+const char* task_name(task_type type);
+
+struct pick_args
+{
+	int _0;
+};
+
+inline bool operator==(const pick_args& a, const pick_args& b)
+{
+	return \
+		a._0 == b._0 ;
+}
+
+struct check_args
+{
+	int _0;
+};
+
+inline bool operator==(const check_args& a, const check_args& b)
+{
+	return \
+		a._0 == b._0 ;
+}
+
+bool dispatch_expand(plnnr::method_instance*, plnnr::planner_state&, void*);
+// expands the top method directly, use instead of plnnr::find_plan_step.
+plnnr::find_plan_status step(plnnr::planner_state&, void*);
+
+enum expand_index
+{
+	expand_check_branch_0 = 1,
+	expand_choose_branch_0,
+	expand_choose_branch_1,
+	expand_choose_branch_2,
+};
+
+extern const plnnr::expand_func expands[];
+
+}
+
+namespace plnnr {
+
+template <typename V>
+struct generated_type_reflector<dispatch::worldstate, V>
+{
+	void operator()(const dispatch::worldstate& world, V& visitor)
+	{
+		PLNNR_GENCODE_VISIT_ATOM_LIST(dispatch, atom_cand, cand_tuple, visitor);
+		PLNNR_GENCODE_VISIT_ATOM_LIST(dispatch, atom_good, good_tuple, visitor);
+	}
+};
+
+template <typename V>
+struct generated_type_reflector<dispatch::cand_tuple, V>
+{
+	void operator()(const dispatch::cand_tuple& tuple, V& visitor)
+	{
+		PLNNR_GENCODE_VISIT_TUPLE_BEGIN(visitor, dispatch, atom_name, atom_cand, 1);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 0);
+		PLNNR_GENCODE_VISIT_TUPLE_END(visitor, dispatch, atom_name, atom_cand, 1);
+	}
+};
+
+template <typename V>
+struct generated_type_reflector<dispatch::good_tuple, V>
+{
+	void operator()(const dispatch::good_tuple& tuple, V& visitor)
+	{
+		PLNNR_GENCODE_VISIT_TUPLE_BEGIN(visitor, dispatch, atom_name, atom_good, 1);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 0);
+		PLNNR_GENCODE_VISIT_TUPLE_END(visitor, dispatch, atom_name, atom_good, 1);
+	}
+};
+
+template <typename V>
+struct generated_type_reflector<dispatch::pick_args, V>
+{
+	void operator()(const dispatch::pick_args& tuple, V& visitor)
+	{
+		PLNNR_GENCODE_VISIT_TUPLE_BEGIN(visitor, dispatch, task_name, task_pick, 1);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 0);
+		PLNNR_GENCODE_VISIT_TUPLE_END(visitor, dispatch, task_name, task_pick, 1);
+	}
+};
+
+template <typename V>
+struct generated_type_reflector<dispatch::check_args, V>
+{
+	void operator()(const dispatch::check_args& tuple, V& visitor)
+	{
+		PLNNR_GENCODE_VISIT_TUPLE_BEGIN(visitor, dispatch, task_name, task_check, 1);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 0);
+		PLNNR_GENCODE_VISIT_TUPLE_END(visitor, dispatch, task_name, task_check, 1);
+	}
+};
+
+template <typename V>
+struct task_type_dispatcher<dispatch::task_type, V>
+{
+	void operator()(const dispatch::task_type& task_type, void* args, V& visitor)
+	{
+		switch (task_type)
+		{
+			case dispatch::task_check:
+				PLNNR_GENCODE_VISIT_TASK_WITH_ARGS(visitor, dispatch, task_check, check_args);
+				break;
+			case dispatch::task_choose:
+				PLNNR_GENCODE_VISIT_TASK_NO_ARGS(visitor, dispatch, task_choose);
+				break;
+			case dispatch::task_pick:
+				PLNNR_GENCODE_VISIT_TASK_WITH_ARGS(visitor, dispatch, task_pick, pick_args);
+				break;
+			default:
+				plnnr_assert(false);
+				break;
+		}
+	}
+};
+
+}
+
+#endif
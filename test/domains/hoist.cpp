@@ -0,0 +1,177 @@
+#include <derplanner/runtime/runtime.h>
+#include "hoist.h"
+
+using namespace plnnr;
+
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+
+namespace hoist {
+
+static const char* atom_type_to_name[] =
+{
+	"a",
+	"b",
+	"<none>",
+};
+
+const char* atom_name(atom_type type) { return atom_type_to_name[type]; }
+
+}
+
+namespace hoist {
+
+static const char* task_type_to_name[] =
+{
+	"!visit",
+	"near",
+	"far",
+	"<none>",
+};
+
+const char* task_name(task_type type) { return task_type_to_name[type]; }
+
+// method near [11:19]
+struct p0_state
+{
+	a_tuple* a_0;
+	b_tuple* b_1;
+	// x [11:23]
+	int _0;
+	// y [11:29]
+	int _1;
+	// z [11:31]
+	int _2;
+	int call_0;
+	int stage;
+};
+
+bool next(p0_state& state, worldstate& world)
+{
+	PLNNR_COROUTINE_BEGIN(state);
+
+	for (state.a_0 = tuple_list::head<a_tuple>(world.atoms[atom_a]); state.a_0 != 0; state.a_0 = state.a_0->next)
+	{
+		state._0 = state.a_0->_0;
+
+		state.call_0 = world.dist(state._0, state._0);
+
+		for (state.b_1 = tuple_list::head<b_tuple>(world.atoms[atom_b]); state.b_1 != 0; state.b_1 = state.b_1->next)
+		{
+			state._1 = state.b_1->_0;
+
+			state._2 = state.b_1->_1;
+
+			if (state.call_0 < 3)
+			{
+				PLNNR_COROUTINE_YIELD(state, 1);
+			}
+		}
+	}
+
+	PLNNR_COROUTINE_END();
+}
+
+// method far [15:9]
+struct p1_state
+{
+	a_tuple* a_0;
+	b_tuple* b_1;
+	// x [15:13]
+	int _0;
+	// y [15:19]
+	int _1;
+	// z [15:21]
+	int _2;
+	int call_0;
+	int stage;
+};
+
+bool next(p1_state& state, worldstate& world)
+{
+	PLNNR_COROUTINE_BEGIN(state);
+
+	for (state.a_0 = tuple_list::head<a_tuple>(world.atoms[atom_a]); state.a_0 != 0; state.a_0 = state.a_0->next)
+	{
+		state._0 = state.a_0->_0;
+
+		state.call_0 = world.dist(state._0, state._0);
+
+		for (state.b_1 = tuple_list::head<b_tuple>(world.atoms[atom_b]); state.b_1 != 0; state.b_1 = state.b_1->next)
+		{
+			state._1 = state.b_1->_0;
+
+			state._2 = state.b_1->_1;
+
+			if (state.call_0 > 10)
+			{
+				PLNNR_COROUTINE_YIELD(state, 1);
+			}
+			break;
+		}
+	}
+
+	PLNNR_COROUTINE_END();
+}
+
+plnnr_static_assert(sizeof(method_instance) + padded_size<p0_state>::value <= max_frame_size);
+
+bool near_branch_0_expand(method_instance* method, planner_state& pstate, void* world)
+{
+	p0_state* precondition = plnnr::precondition<p0_state>(method);
+	worldstate* wstate = static_cast<worldstate*>(world);
+
+	PLNNR_COROUTINE_BEGIN(*method);
+
+	precondition = push_precondition<p0_state>(pstate, method);
+
+	while (next(*precondition, *wstate))
+	{
+		{
+			task_instance* t = push_task(pstate, task_visit, expand_none);
+			visit_args* a = push_arguments<visit_args>(pstate, t);
+			a->_0 = precondition->_0;
+			a->_1 = precondition->_1;
+		}
+
+		PLNNR_COROUTINE_YIELD(*method, 1);
+	}
+
+	if (precondition->stage > 0)
+	{
+		method->flags |= method_flags_expanded;
+		PLNNR_COROUTINE_YIELD(*method, 2);
+	}
+
+	PLNNR_COROUTINE_END();
+}
+
+plnnr_static_assert(sizeof(method_instance) + padded_size<p1_state>::value <= max_frame_size);
+
+bool far_branch_0_expand(method_instance* method, planner_state& pstate, void* world)
+{
+	p1_state* precondition = plnnr::precondition<p1_state>(method);
+	worldstate* wstate = static_cast<worldstate*>(world);
+
+	PLNNR_COROUTINE_BEGIN(*method);
+
+	method->flags |= method_flags_committed;
+	precondition = push_precondition<p1_state>(pstate, method);
+
+	while (next(*precondition, *wstate))
+	{
+		method->flags |= method_flags_expanded;
+		PLNNR_COROUTINE_YIELD(*method, 1);
+	}
+
+	PLNNR_COROUTINE_END();
+}
+
+const expand_func expands[] =
+{
+	0,
+	near_branch_0_expand,
+	far_branch_0_expand,
+};
+
+}
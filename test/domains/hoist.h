@@ -0,0 +1,172 @@
+#ifndef hoist_H_
+#define hoist_H_
+
+#include <derplanner/runtime/interface.h>
+
+namespace plnnr
+{
+	namespace tuple_list
+	{
+		struct handle;
+	}
+}
+
+namespace plnnr
+{
+	struct planner_state;
+	struct method_instance;
+	typedef bool (*expand_func)(method_instance*, planner_state&, void*);
+}
+
+namespace hoist {
+
+enum atom_type
+{
+	atom_a,
+	atom_b,
+	atom_count,
+};
+
+const char* atom_name(atom_type type);
+
+struct worldstate
+{
+	plnnr::tuple_list::handle* atoms[atom_count];
+	int (*dist)(int, int);
+};
+
+struct a_tuple
+{
+	int _0;
+	a_tuple* next;
+	a_tuple* prev;
+	uint32_t slot;
+	enum { id = atom_a };
+};
+
+struct b_tuple
+{
+	int _0;
+	int _1;
+	b_tuple* next;
+	b_tuple* prev;
+	uint32_t slot;
+	enum { id = atom_b };
+};
+
+}
+
+namespace hoist {
+
+enum task_type
+{
+	task_visit,
+	task_near,
+	task_far,
+	task_count,
+};
+
+static const int operator_count = 1;
+static const int method_count = 2;
+
+const char* task_name(task_type type);
+
+struct visit_args
+{
+	int _0;
+	int _1;
+};
+
+inline bool operator==(const visit_args& a, const visit_args& b)
+{
+	return \
+		a._0 == b._0 &&
+		a._1 == b._1 ;
+}
+
+bool near_branch_0_expand(plnnr::method_instance*, plnnr::planner_state&, void*);
+bool far_branch_0_expand(plnnr::method_instance*, plnnr::planner_state&, void*);
+
+enum expand_index
+{
+	expand_near_branch_0 = 1,
+	expand_far_branch_0,
+};
+
+extern const plnnr::expand_func expands[];
+
+}
+
+namespace plnnr {
+
+template <typename V>
+struct generated_type_reflector<hoist::worldstate, V>
+{
+	void operator()(const hoist::worldstate& world, V& visitor)
+	{
+		PLNNR_GENCODE_VISIT_ATOM_LIST(hoist, atom_a, a_tuple, visitor);
+		PLNNR_GENCODE_VISIT_ATOM_LIST(hoist, atom_b, b_tuple, visitor);
+	}
+};
+
+template <typename V>
+struct generated_type_reflector<hoist::a_tuple, V>
+{
+	void operator()(const hoist::a_tuple& tuple, V& visitor)
+	{
+		PLNNR_GENCODE_VISIT_TUPLE_BEGIN(visitor, hoist, atom_name, atom_a, 1);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 0);
+		PLNNR_GENCODE_VISIT_TUPLE_END(visitor, hoist, atom_name, atom_a, 1);
+	}
+};
+
+template <typename V>
+struct generated_type_reflector<hoist::b_tuple, V>
+{
+	void operator()(const hoist::b_tuple& tuple, V& visitor)
+	{
+		PLNNR_GENCODE_VISIT_TUPLE_BEGIN(visitor, hoist, atom_name, atom_b, 2);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 0);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 1);
+		PLNNR_GENCODE_VISIT_TUPLE_END(visitor, hoist, atom_name, atom_b, 2);
+	}
+};
+
+template <typename V>
+struct generated_type_reflector<hoist::visit_args, V>
+{
+	void operator()(const hoist::visit_args& tuple, V& visitor)
+	{
+		PLNNR_GENCODE_VISIT_TUPLE_BEGIN(visitor, hoist, task_name, task_visit, 2);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 0);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 1);
+		PLNNR_GENCODE_VISIT_TUPLE_END(visitor, hoist, task_name, task_visit, 2);
+	}
+};
+
+template <typename V>
+struct task_type_dispatcher<hoist::task_type, V>
+{
+	void operator()(const hoist::task_type& task_type, void* args, V& visitor)
+	{
+		switch (task_type)
+		{
+			case hoist::task_near:
+				PLNNR_GENCODE_VISIT_TASK_NO_ARGS(visitor, hoist, task_near);
+				break;
+			case hoist::task_far:
+				PLNNR_GENCODE_VISIT_TASK_NO_ARGS(visitor, hoist, task_far);
+				break;
+			case hoist::task_visit:
+				PLNNR_GENCODE_VISIT_TASK_WITH_ARGS(visitor, hoist, task_visit, visit_args);
+				break;
+			default:
+				plnnr_assert(false);
+				break;
+		}
+	}
+};
+
+}
+
+#endif
@@ -0,0 +1,204 @@
+#include <derplanner/runtime/runtime.h>
+#include "lookup.h"
+
+using namespace plnnr;
+
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+
+namespace lookup {
+
+static const char* atom_type_to_name[] =
+{
+	"start",
+	"edge",
+	"at",
+	"<none>",
+};
+
+const char* atom_name(atom_type type) { return atom_type_to_name[type]; }
+
+inline bool edge_less(const edge_tuple* a, const edge_tuple* b)
+{
+	return a->_0 < b->_0;
+}
+
+inline size_t edge_lower_bound(worldstate& world, int key)
+{
+	// the index is empty or stale unless `build_static_indices` was called after the worldstate was loaded.
+	plnnr_assert(world.edge_index_size == tuple_list::size(world.atoms[atom_edge]));
+	size_t first = 0;
+	size_t count = world.edge_index_size;
+
+	while (count > 0)
+	{
+		size_t step = count / 2;
+
+		if (world.edge_index[first + step]->_0 < key)
+		{
+			first += step + 1;
+			count -= step + 1;
+		}
+		else
+		{
+			count = step;
+		}
+
+	}
+
+	return first;
+}
+
+inline edge_tuple* edge_at(worldstate& world, size_t cursor, int key)
+{
+	if (cursor < world.edge_index_size && world.edge_index[cursor]->_0 == key)
+	{
+		return world.edge_index[cursor];
+	}
+
+	return 0;
+}
+
+bool build_static_indices(worldstate& world)
+{
+	destroy_static_indices(world);
+
+	world.edge_index_size = tuple_list::size(world.atoms[atom_edge]);
+
+	if (world.edge_index_size > 0)
+	{
+		world.edge_index = static_cast<edge_tuple**>(memory::allocate(sizeof(edge_tuple*) * world.edge_index_size));
+
+		if (!world.edge_index)
+		{
+			world.edge_index_size = 0;
+			return false;
+		}
+
+		size_t i = 0;
+
+		for (edge_tuple* t = tuple_list::head<edge_tuple>(world.atoms[atom_edge]); t != 0; t = t->next)
+		{
+			world.edge_index[i++] = t;
+		}
+
+		if (!stable_sort(world.edge_index, world.edge_index_size, edge_less))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void destroy_static_indices(worldstate& world)
+{
+	if (world.edge_index)
+	{
+		memory::deallocate(world.edge_index);
+	}
+
+	world.edge_index = 0;
+	world.edge_index_size = 0;
+
+}
+
+}
+
+namespace lookup {
+
+static const char* task_type_to_name[] =
+{
+	"!go",
+	"hops",
+	"<none>",
+};
+
+const char* task_name(task_type type) { return task_type_to_name[type]; }
+
+// method hops [14:19]
+struct p0_state
+{
+	start_tuple* start_0;
+	edge_tuple* edge_1;
+	// x [14:27]
+	int _0;
+	// y [14:38]
+	int _1;
+	uint32_t edge_1_cursor;
+	int stage;
+};
+
+bool next(p0_state& state, worldstate& world)
+{
+	PLNNR_COROUTINE_BEGIN(state);
+
+	for (state.start_0 = tuple_list::head<start_tuple>(world.atoms[atom_start]); state.start_0 != 0; state.start_0 = state.start_0->next)
+	{
+		state._0 = state.start_0->_0;
+
+		for (state.edge_1_cursor = uint32_t(edge_lower_bound(world, state._0)), state.edge_1 = edge_at(world, state.edge_1_cursor, state._0); state.edge_1 != 0; state.edge_1 = edge_at(world, ++state.edge_1_cursor, state._0))
+		{
+			if (state.edge_1->_0 != state._0)
+			{
+				continue;
+			}
+
+			state._1 = state.edge_1->_1;
+
+			PLNNR_COROUTINE_YIELD(state, 1);
+		}
+	}
+
+	PLNNR_COROUTINE_END();
+}
+
+plnnr_static_assert(sizeof(method_instance) + padded_size<p0_state>::value <= max_frame_size);
+
+bool hops_branch_0_expand(method_instance* method, planner_state& pstate, void* world)
+{
+	p0_state* precondition = plnnr::precondition<p0_state>(method);
+	worldstate* wstate = static_cast<worldstate*>(world);
+
+	PLNNR_COROUTINE_BEGIN(*method);
+
+	precondition = push_precondition<p0_state>(pstate, method);
+
+	while (next(*precondition, *wstate))
+	{
+		{
+			task_instance* t = push_task(pstate, task_go, expand_none);
+			go_args* a = push_arguments<go_args>(pstate, t);
+			a->_0 = precondition->_0;
+			a->_1 = precondition->_1;
+
+			{
+				tuple_list::handle* list = wstate->atoms[atom_at];
+				at_tuple* tuple = tuple_list::append<at_tuple>(list);
+				tuple->_0 = a->_1;
+				operator_effect* effect = push<operator_effect>(pstate.journal);
+				effect->tuple = tuple->slot;
+				effect->atom = atom_at;
+				effect->kind = effect_add;
+			}
+		}
+
+		PLNNR_COROUTINE_YIELD(*method, 1);
+	}
+
+	if (precondition->stage > 0)
+	{
+		method->flags |= method_flags_expanded;
+		PLNNR_COROUTINE_YIELD(*method, 2);
+	}
+
+	PLNNR_COROUTINE_END();
+}
+
+const expand_func expands[] =
+{
+	0,
+	hops_branch_0_expand,
+};
+
+}
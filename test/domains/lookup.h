@@ -0,0 +1,194 @@
+#ifndef lookup_H_
+#define lookup_H_
+
+#include <derplanner/runtime/interface.h>
+
+namespace plnnr
+{
+	namespace tuple_list
+	{
+		struct handle;
+	}
+}
+
+namespace plnnr
+{
+	struct planner_state;
+	struct method_instance;
+	typedef bool (*expand_func)(method_instance*, planner_state&, void*);
+}
+
+namespace lookup {
+
+enum atom_type
+{
+	atom_start,
+	atom_edge,
+	atom_at,
+	atom_count,
+};
+
+const char* atom_name(atom_type type);
+
+struct edge_tuple;
+
+struct worldstate
+{
+	plnnr::tuple_list::handle* atoms[atom_count];
+	edge_tuple** edge_index;
+	size_t edge_index_size;
+};
+
+struct start_tuple
+{
+	int _0;
+	start_tuple* next;
+	start_tuple* prev;
+	uint32_t slot;
+	enum { id = atom_start };
+};
+
+struct edge_tuple
+{
+	int _0;
+	int _1;
+	edge_tuple* next;
+	edge_tuple* prev;
+	uint32_t slot;
+	enum { id = atom_edge };
+};
+
+struct at_tuple
+{
+	int _0;
+	at_tuple* next;
+	at_tuple* prev;
+	uint32_t slot;
+	enum { id = atom_at };
+};
+
+bool build_static_indices(worldstate& world);
+void destroy_static_indices(worldstate& world);
+
+}
+
+namespace lookup {
+
+enum task_type
+{
+	task_go,
+	task_hops,
+	task_count,
+};
+
+static const int operator_count = 1;
+static const int method_count = 1;
+
+const char* task_name(task_type type);
+
+struct go_args
+{
+	int _0;
+	int _1;
+};
+
+inline bool operator==(const go_args& a, const go_args& b)
+{
+	return \
+		a._0 == b._0 &&
+		a._1 == b._1 ;
+}
+
+bool hops_branch_0_expand(plnnr::method_instance*, plnnr::planner_state&, void*);
+
+enum expand_index
+{
+	expand_hops_branch_0 = 1,
+};
+
+extern const plnnr::expand_func expands[];
+
+}
+
+namespace plnnr {
+
+template <typename V>
+struct generated_type_reflector<lookup::worldstate, V>
+{
+	void operator()(const lookup::worldstate& world, V& visitor)
+	{
+		PLNNR_GENCODE_VISIT_ATOM_LIST(lookup, atom_start, start_tuple, visitor);
+		PLNNR_GENCODE_VISIT_ATOM_LIST(lookup, atom_edge, edge_tuple, visitor);
+		PLNNR_GENCODE_VISIT_ATOM_LIST(lookup, atom_at, at_tuple, visitor);
+	}
+};
+
+template <typename V>
+struct generated_type_reflector<lookup::start_tuple, V>
+{
+	void operator()(const lookup::start_tuple& tuple, V& visitor)
+	{
+		PLNNR_GENCODE_VISIT_TUPLE_BEGIN(visitor, lookup, atom_name, atom_start, 1);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 0);
+		PLNNR_GENCODE_VISIT_TUPLE_END(visitor, lookup, atom_name, atom_start, 1);
+	}
+};
+
+template <typename V>
+struct generated_type_reflector<lookup::edge_tuple, V>
+{
+	void operator()(const lookup::edge_tuple& tuple, V& visitor)
+	{
+		PLNNR_GENCODE_VISIT_TUPLE_BEGIN(visitor, lookup, atom_name, atom_edge, 2);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 0);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 1);
+		PLNNR_GENCODE_VISIT_TUPLE_END(visitor, lookup, atom_name, atom_edge, 2);
+	}
+};
+
+template <typename V>
+struct generated_type_reflector<lookup::at_tuple, V>
+{
+	void operator()(const lookup::at_tuple& tuple, V& visitor)
+	{
+		PLNNR_GENCODE_VISIT_TUPLE_BEGIN(visitor, lookup, atom_name, atom_at, 1);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 0);
+		PLNNR_GENCODE_VISIT_TUPLE_END(visitor, lookup, atom_name, atom_at, 1);
+	}
+};
+
+template <typename V>
+struct generated_type_reflector<lookup::go_args, V>
+{
+	void operator()(const lookup::go_args& tuple, V& visitor)
+	{
+		PLNNR_GENCODE_VISIT_TUPLE_BEGIN(visitor, lookup, task_name, task_go, 2);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 0);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 1);
+		PLNNR_GENCODE_VISIT_TUPLE_END(visitor, lookup, task_name, task_go, 2);
+	}
+};
+
+template <typename V>
+struct task_type_dispatcher<lookup::task_type, V>
+{
+	void operator()(const lookup::task_type& task_type, void* args, V& visitor)
+	{
+		switch (task_type)
+		{
+			case lookup::task_hops:
+				PLNNR_GENCODE_VISIT_TASK_NO_ARGS(visitor, lookup, task_hops);
+				break;
+			case lookup::task_go:
+				PLNNR_GENCODE_VISIT_TASK_WITH_ARGS(visitor, lookup, task_go, go_args);
+				break;
+			default:
+				plnnr_assert(false);
+				break;
+		}
+	}
+};
+
+}
+
+#endif
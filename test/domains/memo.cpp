@@ -0,0 +1,290 @@
+#include <derplanner/runtime/runtime.h>
+#include "memo.h"
+
+using namespace plnnr;
+
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+
+namespace memo {
+
+static const char* atom_type_to_name[] =
+{
+	"item",
+	"mark",
+	"<none>",
+};
+
+const char* atom_name(atom_type type) { return atom_type_to_name[type]; }
+
+void invalidate_memo(memo_tables& memo)
+{
+	// once the fingerprint wraps around, entries stamped with it long ago would be valid again.
+	if (++memo.fingerprint == 0)
+	{
+		memo = memo_tables();
+	}
+}
+
+static int weight_memoized(worldstate& world, void* memo, int _0)
+{
+	if (!memo)
+	{
+		return world.weight(_0);
+	}
+
+	memo_tables& tables = *static_cast<memo_tables*>(memo);
+	weight_memo& table = tables.weight_table;
+
+	uint32_t hash = memo_hash_seed;
+	hash = memo_hash(hash, _0);
+	weight_memo::entry& e = table.entries[hash % weight_memo::size];
+
+	if (e.valid && e.fingerprint == tables.fingerprint && e._0 == _0)
+	{
+		return e.result;
+	}
+
+	e._0 = _0;
+	e.result = world.weight(_0);
+	e.fingerprint = tables.fingerprint;
+	e.valid = true;
+
+	return e.result;
+}
+
+}
+
+namespace memo {
+
+static const char* task_type_to_name[] =
+{
+	"!touch",
+	"root",
+	"scan",
+	"probe",
+	"<none>",
+};
+
+const char* task_name(task_type type) { return task_type_to_name[type]; }
+
+// method root [13:9]
+struct p0_state
+{
+	int stage;
+};
+
+bool next(p0_state& state, worldstate& world, void* memo)
+{
+	PLNNR_COROUTINE_BEGIN(state);
+
+	PLNNR_COROUTINE_YIELD(state, 1);
+
+	PLNNR_COROUTINE_END();
+}
+
+// method scan [18:9]
+struct p1_state
+{
+	item_tuple* item_0;
+	item_tuple* item_1;
+	// x [18:16]
+	int _0;
+	// y [18:25]
+	int _1;
+	int call_0;
+	int stage;
+};
+
+bool next(p1_state& state, worldstate& world, void* memo)
+{
+	PLNNR_COROUTINE_BEGIN(state);
+
+	for (state.item_0 = tuple_list::head<item_tuple>(world.atoms[atom_item]); state.item_0 != 0; state.item_0 = state.item_0->next)
+	{
+		state._0 = state.item_0->_0;
+
+		for (state.item_1 = tuple_list::head<item_tuple>(world.atoms[atom_item]); state.item_1 != 0; state.item_1 = state.item_1->next)
+		{
+			state._1 = state.item_1->_0;
+
+			if (state._0 > weight_memoized(world, memo, state._1))
+			{
+				PLNNR_COROUTINE_YIELD(state, 1);
+			}
+		}
+	}
+
+	PLNNR_COROUTINE_END();
+}
+
+// method scan [21:9]
+struct p2_state
+{
+	int stage;
+};
+
+bool next(p2_state& state, worldstate& world, void* memo)
+{
+	PLNNR_COROUTINE_BEGIN(state);
+
+	PLNNR_COROUTINE_YIELD(state, 1);
+
+	PLNNR_COROUTINE_END();
+}
+
+// method probe [26:9]
+struct p3_state
+{
+	int call_0;
+	int stage;
+};
+
+bool next(p3_state& state, worldstate& world, void* memo)
+{
+	PLNNR_COROUTINE_BEGIN(state);
+
+	if (weight_memoized(world, memo, 0) == 10)
+	{
+		PLNNR_COROUTINE_YIELD(state, 1);
+	}
+	PLNNR_COROUTINE_END();
+}
+
+plnnr_static_assert(sizeof(method_instance) + padded_size<p0_state>::value <= max_frame_size);
+
+bool root_branch_0_expand(method_instance* method, planner_state& pstate, void* world)
+{
+	p0_state* precondition = plnnr::precondition<p0_state>(method);
+	worldstate* wstate = static_cast<worldstate*>(world);
+
+	PLNNR_COROUTINE_BEGIN(*method);
+
+	method->flags |= method_flags_committed;
+	precondition = push_precondition<p0_state>(pstate, method);
+
+	while (next(*precondition, *wstate, pstate.memo))
+	{
+		{
+			method_instance* t = push_method(pstate, task_scan, expand_scan_branch_0);
+		}
+
+		PLNNR_COROUTINE_YIELD(*method, 1);
+
+		if (method->flags & method_flags_failed)
+		{
+			break;
+		}
+
+		{
+			method_instance* t = push_method(pstate, task_probe, expand_probe_branch_0);
+		}
+
+		PLNNR_COROUTINE_YIELD(*method, 2);
+
+		if (method->flags & method_flags_failed)
+		{
+			break;
+		}
+
+		{
+			task_instance* t = push_task(pstate, task_touch, expand_none);
+			touch_args* a = push_arguments<touch_args>(pstate, t);
+			a->_0 = 1;
+
+			{
+				tuple_list::handle* list = wstate->atoms[atom_mark];
+				mark_tuple* tuple = tuple_list::append<mark_tuple>(list);
+				tuple->_0 = a->_0;
+				operator_effect* effect = push<operator_effect>(pstate.journal);
+				effect->tuple = tuple->slot;
+				effect->atom = atom_mark;
+				effect->kind = effect_add;
+			}
+		}
+
+		PLNNR_COROUTINE_YIELD(*method, 3);
+
+		{
+			method_instance* t = push_tail_method(pstate, task_probe, expand_probe_branch_0);
+		}
+
+		return true;
+	}
+
+	PLNNR_COROUTINE_END();
+}
+
+plnnr_static_assert(sizeof(method_instance) + padded_size<p1_state>::value <= max_frame_size);
+
+bool scan_branch_0_expand(method_instance* method, planner_state& pstate, void* world)
+{
+	p1_state* precondition = plnnr::precondition<p1_state>(method);
+	worldstate* wstate = static_cast<worldstate*>(world);
+
+	PLNNR_COROUTINE_BEGIN(*method);
+
+	precondition = push_precondition<p1_state>(pstate, method);
+
+	while (next(*precondition, *wstate, pstate.memo))
+	{
+		method->flags |= method_flags_expanded;
+		PLNNR_COROUTINE_YIELD(*method, 1);
+	}
+
+	return expand_next_branch(pstate, expand_scan_branch_1, world);
+	PLNNR_COROUTINE_END();
+}
+
+plnnr_static_assert(sizeof(method_instance) + padded_size<p2_state>::value <= max_frame_size);
+
+bool scan_branch_1_expand(method_instance* method, planner_state& pstate, void* world)
+{
+	p2_state* precondition = plnnr::precondition<p2_state>(method);
+	worldstate* wstate = static_cast<worldstate*>(world);
+
+	PLNNR_COROUTINE_BEGIN(*method);
+
+	method->flags |= method_flags_committed;
+	precondition = push_precondition<p2_state>(pstate, method);
+
+	while (next(*precondition, *wstate, pstate.memo))
+	{
+		method->flags |= method_flags_expanded;
+		PLNNR_COROUTINE_YIELD(*method, 1);
+	}
+
+	PLNNR_COROUTINE_END();
+}
+
+plnnr_static_assert(sizeof(method_instance) + padded_size<p3_state>::value <= max_frame_size);
+
+bool probe_branch_0_expand(method_instance* method, planner_state& pstate, void* world)
+{
+	p3_state* precondition = plnnr::precondition<p3_state>(method);
+	worldstate* wstate = static_cast<worldstate*>(world);
+
+	PLNNR_COROUTINE_BEGIN(*method);
+
+	method->flags |= method_flags_committed;
+	precondition = push_precondition<p3_state>(pstate, method);
+
+	while (next(*precondition, *wstate, pstate.memo))
+	{
+		method->flags |= method_flags_expanded;
+		PLNNR_COROUTINE_YIELD(*method, 1);
+	}
+
+	PLNNR_COROUTINE_END();
+}
+
+const expand_func expands[] =
+{
+	0,
+	root_branch_0_expand,
+	scan_branch_0_expand,
+	scan_branch_1_expand,
+	probe_branch_0_expand,
+};
+
+}
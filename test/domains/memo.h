@@ -0,0 +1,201 @@
+#ifndef memo_H_
+#define memo_H_
+
+#include <derplanner/runtime/interface.h>
+
+namespace plnnr
+{
+	namespace tuple_list
+	{
+		struct handle;
+	}
+}
+
+namespace plnnr
+{
+	struct planner_state;
+	struct method_instance;
+	typedef bool (*expand_func)(method_instance*, planner_state&, void*);
+}
+
+namespace memo {
+
+enum atom_type
+{
+	atom_item,
+	atom_mark,
+	atom_count,
+};
+
+const char* atom_name(atom_type type);
+
+struct weight_memo
+{
+	enum { size = 256 };
+
+	struct entry
+	{
+		int _0;
+		int result;
+		unsigned fingerprint;
+		bool valid;
+	};
+
+	entry entries[size];
+};
+
+// results of ':pure' functions cached by one planner, set 'planner_state::memo' to a zero-initialized instance.
+// results are kept across planning steps and plans until 'invalidate_memo' is called.
+struct memo_tables
+{
+	unsigned fingerprint;
+	weight_memo weight_table;
+};
+
+// drops cached results, call it when the values the ':pure' functions compute change.
+void invalidate_memo(memo_tables& memo);
+
+struct worldstate
+{
+	plnnr::tuple_list::handle* atoms[atom_count];
+	int (*weight)(int);
+};
+
+struct item_tuple
+{
+	int _0;
+	item_tuple* next;
+	item_tuple* prev;
+	uint32_t slot;
+	enum { id = atom_item };
+};
+
+struct mark_tuple
+{
+	int _0;
+	mark_tuple* next;
+	mark_tuple* prev;
+	uint32_t slot;
+	enum { id = atom_mark };
+};
+
+}
+
+namespace memo {
+
+enum task_type
+{
+	task_touch,
+	task_root,
+	task_scan,
+	task_probe,
+	task_count,
+};
+
+static const int operator_count = 1;
+static const int method_count = 3;
+
+const char* task_name(task_type type);
+
+struct touch_args
+{
+	int _0;
+};
+
+inline bool operator==(const touch_args& a, const touch_args& b)
+{
+	return \
+		a._0 == b._0 ;
+}
+
+bool root_branch_0_expand(plnnr::method_instance*, plnnr::planner_state&, void*);
+bool scan_branch_0_expand(plnnr::method_instance*, plnnr::planner_state&, void*);
+bool scan_branch_1_expand(plnnr::method_instance*, plnnr::planner_state&, void*);
+bool probe_branch_0_expand(plnnr::method_instance*, plnnr::planner_state&, void*);
+
+enum expand_index
+{
+	expand_root_branch_0 = 1,
+	expand_scan_branch_0,
+	expand_scan_branch_1,
+	expand_probe_branch_0,
+};
+
+extern const plnnr::expand_func expands[];
+
+}
+
+namespace plnnr {
+
+template <typename V>
+struct generated_type_reflector<memo::worldstate, V>
+{
+	void operator()(const memo::worldstate& world, V& visitor)
+	{
+		PLNNR_GENCODE_VISIT_ATOM_LIST(memo, atom_item, item_tuple, visitor);
+		PLNNR_GENCODE_VISIT_ATOM_LIST(memo, atom_mark, mark_tuple, visitor);
+	}
+};
+
+template <typename V>
+struct generated_type_reflector<memo::item_tuple, V>
+{
+	void operator()(const memo::item_tuple& tuple, V& visitor)
+	{
+		PLNNR_GENCODE_VISIT_TUPLE_BEGIN(visitor, memo, atom_name, atom_item, 1);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 0);
+		PLNNR_GENCODE_VISIT_TUPLE_END(visitor, memo, atom_name, atom_item, 1);
+	}
+};
+
+template <typename V>
+struct generated_type_reflector<memo::mark_tuple, V>
+{
+	void operator()(const memo::mark_tuple& tuple, V& visitor)
+	{
+		PLNNR_GENCODE_VISIT_TUPLE_BEGIN(visitor, memo, atom_name, atom_mark, 1);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 0);
+		PLNNR_GENCODE_VISIT_TUPLE_END(visitor, memo, atom_name, atom_mark, 1);
+	}
+};
+
+template <typename V>
+struct generated_type_reflector<memo::touch_args, V>
+{
+	void operator()(const memo::touch_args& tuple, V& visitor)
+	{
+		PLNNR_GENCODE_VISIT_TUPLE_BEGIN(visitor, memo, task_name, task_touch, 1);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 0);
+		PLNNR_GENCODE_VISIT_TUPLE_END(visitor, memo, task_name, task_touch, 1);
+	}
+};
+
+template <typename V>
+struct task_type_dispatcher<memo::task_type, V>
+{
+	void operator()(const memo::task_type& task_type, void* args, V& visitor)
+	{
+		switch (task_type)
+		{
+			case memo::task_root:
+				PLNNR_GENCODE_VISIT_TASK_NO_ARGS(visitor, memo, task_root);
+				break;
+			case memo::task_scan:
+				PLNNR_GENCODE_VISIT_TASK_NO_ARGS(visitor, memo, task_scan);
+				break;
+			case memo::task_probe:
+				PLNNR_GENCODE_VISIT_TASK_NO_ARGS(visitor, memo, task_probe);
+				break;
+			case memo::task_touch:
+				PLNNR_GENCODE_VISIT_TASK_WITH_ARGS(visitor, memo, task_touch, touch_args);
+				break;
+			default:
+				plnnr_assert(false);
+				break;
+		}
+	}
+};
+
+}
+
+#endif
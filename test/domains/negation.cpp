@@ -0,0 +1,105 @@
+#include <derplanner/runtime/runtime.h>
+#include "negation.h"
+
+using namespace plnnr;
+
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+
+namespace negation {
+
+static const char* atom_type_to_name[] =
+{
+	"on",
+	"pair",
+	"<none>",
+};
+
+const char* atom_name(atom_type type) { return atom_type_to_name[type]; }
+
+}
+
+namespace negation {
+
+static const char* task_type_to_name[] =
+{
+	"!pick",
+	"root",
+	"<none>",
+};
+
+const char* task_name(task_type type) { return task_type_to_name[type]; }
+
+// method root [10:9]
+struct p0_state
+{
+	pair_tuple* pair_0;
+	on_tuple* on_1;
+	// x [10:16]
+	int _0;
+	// y [10:18]
+	int _1;
+	int stage;
+};
+
+bool next(p0_state& state, worldstate& world)
+{
+	PLNNR_COROUTINE_BEGIN(state);
+
+	for (state.pair_0 = tuple_list::head<pair_tuple>(world.atoms[atom_pair]); state.pair_0 != 0; state.pair_0 = state.pair_0->next)
+	{
+		state._0 = state.pair_0->_0;
+
+		state._1 = state.pair_0->_1;
+
+		for (state.on_1 = tuple_list::head<on_tuple>(world.atoms[atom_on]); state.on_1 != 0; state.on_1 = state.on_1->next)
+		{
+			if (state.on_1->_0 == state._0 && state.on_1->_1 == state._1)
+			{
+				break;
+			}
+		}
+
+		if (state.on_1 == 0)
+		{
+			PLNNR_COROUTINE_YIELD(state, 1);
+		}
+	}
+
+	PLNNR_COROUTINE_END();
+}
+
+plnnr_static_assert(sizeof(method_instance) + padded_size<p0_state>::value <= max_frame_size);
+
+bool root_branch_0_expand(method_instance* method, planner_state& pstate, void* world)
+{
+	p0_state* precondition = plnnr::precondition<p0_state>(method);
+	worldstate* wstate = static_cast<worldstate*>(world);
+
+	PLNNR_COROUTINE_BEGIN(*method);
+
+	precondition = push_precondition<p0_state>(pstate, method);
+
+	while (next(*precondition, *wstate))
+	{
+		{
+			task_instance* t = push_task(pstate, task_pick, expand_none);
+			pick_args* a = push_arguments<pick_args>(pstate, t);
+			a->_0 = precondition->_0;
+			a->_1 = precondition->_1;
+		}
+
+		method->flags |= method_flags_expanded;
+		PLNNR_COROUTINE_YIELD(*method, 1);
+	}
+
+	PLNNR_COROUTINE_END();
+}
+
+const expand_func expands[] =
+{
+	0,
+	root_branch_0_expand,
+};
+
+}
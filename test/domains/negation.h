@@ -0,0 +1,167 @@
+#ifndef negation_H_
+#define negation_H_
+
+#include <derplanner/runtime/interface.h>
+
+namespace plnnr
+{
+	namespace tuple_list
+	{
+		struct handle;
+	}
+}
+
+namespace plnnr
+{
+	struct planner_state;
+	struct method_instance;
+	typedef bool (*expand_func)(method_instance*, planner_state&, void*);
+}
+
+namespace negation {
+
+enum atom_type
+{
+	atom_on,
+	atom_pair,
+	atom_count,
+};
+
+const char* atom_name(atom_type type);
+
+struct worldstate
+{
+	plnnr::tuple_list::handle* atoms[atom_count];
+};
+
+struct on_tuple
+{
+	int _0;
+	int _1;
+	on_tuple* next;
+	on_tuple* prev;
+	uint32_t slot;
+	enum { id = atom_on };
+};
+
+struct pair_tuple
+{
+	int _0;
+	int _1;
+	pair_tuple* next;
+	pair_tuple* prev;
+	uint32_t slot;
+	enum { id = atom_pair };
+};
+
+}
+
+namespace negation {
+
+enum task_type
+{
+	task_pick,
+	task_root,
+	task_count,
+};
+
+static const int operator_count = 1;
+static const int method_count = 1;
+
+const char* task_name(task_type type);
+
+struct pick_args
+{
+	int _0;
+	int _1;
+};
+
+inline bool operator==(const pick_args& a, const pick_args& b)
+{
+	return \
+		a._0 == b._0 &&
+		a._1 == b._1 ;
+}
+
+bool root_branch_0_expand(plnnr::method_instance*, plnnr::planner_state&, void*);
+
+enum expand_index
+{
+	expand_root_branch_0 = 1,
+};
+
+extern const plnnr::expand_func expands[];
+
+}
+
+namespace plnnr {
+
+template <typename V>
+struct generated_type_reflector<negation::worldstate, V>
+{
+	void operator()(const negation::worldstate& world, V& visitor)
+	{
+		PLNNR_GENCODE_VISIT_ATOM_LIST(negation, atom_on, on_tuple, visitor);
+		PLNNR_GENCODE_VISIT_ATOM_LIST(negation, atom_pair, pair_tuple, visitor);
+	}
+};
+
+template <typename V>
+struct generated_type_reflector<negation::on_tuple, V>
+{
+	void operator()(const negation::on_tuple& tuple, V& visitor)
+	{
+		PLNNR_GENCODE_VISIT_TUPLE_BEGIN(visitor, negation, atom_name, atom_on, 2);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 0);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 1);
+		PLNNR_GENCODE_VISIT_TUPLE_END(visitor, negation, atom_name, atom_on, 2);
+	}
+};
+
+template <typename V>
+struct generated_type_reflector<negation::pair_tuple, V>
+{
+	void operator()(const negation::pair_tuple& tuple, V& visitor)
+	{
+		PLNNR_GENCODE_VISIT_TUPLE_BEGIN(visitor, negation, atom_name, atom_pair, 2);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 0);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 1);
+		PLNNR_GENCODE_VISIT_TUPLE_END(visitor, negation, atom_name, atom_pair, 2);
+	}
+};
+
+template <typename V>
+struct generated_type_reflector<negation::pick_args, V>
+{
+	void operator()(const negation::pick_args& tuple, V& visitor)
+	{
+		PLNNR_GENCODE_VISIT_TUPLE_BEGIN(visitor, negation, task_name, task_pick, 2);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 0);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 1);
+		PLNNR_GENCODE_VISIT_TUPLE_END(visitor, negation, task_name, task_pick, 2);
+	}
+};
+
+template <typename V>
+struct task_type_dispatcher<negation::task_type, V>
+{
+	void operator()(const negation::task_type& task_type, void* args, V& visitor)
+	{
+		switch (task_type)
+		{
+			case negation::task_root:
+				PLNNR_GENCODE_VISIT_TASK_NO_ARGS(visitor, negation, task_root);
+				break;
+			case negation::task_pick:
+				PLNNR_GENCODE_VISIT_TASK_WITH_ARGS(visitor, negation, task_pick, pick_args);
+				break;
+			default:
+				plnnr_assert(false);
+				break;
+		}
+	}
+};
+
+}
+
+#endif
@@ -0,0 +1,517 @@
+#include <derplanner/runtime/runtime.h>
+#include "retry.h"
+
+using namespace plnnr;
+
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+
+namespace retry {
+
+static const char* atom_type_to_name[] =
+{
+	"cand",
+	"good",
+	"note",
+	"<none>",
+};
+
+const char* atom_name(atom_type type) { return atom_type_to_name[type]; }
+
+}
+
+namespace retry {
+
+static const char* task_type_to_name[] =
+{
+	"!pick",
+	"!note",
+	"check",
+	"mark",
+	"never",
+	"first-good",
+	"retry-after-expanded",
+	"check-last",
+	"backjump",
+	"<none>",
+};
+
+const char* task_name(task_type type) { return task_type_to_name[type]; }
+
+// method check [16:9]
+struct p0_state
+{
+	good_tuple* good_0;
+	// x [16:16]
+	int _0;
+	int stage;
+};
+
+bool next(p0_state& state, worldstate& world)
+{
+	PLNNR_COROUTINE_BEGIN(state);
+
+	for (state.good_0 = tuple_list::head<good_tuple>(world.atoms[atom_good]); state.good_0 != 0; state.good_0 = state.good_0->next)
+	{
+		if (state.good_0->_0 != state._0)
+		{
+			continue;
+		}
+
+		PLNNR_COROUTINE_YIELD(state, 1);
+		break;
+	}
+
+	PLNNR_COROUTINE_END();
+}
+
+// method mark [21:9]
+struct p1_state
+{
+	cand_tuple* cand_0;
+	// x [21:16]
+	int _0;
+	int stage;
+};
+
+bool next(p1_state& state, worldstate& world)
+{
+	PLNNR_COROUTINE_BEGIN(state);
+
+	for (state.cand_0 = tuple_list::head<cand_tuple>(world.atoms[atom_cand]); state.cand_0 != 0; state.cand_0 = state.cand_0->next)
+	{
+		if (state.cand_0->_0 != state._0)
+		{
+			continue;
+		}
+
+		PLNNR_COROUTINE_YIELD(state, 1);
+		break;
+	}
+
+	PLNNR_COROUTINE_END();
+}
+
+// method never [26:9]
+struct p2_state
+{
+	good_tuple* good_0;
+	int stage;
+};
+
+bool next(p2_state& state, worldstate& world)
+{
+	PLNNR_COROUTINE_BEGIN(state);
+
+	for (state.good_0 = tuple_list::head<good_tuple>(world.atoms[atom_good]); state.good_0 != 0; state.good_0 = state.good_0->next)
+	{
+		if (state.good_0->_0 != 0)
+		{
+			continue;
+		}
+
+		PLNNR_COROUTINE_YIELD(state, 1);
+		break;
+	}
+
+	PLNNR_COROUTINE_END();
+}
+
+// method first-good [31:9]
+struct p3_state
+{
+	cand_tuple* cand_0;
+	// x [31:16]
+	int _0;
+	int stage;
+};
+
+bool next(p3_state& state, worldstate& world)
+{
+	PLNNR_COROUTINE_BEGIN(state);
+
+	for (state.cand_0 = tuple_list::head<cand_tuple>(world.atoms[atom_cand]); state.cand_0 != 0; state.cand_0 = state.cand_0->next)
+	{
+		state._0 = state.cand_0->_0;
+
+		PLNNR_COROUTINE_YIELD(state, 1);
+	}
+
+	PLNNR_COROUTINE_END();
+}
+
+// method retry-after-expanded [36:9]
+struct p4_state
+{
+	cand_tuple* cand_0;
+	// x [36:16]
+	int _0;
+	int stage;
+};
+
+bool next(p4_state& state, worldstate& world)
+{
+	PLNNR_COROUTINE_BEGIN(state);
+
+	for (state.cand_0 = tuple_list::head<cand_tuple>(world.atoms[atom_cand]); state.cand_0 != 0; state.cand_0 = state.cand_0->next)
+	{
+		state._0 = state.cand_0->_0;
+
+		PLNNR_COROUTINE_YIELD(state, 1);
+	}
+
+	PLNNR_COROUTINE_END();
+}
+
+// method check-last [41:9]
+struct p5_state
+{
+	cand_tuple* cand_0;
+	// x [41:16]
+	int _0;
+	int stage;
+};
+
+bool next(p5_state& state, worldstate& world)
+{
+	PLNNR_COROUTINE_BEGIN(state);
+
+	for (state.cand_0 = tuple_list::head<cand_tuple>(world.atoms[atom_cand]); state.cand_0 != 0; state.cand_0 = state.cand_0->next)
+	{
+		state._0 = state.cand_0->_0;
+
+		PLNNR_COROUTINE_YIELD(state, 1);
+	}
+
+	PLNNR_COROUTINE_END();
+}
+
+// method backjump [46:9]
+struct p6_state
+{
+	cand_tuple* cand_0;
+	// x [46:16]
+	int _0;
+	int call_0;
+	int stage;
+};
+
+bool next(p6_state& state, worldstate& world)
+{
+	PLNNR_COROUTINE_BEGIN(state);
+
+	for (state.cand_0 = tuple_list::head<cand_tuple>(world.atoms[atom_cand]); state.cand_0 != 0; state.cand_0 = state.cand_0->next)
+	{
+		state._0 = state.cand_0->_0;
+
+		if (world.probe(state._0) > 0)
+		{
+			PLNNR_COROUTINE_YIELD(state, 1);
+		}
+	}
+
+	PLNNR_COROUTINE_END();
+}
+
+// method backjump [49:9]
+struct p7_state
+{
+	int stage;
+};
+
+bool next(p7_state& state, worldstate& world)
+{
+	PLNNR_COROUTINE_BEGIN(state);
+
+	PLNNR_COROUTINE_YIELD(state, 1);
+
+	PLNNR_COROUTINE_END();
+}
+
+plnnr_static_assert(sizeof(method_instance) + padded_size<check_args>::value + padded_size<p0_state>::value <= max_frame_size);
+
+bool check_branch_0_expand(method_instance* method, planner_state& pstate, void* world)
+{
+	p0_state* precondition = plnnr::precondition<p0_state>(method);
+	check_args* method_args = plnnr::arguments<check_args>(method);
+	worldstate* wstate = static_cast<worldstate*>(world);
+
+	PLNNR_COROUTINE_BEGIN(*method);
+
+	method->flags |= method_flags_committed;
+	precondition = push_precondition<p0_state>(pstate, method);
+	precondition->_0 = method_args->_0;
+
+	while (next(*precondition, *wstate))
+	{
+		method->flags |= method_flags_expanded;
+		PLNNR_COROUTINE_YIELD(*method, 1);
+	}
+
+	PLNNR_COROUTINE_END();
+}
+
+plnnr_static_assert(sizeof(method_instance) + padded_size<mark_args>::value + padded_size<p1_state>::value <= max_frame_size);
+
+bool mark_branch_0_expand(method_instance* method, planner_state& pstate, void* world)
+{
+	p1_state* precondition = plnnr::precondition<p1_state>(method);
+	mark_args* method_args = plnnr::arguments<mark_args>(method);
+	worldstate* wstate = static_cast<worldstate*>(world);
+
+	PLNNR_COROUTINE_BEGIN(*method);
+
+	method->flags |= method_flags_committed;
+	precondition = push_precondition<p1_state>(pstate, method);
+	precondition->_0 = method_args->_0;
+
+	while (next(*precondition, *wstate))
+	{
+		{
+			task_instance* t = push_task(pstate, task_note, expand_none);
+			note_args* a = push_arguments<note_args>(pstate, t);
+			a->_0 = method_args->_0;
+
+			{
+				tuple_list::handle* list = wstate->atoms[atom_note];
+				note_tuple* tuple = tuple_list::append<note_tuple>(list);
+				tuple->_0 = a->_0;
+				operator_effect* effect = push<operator_effect>(pstate.journal);
+				effect->tuple = tuple->slot;
+				effect->atom = atom_note;
+				effect->kind = effect_add;
+			}
+		}
+
+		method->flags |= method_flags_expanded;
+		PLNNR_COROUTINE_YIELD(*method, 1);
+	}
+
+	PLNNR_COROUTINE_END();
+}
+
+plnnr_static_assert(sizeof(method_instance) + padded_size<p2_state>::value <= max_frame_size);
+
+bool never_branch_0_expand(method_instance* method, planner_state& pstate, void* world)
+{
+	p2_state* precondition = plnnr::precondition<p2_state>(method);
+	worldstate* wstate = static_cast<worldstate*>(world);
+
+	PLNNR_COROUTINE_BEGIN(*method);
+
+	method->flags |= method_flags_committed;
+	precondition = push_precondition<p2_state>(pstate, method);
+
+	while (next(*precondition, *wstate))
+	{
+		method->flags |= method_flags_expanded;
+		PLNNR_COROUTINE_YIELD(*method, 1);
+	}
+
+	PLNNR_COROUTINE_END();
+}
+
+plnnr_static_assert(sizeof(method_instance) + padded_size<p3_state>::value <= max_frame_size);
+
+bool first_good_branch_0_expand(method_instance* method, planner_state& pstate, void* world)
+{
+	p3_state* precondition = plnnr::precondition<p3_state>(method);
+	worldstate* wstate = static_cast<worldstate*>(world);
+
+	PLNNR_COROUTINE_BEGIN(*method);
+
+	precondition = push_precondition<p3_state>(pstate, method);
+
+	while (next(*precondition, *wstate))
+	{
+		{
+			method_instance* t = push_method(pstate, task_check, expand_check_branch_0);
+			check_args* a = push_arguments<check_args>(pstate, t);
+			a->_0 = precondition->_0;
+		}
+
+		PLNNR_COROUTINE_YIELD(*method, 1);
+
+		if (method->flags & method_flags_failed)
+		{
+			continue;
+		}
+
+		{
+			task_instance* t = push_task(pstate, task_pick, expand_none);
+			pick_args* a = push_arguments<pick_args>(pstate, t);
+			a->_0 = precondition->_0;
+		}
+
+		method->flags |= method_flags_expanded;
+		PLNNR_COROUTINE_YIELD(*method, 2);
+	}
+
+	PLNNR_COROUTINE_END();
+}
+
+plnnr_static_assert(sizeof(method_instance) + padded_size<p4_state>::value <= max_frame_size);
+
+bool retry_after_expanded_branch_0_expand(method_instance* method, planner_state& pstate, void* world)
+{
+	p4_state* precondition = plnnr::precondition<p4_state>(method);
+	worldstate* wstate = static_cast<worldstate*>(world);
+
+	PLNNR_COROUTINE_BEGIN(*method);
+
+	precondition = push_precondition<p4_state>(pstate, method);
+
+	while (next(*precondition, *wstate))
+	{
+		{
+			method_instance* t = push_method(pstate, task_mark, expand_mark_branch_0);
+			mark_args* a = push_arguments<mark_args>(pstate, t);
+			a->_0 = precondition->_0;
+		}
+
+		PLNNR_COROUTINE_YIELD(*method, 1);
+
+		if (method->flags & method_flags_failed)
+		{
+			continue;
+		}
+
+		{
+			method_instance* t = push_method(pstate, task_check, expand_check_branch_0);
+			check_args* a = push_arguments<check_args>(pstate, t);
+			a->_0 = precondition->_0;
+		}
+
+		PLNNR_COROUTINE_YIELD(*method, 2);
+
+		if (method->flags & method_flags_failed)
+		{
+			continue;
+		}
+
+		{
+			task_instance* t = push_task(pstate, task_pick, expand_none);
+			pick_args* a = push_arguments<pick_args>(pstate, t);
+			a->_0 = precondition->_0;
+		}
+
+		method->flags |= method_flags_expanded;
+		PLNNR_COROUTINE_YIELD(*method, 3);
+	}
+
+	PLNNR_COROUTINE_END();
+}
+
+plnnr_static_assert(sizeof(method_instance) + padded_size<p5_state>::value <= max_frame_size);
+
+bool check_last_branch_0_expand(method_instance* method, planner_state& pstate, void* world)
+{
+	p5_state* precondition = plnnr::precondition<p5_state>(method);
+	worldstate* wstate = static_cast<worldstate*>(world);
+
+	PLNNR_COROUTINE_BEGIN(*method);
+
+	precondition = push_precondition<p5_state>(pstate, method);
+
+	while (next(*precondition, *wstate))
+	{
+		{
+			task_instance* t = push_task(pstate, task_pick, expand_none);
+			pick_args* a = push_arguments<pick_args>(pstate, t);
+			a->_0 = precondition->_0;
+		}
+
+		PLNNR_COROUTINE_YIELD(*method, 1);
+
+		{
+			method_instance* t = push_method(pstate, task_check, expand_check_branch_0);
+			check_args* a = push_arguments<check_args>(pstate, t);
+			a->_0 = precondition->_0;
+		}
+
+		method->flags |= method_flags_expanded;
+		PLNNR_COROUTINE_YIELD(*method, 2);
+	}
+
+	PLNNR_COROUTINE_END();
+}
+
+plnnr_static_assert(sizeof(method_instance) + padded_size<p6_state>::value <= max_frame_size);
+
+bool backjump_branch_0_expand(method_instance* method, planner_state& pstate, void* world)
+{
+	p6_state* precondition = plnnr::precondition<p6_state>(method);
+	worldstate* wstate = static_cast<worldstate*>(world);
+
+	PLNNR_COROUTINE_BEGIN(*method);
+
+	precondition = push_precondition<p6_state>(pstate, method);
+
+	while (next(*precondition, *wstate))
+	{
+		{
+			method_instance* t = push_method(pstate, task_never, expand_never_branch_0);
+		}
+
+		PLNNR_COROUTINE_YIELD(*method, 1);
+
+		if (method->flags & method_flags_failed)
+		{
+			break;
+		}
+
+		{
+			task_instance* t = push_task(pstate, task_pick, expand_none);
+			pick_args* a = push_arguments<pick_args>(pstate, t);
+			a->_0 = precondition->_0;
+		}
+
+		method->flags |= method_flags_expanded;
+		PLNNR_COROUTINE_YIELD(*method, 2);
+	}
+
+	return expand_next_branch(pstate, expand_backjump_branch_1, world);
+	PLNNR_COROUTINE_END();
+}
+
+plnnr_static_assert(sizeof(method_instance) + padded_size<p7_state>::value <= max_frame_size);
+
+bool backjump_branch_1_expand(method_instance* method, planner_state& pstate, void* world)
+{
+	p7_state* precondition = plnnr::precondition<p7_state>(method);
+	worldstate* wstate = static_cast<worldstate*>(world);
+
+	PLNNR_COROUTINE_BEGIN(*method);
+
+	method->flags |= method_flags_committed;
+	precondition = push_precondition<p7_state>(pstate, method);
+
+	while (next(*precondition, *wstate))
+	{
+		{
+			task_instance* t = push_task(pstate, task_pick, expand_none);
+			pick_args* a = push_arguments<pick_args>(pstate, t);
+			a->_0 = 0;
+		}
+
+		method->flags |= method_flags_expanded;
+		PLNNR_COROUTINE_YIELD(*method, 1);
+	}
+
+	PLNNR_COROUTINE_END();
+}
+
+const expand_func expands[] =
+{
+	0,
+	check_branch_0_expand,
+	mark_branch_0_expand,
+	never_branch_0_expand,
+	first_good_branch_0_expand,
+	retry_after_expanded_branch_0_expand,
+	check_last_branch_0_expand,
+	backjump_branch_0_expand,
+	backjump_branch_1_expand,
+};
+
+}
@@ -0,0 +1,291 @@
+#ifndef retry_H_
+#define retry_H_
+
+#include <derplanner/runtime/interface.h>
+
+namespace plnnr
+{
+	namespace tuple_list
+	{
+		struct handle;
+	}
+}
+
+namespace plnnr
+{
+	struct planner_state;
+	struct method_instance;
+	typedef bool (*expand_func)(method_instance*, planner_state&, void*);
+}
+
+namespace retry {
+
+enum atom_type
+{
+	atom_cand,
+	atom_good,
+	atom_note,
+	atom_count,
+};
+
+const char* atom_name(atom_type type);
+
+struct worldstate
+{
+	plnnr::tuple_list::handle* atoms[atom_count];
+	int (*probe)(int);
+};
+
+struct cand_tuple
+{
+	int _0;
+	cand_tuple* next;
+	cand_tuple* prev;
+	uint32_t slot;
+	enum { id = atom_cand };
+};
+
+struct good_tuple
+{
+	int _0;
+	good_tuple* next;
+	good_tuple* prev;
+	uint32_t slot;
+	enum { id = atom_good };
+};
+
+struct note_tuple
+{
+	int _0;
+	note_tuple* next;
+	note_tuple* prev;
+	uint32_t slot;
+	enum { id = atom_note };
+};
+
+}
+
+namespace retry {
+
+enum task_type
+{
+	task_pick,
+	task_note,
+	task_check,
+	task_mark,
+	task_never,
+	task_first_good,
+	task_retry_after_expanded,
+	task_check_last,
+	task_backjump,
+	task_count,
+};
+
+static const int operator_count = 2;
+static const int method_count = 7;
+
+const char* task_name(task_type type);
+
+struct pick_args
+{
+	int _0;
+};
+
+inline bool operator==(const pick_args& a, const pick_args& b)
+{
+	return \
+		a._0 == b._0 ;
+}
+
+struct note_args
+{
+	int _0;
+};
+
+inline bool operator==(const note_args& a, const note_args& b)
+{
+	return \
+		a._0 == b._0 ;
+}
+
+struct check_args
+{
+	int _0;
+};
+
+inline bool operator==(const check_args& a, const check_args& b)
+{
+	return \
+		a._0 == b._0 ;
+}
+
+struct mark_args
+{
+	int _0;
+};
+
+inline bool operator==(const mark_args& a, const mark_args& b)
+{
+	return \
+		a._0 == b._0 ;
+}
+
+bool check_branch_0_expand(plnnr::method_instance*, plnnr::planner_state&, void*);
+bool mark_branch_0_expand(plnnr::method_instance*, plnnr::planner_state&, void*);
+bool never_branch_0_expand(plnnr::method_instance*, plnnr::planner_state&, void*);
+bool first_good_branch_0_expand(plnnr::method_instance*, plnnr::planner_state&, void*);
+bool retry_after_expanded_branch_0_expand(plnnr::method_instance*, plnnr::planner_state&, void*);
+bool check_last_branch_0_expand(plnnr::method_instance*, plnnr::planner_state&, void*);
+bool backjump_branch_0_expand(plnnr::method_instance*, plnnr::planner_state&, void*);
+bool backjump_branch_1_expand(plnnr::method_instance*, plnnr::planner_state&, void*);
+
+enum expand_index
+{
+	expand_check_branch_0 = 1,
+	expand_mark_branch_0,
+	expand_never_branch_0,
+	expand_first_good_branch_0,
+	expand_retry_after_expanded_branch_0,
+	expand_check_last_branch_0,
+	expand_backjump_branch_0,
+	expand_backjump_branch_1,
+};
+
+extern const plnnr::expand_func expands[];
+
+}
+
+namespace plnnr {
+
+template <typename V>
+struct generated_type_reflector<retry::worldstate, V>
+{
+	void operator()(const retry::worldstate& world, V& visitor)
+	{
+		PLNNR_GENCODE_VISIT_ATOM_LIST(retry, atom_cand, cand_tuple, visitor);
+		PLNNR_GENCODE_VISIT_ATOM_LIST(retry, atom_good, good_tuple, visitor);
+		PLNNR_GENCODE_VISIT_ATOM_LIST(retry, atom_note, note_tuple, visitor);
+	}
+};
+
+template <typename V>
+struct generated_type_reflector<retry::cand_tuple, V>
+{
+	void operator()(const retry::cand_tuple& tuple, V& visitor)
+	{
+		PLNNR_GENCODE_VISIT_TUPLE_BEGIN(visitor, retry, atom_name, atom_cand, 1);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 0);
+		PLNNR_GENCODE_VISIT_TUPLE_END(visitor, retry, atom_name, atom_cand, 1);
+	}
+};
+
+template <typename V>
+struct generated_type_reflector<retry::good_tuple, V>
+{
+	void operator()(const retry::good_tuple& tuple, V& visitor)
+	{
+		PLNNR_GENCODE_VISIT_TUPLE_BEGIN(visitor, retry, atom_name, atom_good, 1);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 0);
+		PLNNR_GENCODE_VISIT_TUPLE_END(visitor, retry, atom_name, atom_good, 1);
+	}
+};
+
+template <typename V>
+struct generated_type_reflector<retry::note_tuple, V>
+{
+	void operator()(const retry::note_tuple& tuple, V& visitor)
+	{
+		PLNNR_GENCODE_VISIT_TUPLE_BEGIN(visitor, retry, atom_name, atom_note, 1);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 0);
+		PLNNR_GENCODE_VISIT_TUPLE_END(visitor, retry, atom_name, atom_note, 1);
+	}
+};
+
+template <typename V>
+struct generated_type_reflector<retry::pick_args, V>
+{
+	void operator()(const retry::pick_args& tuple, V& visitor)
+	{
+		PLNNR_GENCODE_VISIT_TUPLE_BEGIN(visitor, retry, task_name, task_pick, 1);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 0);
+		PLNNR_GENCODE_VISIT_TUPLE_END(visitor, retry, task_name, task_pick, 1);
+	}
+};
+
+template <typename V>
+struct generated_type_reflector<retry::note_args, V>
+{
+	void operator()(const retry::note_args& tuple, V& visitor)
+	{
+		PLNNR_GENCODE_VISIT_TUPLE_BEGIN(visitor, retry, task_name, task_note, 1);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 0);
+		PLNNR_GENCODE_VISIT_TUPLE_END(visitor, retry, task_name, task_note, 1);
+	}
+};
+
+template <typename V>
+struct generated_type_reflector<retry::check_args, V>
+{
+	void operator()(const retry::check_args& tuple, V& visitor)
+	{
+		PLNNR_GENCODE_VISIT_TUPLE_BEGIN(visitor, retry, task_name, task_check, 1);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 0);
+		PLNNR_GENCODE_VISIT_TUPLE_END(visitor, retry, task_name, task_check, 1);
+	}
+};
+
+template <typename V>
+struct generated_type_reflector<retry::mark_args, V>
+{
+	void operator()(const retry::mark_args& tuple, V& visitor)
+	{
+		PLNNR_GENCODE_VISIT_TUPLE_BEGIN(visitor, retry, task_name, task_mark, 1);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 0);
+		PLNNR_GENCODE_VISIT_TUPLE_END(visitor, retry, task_name, task_mark, 1);
+	}
+};
+
+template <typename V>
+struct task_type_dispatcher<retry::task_type, V>
+{
+	void operator()(const retry::task_type& task_type, void* args, V& visitor)
+	{
+		switch (task_type)
+		{
+			case retry::task_check:
+				PLNNR_GENCODE_VISIT_TASK_WITH_ARGS(visitor, retry, task_check, check_args);
+				break;
+			case retry::task_mark:
+				PLNNR_GENCODE_VISIT_TASK_WITH_ARGS(visitor, retry, task_mark, mark_args);
+				break;
+			case retry::task_never:
+				PLNNR_GENCODE_VISIT_TASK_NO_ARGS(visitor, retry, task_never);
+				break;
+			case retry::task_first_good:
+				PLNNR_GENCODE_VISIT_TASK_NO_ARGS(visitor, retry, task_first_good);
+				break;
+			case retry::task_retry_after_expanded:
+				PLNNR_GENCODE_VISIT_TASK_NO_ARGS(visitor, retry, task_retry_after_expanded);
+				break;
+			case retry::task_check_last:
+				PLNNR_GENCODE_VISIT_TASK_NO_ARGS(visitor, retry, task_check_last);
+				break;
+			case retry::task_backjump:
+				PLNNR_GENCODE_VISIT_TASK_NO_ARGS(visitor, retry, task_backjump);
+				break;
+			case retry::task_pick:
+				PLNNR_GENCODE_VISIT_TASK_WITH_ARGS(visitor, retry, task_pick, pick_args);
+				break;
+			case retry::task_note:
+				PLNNR_GENCODE_VISIT_TASK_WITH_ARGS(visitor, retry, task_note, note_args);
+				break;
+			default:
+				plnnr_assert(false);
+				break;
+		}
+	}
+};
+
+}
+
+#endif
@@ -0,0 +1,141 @@
+#include <derplanner/runtime/runtime.h>
+#include "semijoin.h"
+
+using namespace plnnr;
+
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+
+namespace semijoin {
+
+static const char* atom_type_to_name[] =
+{
+	"item",
+	"<none>",
+};
+
+const char* atom_name(atom_type type) { return atom_type_to_name[type]; }
+
+}
+
+namespace semijoin {
+
+static const char* task_type_to_name[] =
+{
+	"!tick",
+	"any",
+	"each",
+	"<none>",
+};
+
+const char* task_name(task_type type) { return task_type_to_name[type]; }
+
+// method any [9:9]
+struct p0_state
+{
+	item_tuple* item_0;
+	// x [9:16]
+	int _0;
+	int stage;
+};
+
+bool next(p0_state& state, worldstate& world)
+{
+	PLNNR_COROUTINE_BEGIN(state);
+
+	for (state.item_0 = tuple_list::head<item_tuple>(world.atoms[atom_item]); state.item_0 != 0; state.item_0 = state.item_0->next)
+	{
+		state._0 = state.item_0->_0;
+
+		PLNNR_COROUTINE_YIELD(state, 1);
+		break;
+	}
+
+	PLNNR_COROUTINE_END();
+}
+
+// method each [14:19]
+struct p1_state
+{
+	item_tuple* item_0;
+	// x [14:26]
+	int _0;
+	int stage;
+};
+
+bool next(p1_state& state, worldstate& world)
+{
+	PLNNR_COROUTINE_BEGIN(state);
+
+	for (state.item_0 = tuple_list::head<item_tuple>(world.atoms[atom_item]); state.item_0 != 0; state.item_0 = state.item_0->next)
+	{
+		state._0 = state.item_0->_0;
+
+		PLNNR_COROUTINE_YIELD(state, 1);
+	}
+
+	PLNNR_COROUTINE_END();
+}
+
+plnnr_static_assert(sizeof(method_instance) + padded_size<p0_state>::value <= max_frame_size);
+
+bool any_branch_0_expand(method_instance* method, planner_state& pstate, void* world)
+{
+	p0_state* precondition = plnnr::precondition<p0_state>(method);
+	worldstate* wstate = static_cast<worldstate*>(world);
+
+	PLNNR_COROUTINE_BEGIN(*method);
+
+	method->flags |= method_flags_committed;
+	precondition = push_precondition<p0_state>(pstate, method);
+
+	while (next(*precondition, *wstate))
+	{
+		{
+			task_instance* t = push_task(pstate, task_tick, expand_none);
+		}
+
+		method->flags |= method_flags_expanded;
+		PLNNR_COROUTINE_YIELD(*method, 1);
+	}
+
+	PLNNR_COROUTINE_END();
+}
+
+plnnr_static_assert(sizeof(method_instance) + padded_size<p1_state>::value <= max_frame_size);
+
+bool each_branch_0_expand(method_instance* method, planner_state& pstate, void* world)
+{
+	p1_state* precondition = plnnr::precondition<p1_state>(method);
+	worldstate* wstate = static_cast<worldstate*>(world);
+
+	PLNNR_COROUTINE_BEGIN(*method);
+
+	precondition = push_precondition<p1_state>(pstate, method);
+
+	while (next(*precondition, *wstate))
+	{
+		{
+			task_instance* t = push_task(pstate, task_tick, expand_none);
+		}
+
+		PLNNR_COROUTINE_YIELD(*method, 1);
+	}
+
+	if (precondition->stage > 0)
+	{
+		method->flags |= method_flags_expanded;
+		PLNNR_COROUTINE_YIELD(*method, 2);
+	}
+
+	PLNNR_COROUTINE_END();
+}
+
+const expand_func expands[] =
+{
+	0,
+	any_branch_0_expand,
+	each_branch_0_expand,
+};
+
+}
@@ -0,0 +1,122 @@
+#ifndef semijoin_H_
+#define semijoin_H_
+
+#include <derplanner/runtime/interface.h>
+
+namespace plnnr
+{
+	namespace tuple_list
+	{
+		struct handle;
+	}
+}
+
+namespace plnnr
+{
+	struct planner_state;
+	struct method_instance;
+	typedef bool (*expand_func)(method_instance*, planner_state&, void*);
+}
+
+namespace semijoin {
+
+enum atom_type
+{
+	atom_item,
+	atom_count,
+};
+
+const char* atom_name(atom_type type);
+
+struct worldstate
+{
+	plnnr::tuple_list::handle* atoms[atom_count];
+};
+
+struct item_tuple
+{
+	int _0;
+	item_tuple* next;
+	item_tuple* prev;
+	uint32_t slot;
+	enum { id = atom_item };
+};
+
+}
+
+namespace semijoin {
+
+enum task_type
+{
+	task_tick,
+	task_any,
+	task_each,
+	task_count,
+};
+
+static const int operator_count = 1;
+static const int method_count = 2;
+
+const char* task_name(task_type type);
+
+bool any_branch_0_expand(plnnr::method_instance*, plnnr::planner_state&, void*);
+bool each_branch_0_expand(plnnr::method_instance*, plnnr::planner_state&, void*);
+
+enum expand_index
+{
+	expand_any_branch_0 = 1,
+	expand_each_branch_0,
+};
+
+extern const plnnr::expand_func expands[];
+
+}
+
+namespace plnnr {
+
+template <typename V>
+struct generated_type_reflector<semijoin::worldstate, V>
+{
+	void operator()(const semijoin::worldstate& world, V& visitor)
+	{
+		PLNNR_GENCODE_VISIT_ATOM_LIST(semijoin, atom_item, item_tuple, visitor);
+	}
+};
+
+template <typename V>
+struct generated_type_reflector<semijoin::item_tuple, V>
+{
+	void operator()(const semijoin::item_tuple& tuple, V& visitor)
+	{
+		PLNNR_GENCODE_VISIT_TUPLE_BEGIN(visitor, semijoin, atom_name, atom_item, 1);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 0);
+		PLNNR_GENCODE_VISIT_TUPLE_END(visitor, semijoin, atom_name, atom_item, 1);
+	}
+};
+
+template <typename V>
+struct task_type_dispatcher<semijoin::task_type, V>
+{
+	void operator()(const semijoin::task_type& task_type, void* args, V& visitor)
+	{
+		switch (task_type)
+		{
+			case semijoin::task_any:
+				PLNNR_GENCODE_VISIT_TASK_NO_ARGS(visitor, semijoin, task_any);
+				break;
+			case semijoin::task_each:
+				PLNNR_GENCODE_VISIT_TASK_NO_ARGS(visitor, semijoin, task_each);
+				break;
+			case semijoin::task_tick:
+				PLNNR_GENCODE_VISIT_TASK_NO_ARGS(visitor, semijoin, task_tick);
+				break;
+			default:
+				plnnr_assert(false);
+				break;
+		}
+	}
+};
+
+}
+
+#endif
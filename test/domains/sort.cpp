@@ -0,0 +1,120 @@
+#include <derplanner/runtime/runtime.h>
+#include "sort.h"
+
+using namespace plnnr;
+
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+
+namespace sort {
+
+static const char* atom_type_to_name[] =
+{
+	"item",
+	"weight",
+	"<none>",
+};
+
+const char* atom_name(atom_type type) { return atom_type_to_name[type]; }
+
+}
+
+namespace sort {
+
+static const char* task_type_to_name[] =
+{
+	"!take",
+	"root",
+	"<none>",
+};
+
+const char* task_name(task_type type) { return task_type_to_name[type]; }
+
+// method root [11:13]
+struct p0_state
+{
+	item_tuple* item_0;
+	weight_tuple* weight_1;
+	// x [11:20]
+	int _0;
+	// k [11:33]
+	int _1;
+	int stage;
+};
+
+bool next(p0_state& state, worldstate& world)
+{
+	PLNNR_COROUTINE_BEGIN(state);
+
+	for (state.item_0 = tuple_list::head<item_tuple>(world.atoms[atom_item]); state.item_0 != 0; state.item_0 = state.item_0->next)
+	{
+		state._0 = state.item_0->_0;
+
+		for (state.weight_1 = tuple_list::head<weight_tuple>(world.atoms[atom_weight]); state.weight_1 != 0; state.weight_1 = state.weight_1->next)
+		{
+			if (state.weight_1->_0 != state._0)
+			{
+				continue;
+			}
+
+			state._1 = state.weight_1->_1;
+
+			PLNNR_COROUTINE_YIELD(state, 1);
+		}
+	}
+
+	PLNNR_COROUTINE_END();
+}
+
+typedef sorted_bindings<p0_state, int, 16> p0_sorted;
+
+bool next(p0_sorted& sorted, p0_state* precondition, worldstate* wstate)
+{
+	if (begin_batch(sorted, *precondition))
+	{
+		while (!batch_full(sorted) && next(*precondition, *wstate))
+		{
+			insert_binding(sorted, *precondition, precondition->_1);
+		}
+
+		end_batch(sorted, *precondition);
+	}
+
+	return next_binding(sorted, *precondition);
+}
+
+plnnr_static_assert(sizeof(method_instance) + padded_size<p0_state>::value + padded_size<p0_sorted>::value <= max_frame_size);
+
+bool root_branch_0_expand(method_instance* method, planner_state& pstate, void* world)
+{
+	p0_state* precondition = plnnr::precondition<p0_state>(method);
+	p0_sorted* sorted = sorted_bindings_of<p0_sorted>(method);
+	worldstate* wstate = static_cast<worldstate*>(world);
+
+	PLNNR_COROUTINE_BEGIN(*method);
+
+	precondition = push_precondition<p0_state>(pstate, method);
+	sorted = push_sorted_bindings<p0_sorted>(pstate, method);
+
+	while (next(*sorted, precondition, wstate))
+	{
+		{
+			task_instance* t = push_task(pstate, task_take, expand_none);
+			take_args* a = push_arguments<take_args>(pstate, t);
+			a->_0 = precondition->_0;
+		}
+
+		method->flags |= method_flags_expanded;
+		PLNNR_COROUTINE_YIELD(*method, 1);
+	}
+
+	PLNNR_COROUTINE_END();
+}
+
+const expand_func expands[] =
+{
+	0,
+	root_branch_0_expand,
+};
+
+}
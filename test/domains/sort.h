@@ -0,0 +1,162 @@
+#ifndef sort_H_
+#define sort_H_
+
+#include <derplanner/runtime/interface.h>
+
+namespace plnnr
+{
+	namespace tuple_list
+	{
+		struct handle;
+	}
+}
+
+namespace plnnr
+{
+	struct planner_state;
+	struct method_instance;
+	typedef bool (*expand_func)(method_instance*, planner_state&, void*);
+}
+
+namespace sort {
+
+enum atom_type
+{
+	atom_item,
+	atom_weight,
+	atom_count,
+};
+
+const char* atom_name(atom_type type);
+
+struct worldstate
+{
+	plnnr::tuple_list::handle* atoms[atom_count];
+};
+
+struct item_tuple
+{
+	int _0;
+	item_tuple* next;
+	item_tuple* prev;
+	uint32_t slot;
+	enum { id = atom_item };
+};
+
+struct weight_tuple
+{
+	int _0;
+	int _1;
+	weight_tuple* next;
+	weight_tuple* prev;
+	uint32_t slot;
+	enum { id = atom_weight };
+};
+
+}
+
+namespace sort {
+
+enum task_type
+{
+	task_take,
+	task_root,
+	task_count,
+};
+
+static const int operator_count = 1;
+static const int method_count = 1;
+
+const char* task_name(task_type type);
+
+struct take_args
+{
+	int _0;
+};
+
+inline bool operator==(const take_args& a, const take_args& b)
+{
+	return \
+		a._0 == b._0 ;
+}
+
+bool root_branch_0_expand(plnnr::method_instance*, plnnr::planner_state&, void*);
+
+enum expand_index
+{
+	expand_root_branch_0 = 1,
+};
+
+extern const plnnr::expand_func expands[];
+
+}
+
+namespace plnnr {
+
+template <typename V>
+struct generated_type_reflector<sort::worldstate, V>
+{
+	void operator()(const sort::worldstate& world, V& visitor)
+	{
+		PLNNR_GENCODE_VISIT_ATOM_LIST(sort, atom_item, item_tuple, visitor);
+		PLNNR_GENCODE_VISIT_ATOM_LIST(sort, atom_weight, weight_tuple, visitor);
+	}
+};
+
+template <typename V>
+struct generated_type_reflector<sort::item_tuple, V>
+{
+	void operator()(const sort::item_tuple& tuple, V& visitor)
+	{
+		PLNNR_GENCODE_VISIT_TUPLE_BEGIN(visitor, sort, atom_name, atom_item, 1);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 0);
+		PLNNR_GENCODE_VISIT_TUPLE_END(visitor, sort, atom_name, atom_item, 1);
+	}
+};
+
+template <typename V>
+struct generated_type_reflector<sort::weight_tuple, V>
+{
+	void operator()(const sort::weight_tuple& tuple, V& visitor)
+	{
+		PLNNR_GENCODE_VISIT_TUPLE_BEGIN(visitor, sort, atom_name, atom_weight, 2);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 0);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 1);
+		PLNNR_GENCODE_VISIT_TUPLE_END(visitor, sort, atom_name, atom_weight, 2);
+	}
+};
+
+template <typename V>
+struct generated_type_reflector<sort::take_args, V>
+{
+	void operator()(const sort::take_args& tuple, V& visitor)
+	{
+		PLNNR_GENCODE_VISIT_TUPLE_BEGIN(visitor, sort, task_name, task_take, 1);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 0);
+		PLNNR_GENCODE_VISIT_TUPLE_END(visitor, sort, task_name, task_take, 1);
+	}
+};
+
+template <typename V>
+struct task_type_dispatcher<sort::task_type, V>
+{
+	void operator()(const sort::task_type& task_type, void* args, V& visitor)
+	{
+		switch (task_type)
+		{
+			case sort::task_root:
+				PLNNR_GENCODE_VISIT_TASK_NO_ARGS(visitor, sort, task_root);
+				break;
+			case sort::task_take:
+				PLNNR_GENCODE_VISIT_TASK_WITH_ARGS(visitor, sort, task_take, take_args);
+				break;
+			default:
+				plnnr_assert(false);
+				break;
+		}
+	}
+};
+
+}
+
+#endif
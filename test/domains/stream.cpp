@@ -0,0 +1,272 @@
+#include <derplanner/runtime/runtime.h>
+#include "stream.h"
+
+using namespace plnnr;
+
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+
+namespace stream {
+
+static const char* atom_type_to_name[] =
+{
+	"item",
+	"big",
+	"<none>",
+};
+
+const char* atom_name(atom_type type) { return atom_type_to_name[type]; }
+
+}
+
+namespace stream {
+
+static const char* task_type_to_name[] =
+{
+	"!a",
+	"root",
+	"prefix",
+	"pick",
+	"check",
+	"<none>",
+};
+
+const char* task_name(task_type type) { return task_type_to_name[type]; }
+
+// method root [10:9]
+struct p0_state
+{
+	int stage;
+};
+
+bool next(p0_state& state, worldstate& world)
+{
+	PLNNR_COROUTINE_BEGIN(state);
+
+	PLNNR_COROUTINE_YIELD(state, 1);
+
+	PLNNR_COROUTINE_END();
+}
+
+// method prefix [15:9]
+struct p1_state
+{
+	int stage;
+};
+
+bool next(p1_state& state, worldstate& world)
+{
+	PLNNR_COROUTINE_BEGIN(state);
+
+	PLNNR_COROUTINE_YIELD(state, 1);
+
+	PLNNR_COROUTINE_END();
+}
+
+// method pick [20:9]
+struct p2_state
+{
+	item_tuple* item_0;
+	// x [20:15]
+	int _0;
+	int stage;
+};
+
+bool next(p2_state& state, worldstate& world)
+{
+	PLNNR_COROUTINE_BEGIN(state);
+
+	for (state.item_0 = tuple_list::head<item_tuple>(world.atoms[atom_item]); state.item_0 != 0; state.item_0 = state.item_0->next)
+	{
+		state._0 = state.item_0->_0;
+
+		PLNNR_COROUTINE_YIELD(state, 1);
+	}
+
+	PLNNR_COROUTINE_END();
+}
+
+// method check [25:9]
+struct p3_state
+{
+	big_tuple* big_0;
+	// x [25:14]
+	int _0;
+	int stage;
+};
+
+bool next(p3_state& state, worldstate& world)
+{
+	PLNNR_COROUTINE_BEGIN(state);
+
+	for (state.big_0 = tuple_list::head<big_tuple>(world.atoms[atom_big]); state.big_0 != 0; state.big_0 = state.big_0->next)
+	{
+		if (state.big_0->_0 != state._0)
+		{
+			continue;
+		}
+
+		PLNNR_COROUTINE_YIELD(state, 1);
+		break;
+	}
+
+	PLNNR_COROUTINE_END();
+}
+
+plnnr_static_assert(sizeof(method_instance) + padded_size<p0_state>::value <= max_frame_size);
+
+bool root_branch_0_expand(method_instance* method, planner_state& pstate, void* world)
+{
+	p0_state* precondition = plnnr::precondition<p0_state>(method);
+	worldstate* wstate = static_cast<worldstate*>(world);
+
+	PLNNR_COROUTINE_BEGIN(*method);
+
+	method->flags |= method_flags_committed;
+	precondition = push_precondition<p0_state>(pstate, method);
+
+	while (next(*precondition, *wstate))
+	{
+		// inlined prefix
+		{
+			task_instance* t = push_task(pstate, task_a, expand_none);
+			a_args* a = push_arguments<a_args>(pstate, t);
+			a->_0 = 1;
+		}
+
+		PLNNR_COROUTINE_YIELD(*method, 1);
+
+		{
+			task_instance* t = push_task(pstate, task_a, expand_none);
+			a_args* a = push_arguments<a_args>(pstate, t);
+			a->_0 = 2;
+		}
+
+		PLNNR_COROUTINE_YIELD(*method, 2);
+
+		{
+			method_instance* t = push_method(pstate, task_pick, expand_pick_branch_0);
+		}
+
+		PLNNR_COROUTINE_YIELD(*method, 3);
+
+		if (method->flags & method_flags_failed)
+		{
+			break;
+		}
+
+		{
+			task_instance* t = push_task(pstate, task_a, expand_none);
+			a_args* a = push_arguments<a_args>(pstate, t);
+			a->_0 = 100;
+		}
+
+		method->flags |= method_flags_expanded;
+		PLNNR_COROUTINE_YIELD(*method, 4);
+	}
+
+	PLNNR_COROUTINE_END();
+}
+
+plnnr_static_assert(sizeof(method_instance) + padded_size<p1_state>::value <= max_frame_size);
+
+bool prefix_branch_0_expand(method_instance* method, planner_state& pstate, void* world)
+{
+	p1_state* precondition = plnnr::precondition<p1_state>(method);
+	worldstate* wstate = static_cast<worldstate*>(world);
+
+	PLNNR_COROUTINE_BEGIN(*method);
+
+	method->flags |= method_flags_committed;
+	precondition = push_precondition<p1_state>(pstate, method);
+
+	while (next(*precondition, *wstate))
+	{
+		{
+			task_instance* t = push_task(pstate, task_a, expand_none);
+			a_args* a = push_arguments<a_args>(pstate, t);
+			a->_0 = 1;
+		}
+
+		PLNNR_COROUTINE_YIELD(*method, 1);
+
+		{
+			task_instance* t = push_task(pstate, task_a, expand_none);
+			a_args* a = push_arguments<a_args>(pstate, t);
+			a->_0 = 2;
+		}
+
+		method->flags |= method_flags_expanded;
+		PLNNR_COROUTINE_YIELD(*method, 2);
+	}
+
+	PLNNR_COROUTINE_END();
+}
+
+plnnr_static_assert(sizeof(method_instance) + padded_size<p2_state>::value <= max_frame_size);
+
+bool pick_branch_0_expand(method_instance* method, planner_state& pstate, void* world)
+{
+	p2_state* precondition = plnnr::precondition<p2_state>(method);
+	worldstate* wstate = static_cast<worldstate*>(world);
+
+	PLNNR_COROUTINE_BEGIN(*method);
+
+	precondition = push_precondition<p2_state>(pstate, method);
+
+	while (next(*precondition, *wstate))
+	{
+		{
+			task_instance* t = push_task(pstate, task_a, expand_none);
+			a_args* a = push_arguments<a_args>(pstate, t);
+			a->_0 = precondition->_0;
+		}
+
+		PLNNR_COROUTINE_YIELD(*method, 1);
+
+		{
+			method_instance* t = push_method(pstate, task_check, expand_check_branch_0);
+			check_args* a = push_arguments<check_args>(pstate, t);
+			a->_0 = precondition->_0;
+		}
+
+		method->flags |= method_flags_expanded;
+		PLNNR_COROUTINE_YIELD(*method, 2);
+	}
+
+	PLNNR_COROUTINE_END();
+}
+
+plnnr_static_assert(sizeof(method_instance) + padded_size<check_args>::value + padded_size<p3_state>::value <= max_frame_size);
+
+bool check_branch_0_expand(method_instance* method, planner_state& pstate, void* world)
+{
+	p3_state* precondition = plnnr::precondition<p3_state>(method);
+	check_args* method_args = plnnr::arguments<check_args>(method);
+	worldstate* wstate = static_cast<worldstate*>(world);
+
+	PLNNR_COROUTINE_BEGIN(*method);
+
+	method->flags |= method_flags_committed;
+	precondition = push_precondition<p3_state>(pstate, method);
+	precondition->_0 = method_args->_0;
+
+	while (next(*precondition, *wstate))
+	{
+		method->flags |= method_flags_expanded;
+		PLNNR_COROUTINE_YIELD(*method, 1);
+	}
+
+	PLNNR_COROUTINE_END();
+}
+
+const expand_func expands[] =
+{
+	0,
+	root_branch_0_expand,
+	prefix_branch_0_expand,
+	pick_branch_0_expand,
+	check_branch_0_expand,
+};
+
+}
@@ -0,0 +1,200 @@
+#ifndef stream_H_
+#define stream_H_
+
+#include <derplanner/runtime/interface.h>
+
+namespace plnnr
+{
+	namespace tuple_list
+	{
+		struct handle;
+	}
+}
+
+namespace plnnr
+{
+	struct planner_state;
+	struct method_instance;
+	typedef bool (*expand_func)(method_instance*, planner_state&, void*);
+}
+
+namespace stream {
+
+enum atom_type
+{
+	atom_item,
+	atom_big,
+	atom_count,
+};
+
+const char* atom_name(atom_type type);
+
+struct worldstate
+{
+	plnnr::tuple_list::handle* atoms[atom_count];
+};
+
+struct item_tuple
+{
+	int _0;
+	item_tuple* next;
+	item_tuple* prev;
+	uint32_t slot;
+	enum { id = atom_item };
+};
+
+struct big_tuple
+{
+	int _0;
+	big_tuple* next;
+	big_tuple* prev;
+	uint32_t slot;
+	enum { id = atom_big };
+};
+
+}
+
+namespace stream {
+
+enum task_type
+{
+	task_a,
+	task_root,
+	task_prefix,
+	task_pick,
+	task_check,
+	task_count,
+};
+
+static const int operator_count = 1;
+static const int method_count = 4;
+
+const char* task_name(task_type type);
+
+struct a_args
+{
+	int _0;
+};
+
+inline bool operator==(const a_args& a, const a_args& b)
+{
+	return \
+		a._0 == b._0 ;
+}
+
+struct check_args
+{
+	int _0;
+};
+
+inline bool operator==(const check_args& a, const check_args& b)
+{
+	return \
+		a._0 == b._0 ;
+}
+
+bool root_branch_0_expand(plnnr::method_instance*, plnnr::planner_state&, void*);
+bool prefix_branch_0_expand(plnnr::method_instance*, plnnr::planner_state&, void*);
+bool pick_branch_0_expand(plnnr::method_instance*, plnnr::planner_state&, void*);
+bool check_branch_0_expand(plnnr::method_instance*, plnnr::planner_state&, void*);
+
+enum expand_index
+{
+	expand_root_branch_0 = 1,
+	expand_prefix_branch_0,
+	expand_pick_branch_0,
+	expand_check_branch_0,
+};
+
+extern const plnnr::expand_func expands[];
+
+}
+
+namespace plnnr {
+
+template <typename V>
+struct generated_type_reflector<stream::worldstate, V>
+{
+	void operator()(const stream::worldstate& world, V& visitor)
+	{
+		PLNNR_GENCODE_VISIT_ATOM_LIST(stream, atom_item, item_tuple, visitor);
+		PLNNR_GENCODE_VISIT_ATOM_LIST(stream, atom_big, big_tuple, visitor);
+	}
+};
+
+template <typename V>
+struct generated_type_reflector<stream::item_tuple, V>
+{
+	void operator()(const stream::item_tuple& tuple, V& visitor)
+	{
+		PLNNR_GENCODE_VISIT_TUPLE_BEGIN(visitor, stream, atom_name, atom_item, 1);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 0);
+		PLNNR_GENCODE_VISIT_TUPLE_END(visitor, stream, atom_name, atom_item, 1);
+	}
+};
+
+template <typename V>
+struct generated_type_reflector<stream::big_tuple, V>
+{
+	void operator()(const stream::big_tuple& tuple, V& visitor)
+	{
+		PLNNR_GENCODE_VISIT_TUPLE_BEGIN(visitor, stream, atom_name, atom_big, 1);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 0);
+		PLNNR_GENCODE_VISIT_TUPLE_END(visitor, stream, atom_name, atom_big, 1);
+	}
+};
+
+template <typename V>
+struct generated_type_reflector<stream::a_args, V>
+{
+	void operator()(const stream::a_args& tuple, V& visitor)
+	{
+		PLNNR_GENCODE_VISIT_TUPLE_BEGIN(visitor, stream, task_name, task_a, 1);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 0);
+		PLNNR_GENCODE_VISIT_TUPLE_END(visitor, stream, task_name, task_a, 1);
+	}
+};
+
+template <typename V>
+struct generated_type_reflector<stream::check_args, V>
+{
+	void operator()(const stream::check_args& tuple, V& visitor)
+	{
+		PLNNR_GENCODE_VISIT_TUPLE_BEGIN(visitor, stream, task_name, task_check, 1);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 0);
+		PLNNR_GENCODE_VISIT_TUPLE_END(visitor, stream, task_name, task_check, 1);
+	}
+};
+
+template <typename V>
+struct task_type_dispatcher<stream::task_type, V>
+{
+	void operator()(const stream::task_type& task_type, void* args, V& visitor)
+	{
+		switch (task_type)
+		{
+			case stream::task_root:
+				PLNNR_GENCODE_VISIT_TASK_NO_ARGS(visitor, stream, task_root);
+				break;
+			case stream::task_prefix:
+				PLNNR_GENCODE_VISIT_TASK_NO_ARGS(visitor, stream, task_prefix);
+				break;
+			case stream::task_pick:
+				PLNNR_GENCODE_VISIT_TASK_NO_ARGS(visitor, stream, task_pick);
+				break;
+			case stream::task_check:
+				PLNNR_GENCODE_VISIT_TASK_WITH_ARGS(visitor, stream, task_check, check_args);
+				break;
+			case stream::task_a:
+				PLNNR_GENCODE_VISIT_TASK_WITH_ARGS(visitor, stream, task_a, a_args);
+				break;
+			default:
+				plnnr_assert(false);
+				break;
+		}
+	}
+};
+
+}
+
+#endif
@@ -0,0 +1,267 @@
+#include <derplanner/runtime/runtime.h>
+#include "tail.h"
+
+using namespace plnnr;
+
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+
+namespace tail {
+
+static const char* atom_type_to_name[] =
+{
+	"fuel",
+	"next",
+	"<none>",
+};
+
+const char* atom_name(atom_type type) { return atom_type_to_name[type]; }
+
+}
+
+namespace tail {
+
+static const char* task_type_to_name[] =
+{
+	"!burn",
+	"!step",
+	"drain",
+	"walk",
+	"<none>",
+};
+
+const char* task_name(task_type type) { return task_type_to_name[type]; }
+
+// method drain [14:9]
+struct p0_state
+{
+	fuel_tuple* fuel_0;
+	int stage;
+};
+
+bool next(p0_state& state, worldstate& world)
+{
+	PLNNR_COROUTINE_BEGIN(state);
+
+	for (state.fuel_0 = tuple_list::head<fuel_tuple>(world.atoms[atom_fuel]); state.fuel_0 != 0; state.fuel_0 = state.fuel_0->next)
+	{
+		if (state.fuel_0->_0 == 1)
+		{
+			break;
+		}
+	}
+
+	if (state.fuel_0 == 0)
+	{
+		PLNNR_COROUTINE_YIELD(state, 1);
+	}
+
+	PLNNR_COROUTINE_END();
+}
+
+// method drain [17:9]
+struct p1_state
+{
+	fuel_tuple* fuel_0;
+	int stage;
+};
+
+bool next(p1_state& state, worldstate& world)
+{
+	PLNNR_COROUTINE_BEGIN(state);
+
+	for (state.fuel_0 = tuple_list::head<fuel_tuple>(world.atoms[atom_fuel]); state.fuel_0 != 0; state.fuel_0 = state.fuel_0->next)
+	{
+		if (state.fuel_0->_0 != 1)
+		{
+			continue;
+		}
+
+		PLNNR_COROUTINE_YIELD(state, 1);
+		break;
+	}
+
+	PLNNR_COROUTINE_END();
+}
+
+// method walk [22:9]
+struct p2_state
+{
+	next_tuple* next_0;
+	// x [22:16]
+	int _0;
+	// y [22:18]
+	int _1;
+	int stage;
+};
+
+bool next(p2_state& state, worldstate& world)
+{
+	PLNNR_COROUTINE_BEGIN(state);
+
+	for (state.next_0 = tuple_list::head<next_tuple>(world.atoms[atom_next]); state.next_0 != 0; state.next_0 = state.next_0->next)
+	{
+		if (state.next_0->_0 != state._0)
+		{
+			continue;
+		}
+
+		state._1 = state.next_0->_1;
+
+		PLNNR_COROUTINE_YIELD(state, 1);
+	}
+
+	PLNNR_COROUTINE_END();
+}
+
+// method walk [25:9]
+struct p3_state
+{
+	int stage;
+};
+
+bool next(p3_state& state, worldstate& world)
+{
+	PLNNR_COROUTINE_BEGIN(state);
+
+	PLNNR_COROUTINE_YIELD(state, 1);
+
+	PLNNR_COROUTINE_END();
+}
+
+plnnr_static_assert(sizeof(method_instance) + padded_size<p0_state>::value <= max_frame_size);
+
+bool drain_branch_0_expand(method_instance* method, planner_state& pstate, void* world)
+{
+	p0_state* precondition = plnnr::precondition<p0_state>(method);
+	worldstate* wstate = static_cast<worldstate*>(world);
+
+	PLNNR_COROUTINE_BEGIN(*method);
+
+	precondition = push_precondition<p0_state>(pstate, method);
+
+	while (next(*precondition, *wstate))
+	{
+		method->flags |= method_flags_expanded;
+		PLNNR_COROUTINE_YIELD(*method, 1);
+	}
+
+	return expand_next_branch(pstate, expand_drain_branch_1, world);
+	PLNNR_COROUTINE_END();
+}
+
+plnnr_static_assert(sizeof(method_instance) + padded_size<p1_state>::value <= max_frame_size);
+
+bool drain_branch_1_expand(method_instance* method, planner_state& pstate, void* world)
+{
+	p1_state* precondition = plnnr::precondition<p1_state>(method);
+	worldstate* wstate = static_cast<worldstate*>(world);
+
+	PLNNR_COROUTINE_BEGIN(*method);
+
+	method->flags |= method_flags_committed;
+	precondition = push_precondition<p1_state>(pstate, method);
+
+	while (next(*precondition, *wstate))
+	{
+		{
+			task_instance* t = push_task(pstate, task_burn, expand_none);
+
+			{
+				tuple_list::handle* list = wstate->atoms[atom_fuel];
+				operator_effect* effect = push<operator_effect>(pstate.journal);
+				effect->tuple = precondition->fuel_0->slot;
+				effect->atom = atom_fuel;
+				effect->kind = effect_delete;
+				tuple_list::detach(list, precondition->fuel_0);
+			}
+		}
+
+		PLNNR_COROUTINE_YIELD(*method, 1);
+
+		{
+			method_instance* t = push_tail_method(pstate, task_drain, expand_drain_branch_0);
+		}
+
+		return true;
+	}
+
+	PLNNR_COROUTINE_END();
+}
+
+plnnr_static_assert(sizeof(method_instance) + padded_size<walk_args>::value + padded_size<p2_state>::value <= max_frame_size);
+
+bool walk_branch_0_expand(method_instance* method, planner_state& pstate, void* world)
+{
+	p2_state* precondition = plnnr::precondition<p2_state>(method);
+	walk_args* method_args = plnnr::arguments<walk_args>(method);
+	worldstate* wstate = static_cast<worldstate*>(world);
+
+	PLNNR_COROUTINE_BEGIN(*method);
+
+	precondition = push_precondition<p2_state>(pstate, method);
+	precondition->_0 = method_args->_0;
+
+	while (next(*precondition, *wstate))
+	{
+		{
+			task_instance* t = push_task(pstate, task_step, expand_none);
+			step_args* a = push_arguments<step_args>(pstate, t);
+			a->_0 = precondition->_1;
+		}
+
+		PLNNR_COROUTINE_YIELD(*method, 1);
+
+		{
+			walk_args args;
+			args._0 = precondition->_1;
+			method_instance* t = push_tail_method(pstate, task_walk, expand_walk_branch_0);
+			walk_args* a = push_arguments<walk_args>(pstate, t);
+			*a = args;
+		}
+
+		if (prev_method(top_method(pstate)) != method)
+		{
+			return true;
+		}
+
+		method->flags |= method_flags_expanded;
+		PLNNR_COROUTINE_YIELD(*method, 2);
+	}
+
+	return expand_next_branch(pstate, expand_walk_branch_1, world);
+	PLNNR_COROUTINE_END();
+}
+
+plnnr_static_assert(sizeof(method_instance) + padded_size<walk_args>::value + padded_size<p3_state>::value <= max_frame_size);
+
+bool walk_branch_1_expand(method_instance* method, planner_state& pstate, void* world)
+{
+	p3_state* precondition = plnnr::precondition<p3_state>(method);
+	walk_args* method_args = plnnr::arguments<walk_args>(method);
+	worldstate* wstate = static_cast<worldstate*>(world);
+
+	PLNNR_COROUTINE_BEGIN(*method);
+
+	method->flags |= method_flags_committed;
+	precondition = push_precondition<p3_state>(pstate, method);
+
+	while (next(*precondition, *wstate))
+	{
+		method->flags |= method_flags_expanded;
+		PLNNR_COROUTINE_YIELD(*method, 1);
+	}
+
+	PLNNR_COROUTINE_END();
+}
+
+const expand_func expands[] =
+{
+	0,
+	drain_branch_0_expand,
+	drain_branch_1_expand,
+	walk_branch_0_expand,
+	walk_branch_1_expand,
+};
+
+}
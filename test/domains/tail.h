@@ -0,0 +1,198 @@
+#ifndef tail_H_
+#define tail_H_
+
+#include <derplanner/runtime/interface.h>
+
+namespace plnnr
+{
+	namespace tuple_list
+	{
+		struct handle;
+	}
+}
+
+namespace plnnr
+{
+	struct planner_state;
+	struct method_instance;
+	typedef bool (*expand_func)(method_instance*, planner_state&, void*);
+}
+
+namespace tail {
+
+enum atom_type
+{
+	atom_fuel,
+	atom_next,
+	atom_count,
+};
+
+const char* atom_name(atom_type type);
+
+struct worldstate
+{
+	plnnr::tuple_list::handle* atoms[atom_count];
+};
+
+struct fuel_tuple
+{
+	int _0;
+	fuel_tuple* next;
+	fuel_tuple* prev;
+	uint32_t slot;
+	enum { id = atom_fuel };
+};
+
+struct next_tuple
+{
+	int _0;
+	int _1;
+	next_tuple* next;
+	next_tuple* prev;
+	uint32_t slot;
+	enum { id = atom_next };
+};
+
+}
+
+namespace tail {
+
+enum task_type
+{
+	task_burn,
+	task_step,
+	task_drain,
+	task_walk,
+	task_count,
+};
+
+static const int operator_count = 2;
+static const int method_count = 2;
+
+const char* task_name(task_type type);
+
+struct step_args
+{
+	int _0;
+};
+
+inline bool operator==(const step_args& a, const step_args& b)
+{
+	return \
+		a._0 == b._0 ;
+}
+
+struct walk_args
+{
+	int _0;
+};
+
+inline bool operator==(const walk_args& a, const walk_args& b)
+{
+	return \
+		a._0 == b._0 ;
+}
+
+bool drain_branch_0_expand(plnnr::method_instance*, plnnr::planner_state&, void*);
+bool drain_branch_1_expand(plnnr::method_instance*, plnnr::planner_state&, void*);
+bool walk_branch_0_expand(plnnr::method_instance*, plnnr::planner_state&, void*);
+bool walk_branch_1_expand(plnnr::method_instance*, plnnr::planner_state&, void*);
+
+enum expand_index
+{
+	expand_drain_branch_0 = 1,
+	expand_drain_branch_1,
+	expand_walk_branch_0,
+	expand_walk_branch_1,
+};
+
+extern const plnnr::expand_func expands[];
+
+}
+
+namespace plnnr {
+
+template <typename V>
+struct generated_type_reflector<tail::worldstate, V>
+{
+	void operator()(const tail::worldstate& world, V& visitor)
+	{
+		PLNNR_GENCODE_VISIT_ATOM_LIST(tail, atom_fuel, fuel_tuple, visitor);
+		PLNNR_GENCODE_VISIT_ATOM_LIST(tail, atom_next, next_tuple, visitor);
+	}
+};
+
+template <typename V>
+struct generated_type_reflector<tail::fuel_tuple, V>
+{
+	void operator()(const tail::fuel_tuple& tuple, V& visitor)
+	{
+		PLNNR_GENCODE_VISIT_TUPLE_BEGIN(visitor, tail, atom_name, atom_fuel, 1);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 0);
+		PLNNR_GENCODE_VISIT_TUPLE_END(visitor, tail, atom_name, atom_fuel, 1);
+	}
+};
+
+template <typename V>
+struct generated_type_reflector<tail::next_tuple, V>
+{
+	void operator()(const tail::next_tuple& tuple, V& visitor)
+	{
+		PLNNR_GENCODE_VISIT_TUPLE_BEGIN(visitor, tail, atom_name, atom_next, 2);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 0);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 1);
+		PLNNR_GENCODE_VISIT_TUPLE_END(visitor, tail, atom_name, atom_next, 2);
+	}
+};
+
+template <typename V>
+struct generated_type_reflector<tail::step_args, V>
+{
+	void operator()(const tail::step_args& tuple, V& visitor)
+	{
+		PLNNR_GENCODE_VISIT_TUPLE_BEGIN(visitor, tail, task_name, task_step, 1);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 0);
+		PLNNR_GENCODE_VISIT_TUPLE_END(visitor, tail, task_name, task_step, 1);
+	}
+};
+
+template <typename V>
+struct generated_type_reflector<tail::walk_args, V>
+{
+	void operator()(const tail::walk_args& tuple, V& visitor)
+	{
+		PLNNR_GENCODE_VISIT_TUPLE_BEGIN(visitor, tail, task_name, task_walk, 1);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 0);
+		PLNNR_GENCODE_VISIT_TUPLE_END(visitor, tail, task_name, task_walk, 1);
+	}
+};
+
+template <typename V>
+struct task_type_dispatcher<tail::task_type, V>
+{
+	void operator()(const tail::task_type& task_type, void* args, V& visitor)
+	{
+		switch (task_type)
+		{
+			case tail::task_drain:
+				PLNNR_GENCODE_VISIT_TASK_NO_ARGS(visitor, tail, task_drain);
+				break;
+			case tail::task_walk:
+				PLNNR_GENCODE_VISIT_TASK_WITH_ARGS(visitor, tail, task_walk, walk_args);
+				break;
+			case tail::task_burn:
+				PLNNR_GENCODE_VISIT_TASK_NO_ARGS(visitor, tail, task_burn);
+				break;
+			case tail::task_step:
+				PLNNR_GENCODE_VISIT_TASK_WITH_ARGS(visitor, tail, task_step, step_args);
+				break;
+			default:
+				plnnr_assert(false);
+				break;
+		}
+	}
+};
+
+}
+
+#endif
@@ -0,0 +1,323 @@
+#include <derplanner/runtime/runtime.h>
+#include "trip.h"
+
+using namespace plnnr;
+
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+
+namespace trip {
+
+static const char* atom_type_to_name[] =
+{
+	"start",
+	"finish",
+	"road",
+	"open",
+	"at",
+	"<none>",
+};
+
+const char* atom_name(atom_type type) { return atom_type_to_name[type]; }
+
+}
+
+namespace trip {
+
+static const char* task_type_to_name[] =
+{
+	"!drive",
+	"root",
+	"leg",
+	"stop",
+	"<none>",
+};
+
+const char* task_name(task_type type) { return task_type_to_name[type]; }
+
+// method root [17:9]
+struct p0_state
+{
+	start_tuple* start_0;
+	finish_tuple* finish_1;
+	// s [17:17]
+	int _0;
+	// f [17:28]
+	int _1;
+	int stage;
+};
+
+bool next(p0_state& state, worldstate& world)
+{
+	PLNNR_COROUTINE_BEGIN(state);
+
+	for (state.start_0 = tuple_list::head<start_tuple>(world.atoms[atom_start]); state.start_0 != 0; state.start_0 = state.start_0->next)
+	{
+		state._0 = state.start_0->_0;
+
+		for (state.finish_1 = tuple_list::head<finish_tuple>(world.atoms[atom_finish]); state.finish_1 != 0; state.finish_1 = state.finish_1->next)
+		{
+			state._1 = state.finish_1->_0;
+
+			PLNNR_COROUTINE_YIELD(state, 1);
+		}
+	}
+
+	PLNNR_COROUTINE_END();
+}
+
+// method leg [22:9]
+struct p1_state
+{
+	road_tuple* road_0;
+	road_tuple* road_1;
+	// x [22:16]
+	int _0;
+	// m [22:18]
+	int _1;
+	// d1 [22:20]
+	int _2;
+	// y [22:32]
+	int _3;
+	// d2 [22:34]
+	int _4;
+	int stage;
+};
+
+bool next(p1_state& state, worldstate& world)
+{
+	PLNNR_COROUTINE_BEGIN(state);
+
+	for (state.road_0 = tuple_list::head<road_tuple>(world.atoms[atom_road]); state.road_0 != 0; state.road_0 = state.road_0->next)
+	{
+		if (state.road_0->_0 != state._0)
+		{
+			continue;
+		}
+
+		state._1 = state.road_0->_1;
+
+		state._2 = state.road_0->_2;
+
+		for (state.road_1 = tuple_list::head<road_tuple>(world.atoms[atom_road]); state.road_1 != 0; state.road_1 = state.road_1->next)
+		{
+			if (state.road_1->_0 != state._1)
+			{
+				continue;
+			}
+
+			if (state.road_1->_1 != state._3)
+			{
+				continue;
+			}
+
+			state._4 = state.road_1->_2;
+
+			PLNNR_COROUTINE_YIELD(state, 1);
+		}
+	}
+
+	PLNNR_COROUTINE_END();
+}
+
+// method stop [27:9]
+struct p2_state
+{
+	open_tuple* open_0;
+	// m [27:15]
+	int _0;
+	int stage;
+};
+
+bool next(p2_state& state, worldstate& world)
+{
+	PLNNR_COROUTINE_BEGIN(state);
+
+	for (state.open_0 = tuple_list::head<open_tuple>(world.atoms[atom_open]); state.open_0 != 0; state.open_0 = state.open_0->next)
+	{
+		if (state.open_0->_0 != state._0)
+		{
+			continue;
+		}
+
+		PLNNR_COROUTINE_YIELD(state, 1);
+		break;
+	}
+
+	PLNNR_COROUTINE_END();
+}
+
+plnnr_static_assert(sizeof(method_instance) + padded_size<p0_state>::value <= max_frame_size);
+
+bool root_branch_0_expand(method_instance* method, planner_state& pstate, void* world)
+{
+	p0_state* precondition = plnnr::precondition<p0_state>(method);
+	worldstate* wstate = static_cast<worldstate*>(world);
+
+	PLNNR_COROUTINE_BEGIN(*method);
+
+	precondition = push_precondition<p0_state>(pstate, method);
+
+	while (next(*precondition, *wstate))
+	{
+		{
+			method_instance* t = push_method(pstate, task_leg, expand_leg_branch_0);
+			leg_args* a = push_arguments<leg_args>(pstate, t);
+			a->_0 = precondition->_0;
+			a->_1 = precondition->_1;
+		}
+
+		method->flags |= method_flags_expanded;
+		PLNNR_COROUTINE_YIELD(*method, 1);
+	}
+
+	PLNNR_COROUTINE_END();
+}
+
+plnnr_static_assert(sizeof(method_instance) + padded_size<leg_args>::value + padded_size<p1_state>::value <= max_frame_size);
+
+bool leg_branch_0_expand(method_instance* method, planner_state& pstate, void* world)
+{
+	p1_state* precondition = plnnr::precondition<p1_state>(method);
+	leg_args* method_args = plnnr::arguments<leg_args>(method);
+	worldstate* wstate = static_cast<worldstate*>(world);
+
+	PLNNR_COROUTINE_BEGIN(*method);
+
+	precondition = push_precondition<p1_state>(pstate, method);
+	precondition->_0 = method_args->_0;
+	precondition->_3 = method_args->_1;
+
+	while (next(*precondition, *wstate))
+	{
+		{
+			task_instance* t = push_task(pstate, task_drive, expand_none);
+			drive_args* a = push_arguments<drive_args>(pstate, t);
+			a->_0 = method_args->_0;
+			a->_1 = precondition->_1;
+			a->_2 = precondition->_2;
+			add_cost(t, a->_2);
+
+			for (at_tuple* tuple = tuple_list::head<at_tuple>(wstate->atoms[atom_at]); tuple != 0; tuple = tuple->next)
+			{
+				if (tuple->_0 != a->_0)
+				{
+					continue;
+				}
+
+				tuple_list::handle* list = wstate->atoms[atom_at];
+				operator_effect* effect = push<operator_effect>(pstate.journal);
+				effect->tuple = tuple->slot;
+				effect->atom = atom_at;
+				effect->kind = effect_delete;
+				tuple_list::detach(list, tuple);
+
+				break;
+			}
+
+			{
+				tuple_list::handle* list = wstate->atoms[atom_at];
+				at_tuple* tuple = tuple_list::append<at_tuple>(list);
+				tuple->_0 = a->_1;
+				operator_effect* effect = push<operator_effect>(pstate.journal);
+				effect->tuple = tuple->slot;
+				effect->atom = atom_at;
+				effect->kind = effect_add;
+			}
+		}
+
+		PLNNR_COROUTINE_YIELD(*method, 1);
+
+		if (method->flags & method_flags_failed)
+		{
+			continue;
+		}
+
+		{
+			method_instance* t = push_method(pstate, task_stop, expand_stop_branch_0);
+			stop_args* a = push_arguments<stop_args>(pstate, t);
+			a->_0 = precondition->_1;
+		}
+
+		PLNNR_COROUTINE_YIELD(*method, 2);
+
+		if (method->flags & method_flags_failed)
+		{
+			continue;
+		}
+
+		{
+			task_instance* t = push_task(pstate, task_drive, expand_none);
+			drive_args* a = push_arguments<drive_args>(pstate, t);
+			a->_0 = precondition->_1;
+			a->_1 = method_args->_1;
+			a->_2 = precondition->_4;
+			add_cost(t, a->_2);
+
+			for (at_tuple* tuple = tuple_list::head<at_tuple>(wstate->atoms[atom_at]); tuple != 0; tuple = tuple->next)
+			{
+				if (tuple->_0 != a->_0)
+				{
+					continue;
+				}
+
+				tuple_list::handle* list = wstate->atoms[atom_at];
+				operator_effect* effect = push<operator_effect>(pstate.journal);
+				effect->tuple = tuple->slot;
+				effect->atom = atom_at;
+				effect->kind = effect_delete;
+				tuple_list::detach(list, tuple);
+
+				break;
+			}
+
+			{
+				tuple_list::handle* list = wstate->atoms[atom_at];
+				at_tuple* tuple = tuple_list::append<at_tuple>(list);
+				tuple->_0 = a->_1;
+				operator_effect* effect = push<operator_effect>(pstate.journal);
+				effect->tuple = tuple->slot;
+				effect->atom = atom_at;
+				effect->kind = effect_add;
+			}
+		}
+
+		method->flags |= method_flags_expanded;
+		PLNNR_COROUTINE_YIELD(*method, 3);
+	}
+
+	PLNNR_COROUTINE_END();
+}
+
+plnnr_static_assert(sizeof(method_instance) + padded_size<stop_args>::value + padded_size<p2_state>::value <= max_frame_size);
+
+bool stop_branch_0_expand(method_instance* method, planner_state& pstate, void* world)
+{
+	p2_state* precondition = plnnr::precondition<p2_state>(method);
+	stop_args* method_args = plnnr::arguments<stop_args>(method);
+	worldstate* wstate = static_cast<worldstate*>(world);
+
+	PLNNR_COROUTINE_BEGIN(*method);
+
+	method->flags |= method_flags_committed;
+	precondition = push_precondition<p2_state>(pstate, method);
+	precondition->_0 = method_args->_0;
+
+	while (next(*precondition, *wstate))
+	{
+		method->flags |= method_flags_expanded;
+		PLNNR_COROUTINE_YIELD(*method, 1);
+	}
+
+	PLNNR_COROUTINE_END();
+}
+
+const expand_func expands[] =
+{
+	0,
+	root_branch_0_expand,
+	leg_branch_0_expand,
+	stop_branch_0_expand,
+};
+
+}
@@ -0,0 +1,295 @@
+#ifndef trip_H_
+#define trip_H_
+
+#include <derplanner/runtime/interface.h>
+
+namespace plnnr
+{
+	namespace tuple_list
+	{
+		struct handle;
+	}
+}
+
+namespace plnnr
+{
+	struct planner_state;
+	struct method_instance;
+	typedef bool (*expand_func)(method_instance*, planner_state&, void*);
+}
+
+namespace trip {
+
+enum atom_type
+{
+	atom_start,
+	atom_finish,
+	atom_road,
+	atom_open,
+	atom_at,
+	atom_count,
+};
+
+const char* atom_name(atom_type type);
+
+struct worldstate
+{
+	plnnr::tuple_list::handle* atoms[atom_count];
+};
+
+struct start_tuple
+{
+	int _0;
+	start_tuple* next;
+	start_tuple* prev;
+	uint32_t slot;
+	enum { id = atom_start };
+};
+
+struct finish_tuple
+{
+	int _0;
+	finish_tuple* next;
+	finish_tuple* prev;
+	uint32_t slot;
+	enum { id = atom_finish };
+};
+
+struct road_tuple
+{
+	int _0;
+	int _1;
+	int _2;
+	road_tuple* next;
+	road_tuple* prev;
+	uint32_t slot;
+	enum { id = atom_road };
+};
+
+struct open_tuple
+{
+	int _0;
+	open_tuple* next;
+	open_tuple* prev;
+	uint32_t slot;
+	enum { id = atom_open };
+};
+
+struct at_tuple
+{
+	int _0;
+	at_tuple* next;
+	at_tuple* prev;
+	uint32_t slot;
+	enum { id = atom_at };
+};
+
+}
+
+namespace trip {
+
+enum task_type
+{
+	task_drive,
+	task_root,
+	task_leg,
+	task_stop,
+	task_count,
+};
+
+static const int operator_count = 1;
+static const int method_count = 3;
+
+const char* task_name(task_type type);
+
+struct drive_args
+{
+	int _0;
+	int _1;
+	int _2;
+};
+
+inline bool operator==(const drive_args& a, const drive_args& b)
+{
+	return \
+		a._0 == b._0 &&
+		a._1 == b._1 &&
+		a._2 == b._2 ;
+}
+
+struct leg_args
+{
+	int _0;
+	int _1;
+};
+
+inline bool operator==(const leg_args& a, const leg_args& b)
+{
+	return \
+		a._0 == b._0 &&
+		a._1 == b._1 ;
+}
+
+struct stop_args
+{
+	int _0;
+};
+
+inline bool operator==(const stop_args& a, const stop_args& b)
+{
+	return \
+		a._0 == b._0 ;
+}
+
+bool root_branch_0_expand(plnnr::method_instance*, plnnr::planner_state&, void*);
+bool leg_branch_0_expand(plnnr::method_instance*, plnnr::planner_state&, void*);
+bool stop_branch_0_expand(plnnr::method_instance*, plnnr::planner_state&, void*);
+
+enum expand_index
+{
+	expand_root_branch_0 = 1,
+	expand_leg_branch_0,
+	expand_stop_branch_0,
+};
+
+extern const plnnr::expand_func expands[];
+
+}
+
+namespace plnnr {
+
+template <typename V>
+struct generated_type_reflector<trip::worldstate, V>
+{
+	void operator()(const trip::worldstate& world, V& visitor)
+	{
+		PLNNR_GENCODE_VISIT_ATOM_LIST(trip, atom_start, start_tuple, visitor);
+		PLNNR_GENCODE_VISIT_ATOM_LIST(trip, atom_finish, finish_tuple, visitor);
+		PLNNR_GENCODE_VISIT_ATOM_LIST(trip, atom_road, road_tuple, visitor);
+		PLNNR_GENCODE_VISIT_ATOM_LIST(trip, atom_open, open_tuple, visitor);
+		PLNNR_GENCODE_VISIT_ATOM_LIST(trip, atom_at, at_tuple, visitor);
+	}
+};
+
+template <typename V>
+struct generated_type_reflector<trip::start_tuple, V>
+{
+	void operator()(const trip::start_tuple& tuple, V& visitor)
+	{
+		PLNNR_GENCODE_VISIT_TUPLE_BEGIN(visitor, trip, atom_name, atom_start, 1);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 0);
+		PLNNR_GENCODE_VISIT_TUPLE_END(visitor, trip, atom_name, atom_start, 1);
+	}
+};
+
+template <typename V>
+struct generated_type_reflector<trip::finish_tuple, V>
+{
+	void operator()(const trip::finish_tuple& tuple, V& visitor)
+	{
+		PLNNR_GENCODE_VISIT_TUPLE_BEGIN(visitor, trip, atom_name, atom_finish, 1);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 0);
+		PLNNR_GENCODE_VISIT_TUPLE_END(visitor, trip, atom_name, atom_finish, 1);
+	}
+};
+
+template <typename V>
+struct generated_type_reflector<trip::road_tuple, V>
+{
+	void operator()(const trip::road_tuple& tuple, V& visitor)
+	{
+		PLNNR_GENCODE_VISIT_TUPLE_BEGIN(visitor, trip, atom_name, atom_road, 3);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 0);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 1);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 2);
+		PLNNR_GENCODE_VISIT_TUPLE_END(visitor, trip, atom_name, atom_road, 3);
+	}
+};
+
+template <typename V>
+struct generated_type_reflector<trip::open_tuple, V>
+{
+	void operator()(const trip::open_tuple& tuple, V& visitor)
+	{
+		PLNNR_GENCODE_VISIT_TUPLE_BEGIN(visitor, trip, atom_name, atom_open, 1);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 0);
+		PLNNR_GENCODE_VISIT_TUPLE_END(visitor, trip, atom_name, atom_open, 1);
+	}
+};
+
+template <typename V>
+struct generated_type_reflector<trip::at_tuple, V>
+{
+	void operator()(const trip::at_tuple& tuple, V& visitor)
+	{
+		PLNNR_GENCODE_VISIT_TUPLE_BEGIN(visitor, trip, atom_name, atom_at, 1);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 0);
+		PLNNR_GENCODE_VISIT_TUPLE_END(visitor, trip, atom_name, atom_at, 1);
+	}
+};
+
+template <typename V>
+struct generated_type_reflector<trip::drive_args, V>
+{
+	void operator()(const trip::drive_args& tuple, V& visitor)
+	{
+		PLNNR_GENCODE_VISIT_TUPLE_BEGIN(visitor, trip, task_name, task_drive, 3);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 0);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 1);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 2);
+		PLNNR_GENCODE_VISIT_TUPLE_END(visitor, trip, task_name, task_drive, 3);
+	}
+};
+
+template <typename V>
+struct generated_type_reflector<trip::leg_args, V>
+{
+	void operator()(const trip::leg_args& tuple, V& visitor)
+	{
+		PLNNR_GENCODE_VISIT_TUPLE_BEGIN(visitor, trip, task_name, task_leg, 2);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 0);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 1);
+		PLNNR_GENCODE_VISIT_TUPLE_END(visitor, trip, task_name, task_leg, 2);
+	}
+};
+
+template <typename V>
+struct generated_type_reflector<trip::stop_args, V>
+{
+	void operator()(const trip::stop_args& tuple, V& visitor)
+	{
+		PLNNR_GENCODE_VISIT_TUPLE_BEGIN(visitor, trip, task_name, task_stop, 1);
+		PLNNR_GENCODE_VISIT_TUPLE_ELEMENT(visitor, tuple, 0);
+		PLNNR_GENCODE_VISIT_TUPLE_END(visitor, trip, task_name, task_stop, 1);
+	}
+};
+
+template <typename V>
+struct task_type_dispatcher<trip::task_type, V>
+{
+	void operator()(const trip::task_type& task_type, void* args, V& visitor)
+	{
+		switch (task_type)
+		{
+			case trip::task_root:
+				PLNNR_GENCODE_VISIT_TASK_NO_ARGS(visitor, trip, task_root);
+				break;
+			case trip::task_leg:
+				PLNNR_GENCODE_VISIT_TASK_WITH_ARGS(visitor, trip, task_leg, leg_args);
+				break;
+			case trip::task_stop:
+				PLNNR_GENCODE_VISIT_TASK_WITH_ARGS(visitor, trip, task_stop, stop_args);
+				break;
+			case trip::task_drive:
+				PLNNR_GENCODE_VISIT_TASK_WITH_ARGS(visitor, trip, task_drive, drive_args);
+				break;
+			default:
+				plnnr_assert(false);
+				break;
+		}
+	}
+};
+
+}
+
+#endif
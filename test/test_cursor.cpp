@@ -0,0 +1,159 @@
+//
+// Copyright (c) 2013 Alexander Shafranov shafranov@gmail.com
+//
+// This software is provided 'as-is', without any express or implied
+// warranty.  In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software. If you use this software
+// in a product, an acknowledgment in the product documentation would be
+// appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+
+#include <string.h>
+#include <unittestpp.h>
+#include <derplanner/runtime/runtime.h>
+#include "domains/cursor.h"
+
+using namespace plnnr;
+
+namespace
+{
+    // 1 links to 2, 3, 4 and 5, all of them have tokens. pages of two tuples, so slots span several pages.
+    struct cursor_world
+    {
+        cursor::worldstate data;
+
+        cursor_world()
+        {
+            memset(&data, 0, sizeof(data));
+            data.atoms[cursor::atom_link] = tuple_list::create<cursor::link_tuple>(2);
+            data.atoms[cursor::atom_token] = tuple_list::create<cursor::token_tuple>(2);
+            data.atoms[cursor::atom_blocked] = tuple_list::create<cursor::blocked_tuple>(2);
+            data.atoms[cursor::atom_goal] = tuple_list::create<cursor::goal_tuple>(2);
+
+            for (int i = 2; i <= 5; ++i)
+            {
+                cursor::link_tuple* link = tuple_list::append<cursor::link_tuple>(data.atoms[cursor::atom_link]);
+                link->_0 = 1;
+                link->_1 = i;
+                tuple_list::append<cursor::token_tuple>(data.atoms[cursor::atom_token])->_0 = i;
+            }
+        }
+
+        ~cursor_world()
+        {
+            for (int i = 0; i < cursor::atom_count; ++i)
+            {
+                tuple_list::destroy(data.atoms[i]);
+            }
+        }
+
+        void blocked(int y)
+        {
+            tuple_list::append<cursor::blocked_tuple>(data.atoms[cursor::atom_blocked])->_0 = y;
+        }
+
+        void goal(int y)
+        {
+            tuple_list::append<cursor::goal_tuple>(data.atoms[cursor::atom_goal])->_0 = y;
+        }
+    };
+
+    struct cursor_planner
+    {
+        stack methods;
+        stack tasks;
+        stack journal;
+        planner_state pstate;
+
+        cursor_planner()
+            : methods(4096)
+            , tasks(4096)
+            , journal(4096)
+        {
+            memset(&pstate, 0, sizeof(pstate));
+            pstate.methods = &methods;
+            pstate.tasks = &tasks;
+            pstate.journal = &journal;
+            pstate.expands = cursor::expands;
+        }
+    };
+
+    // argument of the single `!take` of the plan, -1 if the plan is different.
+    int taken(const planner_state& pstate)
+    {
+        task_instance* task = top_task(pstate);
+
+        if (!task || prev_task(task) || task->type != cursor::task_take)
+        {
+            return -1;
+        }
+
+        return static_cast<cursor::take_args*>(arguments(task))->_0;
+    }
+
+    void init_pick(planner_state& pstate)
+    {
+        cursor::pick_args from = { 1 };
+        find_plan_init(pstate, cursor::task_pick, cursor::expand_pick_branch_0);
+        *push_arguments<cursor::pick_args>(pstate, top_method(pstate)) = from;
+    }
+
+    // the precondition resumes from the slots it saved after each `(accept y)` failure and the undone `!take`.
+    TEST(slot_cursors_resume_after_failure)
+    {
+        cursor_world world;
+        world.blocked(3);
+        world.goal(5);
+
+        cursor_planner planner;
+        init_pick(planner.pstate);
+
+        find_plan_status status;
+
+        while ((status = find_plan_step(planner.pstate, &world.data)) == plan_in_progress)
+        {
+        }
+
+        CHECK_EQUAL(plan_found, status);
+        CHECK_EQUAL(5, taken(planner.pstate));
+        CHECK_EQUAL(3u, tuple_list::size(world.data.atoms[cursor::atom_token]));
+
+        undo_effects(planner.pstate.journal, &world.data);
+        CHECK_EQUAL(4u, tuple_list::size(world.data.atoms[cursor::atom_token]));
+    }
+
+    // each plan deletes the token found through the slot kept in the precondition, enumeration restores all of them.
+    TEST(slot_cursors_enumeration)
+    {
+        cursor_world world;
+        world.goal(2);
+        world.goal(4);
+
+        cursor_planner planner;
+        init_pick(planner.pstate);
+
+        const int expected[] = { 2, 4 };
+        int num_plans = 0;
+
+        while (find_next_plan(planner.pstate, &world.data) == plan_found)
+        {
+            CHECK(num_plans < 2);
+            CHECK_EQUAL(expected[num_plans < 2 ? num_plans : 0], taken(planner.pstate));
+            CHECK_EQUAL(3u, tuple_list::size(world.data.atoms[cursor::atom_token]));
+            ++num_plans;
+        }
+
+        CHECK_EQUAL(2, num_plans);
+        CHECK_EQUAL(4u, tuple_list::size(world.data.atoms[cursor::atom_token]));
+    }
+}
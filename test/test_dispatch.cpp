@@ -0,0 +1,156 @@
+//
+// Copyright (c) 2013 Alexander Shafranov shafranov@gmail.com
+//
+// This software is provided 'as-is', without any express or implied
+// warranty.  In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software. If you use this software
+// in a product, an acknowledgment in the product documentation would be
+// appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+
+
+#include <string.h>
+#include <unittestpp.h>
+#include <derplanner/runtime/runtime.h>
+#include "domains/dispatch.h"
+
+using namespace plnnr;
+
+namespace
+{
+    // candidates 1, 2 and 3, tests add more and mark the good ones.
+    struct dispatch_world
+    {
+        dispatch::worldstate data;
+
+        dispatch_world()
+        {
+            memset(&data, 0, sizeof(data));
+            data.atoms[dispatch::atom_cand] = tuple_list::create<dispatch::cand_tuple>(16);
+            data.atoms[dispatch::atom_good] = tuple_list::create<dispatch::good_tuple>(16);
+
+            for (int i = 1; i <= 3; ++i)
+            {
+                cand(i);
+            }
+        }
+
+        ~dispatch_world()
+        {
+            tuple_list::destroy(data.atoms[dispatch::atom_cand]);
+            tuple_list::destroy(data.atoms[dispatch::atom_good]);
+        }
+
+        void cand(int x)
+        {
+            tuple_list::append<dispatch::cand_tuple>(data.atoms[dispatch::atom_cand])->_0 = x;
+        }
+
+        void good(int x)
+        {
+            tuple_list::append<dispatch::good_tuple>(data.atoms[dispatch::atom_good])->_0 = x;
+        }
+    };
+
+    struct dispatch_planner
+    {
+        stack methods;
+        stack tasks;
+        stack journal;
+        planner_state pstate;
+
+        dispatch_planner()
+            : methods(4096)
+            , tasks(4096)
+            , journal(4096)
+        {
+            memset(&pstate, 0, sizeof(pstate));
+            pstate.methods = &methods;
+            pstate.tasks = &tasks;
+            pstate.journal = &journal;
+            pstate.expands = dispatch::expands;
+        }
+    };
+
+    // argument of the single `!pick` of the plan, -1 if the plan is different.
+    int picked(const planner_state& pstate)
+    {
+        task_instance* task = top_task(pstate);
+
+        if (!task || prev_task(task) || task->type != dispatch::task_pick)
+        {
+            return -1;
+        }
+
+        return static_cast<dispatch::pick_args*>(arguments(task))->_0;
+    }
+
+    find_plan_status run_step(planner_state& pstate, void* world)
+    {
+        find_plan_init(pstate, dispatch::task_choose, dispatch::expand_choose_branch_0);
+
+        find_plan_status status;
+
+        while ((status = dispatch::step(pstate, world)) == plan_in_progress)
+        {
+        }
+
+        return status;
+    }
+
+    // branch 0 finds no binding, the jump to branch 1 retries its bindings after (check x) fails.
+    TEST(single_dispatch_next_branch)
+    {
+        dispatch_world world;
+        world.good(3);
+
+        dispatch_planner planner;
+        CHECK_EQUAL(plan_found, run_step(planner.pstate, &world.data));
+        CHECK_EQUAL(3, picked(planner.pstate));
+    }
+
+    // every binding of branch 1 fails, branch 2 is reached through two jumps.
+    TEST(single_dispatch_last_branch)
+    {
+        dispatch_world world;
+
+        dispatch_planner planner;
+        CHECK_EQUAL(plan_found, run_step(planner.pstate, &world.data));
+        CHECK_EQUAL(0, picked(planner.pstate));
+    }
+
+    // the expand table points at the same function, so the runtime search functions work too.
+    TEST(single_dispatch_enumeration)
+    {
+        dispatch_world world;
+        world.cand(7);
+        world.good(3);
+        world.good(7);
+
+        dispatch_planner planner;
+        find_plan_init(planner.pstate, dispatch::task_choose, dispatch::expand_choose_branch_0);
+
+        // 7 from branch 0, then 3 and 7 from branch 1 and 0 from branch 2.
+        const int expected[] = { 7, 3, 7, 0 };
+        int num_plans = 0;
+
+        while (find_next_plan(planner.pstate, &world.data) == plan_found)
+        {
+            CHECK(num_plans < 4);
+            CHECK_EQUAL(expected[num_plans < 4 ? num_plans : 0], picked(planner.pstate));
+            ++num_plans;
+        }
+
+        CHECK_EQUAL(4, num_plans);
+    }
+}
@@ -28,6 +28,8 @@
 #include "compiler/ast_domain.h"
 #include "compiler/ast_worldstate.h"
 #include "compiler/ast_infer.h"
+#include "compiler/ast_tools.h"
+#include <derplanner/compiler/ast_build.h>
 
 using namespace plnnrc;
 
@@ -145,6 +147,46 @@ namespace
         CHECK_EQUAL(expected, actual_str.c_str());
     }
 
+    TEST(sorted_branch_ast_structure)
+    {
+        char buffer[] = \
+"(:domain (test)                  "
+"    (:method (closest ?t)        "
+"        (:sort-by (dist ?t ?x)   "
+"            ((item ?x))          "
+"            ((!take ?x)))        "
+"    )                            "
+")                                ";
+
+        sexpr::tree expr;
+        expr.parse(buffer);
+        ast::tree tree;
+        ast::node* actual_tree = ast::build_domain(tree, expr.root()->first_child);
+        CHECK(actual_tree);
+        std::string actual_str = to_string(actual_tree);
+
+        const char* expected = \
+"node_domain\n"
+"    node_namespace (test)\n"
+"    node_method\n"
+"        node_atom closest\n"
+"            node_term_variable ?t\n"
+"        node_branch\n"
+"            node_op_or\n"
+"                node_op_and\n"
+"                    node_atom item\n"
+"                        node_term_variable ?x\n"
+"            node_task_list\n"
+"                node_atom !take\n"
+"                    node_term_variable ?x\n"
+"            node_sort_by\n"
+"                node_term_call dist\n"
+"                    node_term_variable ?t\n"
+"                    node_term_variable ?x";
+
+        CHECK_EQUAL(expected, actual_str.c_str());
+    }
+
     TEST(declared_operator)
     {
         char buffer[] = \
@@ -304,6 +346,7 @@ namespace
         char buffer[] = \
 "(:worldstate (test)                                    "
 "   (:function (function_name (int) (double)) -> (int)) "
+"   (:function (pure_function (int)) -> (int) :pure)    "
 ")                                                      ";
 
         sexpr::tree expr;
@@ -321,6 +364,10 @@ namespace
 "        node_atom function_name\n"
 "            node_worldstate_type (int)\n"
 "            node_worldstate_type (double)\n"
+"        node_worldstate_type (int)\n"
+"    node_function\n"
+"        node_atom pure_function\n"
+"            node_worldstate_type (int)\n"
 "        node_worldstate_type (int)";
 
         CHECK_EQUAL(expected, actual_str.c_str());
@@ -335,6 +382,10 @@ namespace
 
         CHECK_EQUAL(0u, tree.ws_atoms.count());
         CHECK(tree.ws_funcs.find("function_name") != 0);
+        CHECK(!ast::annotation<ast::func_ann>(tree.ws_funcs.find("function_name"))->pure);
+
+        CHECK(tree.ws_funcs.find("pure_function") != 0);
+        CHECK(ast::annotation<ast::func_ann>(tree.ws_funcs.find("pure_function"))->pure);
     }
 
     TEST(worldstate_atom_table)
@@ -442,4 +493,197 @@ namespace
         CHECK_EQUAL(type1, ast::annotation<ast::term_ann>(m2_u)->type_tag);
         CHECK_EQUAL(type2, ast::annotation<ast::term_ann>(m2_v)->type_tag);
     }
+
+    TEST(constant_type_inference)
+    {
+        char buffer[] = \
+"(:worldstate (test)            "
+"    (a (int) (float))          "
+")                              "
+"                               "
+"(:domain (test)                "
+"   (:operator (!o u v))        "
+"                               "
+"   (:method (m)                "
+"       ((a x 0.5))             "
+"       ((!o x 3))              "
+"   )                           "
+")                              ";
+
+        sexpr::tree expr;
+        expr.parse(buffer);
+        ast::tree tree;
+        ast::build_translation_unit(tree, expr.root());
+        CHECK(!tree.error_node_cache.size());
+
+        const int type_int = 1;
+        const int type_float = 2;
+
+        ast::node* precondition = tree.methods.find("m")->first_child->next_sibling->first_child;
+        ast::node* a_0_5 = precondition->first_child->first_child->first_child->next_sibling;
+        ast::node* o_v = tree.operators.find("!o")->first_child->first_child->next_sibling;
+
+        CHECK_EQUAL(type_float, ast::annotation<ast::term_ann>(a_0_5)->type_tag);
+        CHECK_EQUAL(type_int, ast::annotation<ast::term_ann>(o_v)->type_tag);
+    }
+
+    TEST(method_inlining)
+    {
+        char buffer[] = \
+"(:worldstate (test)                "
+"    (a (int))                      "
+")                                  "
+"(:domain (test)                    "
+"    (:method (root)                "
+"        ((a x))                    "
+"        ((m1 x) (loop x))          "
+"    )                              "
+"    (:method (m1 u)                "
+"        ()                         "
+"        ((!op u) (m2 u))           "
+"    )                              "
+"    (:method (m2 v)                "
+"        ()                         "
+"        ((:add (a v)))             "
+"    )                              "
+"    (:method (loop w)              "
+"        ()                         "
+"        ((loop w))                 "
+"    )                              "
+")                                  ";
+
+        sexpr::tree expr;
+        expr.parse(buffer);
+        ast::tree tree;
+        ast::build_translation_unit(tree, expr.root());
+        CHECK(!tree.error_node_cache.size());
+
+        CHECK_EQUAL(3u, ast::inline_methods(tree, 8));
+
+        ast::node* root_tasks = tree.methods.find("root")->first_child->next_sibling->first_child->next_sibling;
+
+        const char* expected = \
+"node_task_list\n"
+"    node_task_list\n"
+"        node_atom !op\n"
+"            node_term_variable x\n"
+"        node_task_list\n"
+"            node_add_list\n"
+"                node_atom a\n"
+"                    node_term_variable x\n"
+"    node_atom loop\n"
+"        node_term_variable x";
+
+        CHECK_EQUAL(expected, to_string(root_tasks).c_str());
+
+        // substituted variables are bound to the precondition variable of the caller.
+        ast::node* precondition_x = tree.methods.find("root")->first_child->next_sibling->first_child->first_child->first_child->first_child;
+        ast::node* op_x = ast::first_task(root_tasks)->first_child;
+        ast::node* add_x = ast::next_task(root_tasks, ast::first_task(root_tasks))->first_child->first_child;
+
+        CHECK_EQUAL(precondition_x, ast::definition(op_x));
+        CHECK_EQUAL(precondition_x, ast::definition(add_x));
+    }
+
+    TEST(literal_reordering)
+    {
+        char buffer[] = \
+"(:worldstate (test)                "
+"    (a (int) :size 100)            "
+"    (b (int) (int))                "
+"    (c (int) :size 4)              "
+")                                  "
+"(:domain (test)                    "
+"    (:method (root)                "
+"        ((a x) (c y) (b x y) (< x 3))"
+"        ((!op x y))                "
+"    )                              "
+")                                  ";
+
+        sexpr::tree expr;
+        expr.parse(buffer);
+        ast::tree tree;
+        ast::build_translation_unit(tree, expr.root());
+        CHECK(!tree.error_node_cache.size());
+
+        CHECK_EQUAL(1u, ast::reorder_literals(tree));
+
+        ast::node* precondition = tree.methods.find("root")->first_child->next_sibling->first_child;
+
+        const char* expected = \
+"node_op_or\n"
+"    node_op_and\n"
+"        node_atom c\n"
+"            node_term_variable y\n"
+"        node_atom b\n"
+"            node_term_variable x\n"
+"            node_term_variable y\n"
+"        node_op_lt\n"
+"            node_term_variable x\n"
+"            node_term_int 3\n"
+"        node_atom a\n"
+"            node_term_variable x";
+
+        CHECK_EQUAL(expected, to_string(precondition).c_str());
+
+        // variables are relinked to their new first occurrence.
+        ast::node* c_y = precondition->first_child->first_child->first_child;
+        ast::node* b_x = c_y->parent->next_sibling->first_child;
+        ast::node* op_x = precondition->next_sibling->first_child->first_child;
+
+        CHECK(!ast::definition(b_x));
+        CHECK_EQUAL(b_x, ast::definition(op_x));
+        CHECK_EQUAL(0, ast::annotation<ast::term_ann>(c_y)->var_index);
+        CHECK_EQUAL(1, ast::annotation<ast::term_ann>(b_x)->var_index);
+        CHECK_EQUAL(0, ast::annotation<ast::atom_ann>(c_y->parent)->index);
+    }
+
+    TEST(static_atoms)
+    {
+        char buffer[] = \
+"(:worldstate (test)                "
+"    (a (int))                      "
+"    (b (int) (int))                "
+"    (c (int) (int))                "
+"    (d (int))                      "
+")                                  "
+"(:domain (test)                    "
+"    (:operator (!op x)             "
+"        (:add (d x))               "
+"    )                              "
+"    (:method (root)                "
+"        ((a x) (b y x) (c x y))    "
+"        ((!op x) (:add (a y)))     "
+"    )                              "
+")                                  ";
+
+        sexpr::tree expr;
+        expr.parse(buffer);
+        ast::tree tree;
+        ast::build_translation_unit(tree, expr.root());
+        CHECK(!tree.error_node_cache.size());
+
+        CHECK_EQUAL(2u, ast::find_static_atoms(tree));
+
+        ast::atom_ann* a = ast::annotation<ast::atom_ann>(tree.ws_atoms.find("a"));
+        ast::atom_ann* b = ast::annotation<ast::atom_ann>(tree.ws_atoms.find("b"));
+        ast::atom_ann* c = ast::annotation<ast::atom_ann>(tree.ws_atoms.find("c"));
+        ast::atom_ann* d = ast::annotation<ast::atom_ann>(tree.ws_atoms.find("d"));
+
+        // modified by an effect inside a task list.
+        CHECK(a->modified);
+        CHECK(!a->indexed);
+
+        // modified by an operator.
+        CHECK(d->modified);
+        CHECK(!d->indexed);
+
+        // static, keyed by the argument bound before the atom is visited.
+        CHECK(b->indexed);
+        CHECK_EQUAL(1, b->index_key);
+
+        // both arguments are bound, the first one wins.
+        CHECK(c->indexed);
+        CHECK_EQUAL(0, c->index_key);
+    }
 }
@@ -18,6 +18,8 @@
 // 3. This notice may not be removed or altered from any source distribution.
 //
 
+#include <stdio.h>
+#include <string.h>
 #include <unittestpp.h>
 #include <derplanner/compiler/errors.h>
 #include "test_errors.h"
@@ -62,4 +64,48 @@ namespace
     TEST(_32) { check_error("(:domain (d) (:method (m) () ((!t\nx))))", error_unbound_var, 2, 1); }
     TEST(_33) { check_error("(:worldstate (w) (:function (f (t))->(b))) (:domain (d) (:method (m)\n((f u)) ()))", error_unbound_var, 2, 5); }
     TEST(_34) { check_error("(:domain (d) (:method (m)\n((== u u)) ()))", error_unbound_var, 2, 6); }
+
+    // 65536 operators don't fit 16-bit task types.
+    TEST(_35)
+    {
+        const int count = 65536;
+        char* code = new char[count * 24 + 32];
+        char* cursor = code + sprintf(code, "(:domain (t)");
+
+        for (int i = 0; i < count; ++i)
+        {
+            cursor += sprintf(cursor, " (:operator (o%d))", i);
+        }
+
+        strcpy(cursor, ")");
+        check_error(code, error_limit_exceeded, 1, 1);
+        delete [] code;
+    }
+
+    // 65535 branches and the reserved index 0 don't fit 16-bit expand indices.
+    TEST(_36)
+    {
+        const int count = 65535;
+        char* code = new char[count * 8 + 32];
+        char* cursor = code + sprintf(code, "(:domain (t) (:method (m)");
+
+        for (int i = 0; i < count; ++i)
+        {
+            cursor += sprintf(cursor, " () ()");
+        }
+
+        strcpy(cursor, "))");
+        check_error(code, error_limit_exceeded, 1, 1);
+        delete [] code;
+    }
+
+    TEST(_37) { check_error("(:domain (t) (:operator (o) (:cost 1)\n(:cost 2)))", error_multiple_definitions, 2, 1); }
+    TEST(_38) { check_error("(:domain (t) (:operator (o) (:cost 1\n2)))", error_unexpected, 2, 1); }
+    TEST(_39) { check_error("(:domain (t) (:operator (o)\n(:cost)))", error_expected_type, 2, 2); }
+    TEST(_40) { check_error("(:domain (d) (:operator (!o x) (:cost\ny)))", error_unbound_var, 2, 1); }
+    TEST(_41) { check_error("(:domain (t) (:operator (o) (:cost\n-1)))", error_negative_cost, 2, 1); }
+    TEST(_42) { check_error("(:domain (t) (:operator (o) (:cost\n-0.5)))", error_negative_cost, 2, 1); }
+    TEST(_43) { check_error("(:domain (t) (:method\n(m) (:sort-by)))", error_expected_sort_key, 2, 6); }
+    TEST(_44) { check_error("(:domain (t) (:method\n(m) (:sort-by k ())))", error_expected_type, 2, 18); }
+    TEST(_45) { check_error("(:domain (d) (:method (m) (:sort-by\nk () ())))", error_unbound_var, 2, 1); }
 }
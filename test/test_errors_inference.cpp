@@ -39,4 +39,5 @@ namespace
     TEST(_9)  { check_error("(:worldstate (w) (a (t1)) (:function (f (t2))->(b))) (:domain (d) (:method (m) ((a x)\n(f x)) ()))", error_type_mismatch, 2, 4); }
     TEST(_10) { check_error("(:worldstate (w) (a (t1)) (b (t2))) (:domain (d) (:method (m\nx) ((a x) (b x)) ()))", error_type_mismatch, 2, 12); }
     TEST(_11) { check_error("(:worldstate (w) (a (t1)) (:function (f)->(t2))) (:domain (d) (:method (m) ((a\n(f))) ()))", error_type_mismatch, 2, 2); }
+    TEST(_12) { check_error("(:worldstate (w) (a (t1))) (:domain (d) (:operator (!o x)) (:method (m) () ((!o\n1))))", error_unable_to_infer_type, 2, 1); }
 }
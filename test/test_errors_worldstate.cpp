@@ -45,4 +45,6 @@ namespace
     TEST(_15) { check_error("(:worldstate (t) (:function (f)))", error_expected_token, 1, 31); }
     TEST(_16) { check_error("(:worldstate (t) (:function (f)->))", error_expected_type, 1, 34); }
     TEST(_17) { check_error("(:worldstate (t) (:function (f)->(t)) (:function (f)->(t)))", error_redefinition, 1, 51); }
+    TEST(_18) { check_error("(:worldstate (t) (a (int) :size x))", error_expected_type, 1, 33); }
+    TEST(_19) { check_error("(:worldstate (t) (:function (f)->(t) x))", error_expected_token, 1, 38); }
 }
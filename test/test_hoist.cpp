@@ -0,0 +1,123 @@
+//
+// Copyright (c) 2013 Alexander Shafranov shafranov@gmail.com
+//
+// This software is provided 'as-is', without any express or implied
+// warranty.  In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software. If you use this software
+// in a product, an acknowledgment in the product documentation would be
+// appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+
+
+#include <string.h>
+#include <unittestpp.h>
+#include <derplanner/runtime/runtime.h>
+#include "domains/hoist.h"
+
+using namespace plnnr;
+
+namespace
+{
+    int dist_calls;
+
+    int dist(int x, int y)
+    {
+        ++dist_calls;
+        return x + y;
+    }
+
+    struct hoist_world
+    {
+        hoist::worldstate data;
+
+        hoist_world()
+        {
+            memset(&data, 0, sizeof(data));
+            data.atoms[hoist::atom_a] = tuple_list::create<hoist::a_tuple>(16);
+            data.atoms[hoist::atom_b] = tuple_list::create<hoist::b_tuple>(16);
+            data.dist = dist;
+
+            for (int i = 0; i < 3; ++i)
+            {
+                tuple_list::append<hoist::a_tuple>(data.atoms[hoist::atom_a])->_0 = i;
+            }
+
+            for (int i = 0; i < 4; ++i)
+            {
+                hoist::b_tuple* b = tuple_list::append<hoist::b_tuple>(data.atoms[hoist::atom_b]);
+                b->_0 = i;
+                b->_1 = i;
+            }
+        }
+
+        ~hoist_world()
+        {
+            tuple_list::destroy(data.atoms[hoist::atom_a]);
+            tuple_list::destroy(data.atoms[hoist::atom_b]);
+        }
+    };
+
+    struct hoist_planner
+    {
+        stack methods;
+        stack tasks;
+        stack journal;
+        planner_state pstate;
+
+        hoist_planner()
+            : methods(4096)
+            , tasks(4096)
+            , journal(4096)
+        {
+            memset(&pstate, 0, sizeof(pstate));
+            pstate.methods = &methods;
+            pstate.tasks = &tasks;
+            pstate.journal = &journal;
+            pstate.expands = hoist::expands;
+        }
+    };
+
+    // (dist x x) depends on `x` only, so it is called once per `a` tuple, not once per (a, b) pair.
+    TEST(comparison_call_hoisted_out_of_inner_loop)
+    {
+        hoist_world world;
+        hoist_planner planner;
+        dist_calls = 0;
+
+        CHECK(!find_plan(planner.pstate, hoist::task_far, hoist::expand_far_branch_0, &world.data));
+        CHECK_EQUAL(3, dist_calls);
+    }
+
+    // hoisted results still select the right bindings: x = 0 and x = 1 with each of the 4 `b` tuples.
+    TEST(comparison_call_hoisted_result)
+    {
+        hoist_world world;
+        hoist_planner planner;
+        dist_calls = 0;
+
+        CHECK(find_plan(planner.pstate, hoist::task_near, hoist::expand_near_branch_0, &world.data));
+        CHECK_EQUAL(3, dist_calls);
+
+        int num_visits = 0;
+
+        for (task_instance* task = bottom<task_instance>(planner.pstate.tasks); task != 0; task = next_task(task))
+        {
+            hoist::visit_args* args = static_cast<hoist::visit_args*>(arguments(task));
+            CHECK(args->_0 < 2);
+            CHECK_EQUAL(num_visits % 4, args->_1);
+            ++num_visits;
+        }
+
+        CHECK_EQUAL(8, num_visits);
+    }
+}
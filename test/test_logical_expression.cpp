@@ -273,4 +273,40 @@ namespace
         const char* expected = "(or (and (t1) (not (t2))) (and (t1) (t2) (t3) (t4)))";
         CHECK_EQUAL(expected, to_string(actual).c_str());
     }
+
+    TEST(nnf_clauses_conversion_1)
+    {
+        sexpr::tree expr;
+        char buffer[] = "((and (q1) (or (r1) (r2)) (q2) (or (r3) (r4)) (q3)))";
+        expr.parse(buffer);
+        ast::tree tree;
+        ast::node* actual = ast::build_logical_expression(tree, expr.root()->first_child);
+        actual = ast::convert_to_nnf_clauses(tree, actual);
+        const char* expected = "(or (and (q1) (or (and (r1)) (and (r2))) (q2) (or (and (r3)) (and (r4))) (q3)))";
+        CHECK_EQUAL(expected, to_string(actual).c_str());
+    }
+
+    TEST(nnf_clauses_conversion_2)
+    {
+        sexpr::tree expr;
+        char buffer[] = "((or (a) (b)))";
+        expr.parse(buffer);
+        ast::tree tree;
+        ast::node* actual = ast::build_logical_expression(tree, expr.root()->first_child);
+        actual = ast::convert_to_nnf_clauses(tree, actual);
+        const char* expected = "(or (and (a)) (and (b)))";
+        CHECK_EQUAL(expected, to_string(actual).c_str());
+    }
+
+    TEST(nnf_clauses_conversion_3)
+    {
+        sexpr::tree expr;
+        char buffer[] = "((t1) (not (and (t2) (or (t3) (t4)))))";
+        expr.parse(buffer);
+        ast::tree tree;
+        ast::node* actual = ast::build_logical_expression(tree, expr.root()->first_child);
+        actual = ast::convert_to_nnf_clauses(tree, actual);
+        const char* expected = "(or (and (t1) (or (and (not (t2))) (and (not (t3)) (not (t4))))))";
+        CHECK_EQUAL(expected, to_string(actual).c_str());
+    }
 }
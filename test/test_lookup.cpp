@@ -0,0 +1,136 @@
+//
+// Copyright (c) 2013 Alexander Shafranov shafranov@gmail.com
+//
+// This software is provided 'as-is', without any express or implied
+// warranty.  In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software. If you use this software
+// in a product, an acknowledgment in the product documentation would be
+// appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+
+
+#include <string.h>
+#include <unittestpp.h>
+#include <derplanner/runtime/runtime.h>
+#include "domains/lookup.h"
+
+using namespace plnnr;
+
+namespace
+{
+    // edges from 1 to 2, 3 and 4 mixed with edges from other nodes.
+    struct lookup_world
+    {
+        lookup::worldstate data;
+
+        lookup_world()
+        {
+            memset(&data, 0, sizeof(data));
+            data.atoms[lookup::atom_start] = tuple_list::create<lookup::start_tuple>(16);
+            data.atoms[lookup::atom_edge] = tuple_list::create<lookup::edge_tuple>(16);
+            data.atoms[lookup::atom_at] = tuple_list::create<lookup::at_tuple>(16);
+
+            tuple_list::append<lookup::start_tuple>(data.atoms[lookup::atom_start])->_0 = 1;
+
+            const int edges[][2] = { { 2, 1 }, { 1, 2 }, { 0, 5 }, { 1, 3 }, { 3, 1 }, { 1, 4 }, { 5, 6 } };
+
+            for (unsigned i = 0; i < sizeof(edges) / sizeof(edges[0]); ++i)
+            {
+                lookup::edge_tuple* edge = tuple_list::append<lookup::edge_tuple>(data.atoms[lookup::atom_edge]);
+                edge->_0 = edges[i][0];
+                edge->_1 = edges[i][1];
+            }
+        }
+
+        ~lookup_world()
+        {
+            lookup::destroy_static_indices(data);
+
+            for (int i = 0; i < lookup::atom_count; ++i)
+            {
+                tuple_list::destroy(data.atoms[i]);
+            }
+        }
+    };
+
+    struct lookup_planner
+    {
+        stack methods;
+        stack tasks;
+        stack journal;
+        planner_state pstate;
+
+        lookup_planner()
+            : methods(4096)
+            , tasks(4096)
+            , journal(4096)
+        {
+            memset(&pstate, 0, sizeof(pstate));
+            pstate.methods = &methods;
+            pstate.tasks = &tasks;
+            pstate.journal = &journal;
+            pstate.expands = lookup::expands;
+        }
+    };
+
+    // `edge` is only read, so it's looked up in a sorted index keyed by the bound source.
+    TEST(static_index_lookup)
+    {
+        lookup_world world;
+        CHECK(lookup::build_static_indices(world.data));
+        CHECK_EQUAL(7u, world.data.edge_index_size);
+
+        lookup_planner planner;
+        CHECK(find_plan(planner.pstate, lookup::task_hops, lookup::expand_hops_branch_0, &world.data));
+
+        // ties keep the list order.
+        const int expected[] = { 2, 3, 4 };
+        int num_hops = 0;
+
+        for (task_instance* task = bottom<task_instance>(planner.pstate.tasks); task != 0; task = next_task(task))
+        {
+            lookup::go_args* args = static_cast<lookup::go_args*>(arguments(task));
+            CHECK_EQUAL(1, args->_0);
+            CHECK(num_hops < 3);
+            CHECK_EQUAL(expected[num_hops < 3 ? num_hops : 0], args->_1);
+            ++num_hops;
+        }
+
+        CHECK_EQUAL(3, num_hops);
+    }
+
+    // rebuilding replaces the index, e.g. after the worldstate is reloaded.
+    TEST(static_index_rebuild)
+    {
+        lookup_world world;
+        CHECK(lookup::build_static_indices(world.data));
+
+        lookup::edge_tuple* edge = tuple_list::append<lookup::edge_tuple>(world.data.atoms[lookup::atom_edge]);
+        edge->_0 = 1;
+        edge->_1 = 7;
+        CHECK(lookup::build_static_indices(world.data));
+        CHECK_EQUAL(8u, world.data.edge_index_size);
+
+        lookup_planner planner;
+        CHECK(find_plan(planner.pstate, lookup::task_hops, lookup::expand_hops_branch_0, &world.data));
+
+        int num_hops = 0;
+
+        for (task_instance* task = bottom<task_instance>(planner.pstate.tasks); task != 0; task = next_task(task))
+        {
+            ++num_hops;
+        }
+
+        CHECK_EQUAL(4, num_hops);
+    }
+}
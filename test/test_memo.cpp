@@ -0,0 +1,160 @@
+//
+// Copyright (c) 2013 Alexander Shafranov shafranov@gmail.com
+//
+// This software is provided 'as-is', without any express or implied
+// warranty.  In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software. If you use this software
+// in a product, an acknowledgment in the product documentation would be
+// appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+
+
+#include <string.h>
+#include <unittestpp.h>
+#include <derplanner/runtime/runtime.h>
+#include "domains/memo.h"
+
+using namespace plnnr;
+
+namespace
+{
+    int weight_calls;
+
+    int weight(int x)
+    {
+        ++weight_calls;
+        return x + 10;
+    }
+
+    struct memo_world
+    {
+        memo::worldstate data;
+
+        memo_world()
+        {
+            memset(&data, 0, sizeof(data));
+            data.atoms[memo::atom_item] = tuple_list::create<memo::item_tuple>(16);
+            data.atoms[memo::atom_mark] = tuple_list::create<memo::mark_tuple>(16);
+            data.weight = weight;
+
+            for (int i = 0; i < 3; ++i)
+            {
+                memo::item_tuple* item = tuple_list::append<memo::item_tuple>(data.atoms[memo::atom_item]);
+                item->_0 = i;
+            }
+        }
+
+        ~memo_world()
+        {
+            tuple_list::destroy(data.atoms[memo::atom_item]);
+            tuple_list::destroy(data.atoms[memo::atom_mark]);
+        }
+    };
+
+    struct planner
+    {
+        stack methods;
+        stack tasks;
+        stack journal;
+        memo::memo_tables tables;
+        planner_state pstate;
+
+        planner()
+            : methods(4096)
+            , tasks(4096)
+            , journal(4096)
+        {
+            memset(&tables, 0, sizeof(tables));
+            memset(&pstate, 0, sizeof(pstate));
+            pstate.methods = &methods;
+            pstate.tasks = &tasks;
+            pstate.journal = &journal;
+            pstate.expands = memo::expands;
+            pstate.memo = &tables;
+        }
+    };
+
+    TEST(memo_within_precondition)
+    {
+        memo_world world;
+        planner p;
+        weight_calls = 0;
+
+        // `scan` tries 9 bindings, with 3 distinct arguments of `weight`.
+        CHECK(find_plan(p.pstate, memo::task_scan, memo::expand_scan_branch_0, &world.data));
+        CHECK_EQUAL(3, weight_calls);
+    }
+
+    TEST(memo_disabled)
+    {
+        memo_world world;
+        planner p;
+        p.pstate.memo = 0;
+        weight_calls = 0;
+
+        CHECK(find_plan(p.pstate, memo::task_scan, memo::expand_scan_branch_0, &world.data));
+        CHECK_EQUAL(9, weight_calls);
+    }
+
+    TEST(memo_reused_across_expansions)
+    {
+        memo_world world;
+        planner p;
+        weight_calls = 0;
+
+        // `probe` is expanded twice, before and after (!touch 1), and reuses (weight 0) computed by `scan`.
+        CHECK(find_plan(p.pstate, memo::task_root, memo::expand_root_branch_0, &world.data));
+        CHECK_EQUAL(3, weight_calls);
+
+        // and so does the next plan.
+        undo_effects(p.pstate.journal, &world.data);
+        reset(p.pstate);
+        CHECK(find_plan(p.pstate, memo::task_root, memo::expand_root_branch_0, &world.data));
+        CHECK_EQUAL(3, weight_calls);
+    }
+
+    TEST(memo_invalidated_by_caller)
+    {
+        memo_world world;
+        planner p;
+        weight_calls = 0;
+
+        CHECK(find_plan(p.pstate, memo::task_probe, memo::expand_probe_branch_0, &world.data));
+        CHECK_EQUAL(1, weight_calls);
+
+        memo::invalidate_memo(p.tables);
+        reset(p.pstate);
+        CHECK(find_plan(p.pstate, memo::task_probe, memo::expand_probe_branch_0, &world.data));
+        CHECK_EQUAL(2, weight_calls);
+    }
+
+    TEST(memo_fingerprint_wraps_around)
+    {
+        memo_world world;
+        planner p;
+        weight_calls = 0;
+
+        // cached with fingerprint 0.
+        CHECK(find_plan(p.pstate, memo::task_probe, memo::expand_probe_branch_0, &world.data));
+        CHECK_EQUAL(1, weight_calls);
+
+        // the next invalidation brings the fingerprint back to 0.
+        p.tables.fingerprint = 0xffffffff;
+        memo::invalidate_memo(p.tables);
+        CHECK_EQUAL(0u, p.tables.fingerprint);
+
+        reset(p.pstate);
+        CHECK(find_plan(p.pstate, memo::task_probe, memo::expand_probe_branch_0, &world.data));
+        CHECK_EQUAL(2, weight_calls);
+    }
+}
@@ -0,0 +1,93 @@
+//
+// Copyright (c) 2013 Alexander Shafranov shafranov@gmail.com
+//
+// This software is provided 'as-is', without any express or implied
+// warranty.  In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software. If you use this software
+// in a product, an acknowledgment in the product documentation would be
+// appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+
+
+#include <string.h>
+#include <unittestpp.h>
+#include <derplanner/runtime/runtime.h>
+#include "domains/negation.h"
+
+using namespace plnnr;
+
+namespace
+{
+    struct negation_world
+    {
+        negation::worldstate data;
+
+        negation_world()
+        {
+            memset(&data, 0, sizeof(data));
+            data.atoms[negation::atom_on] = tuple_list::create<negation::on_tuple>(16);
+            data.atoms[negation::atom_pair] = tuple_list::create<negation::pair_tuple>(16);
+        }
+
+        ~negation_world()
+        {
+            tuple_list::destroy(data.atoms[negation::atom_on]);
+            tuple_list::destroy(data.atoms[negation::atom_pair]);
+        }
+
+        void on(int x, int y)
+        {
+            negation::on_tuple* t = tuple_list::append<negation::on_tuple>(data.atoms[negation::atom_on]);
+            t->_0 = x;
+            t->_1 = y;
+        }
+
+        void pair(int x, int y)
+        {
+            negation::pair_tuple* t = tuple_list::append<negation::pair_tuple>(data.atoms[negation::atom_pair]);
+            t->_0 = x;
+            t->_1 = y;
+        }
+    };
+
+    // (not (on x y)) with both arguments bound must match whole tuples, not single arguments.
+    TEST(negation_of_bound_atom)
+    {
+        negation_world world;
+        world.on(1, 2);
+        world.on(3, 4);
+        world.pair(1, 2);
+        world.pair(1, 4);
+        world.pair(3, 4);
+
+        stack methods(4096);
+        stack tasks(4096);
+        stack journal(4096);
+
+        planner_state pstate;
+        memset(&pstate, 0, sizeof(pstate));
+        pstate.methods = &methods;
+        pstate.tasks = &tasks;
+        pstate.journal = &journal;
+        pstate.expands = negation::expands;
+
+        CHECK(find_plan(pstate, negation::task_root, negation::expand_root_branch_0, &world.data));
+
+        task_instance* task = bottom<task_instance>(pstate.tasks);
+        CHECK_EQUAL(negation::task_pick, task->type);
+
+        negation::pick_args* args = static_cast<negation::pick_args*>(arguments(task));
+        CHECK_EQUAL(1, args->_0);
+        CHECK_EQUAL(4, args->_1);
+    }
+}
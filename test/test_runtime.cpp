@@ -0,0 +1,1050 @@
+//
+// Copyright (c) 2013 Alexander Shafranov shafranov@gmail.com
+//
+// This software is provided 'as-is', without any express or implied
+// warranty.  In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software. If you use this software
+// in a product, an acknowledgment in the product documentation would be
+// appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+
+
+#include <string.h>
+#include <float.h>
+#include <unittestpp.h>
+#include <derplanner/runtime/runtime.h>
+#include "domains/trip.h"
+#include "domains/retry.h"
+#include "domains/tail.h"
+#include "domains/detach.h"
+#include "domains/apply.h"
+#include "domains/adaptive.h"
+
+using namespace plnnr;
+
+namespace
+{
+    // roads from 1 to 4 via 5 (closed), 2 and 3, the last one is the shortest.
+    struct trip_world
+    {
+        trip::worldstate data;
+
+        trip_world()
+        {
+            memset(&data, 0, sizeof(data));
+            data.atoms[trip::atom_start] = tuple_list::create<trip::start_tuple>(16);
+            data.atoms[trip::atom_finish] = tuple_list::create<trip::finish_tuple>(16);
+            data.atoms[trip::atom_road] = tuple_list::create<trip::road_tuple>(16);
+            data.atoms[trip::atom_open] = tuple_list::create<trip::open_tuple>(16);
+            data.atoms[trip::atom_at] = tuple_list::create<trip::at_tuple>(16);
+
+            append<trip::start_tuple>(trip::atom_start)->_0 = 1;
+            append<trip::finish_tuple>(trip::atom_finish)->_0 = 4;
+            append<trip::at_tuple>(trip::atom_at)->_0 = 1;
+            append<trip::open_tuple>(trip::atom_open)->_0 = 2;
+            append<trip::open_tuple>(trip::atom_open)->_0 = 3;
+
+            road(1, 5, 1);
+            road(1, 2, 3);
+            road(1, 3, 1);
+            road(5, 4, 2);
+            road(2, 4, 4);
+            road(3, 4, 5);
+        }
+
+        ~trip_world()
+        {
+            for (int i = 0; i < trip::atom_count; ++i)
+            {
+                tuple_list::destroy(data.atoms[i]);
+            }
+        }
+
+        template <typename T>
+        T* append(int atom)
+        {
+            return tuple_list::append<T>(data.atoms[atom]);
+        }
+
+        void road(int x, int y, int d)
+        {
+            trip::road_tuple* t = append<trip::road_tuple>(trip::atom_road);
+            t->_0 = x;
+            t->_1 = y;
+            t->_2 = d;
+        }
+
+        // the single `at` tuple, 0 if there are several.
+        int at()
+        {
+            tuple_list::handle* list = data.atoms[trip::atom_at];
+            return tuple_list::size(list) == 1 ? tuple_list::head<trip::at_tuple>(list)->_0 : 0;
+        }
+    };
+
+    struct trip_planner
+    {
+        stack methods;
+        stack tasks;
+        stack journal;
+        planner_state pstate;
+
+        trip_planner()
+            : methods(4096)
+            , tasks(4096)
+            , journal(4096)
+        {
+            memset(&pstate, 0, sizeof(pstate));
+            pstate.methods = &methods;
+            pstate.tasks = &tasks;
+            pstate.journal = &journal;
+            pstate.expands = trip::expands;
+        }
+    };
+
+    // writes the `!drive` destinations of the plan in `pstate` to `stops`, returns their number.
+    int plan_stops(const planner_state& pstate, int* stops)
+    {
+        int count = 0;
+
+        for (task_instance* task = pstate.top_task ? bottom<task_instance>(pstate.tasks) : 0; task != 0; task = next_task(task))
+        {
+            stops[count++] = static_cast<trip::drive_args*>(arguments(task))->_1;
+        }
+
+        return count;
+    }
+
+    TEST(save_load_continue)
+    {
+        trip_world world;
+        uint32_t fingerprint = world_fingerprint(&world.data, trip::atom_count);
+
+        trip_planner expected;
+        CHECK(find_plan(expected.pstate, trip::task_root, trip::expand_root_branch_0, &world.data));
+        int expected_stops[8];
+        int expected_count = plan_stops(expected.pstate, expected_stops);
+        CHECK_EQUAL(2, expected_count);
+        CHECK_EQUAL(2, expected_stops[0]);
+        undo_effects(expected.pstate.journal, &world.data);
+
+        trip_planner original;
+        find_plan_init(original.pstate, trip::task_root, trip::expand_root_branch_0);
+
+        // pause with effects applied to the worldstate.
+        while (original.journal.empty())
+        {
+            CHECK_EQUAL(plan_in_progress, find_plan_step(original.pstate, &world.data));
+        }
+
+        char buffer[4096];
+        size_t size = save(original.pstate, fingerprint, buffer, sizeof(buffer));
+        CHECK(size > 0);
+        CHECK_EQUAL(save_size(original.pstate), size);
+
+        undo_effects(original.pstate.journal, &world.data);
+        CHECK_EQUAL(1, world.at());
+
+        trip_planner loaded;
+        CHECK(load(loaded.pstate, world_fingerprint(&world.data, trip::atom_count), buffer, size));
+        redo_effects(loaded.pstate.journal, &world.data);
+
+        find_plan_status status = plan_in_progress;
+
+        while (status == plan_in_progress)
+        {
+            status = find_plan_step(loaded.pstate, &world.data);
+        }
+
+        CHECK_EQUAL(plan_found, status);
+
+        int stops[8];
+        CHECK_EQUAL(expected_count, plan_stops(loaded.pstate, stops));
+        CHECK_ARRAY_EQUAL(expected_stops, stops, expected_count);
+        CHECK_EQUAL(4, world.at());
+    }
+
+    TEST(load_into_other_world)
+    {
+        trip_world world;
+        trip_world other;
+
+        trip_planner original;
+        find_plan_init(original.pstate, trip::task_root, trip::expand_root_branch_0);
+        find_plan_step(original.pstate, &world.data);
+
+        char buffer[4096];
+        size_t size = save(original.pstate, world_fingerprint(&world.data, trip::atom_count), buffer, sizeof(buffer));
+        CHECK(size > 0);
+
+        trip_planner loaded;
+        CHECK(!load(loaded.pstate, world_fingerprint(&other.data, trip::atom_count), buffer, size));
+
+        tuple_list::clear(world.data.atoms[trip::atom_at]);
+        CHECK(!load(loaded.pstate, world_fingerprint(&world.data, trip::atom_count), buffer, size));
+    }
+
+    // pauses the search with a method expanded and its effects applied.
+    void pause_trip(trip_planner& planner, trip_world& world)
+    {
+        find_plan_init(planner.pstate, trip::task_root, trip::expand_root_branch_0);
+
+        while (planner.journal.empty())
+        {
+            CHECK_EQUAL(plan_in_progress, find_plan_step(planner.pstate, &world.data));
+        }
+    }
+
+    find_plan_status finish_trip(trip_planner& planner, trip_world& world)
+    {
+        find_plan_status status = plan_in_progress;
+
+        while (status == plan_in_progress)
+        {
+            status = find_plan_step(planner.pstate, &world.data);
+        }
+
+        return status;
+    }
+
+    // frames are linked by offsets, so a paused search continues after its stacks are reallocated.
+    TEST(continue_after_stack_growth)
+    {
+        trip_world world;
+        trip_planner planner;
+        pause_trip(planner, world);
+
+        CHECK(planner.methods.grow(planner.methods.capacity() * 16));
+        CHECK(planner.tasks.grow(planner.tasks.capacity() * 16));
+        CHECK(planner.journal.grow(planner.journal.capacity() * 16));
+
+        CHECK_EQUAL(plan_found, finish_trip(planner, world));
+
+        int stops[8];
+        const int via_2[] = { 2, 4 };
+        CHECK_EQUAL(2, plan_stops(planner.pstate, stops));
+        CHECK_ARRAY_EQUAL(via_2, stops, 2);
+        CHECK_EQUAL(4, world.at());
+    }
+
+    // a paused search copied to other stacks continues there, the original stacks are not referenced.
+    TEST(continue_on_copied_stacks)
+    {
+        trip_world world;
+        trip_planner original;
+        pause_trip(original, world);
+
+        trip_planner copy;
+        CHECK(copy.methods.assign(original.methods));
+        CHECK(copy.tasks.assign(original.tasks));
+        CHECK(copy.journal.assign(original.journal));
+        copy.pstate.top_method = original.pstate.top_method;
+        copy.pstate.top_task = original.pstate.top_task;
+
+        memset(original.methods.buffer(), 0xcd, original.methods.capacity());
+        memset(original.tasks.buffer(), 0xcd, original.tasks.capacity());
+        memset(original.journal.buffer(), 0xcd, original.journal.capacity());
+
+        CHECK_EQUAL(plan_found, finish_trip(copy, world));
+
+        int stops[8];
+        const int via_2[] = { 2, 4 };
+        CHECK_EQUAL(2, plan_stops(copy.pstate, stops));
+        CHECK_ARRAY_EQUAL(via_2, stops, 2);
+        CHECK_EQUAL(4, world.at());
+    }
+
+    // resume stages are numbered from 1 in the order of the yields of a branch, no trip branch has more than 3.
+    TEST(dense_coroutine_stages)
+    {
+        trip_world world;
+        trip_planner planner;
+        find_plan_init(planner.pstate, trip::task_root, trip::expand_root_branch_0);
+
+        unsigned seen = 0;
+        find_plan_status status = plan_in_progress;
+
+        while (status == plan_in_progress)
+        {
+            status = find_plan_step(planner.pstate, &world.data);
+
+            for (method_instance* method = planner.pstate.top_method ? top_method(planner.pstate) : 0; method != 0; method = prev_method(method))
+            {
+                CHECK(method->stage <= 3);
+
+                if (method->type == trip::task_leg && method->stage <= 3)
+                {
+                    seen |= 1u << method->stage;
+                }
+            }
+        }
+
+        CHECK_EQUAL(plan_found, status);
+        // `leg` is seen suspended after its first and second subtasks.
+        CHECK_EQUAL(0x6u, seen & 0x6u);
+    }
+
+    TEST(export_plan_layout)
+    {
+        trip_world world;
+        trip_planner planner;
+        CHECK(find_plan(planner.pstate, trip::task_root, trip::expand_root_branch_0, &world.data));
+
+        // int arguments keep the buffer aligned for the steps.
+        int buffer[64];
+        size_t size = export_plan(planner.pstate, buffer, sizeof(buffer));
+        CHECK(size > 0);
+
+        plan_step* step = first_step(buffer);
+        CHECK(step == reinterpret_cast<plan_step*>(buffer));
+
+        const int expected[2][3] = { { 1, 2, 3 }, { 2, 4, 4 } };
+
+        for (int i = 0; i < 2; ++i)
+        {
+            CHECK(step != 0);
+            CHECK_EQUAL(trip::task_drive, step->type);
+            CHECK_EQUAL(sizeof(plan_step), step->arguments);
+            CHECK_EQUAL(sizeof(plan_step) + sizeof(trip::drive_args), step->size);
+            CHECK_ARRAY_EQUAL(expected[i], static_cast<int*>(arguments(step)), 3);
+
+            plan_step* next = next_step(step);
+
+            if (!next)
+            {
+                // terminator follows the last step and ends the written bytes.
+                plan_step* terminator = static_cast<plan_step*>(memory::offset(step, step->size));
+                CHECK_EQUAL(-1, terminator->type);
+                CHECK_EQUAL(0, terminator->size);
+                CHECK_EQUAL(size, size_t(reinterpret_cast<char*>(terminator + 1) - reinterpret_cast<char*>(buffer)));
+            }
+
+            step = next;
+        }
+
+        CHECK(step == 0);
+
+        CHECK_EQUAL(0u, export_plan(planner.pstate, buffer, size - 1));
+        CHECK_EQUAL(size, export_plan(planner.pstate, buffer, size));
+    }
+
+    TEST(enumerate_all_plans)
+    {
+        trip_world world;
+        trip_planner planner;
+        find_plan_init(planner.pstate, trip::task_root, trip::expand_root_branch_0);
+
+        int stops[2][8];
+        int counts[2];
+        float costs[2];
+        int num_plans = 0;
+
+        while (find_next_plan(planner.pstate, &world.data) == plan_found)
+        {
+            CHECK(num_plans < 2);
+            counts[num_plans] = plan_stops(planner.pstate, stops[num_plans]);
+            costs[num_plans] = plan_cost(planner.pstate);
+            CHECK_EQUAL(4, world.at());
+            ++num_plans;
+        }
+
+        CHECK_EQUAL(2, num_plans);
+
+        const int via_2[] = { 2, 4 };
+        const int via_3[] = { 3, 4 };
+        CHECK_EQUAL(2, counts[0]);
+        CHECK_ARRAY_EQUAL(via_2, stops[0], 2);
+        CHECK_CLOSE(7.0f, costs[0], 1e-6f);
+        CHECK_EQUAL(2, counts[1]);
+        CHECK_ARRAY_EQUAL(via_3, stops[1], 2);
+        CHECK_CLOSE(6.0f, costs[1], 1e-6f);
+
+        // exhausting the search undoes every effect.
+        CHECK(planner.journal.empty());
+        CHECK_EQUAL(1, world.at());
+        CHECK_EQUAL(2u, tuple_list::size(world.data.atoms[trip::atom_open]));
+        CHECK_EQUAL(6u, tuple_list::size(world.data.atoms[trip::atom_road]));
+    }
+
+    TEST(optimal_plan)
+    {
+        trip_world world;
+        trip_planner planner;
+        find_plan_init(planner.pstate, trip::task_root, trip::expand_root_branch_0);
+
+        float best = FLT_MAX;
+        int buffer[64];
+        find_plan_status status;
+
+        // a small step budget makes the search resume across calls.
+        while ((status = find_optimal_plan(planner.pstate, &world.data, 3, best, buffer, sizeof(buffer))) == plan_in_progress)
+        {
+        }
+
+        CHECK_EQUAL(plan_found, status);
+        CHECK_CLOSE(6.0f, best, 1e-6f);
+
+        const int expected[2][3] = { { 1, 3, 1 }, { 3, 4, 5 } };
+        plan_step* step = first_step(buffer);
+
+        for (int i = 0; i < 2; ++i)
+        {
+            CHECK(step != 0);
+            CHECK_EQUAL(trip::task_drive, step->type);
+            CHECK_ARRAY_EQUAL(expected[i], static_cast<int*>(arguments(step)), 3);
+            step = next_step(step);
+        }
+
+        CHECK(step == 0);
+        CHECK(planner.journal.empty());
+        CHECK_EQUAL(1, world.at());
+    }
+
+    int probe_calls;
+
+    int probe(int x)
+    {
+        ++probe_calls;
+        return x;
+    }
+
+    // candidates 1, 2 and 3, only the last one is good.
+    struct retry_world
+    {
+        retry::worldstate data;
+
+        retry_world()
+        {
+            memset(&data, 0, sizeof(data));
+            data.atoms[retry::atom_cand] = tuple_list::create<retry::cand_tuple>(16);
+            data.atoms[retry::atom_good] = tuple_list::create<retry::good_tuple>(16);
+            data.atoms[retry::atom_note] = tuple_list::create<retry::note_tuple>(16);
+            data.probe = probe;
+
+            for (int i = 1; i <= 3; ++i)
+            {
+                tuple_list::append<retry::cand_tuple>(data.atoms[retry::atom_cand])->_0 = i;
+            }
+
+            tuple_list::append<retry::good_tuple>(data.atoms[retry::atom_good])->_0 = 3;
+        }
+
+        ~retry_world()
+        {
+            for (int i = 0; i < retry::atom_count; ++i)
+            {
+                tuple_list::destroy(data.atoms[i]);
+            }
+        }
+    };
+
+    struct retry_planner
+    {
+        stack methods;
+        stack tasks;
+        stack journal;
+        planner_state pstate;
+
+        retry_planner()
+            : methods(4096)
+            , tasks(4096)
+            , journal(4096)
+        {
+            memset(&pstate, 0, sizeof(pstate));
+            pstate.methods = &methods;
+            pstate.tasks = &tasks;
+            pstate.journal = &journal;
+            pstate.expands = retry::expands;
+        }
+    };
+
+    // writes the task types and first arguments of the plan in `pstate`, returns the number of tasks.
+    int plan_tasks(const planner_state& pstate, int* types, int* args)
+    {
+        int count = 0;
+
+        for (task_instance* task = pstate.top_task ? bottom<task_instance>(pstate.tasks) : 0; task != 0; task = next_task(task))
+        {
+            types[count] = task->type;
+            args[count++] = *static_cast<int*>(arguments(task));
+        }
+
+        return count;
+    }
+
+    // (check x) fails for x = 1 and x = 2, the parent resumes with the next binding each time.
+    TEST(failed_child_retries_next_binding)
+    {
+        retry_world world;
+        retry_planner planner;
+        CHECK(find_plan(planner.pstate, retry::task_first_good, retry::expand_first_good_branch_0, &world.data));
+
+        int types[8];
+        int args[8];
+        CHECK_EQUAL(1, plan_tasks(planner.pstate, types, args));
+        CHECK_EQUAL(retry::task_pick, types[0]);
+        CHECK_EQUAL(3, args[0]);
+    }
+
+    // (mark x) is fully expanded before (check x) fails: the parent must not be popped as expanded,
+    // and the `note` added for the rejected bindings is undone.
+    TEST(failed_child_after_expanded_sibling)
+    {
+        retry_world world;
+        retry_planner planner;
+        CHECK(find_plan(planner.pstate, retry::task_retry_after_expanded, retry::expand_retry_after_expanded_branch_0, &world.data));
+
+        int types[8];
+        int args[8];
+        CHECK_EQUAL(2, plan_tasks(planner.pstate, types, args));
+        CHECK_EQUAL(retry::task_note, types[0]);
+        CHECK_EQUAL(3, args[0]);
+        CHECK_EQUAL(retry::task_pick, types[1]);
+        CHECK_EQUAL(3, args[1]);
+
+        tuple_list::handle* notes = world.data.atoms[retry::atom_note];
+        CHECK_EQUAL(1u, tuple_list::size(notes));
+        CHECK_EQUAL(3, tuple_list::head<retry::note_tuple>(notes)->_0);
+    }
+
+    // (check x) fails after the parent has pushed all of its tasks, the parent resumes unexpanded.
+    TEST(failed_last_child_retries_next_binding)
+    {
+        retry_world world;
+        retry_planner planner;
+        CHECK(find_plan(planner.pstate, retry::task_check_last, retry::expand_check_last_branch_0, &world.data));
+
+        int types[8];
+        int args[8];
+        CHECK_EQUAL(1, plan_tasks(planner.pstate, types, args));
+        CHECK_EQUAL(retry::task_pick, types[0]);
+        CHECK_EQUAL(3, args[0]);
+    }
+
+    // (never) doesn't depend on `x`, so after it fails the other bindings are skipped for the next branch.
+    TEST(failed_child_skips_independent_bindings)
+    {
+        retry_world world;
+        retry_planner planner;
+        probe_calls = 0;
+        CHECK(find_plan(planner.pstate, retry::task_backjump, retry::expand_backjump_branch_0, &world.data));
+        CHECK_EQUAL(1, probe_calls);
+
+        int types[8];
+        int args[8];
+        CHECK_EQUAL(1, plan_tasks(planner.pstate, types, args));
+        CHECK_EQUAL(retry::task_pick, types[0]);
+        CHECK_EQUAL(0, args[0]);
+    }
+
+    // enumerating finds the only plan, and exhausting the search undoes the notes of all bindings.
+    TEST(failed_child_retries_when_enumerating)
+    {
+        retry_world world;
+        retry_planner planner;
+        find_plan_init(planner.pstate, retry::task_retry_after_expanded, retry::expand_retry_after_expanded_branch_0);
+
+        int num_plans = 0;
+
+        while (find_next_plan(planner.pstate, &world.data) == plan_found)
+        {
+            int types[8];
+            int args[8];
+            CHECK_EQUAL(2, plan_tasks(planner.pstate, types, args));
+            CHECK_EQUAL(3, args[1]);
+            ++num_plans;
+        }
+
+        CHECK_EQUAL(1, num_plans);
+        CHECK(planner.journal.empty());
+        CHECK_EQUAL(0u, tuple_list::size(world.data.atoms[retry::atom_note]));
+    }
+
+    // `length` units of fuel, and a chain of `next` links 0 -> 1 -> ... -> length.
+    struct tail_world
+    {
+        tail::worldstate data;
+
+        tail_world(int length)
+        {
+            memset(&data, 0, sizeof(data));
+            data.atoms[tail::atom_fuel] = tuple_list::create<tail::fuel_tuple>(64);
+            data.atoms[tail::atom_next] = tuple_list::create<tail::next_tuple>(64);
+
+            for (int i = 0; i < length; ++i)
+            {
+                tuple_list::append<tail::fuel_tuple>(data.atoms[tail::atom_fuel])->_0 = 1;
+
+                tail::next_tuple* link = tuple_list::append<tail::next_tuple>(data.atoms[tail::atom_next]);
+                link->_0 = i;
+                link->_1 = i + 1;
+            }
+        }
+
+        ~tail_world()
+        {
+            for (int i = 0; i < tail::atom_count; ++i)
+            {
+                tuple_list::destroy(data.atoms[i]);
+            }
+        }
+    };
+
+    struct tail_planner
+    {
+        stack methods;
+        stack tasks;
+        stack journal;
+        planner_state pstate;
+        size_t max_methods;
+
+        tail_planner()
+            : methods(4096)
+            , tasks(4096)
+            , journal(4096)
+            , max_methods(0)
+        {
+            memset(&pstate, 0, sizeof(pstate));
+            pstate.methods = &methods;
+            pstate.tasks = &tasks;
+            pstate.journal = &journal;
+            pstate.expands = tail::expands;
+        }
+
+        // runs the search to the next plan, recording the deepest method stack.
+        find_plan_status run(void* world, bool enumerate)
+        {
+            find_plan_status status;
+
+            do
+            {
+                status = enumerate ? find_next_plan_step(pstate, world) : find_plan_step(pstate, world);
+                max_methods = methods.top_offset() > max_methods ? methods.top_offset() : max_methods;
+            }
+            while (status == plan_in_progress);
+
+            return status;
+        }
+    };
+
+    // writes the task types and first arguments of a tail plan, -1 for tasks without arguments.
+    int tail_plan(const planner_state& pstate, int* types, int* args)
+    {
+        int count = 0;
+
+        for (task_instance* task = pstate.top_task ? bottom<task_instance>(pstate.tasks) : 0; task != 0; task = next_task(task))
+        {
+            types[count] = task->type;
+            args[count++] = task->args_size ? *static_cast<int*>(arguments(task)) : -1;
+        }
+
+        return count;
+    }
+
+    // (drain) recurses in the last branch, whose tasks don't depend on the precondition: each call replaces its parent.
+    void check_committed_tail_recursion(bool enumerate)
+    {
+        size_t max_methods[2];
+        const int lengths[2] = { 4, 40 };
+
+        for (int i = 0; i < 2; ++i)
+        {
+            tail_world world(lengths[i]);
+            tail_planner planner;
+            find_plan_init(planner.pstate, tail::task_drain, tail::expand_drain_branch_0);
+            CHECK_EQUAL(plan_found, planner.run(&world.data, enumerate));
+
+            int types[64];
+            int args[64];
+            CHECK_EQUAL(lengths[i], tail_plan(planner.pstate, types, args));
+
+            for (int j = 0; j < lengths[i]; ++j)
+            {
+                CHECK_EQUAL(tail::task_burn, types[j]);
+            }
+
+            CHECK_EQUAL(0u, tuple_list::size(world.data.atoms[tail::atom_fuel]));
+
+            if (enumerate)
+            {
+                CHECK_EQUAL(plan_not_found, planner.run(&world.data, enumerate));
+                CHECK_EQUAL(size_t(lengths[i]), tuple_list::size(world.data.atoms[tail::atom_fuel]));
+            }
+
+            max_methods[i] = planner.max_methods;
+        }
+
+        CHECK_EQUAL(max_methods[0], max_methods[1]);
+    }
+
+    TEST(committed_tail_recursion)
+    {
+        check_committed_tail_recursion(false);
+    }
+
+    TEST(committed_tail_recursion_when_enumerating)
+    {
+        check_committed_tail_recursion(true);
+    }
+
+    // (walk x) can't fail, so its recursive call replaces the parent even though it uses the binding of `y`.
+    TEST(infallible_tail_recursion)
+    {
+        size_t max_methods[2];
+        const int lengths[2] = { 4, 40 };
+
+        for (int i = 0; i < 2; ++i)
+        {
+            tail_world world(lengths[i]);
+            tail_planner planner;
+            tail::walk_args start = { 0 };
+            find_plan_init(planner.pstate, tail::task_walk, tail::expand_walk_branch_0);
+            *push_arguments<tail::walk_args>(planner.pstate, top_method(planner.pstate)) = start;
+            CHECK_EQUAL(plan_found, planner.run(&world.data, false));
+
+            int types[64];
+            int args[64];
+            CHECK_EQUAL(lengths[i], tail_plan(planner.pstate, types, args));
+
+            for (int j = 0; j < lengths[i]; ++j)
+            {
+                CHECK_EQUAL(tail::task_step, types[j]);
+                CHECK_EQUAL(j + 1, args[j]);
+            }
+
+            max_methods[i] = planner.max_methods;
+        }
+
+        CHECK_EQUAL(max_methods[0], max_methods[1]);
+    }
+
+    // enumerating keeps the parents for their remaining alternatives, the first plan is the same.
+    TEST(infallible_tail_recursion_when_enumerating)
+    {
+        tail_world world(40);
+        tail_planner planner;
+        tail::walk_args start = { 0 };
+        find_plan_init(planner.pstate, tail::task_walk, tail::expand_walk_branch_0);
+        *push_arguments<tail::walk_args>(planner.pstate, top_method(planner.pstate)) = start;
+        CHECK_EQUAL(plan_found, planner.run(&world.data, true));
+
+        int types[64];
+        int args[64];
+        CHECK_EQUAL(40, tail_plan(planner.pstate, types, args));
+
+        for (int j = 0; j < 40; ++j)
+        {
+            CHECK_EQUAL(tail::task_step, types[j]);
+            CHECK_EQUAL(j + 1, args[j]);
+        }
+    }
+
+    // items (1, 3), (2, 7) and (3, 9), `want` marks the ones `drop-heavy` may keep dropped.
+    struct detach_world
+    {
+        detach::worldstate data;
+
+        detach_world()
+        {
+            memset(&data, 0, sizeof(data));
+            data.atoms[detach::atom_item] = tuple_list::create<detach::item_tuple>(16);
+            data.atoms[detach::atom_want] = tuple_list::create<detach::want_tuple>(16);
+
+            const int items[][2] = { { 1, 3 }, { 2, 7 }, { 3, 9 } };
+
+            for (int i = 0; i < 3; ++i)
+            {
+                detach::item_tuple* item = tuple_list::append<detach::item_tuple>(data.atoms[detach::atom_item]);
+                item->_0 = items[i][0];
+                item->_1 = items[i][1];
+            }
+        }
+
+        ~detach_world()
+        {
+            for (int i = 0; i < detach::atom_count; ++i)
+            {
+                tuple_list::destroy(data.atoms[i]);
+            }
+        }
+
+        // writes ids of the items in list order, returns their number.
+        int items(int* ids)
+        {
+            int count = 0;
+
+            for (detach::item_tuple* item = tuple_list::head<detach::item_tuple>(data.atoms[detach::atom_item]); item != 0; item = item->next)
+            {
+                ids[count++] = item->_0;
+            }
+
+            return count;
+        }
+    };
+
+    struct detach_planner
+    {
+        stack methods;
+        stack tasks;
+        stack journal;
+        planner_state pstate;
+
+        detach_planner()
+            : methods(4096)
+            , tasks(4096)
+            , journal(4096)
+        {
+            memset(&pstate, 0, sizeof(pstate));
+            pstate.methods = &methods;
+            pstate.tasks = &tasks;
+            pstate.journal = &journal;
+            pstate.expands = detach::expands;
+        }
+    };
+
+    // `!drop` detaches the tuple bound by the precondition, undoing a failed binding puts it back in place.
+    TEST(delete_bound_tuple)
+    {
+        detach_world world;
+        tuple_list::append<detach::want_tuple>(world.data.atoms[detach::atom_want])->_0 = 3;
+
+        detach_planner planner;
+        CHECK(find_plan(planner.pstate, detach::task_drop_heavy, detach::expand_drop_heavy_branch_0, &world.data));
+
+        int types[4];
+        int args[4];
+        CHECK_EQUAL(1, plan_tasks(planner.pstate, types, args));
+        CHECK_EQUAL(detach::task_drop, types[0]);
+        CHECK_EQUAL(3, args[0]);
+
+        int ids[4];
+        const int kept[] = { 1, 2 };
+        CHECK_EQUAL(2, world.items(ids));
+        CHECK_ARRAY_EQUAL(kept, ids, 2);
+
+        undo_effects(planner.pstate.journal, &world.data);
+        const int all[] = { 1, 2, 3 };
+        CHECK_EQUAL(3, world.items(ids));
+        CHECK_ARRAY_EQUAL(all, ids, 3);
+    }
+
+    // the first `!drop` detaches the bound tuple, the second one searches for it: the first may have removed it.
+    TEST(delete_bound_tuple_then_search)
+    {
+        detach_world world;
+
+        detach_planner planner;
+        CHECK(find_plan(planner.pstate, detach::task_drop_pair, detach::expand_drop_pair_branch_0, &world.data));
+
+        int types[4];
+        int args[4];
+        CHECK_EQUAL(2, plan_tasks(planner.pstate, types, args));
+        CHECK_EQUAL(1, args[0]);
+        CHECK_EQUAL(2, args[1]);
+
+        int ids[4];
+        CHECK_EQUAL(1, world.items(ids));
+        CHECK_EQUAL(3, ids[0]);
+
+        undo_effects(planner.pstate.journal, &world.data);
+        const int all[] = { 1, 2, 3 };
+        CHECK_EQUAL(3, world.items(ids));
+        CHECK_ARRAY_EQUAL(all, ids, 3);
+    }
+
+    // at 1, roads from 1 to 2 and 3, the destination is set by tests.
+    struct apply_world
+    {
+        apply::worldstate data;
+
+        apply_world(int dest)
+        {
+            memset(&data, 0, sizeof(data));
+            data.atoms[apply::atom_at] = tuple_list::create<apply::at_tuple>(16);
+            data.atoms[apply::atom_road] = tuple_list::create<apply::road_tuple>(16);
+            data.atoms[apply::atom_visited] = tuple_list::create<apply::visited_tuple>(16);
+            data.atoms[apply::atom_dest] = tuple_list::create<apply::dest_tuple>(16);
+
+            tuple_list::append<apply::at_tuple>(data.atoms[apply::atom_at])->_0 = 1;
+            tuple_list::append<apply::dest_tuple>(data.atoms[apply::atom_dest])->_0 = dest;
+
+            for (int y = 2; y <= 3; ++y)
+            {
+                apply::road_tuple* road = tuple_list::append<apply::road_tuple>(data.atoms[apply::atom_road]);
+                road->_0 = 1;
+                road->_1 = y;
+            }
+        }
+
+        ~apply_world()
+        {
+            for (int i = 0; i < apply::atom_count; ++i)
+            {
+                tuple_list::destroy(data.atoms[i]);
+            }
+        }
+
+        // argument of the single tuple of a one-argument atom, 0 if there are none or several.
+        template <typename T>
+        int single(int atom)
+        {
+            tuple_list::handle* list = data.atoms[atom];
+            return tuple_list::size(list) == 1 ? tuple_list::head<T>(list)->_0 : 0;
+        }
+    };
+
+    struct apply_planner
+    {
+        stack methods;
+        stack tasks;
+        stack journal;
+        planner_state pstate;
+
+        apply_planner()
+            : methods(4096)
+            , tasks(4096)
+            , journal(4096)
+        {
+            memset(&pstate, 0, sizeof(pstate));
+            pstate.methods = &methods;
+            pstate.tasks = &tasks;
+            pstate.journal = &journal;
+            pstate.expands = apply::expands;
+        }
+
+        bool run(void* world)
+        {
+            apply::travel_args from = { 1 };
+            find_plan_init(pstate, apply::task_travel, apply::expand_travel_branch_0);
+            *push_arguments<apply::travel_args>(pstate, top_method(pstate)) = from;
+
+            find_plan_status status;
+
+            while ((status = find_plan_step(pstate, world)) == plan_in_progress)
+            {
+            }
+
+            return status == plan_found;
+        }
+    };
+
+    // `apply_move` journals its effects like inlined ones: the move to 2 is undone before the move to 3.
+    TEST(out_of_line_effects)
+    {
+        apply_world world(3);
+        apply_planner planner;
+        CHECK(planner.run(&world.data));
+
+        task_instance* wait = bottom<task_instance>(planner.pstate.tasks);
+        task_instance* move = next_task(wait);
+        CHECK_EQUAL(apply::task_wait, wait->type);
+        CHECK_EQUAL(apply::task_move, move->type);
+        CHECK_EQUAL(3, static_cast<apply::move_args*>(arguments(move))->_1);
+        CHECK(next_task(move) == 0);
+
+        CHECK_EQUAL(3, world.single<apply::at_tuple>(apply::atom_at));
+        CHECK_EQUAL(3, world.single<apply::visited_tuple>(apply::atom_visited));
+
+        undo_effects(planner.pstate.journal, &world.data);
+        CHECK_EQUAL(1, world.single<apply::at_tuple>(apply::atom_at));
+        CHECK_EQUAL(0u, tuple_list::size(world.data.atoms[apply::atom_visited]));
+    }
+
+    // an unreachable destination undoes every applied effect.
+    TEST(out_of_line_effects_no_plan)
+    {
+        apply_world world(4);
+        apply_planner planner;
+        CHECK(!planner.run(&world.data));
+
+        CHECK(planner.journal.empty());
+        CHECK_EQUAL(1, world.single<apply::at_tuple>(apply::atom_at));
+        CHECK_EQUAL(0u, tuple_list::size(world.data.atoms[apply::atom_visited]));
+    }
+
+    // `left` holds 1 .. num_left, `right` pairs 10 and 30 with 1, 20 with 2.
+    struct adaptive_world
+    {
+        adaptive::worldstate data;
+
+        adaptive_world(int num_left)
+        {
+            memset(&data, 0, sizeof(data));
+            data.atoms[adaptive::atom_left] = tuple_list::create<adaptive::left_tuple>(16);
+            data.atoms[adaptive::atom_right] = tuple_list::create<adaptive::right_tuple>(16);
+
+            for (int x = 1; x <= num_left; ++x)
+            {
+                tuple_list::append<adaptive::left_tuple>(data.atoms[adaptive::atom_left])->_0 = x;
+            }
+
+            const int rights[][2] = { { 10, 1 }, { 20, 2 }, { 30, 1 } };
+
+            for (int i = 0; i < 3; ++i)
+            {
+                adaptive::right_tuple* right = tuple_list::append<adaptive::right_tuple>(data.atoms[adaptive::atom_right]);
+                right->_0 = rights[i][0];
+                right->_1 = rights[i][1];
+            }
+        }
+
+        ~adaptive_world()
+        {
+            for (int i = 0; i < adaptive::atom_count; ++i)
+            {
+                tuple_list::destroy(data.atoms[i]);
+            }
+        }
+    };
+
+    // writes `y` of every `!pair x y` in the plan for `num_left` left tuples, returns their number.
+    int adaptive_pairs(int num_left, int* ys)
+    {
+        adaptive_world world(num_left);
+
+        stack methods(4096);
+        stack tasks(4096);
+        stack journal(4096);
+        planner_state pstate;
+        memset(&pstate, 0, sizeof(pstate));
+        pstate.methods = &methods;
+        pstate.tasks = &tasks;
+        pstate.journal = &journal;
+        pstate.expands = adaptive::expands;
+
+        CHECK(find_plan(pstate, adaptive::task_pairs, adaptive::expand_pairs_branch_0, &world.data));
+
+        int count = 0;
+
+        for (task_instance* task = pstate.top_task ? bottom<task_instance>(pstate.tasks) : 0; task != 0; task = next_task(task))
+        {
+            ys[count++] = static_cast<adaptive::pair_args*>(arguments(task))->_1;
+        }
+
+        return count;
+    }
+
+    // the smaller list leads the loop nest, which shows in the order of the bindings.
+    TEST(adaptive_join_order)
+    {
+        int ys[8];
+
+        const int left_first[] = { 10, 30, 20 };
+        CHECK_EQUAL(3, adaptive_pairs(2, ys));
+        CHECK_ARRAY_EQUAL(left_first, ys, 3);
+
+        const int right_first[] = { 10, 20, 30 };
+        CHECK_EQUAL(3, adaptive_pairs(4, ys));
+        CHECK_ARRAY_EQUAL(right_first, ys, 3);
+    }
+}
@@ -0,0 +1,111 @@
+//
+// Copyright (c) 2013 Alexander Shafranov shafranov@gmail.com
+//
+// This software is provided 'as-is', without any express or implied
+// warranty.  In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software. If you use this software
+// in a product, an acknowledgment in the product documentation would be
+// appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+
+
+#include <string.h>
+#include <unittestpp.h>
+#include <derplanner/runtime/runtime.h>
+#include "domains/semijoin.h"
+
+using namespace plnnr;
+
+namespace
+{
+    struct semijoin_world
+    {
+        semijoin::worldstate data;
+
+        semijoin_world()
+        {
+            memset(&data, 0, sizeof(data));
+            data.atoms[semijoin::atom_item] = tuple_list::create<semijoin::item_tuple>(16);
+
+            for (int i = 0; i < 3; ++i)
+            {
+                tuple_list::append<semijoin::item_tuple>(data.atoms[semijoin::atom_item])->_0 = i;
+            }
+        }
+
+        ~semijoin_world()
+        {
+            tuple_list::destroy(data.atoms[semijoin::atom_item]);
+        }
+    };
+
+    struct semijoin_planner
+    {
+        stack methods;
+        stack tasks;
+        stack journal;
+        planner_state pstate;
+
+        semijoin_planner()
+            : methods(4096)
+            , tasks(4096)
+            , journal(4096)
+        {
+            memset(&pstate, 0, sizeof(pstate));
+            pstate.methods = &methods;
+            pstate.tasks = &tasks;
+            pstate.journal = &journal;
+            pstate.expands = semijoin::expands;
+        }
+    };
+
+    int plan_length(const planner_state& pstate)
+    {
+        int length = 0;
+
+        for (task_instance* task = pstate.top_task ? bottom<task_instance>(pstate.tasks) : 0; task != 0; task = next_task(task))
+        {
+            ++length;
+        }
+
+        return length;
+    }
+
+    // `x` isn't used by the task list, so the three items give a single plan.
+    TEST(semijoin_stops_at_first_match)
+    {
+        semijoin_world world;
+        semijoin_planner planner;
+        find_plan_init(planner.pstate, semijoin::task_any, semijoin::expand_any_branch_0);
+
+        int num_plans = 0;
+
+        while (find_next_plan(planner.pstate, &world.data) == plan_found)
+        {
+            CHECK_EQUAL(1, plan_length(planner.pstate));
+            ++num_plans;
+        }
+
+        CHECK_EQUAL(1, num_plans);
+    }
+
+    // a foreach branch needs every binding even if the task list doesn't use it.
+    TEST(semijoin_not_applied_to_foreach)
+    {
+        semijoin_world world;
+        semijoin_planner planner;
+
+        CHECK(find_plan(planner.pstate, semijoin::task_each, semijoin::expand_each_branch_0, &world.data));
+        CHECK_EQUAL(3, plan_length(planner.pstate));
+    }
+}
@@ -0,0 +1,99 @@
+//
+// Copyright (c) 2013 Alexander Shafranov shafranov@gmail.com
+//
+// This software is provided 'as-is', without any express or implied
+// warranty.  In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software. If you use this software
+// in a product, an acknowledgment in the product documentation would be
+// appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+
+
+#include <string.h>
+#include <unittestpp.h>
+#include <derplanner/runtime/runtime.h>
+#include "domains/sort.h"
+
+using namespace plnnr;
+
+namespace
+{
+    struct sort_world
+    {
+        sort::worldstate data;
+
+        sort_world()
+        {
+            memset(&data, 0, sizeof(data));
+            data.atoms[sort::atom_item] = tuple_list::create<sort::item_tuple>(16);
+            data.atoms[sort::atom_weight] = tuple_list::create<sort::weight_tuple>(16);
+        }
+
+        ~sort_world()
+        {
+            tuple_list::destroy(data.atoms[sort::atom_item]);
+            tuple_list::destroy(data.atoms[sort::atom_weight]);
+        }
+
+        void item(int x)
+        {
+            tuple_list::append<sort::item_tuple>(data.atoms[sort::atom_item])->_0 = x;
+        }
+
+        void weight(int x, int k)
+        {
+            sort::weight_tuple* t = tuple_list::append<sort::weight_tuple>(data.atoms[sort::atom_weight]);
+            t->_0 = x;
+            t->_1 = k;
+        }
+    };
+
+    // the sort key isn't used by the task list, but every key of an item is still a binding of its own.
+    TEST(sort_by_several_keys_per_binding)
+    {
+        sort_world world;
+        world.item(1);
+        world.item(2);
+        world.weight(1, 5);
+        world.weight(1, 1);
+        world.weight(2, 3);
+
+        stack methods(4096);
+        stack tasks(4096);
+        stack journal(4096);
+
+        planner_state pstate;
+        memset(&pstate, 0, sizeof(pstate));
+        pstate.methods = &methods;
+        pstate.tasks = &tasks;
+        pstate.journal = &journal;
+        pstate.expands = sort::expands;
+
+        find_plan_init(pstate, sort::task_root, sort::expand_root_branch_0);
+
+        int taken[4];
+        int num_plans = 0;
+
+        while (find_next_plan(pstate, &world.data) == plan_found)
+        {
+            CHECK(num_plans < 4);
+            task_instance* task = bottom<task_instance>(pstate.tasks);
+            taken[num_plans++] = static_cast<sort::take_args*>(arguments(task))->_0;
+        }
+
+        // keys 1, 3 and 5.
+        const int expected[] = { 1, 2, 1 };
+        CHECK_EQUAL(3, num_plans);
+        CHECK_ARRAY_EQUAL(expected, taken, 3);
+    }
+}
@@ -0,0 +1,123 @@
+//
+// Copyright (c) 2013 Alexander Shafranov shafranov@gmail.com
+//
+// This software is provided 'as-is', without any express or implied
+// warranty.  In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+// claim that you wrote the original software. If you use this software
+// in a product, an acknowledgment in the product documentation would be
+// appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+// misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+
+
+#include <string.h>
+#include <unittestpp.h>
+#include <derplanner/runtime/runtime.h>
+#include "domains/stream.h"
+
+using namespace plnnr;
+
+namespace
+{
+    struct stream_world
+    {
+        stream::worldstate data;
+
+        stream_world()
+        {
+            memset(&data, 0, sizeof(data));
+            data.atoms[stream::atom_item] = tuple_list::create<stream::item_tuple>(16);
+            data.atoms[stream::atom_big] = tuple_list::create<stream::big_tuple>(16);
+        }
+
+        ~stream_world()
+        {
+            tuple_list::destroy(data.atoms[stream::atom_item]);
+            tuple_list::destroy(data.atoms[stream::atom_big]);
+        }
+
+        void item(int x)
+        {
+            tuple_list::append<stream::item_tuple>(data.atoms[stream::atom_item])->_0 = x;
+        }
+
+        void big(int x)
+        {
+            tuple_list::append<stream::big_tuple>(data.atoms[stream::atom_big])->_0 = x;
+        }
+    };
+
+    // `prefix` is committed while `pick` still backtracks over the items.
+    TEST(streamed_prefix_of_final_plan)
+    {
+        stream_world world;
+        world.item(10);
+        world.item(11);
+        world.item(12);
+        world.big(12);
+
+        stack methods(4096);
+        stack tasks(4096);
+        stack journal(4096);
+
+        planner_state pstate;
+        memset(&pstate, 0, sizeof(pstate));
+        pstate.methods = &methods;
+        pstate.tasks = &tasks;
+        pstate.journal = &journal;
+        pstate.expands = stream::expands;
+
+        find_plan_init(pstate, stream::task_root, stream::expand_root_branch_0);
+
+        int streamed[8];
+        int num_streamed = 0;
+        int num_streamed_in_progress = 0;
+        size_t cursor = 0;
+        find_plan_status status = plan_in_progress;
+
+        while (status == plan_in_progress)
+        {
+            status = find_plan_step(pstate, &world.data);
+
+            while (task_instance* task = next_committed_task(pstate, cursor))
+            {
+                CHECK(num_streamed < 8);
+                streamed[num_streamed++] = static_cast<stream::a_args*>(arguments(task))->_0;
+            }
+
+            if (status == plan_in_progress)
+            {
+                num_streamed_in_progress = num_streamed;
+            }
+        }
+
+        CHECK_EQUAL(plan_found, status);
+        // !a 1, !a 2 and, once `pick` is on its last item, !a 12 are streamed before the search ends.
+        CHECK_EQUAL(3, num_streamed_in_progress);
+
+        int plan[8];
+        int num_tasks = 0;
+
+        for (task_instance* task = bottom<task_instance>(pstate.tasks); task != 0; task = next_task(task))
+        {
+            plan[num_tasks++] = static_cast<stream::a_args*>(arguments(task))->_0;
+        }
+
+        const int expected[] = { 1, 2, 12, 100 };
+        CHECK_EQUAL(4, num_tasks);
+        CHECK_ARRAY_EQUAL(expected, plan, 4);
+
+        // the whole plan is committed once found.
+        CHECK_EQUAL(num_tasks, num_streamed);
+        CHECK_ARRAY_EQUAL(plan, streamed, num_streamed);
+    }
+}
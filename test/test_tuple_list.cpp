@@ -31,6 +31,7 @@ namespace
         void* parent;
         tuple* next;
         tuple* prev;
+        uint32_t slot;
     };
 
     struct holder
@@ -69,6 +70,7 @@ namespace
         }
 
         CHECK_EQUAL(10, count);
+        CHECK_EQUAL(10u, tuple_list::size(h.list));
     }
 
     TEST(undo_sequantial_add)
@@ -163,6 +165,8 @@ namespace
             }
         }
 
+        CHECK_EQUAL(10u, tuple_list::size(h.list));
+
         // undo journal
         for (int i = sizeof(journal)/sizeof(journal[0]) - 1; i >= 0; --i)
         {
@@ -181,6 +185,7 @@ namespace
         }
 
         CHECK_EQUAL(10, count);
+        CHECK_EQUAL(10u, tuple_list::size(h.list));
 
         for (tuple* tail = head; ; tail = tail->next)
         {
@@ -267,4 +272,60 @@ namespace
             }
         }
     }
+
+    TEST(slots_across_pages)
+    {
+        holder h(3);
+
+        tuple* tuples[10];
+
+        for (int i = 0; i < 10; ++i)
+        {
+            tuples[i] = tuple_list::append<tuple>(h.list);
+            tuples[i]->data = i;
+        }
+
+        for (int i = 0; i < 10; ++i)
+        {
+            uint32_t slot = tuple_list::slot(h.list, tuples[i]);
+            CHECK_EQUAL((uint32_t)i, slot);
+            CHECK_EQUAL(tuples[i], tuple_list::at<tuple>(h.list, slot));
+        }
+
+        // slots stay valid for detached tuples.
+        tuple_list::detach(h.list, tuples[4]);
+        tuple_list::detach(h.list, tuples[7]);
+        CHECK_EQUAL(8u, tuple_list::size(h.list));
+
+        tuple_list::restore(h.list, tuple_list::at<tuple>(h.list, 7));
+        tuple_list::restore(h.list, tuple_list::at<tuple>(h.list, 4));
+
+        int count = 0;
+
+        for (tuple* t = tuple_list::head<tuple>(h.list); t != 0; t = t->next, ++count)
+        {
+            CHECK_EQUAL(count, t->data);
+        }
+
+        CHECK_EQUAL(10, count);
+    }
+
+    TEST(slot_of_foreign_tuple)
+    {
+        holder h(3);
+        holder other(3);
+
+        for (int i = 0; i < 5; ++i)
+        {
+            tuple_list::append<tuple>(h.list);
+        }
+
+        tuple* foreign = tuple_list::append<tuple>(other.list);
+
+        tuple local;
+        local.slot = 0;
+
+        CHECK_EQUAL(tuple_list::invalid_slot, tuple_list::slot(h.list, foreign));
+        CHECK_EQUAL(tuple_list::invalid_slot, tuple_list::slot(h.list, &local));
+    }
 }